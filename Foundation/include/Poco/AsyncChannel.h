@@ -22,10 +22,20 @@
 
 #include "Poco/Foundation.h"
 #include "Poco/Channel.h"
+#include "Poco/Message.h"
 #include "Poco/Thread.h"
 #include "Poco/Mutex.h"
 #include "Poco/Runnable.h"
-#include "Poco/NotificationQueue.h"
+#include "Poco/Condition.h"
+#include <vector>
+#if !defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL) && !defined(POCO_NO_LOCKFREE_ASYNCCHANNEL)
+	#if defined(POCO_HAVE_STD_ATOMICS) || __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+		#define POCO_HAVE_LOCKFREE_ASYNCCHANNEL
+	#endif
+#endif
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+#include <atomic>
+#endif
 
 
 namespace Poco {
@@ -40,8 +50,54 @@ class Foundation_API AsyncChannel: public Channel, public Runnable
 	///
 	/// All log messages are put into a queue and this queue is
 	/// then processed by a separate thread.
+	///
+	/// The queue is a preallocated ring buffer of message slots.
+	/// log() copies the message into a free slot, reusing the
+	/// memory of the message previously held by the slot, so that
+	/// in the steady state logging a message does not allocate
+	/// memory. If std::atomic is available (C++11), claiming and
+	/// releasing slots does not acquire a lock; a mutex is only used
+	/// to put the logging thread to sleep when the queue is empty,
+	/// and to put producers to sleep when the queue is full.
+	/// If POCO_NO_LOCKFREE_ASYNCCHANNEL is defined, the ring
+	/// buffer is protected by a mutex instead.
+	///
+	/// The logging thread takes the queued messages out of the
+	/// ring buffer in batches, swapping them with the messages of
+	/// its batch buffer (so that the slots are available again
+	/// immediately, and their memory is still recycled), and passes
+	/// every batch to the target channel's logBatch() method.
+	///
+	/// The overflow policy determines what happens if a message is
+	/// logged while the queue is full:
+	///   - OVERFLOW_BLOCK (default): log() waits until the logging
+	///     thread has made room for the message.
+	///   - OVERFLOW_DROP_NEWEST: the new message is discarded.
+	///   - OVERFLOW_DROP_OLDEST: the oldest message in the queue
+	///     that has not been taken by the logging thread yet is
+	///     discarded.
+	/// Discarded messages are counted; see droppedMessages().
+	/// Messages logged from the logging thread itself (e.g., by
+	/// the target channel) are discarded instead of blocking
+	/// if the queue is full.
 {
 public:
+	enum OverflowPolicy
+	{
+		OVERFLOW_BLOCK,       /// Wait until the queue has room for the message.
+		OVERFLOW_DROP_NEWEST, /// Discard the message being logged.
+		OVERFLOW_DROP_OLDEST  /// Discard the oldest message in the queue.
+	};
+
+	enum
+	{
+		DEFAULT_QUEUE_SIZE = 4096,
+			/// The default number of message slots.
+		DEFAULT_BATCH_SIZE = 64
+			/// The default maximum number of messages
+			/// passed to the target channel at once.
+	};
+
 	AsyncChannel(Channel* pChannel = 0, Thread::Priority prio = Thread::PRIO_NORMAL);
 		/// Creates the AsyncChannel and connects it to
 		/// the given channel.
@@ -59,12 +115,40 @@ public:
 		
 	void close();
 		/// Closes the channel and stops the background
-		/// logging thread.
+		/// logging thread, after all queued messages
+		/// have been passed to the target channel.
 
 	void log(const Message& msg);
 		/// Queues the message for processing by the
 		/// background thread.
 
+	void setQueueSize(std::size_t size);
+		/// Sets the number of message slots. The size is
+		/// rounded up to the next power of two.
+		///
+		/// Throws an IllegalStateException if the
+		/// channel is open.
+
+	std::size_t getQueueSize() const;
+		/// Returns the number of message slots.
+
+	void setBatchSize(std::size_t size);
+		/// Sets the maximum number of messages passed to the
+		/// target channel's logBatch() method at once.
+
+	std::size_t getBatchSize() const;
+		/// Returns the batch size.
+
+	void setOverflowPolicy(OverflowPolicy policy);
+		/// Sets the overflow policy.
+
+	OverflowPolicy getOverflowPolicy() const;
+		/// Returns the overflow policy.
+
+	Poco::UInt64 droppedMessages() const;
+		/// Returns the number of messages that have been
+		/// discarded because the queue was full.
+
 	void setProperty(const std::string& name, const std::string& value);
 		/// Sets or changes a configuration property.
 		///
@@ -81,18 +165,91 @@ public:
 		///    * highest
 		///
 		/// The "priority" property is set-only.
+		///
+		/// The "queueSize" property sets the number of message
+		/// slots (see setQueueSize()).
+		///
+		/// The "batchSize" property sets the maximum number of
+		/// messages passed to the target channel at once.
+		///
+		/// The "overflow" property sets the overflow policy.
+		/// The following values are supported:
+		///    * block (default)
+		///    * dropNewest
+		///    * dropOldest
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the "queueSize", "batchSize"
+		/// or "overflow" property.
 
 protected:
 	~AsyncChannel();
 	void run();
 	void setPriority(const std::string& value);
+
+	bool tryEnqueue(const Message& msg);
+		/// Copies the message into a free slot. Returns
+		/// false if the queue is full.
+
+	bool dropOldest();
+		/// Discards the oldest message not yet taken by the
+		/// logging thread. Returns false if there is none.
+
+	std::size_t dequeueBatch();
+		/// Moves up to batch size queued messages into the
+		/// batch buffer, and returns their number.
+
+	void waitForMessages();
+		/// Waits until a message is available or the
+		/// channel is being closed.
+
+	void waitForSpace();
+		/// Waits until the queue has room for a message.
 		
 private:
-	Channel*  _pChannel;
-	Thread    _thread;
-	FastMutex _threadMutex;
-	FastMutex _channelMutex;
-	NotificationQueue _queue;
+	AsyncChannel(const AsyncChannel&);
+	AsyncChannel& operator = (const AsyncChannel&);
+
+	void allocate(std::size_t size);
+
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+	Channel*       _pChannel;
+	Thread         _thread;
+	FastMutex      _threadMutex;
+	FastMutex      _channelMutex;
+	Message*       _pMessages;
+	std::vector<Message> _batch;
+	std::size_t    _mask;
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	std::atomic<std::size_t>   _batchSize;
+	std::atomic<int>           _overflowPolicy;
+	std::atomic<std::size_t>*  _pSequences;
+	char                       _pad1[CACHE_LINE_SIZE];
+	std::atomic<std::size_t>   _enqueuePos;
+	char                       _pad2[CACHE_LINE_SIZE];
+	std::atomic<std::size_t>   _dequeuePos;
+	char                       _pad3[CACHE_LINE_SIZE];
+	std::atomic<int>           _waitingProducers;
+	std::atomic<bool>          _waitingConsumer;
+	std::atomic<bool>          _stop;
+	std::atomic<Poco::UInt64>  _dropped;
+#else
+	std::size_t    _batchSize;
+	OverflowPolicy _overflowPolicy;
+	std::size_t    _enqueuePos;
+	std::size_t    _dequeuePos;
+	int            _waitingProducers;
+	bool           _waitingConsumer;
+	bool           _stop;
+	Poco::UInt64   _dropped;
+#endif
+	mutable FastMutex _mutex;
+	Condition         _messageAvailable;
+	Condition         _spaceAvailable;
 };
 
 
@@ -0,0 +1,209 @@
+//
+// BinaryLogChannel.h
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Definition of the BinaryLogChannel class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BinaryLogChannel_INCLUDED
+#define Foundation_BinaryLogChannel_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Channel.h"
+#include "Poco/Mutex.h"
+#include <map>
+
+
+namespace Poco {
+
+
+class FileOutputStream;
+
+
+class Foundation_API BinaryLogChannel: public Channel
+	/// A Channel that writes messages to a file in a compact,
+	/// structured binary format, instead of formatting them as text.
+	///
+	/// All fields of a message are written: time, priority, source,
+	/// thread name, thread identifiers, process identifier, source
+	/// file and line, parameters and text. Formatting is deferred
+	/// until the log file is read with a BinaryLogReader, which
+	/// reconstructs the Message objects, so that they can be
+	/// formatted with any Formatter (e.g., a PatternFormatter).
+	///
+	/// The file starts with an 8 byte signature ("PocoBLog"),
+	/// followed by a single byte containing the format version.
+	/// The rest of the file is a sequence of records. Every record
+	/// starts with its length (32-bit, little endian, not including
+	/// the length field itself), followed by a single byte denoting
+	/// the record type and the record's payload. Integers in the
+	/// payload are stored in 7-bit encoded form (see BinaryWriter),
+	/// signed integers are zig-zag encoded first. Strings are stored
+	/// as their 7-bit encoded length, followed by their contents.
+	/// Readers skip records of unknown types.
+	///
+	/// Source names, thread names, source file paths and parameter
+	/// names usually take only a few distinct values. Therefore,
+	/// each distinct string is written only once, in a string record
+	/// assigning it an identifier, and messages refer to these strings
+	/// by their identifiers.
+	///
+	/// If the file exists when the channel is opened, new records
+	/// are appended to it. The existing records are scanned first:
+	/// string records are read, so that their identifiers are reused
+	/// and never redefined within a file, and an incomplete record at
+	/// the end of the file (e.g., after the application writing the
+	/// file has crashed) is removed. Opening a file that is not a
+	/// binary log file of the current format version fails.
+	/// There is no support for log file rotation.
+	///
+	/// The BinaryLogChannel supports the following properties:
+	///
+	///   * path:  The log file's path.
+	///   * flush: Specifies whether every message is immediately
+	///            flushed to the log file ("true", default), or
+	///            written when the channel's buffer is full ("false").
+{
+public:
+	enum RecordType
+	{
+		RECORD_STRING  = 1,
+			/// Payload: string identifier, string.
+		RECORD_MESSAGE = 2
+			/// Payload: time (microseconds since the epoch),
+			/// priority, source string identifier, thread name
+			/// string identifier, thread identifier, OS thread
+			/// identifier, process identifier, source file string
+			/// identifier (0 if none), source line, number of
+			/// parameters, parameters (name string identifier,
+			/// value), text.
+	};
+
+	enum
+	{
+		FORMAT_VERSION = 1,
+			/// The version of the file format.
+		SIGNATURE_SIZE = 8,
+			/// The length of the signature.
+		MAX_RECORD_SIZE = 0x1000000
+			/// The maximum length of a record (excluding the
+			/// length field). Readers reject longer records as
+			/// invalid, so messages that do not fit cannot be
+			/// logged.
+	};
+
+	static const char SIGNATURE[SIGNATURE_SIZE + 1];
+		/// The signature at the beginning of a log file.
+
+	BinaryLogChannel();
+		/// Creates the BinaryLogChannel.
+
+	BinaryLogChannel(const std::string& path);
+		/// Creates the BinaryLogChannel for a file with the given path.
+
+	void open();
+		/// Opens the BinaryLogChannel and creates the log file if necessary.
+
+	void close();
+		/// Closes the BinaryLogChannel.
+
+	void log(const Message& msg);
+		/// Writes the given message to the log file.
+
+	void logBatch(const Message* pMessages, std::size_t count);
+		/// Writes the given messages to the log file, acquiring the
+		/// channel's lock only once. If flush is enabled, the file
+		/// is flushed once after all messages have been written.
+
+	void setProperty(const std::string& name, const std::string& value);
+		/// Sets the property with the given name.
+		///
+		/// The following properties are supported:
+		///   * path:  The log file's path.
+		///   * flush: Specifies whether messages are immediately
+		///            flushed to the log file.
+
+	std::string getProperty(const std::string& name) const;
+		/// Returns the value of the property with the given name.
+
+	const std::string& path() const;
+		/// Returns the log file's path.
+
+	static const std::string PROP_PATH;
+	static const std::string PROP_FLUSH;
+
+protected:
+	~BinaryLogChannel();
+
+	void openImpl();
+		/// Opens the log file, if necessary, and writes the
+		/// file header if the file is empty.
+
+	void recover();
+		/// Reads the string records of an existing log file and
+		/// truncates the file after the last complete record.
+
+	void recoverString(const std::string& payload);
+		/// Registers the string defined by the given string
+		/// record payload.
+
+	void writeMessage(const Message& msg);
+		/// Writes the string records required for the given
+		/// message, followed by the message record.
+
+	UInt32 stringId(const std::string& str);
+		/// Returns the identifier of the given string, after
+		/// writing a string record for it if necessary.
+
+	UInt32 fileId(const char* file);
+		/// Returns the identifier of the given source file path,
+		/// or 0 if file is null.
+
+	void writeRecord(std::string& record);
+		/// Fills in the length of the given record, which starts
+		/// with a placeholder for it, and writes it to the file.
+		///
+		/// Throws an InvalidArgumentException if the record
+		/// is longer than MAX_RECORD_SIZE.
+
+private:
+	typedef std::map<std::string, UInt32> StringIdMap;
+	typedef std::map<const char*, UInt32> FileIdMap;
+
+	std::string       _path;
+	bool              _flush;
+	FileOutputStream* _pStr;
+	StringIdMap       _stringIds;
+	FileIdMap         _fileIds;
+	UInt32            _nextId;
+	std::string       _record;
+	std::string       _stringRecord;
+	FastMutex         _mutex;
+};
+
+
+//
+// inlines
+//
+inline const std::string& BinaryLogChannel::path() const
+{
+	return _path;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BinaryLogChannel_INCLUDED
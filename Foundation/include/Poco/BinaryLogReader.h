@@ -0,0 +1,132 @@
+//
+// BinaryLogReader.h
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogReader
+//
+// Definition of the BinaryLogReader class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_BinaryLogReader_INCLUDED
+#define Foundation_BinaryLogReader_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Message.h"
+#include <istream>
+#include <map>
+#include <set>
+
+
+namespace Poco {
+
+
+class Formatter;
+
+
+class Foundation_API BinaryLogReader
+	/// This class reads the messages from a log file written
+	/// by a BinaryLogChannel.
+	///
+	/// Usage example:
+	///     Poco::FileInputStream istr("app.blog");
+	///     Poco::BinaryLogReader reader(istr);
+	///     Poco::PatternFormatter formatter("%Y-%m-%d %H:%M:%S.%i [%p] %s: %t");
+	///     Poco::Message msg;
+	///     std::string text;
+	///     while (reader.read(msg))
+	///     {
+	///         text.clear();
+	///         formatter.format(msg, text);
+	///         std::cout << text << std::endl;
+	///     }
+{
+public:
+	BinaryLogReader(std::istream& istr);
+		/// Creates the BinaryLogReader for the given stream, which
+		/// must be opened in binary mode, and reads the file header.
+		///
+		/// Throws a DataFormatException if the stream does not
+		/// start with a valid header.
+
+	~BinaryLogReader();
+		/// Destroys the BinaryLogReader.
+
+	bool read(Message& msg);
+		/// Reads the next message from the stream.
+		///
+		/// Returns false if the end of the stream has been reached.
+		/// An incomplete record at the end of the stream (e.g., after
+		/// the application writing the log file has crashed) is treated
+		/// as the end of the stream.
+		///
+		/// Throws a DataFormatException if the stream contains
+		/// invalid data.
+		///
+		/// The source file path of the message (see Message::getSourceFile())
+		/// points to a string owned by the BinaryLogReader. The string is
+		/// never modified, but it is destroyed together with the
+		/// BinaryLogReader, so the message must not be used after that
+		/// without resetting its source file.
+
+	std::size_t format(Formatter& formatter, std::ostream& ostr);
+		/// Reads all remaining messages from the stream, formats them
+		/// with the given Formatter and writes them to ostr, each
+		/// followed by a newline. Returns the number of messages.
+
+	int version() const;
+		/// Returns the format version of the log file.
+
+protected:
+	bool readRecord();
+		/// Reads the next record into the record buffer.
+		/// Returns false at the end of the stream.
+
+	bool readMessage(Message& msg);
+		/// Processes the record in the record buffer. Returns true
+		/// and fills msg if it is a message record.
+
+	UInt64 read7BitEncoded();
+	Int64 readSigned();
+	void readString(std::string& value);
+	const std::string& lookup(UInt64 id) const;
+
+private:
+	BinaryLogReader();
+	BinaryLogReader(const BinaryLogReader&);
+	BinaryLogReader& operator = (const BinaryLogReader&);
+
+	typedef std::map<UInt32, std::string> StringMap;
+	typedef std::set<std::string> StringSet;
+
+	std::istream& _istr;
+	int           _version;
+	std::string   _record;
+	std::size_t   _pos;
+	StringMap     _strings;
+	StringSet     _sourceFiles;
+};
+
+
+//
+// inlines
+//
+inline int BinaryLogReader::version() const
+{
+	return _version;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_BinaryLogReader_INCLUDED
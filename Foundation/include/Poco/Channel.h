@@ -58,6 +58,18 @@ public:
 		///
 		/// If the channel has not been opened yet, the log()
 		/// method will open it.
+
+	virtual void logBatch(const Message* pMessages, std::size_t count);
+		/// Logs the given number of messages to the channel.
+		///
+		/// Called by channels that collect messages, such as
+		/// AsyncChannel, to pass several messages at once.
+		/// The default implementation calls log() for every
+		/// message. If log() throws for a message, the remaining
+		/// messages are logged nonetheless, and the first exception
+		/// is rethrown afterwards. Subclasses can override this
+		/// method to process the messages more efficiently, e.g.
+		/// by writing them with a single operation.
 		
 	void setProperty(const std::string& name, const std::string& value);
 		/// Throws a PropertyNotSupportedException.
@@ -177,6 +177,16 @@
 // #define POCO_LOG_DEBUG
 
 
+// Size of the per-thread buffer (in bytes) used to
+// capture the format arguments in Logger::logDeferred()
+// and the poco_<level>_df<n> macros. Arguments that
+// fit into the buffer are captured without heap
+// allocations.
+#ifndef POCO_LOG_BUFFER_SIZE
+	#define POCO_LOG_BUFFER_SIZE 256
+#endif
+
+
 // Uncomment to disable the use of bundled OpenSSL binaries
 // (Windows only)
 // #define POCO_EXTERNAL_OPENSSL
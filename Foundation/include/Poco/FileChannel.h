@@ -34,6 +34,7 @@ class LogFile;
 class RotateStrategy;
 class ArchiveStrategy;
 class PurgeStrategy;
+class Timer;
 
 
 class Foundation_API FileChannel: public Channel
@@ -156,6 +157,39 @@ class Foundation_API FileChannel: public Channel
 	///   * true:  Every message is immediately flushed to the log file (default).
 	///   * false: Messages are not immediately flushed to the log file.
 	///
+	/// The groupCommit property enables group commit. With group commit,
+	/// messages are collected in a memory buffer and written to the log file
+	/// with a single write operation, which is much faster than writing and
+	/// flushing every message separately. The buffered messages are written
+	/// as soon as one of the following conditions is met:
+	///
+	///   * the buffer contains commitMessages messages (if commitMessages
+	///     is not zero; default is 0),
+	///   * the buffer contains commitBytes bytes (if commitBytes is
+	///     not zero; default is 65536),
+	///   * commitInterval milliseconds have elapsed since the buffer
+	///     has last been written (if commitInterval is not zero; default is 100).
+	///     The buffer is written by a Timer running in a thread from the
+	///     default ThreadPool. A changed commitInterval takes effect
+	///     when the channel is opened again.
+	///
+	/// The buffer is also written before the log file is rotated, and
+	/// when the channel is closed. The size of the buffer counts towards
+	/// the log file size for size-based rotation. Only messages still in
+	/// the buffer can be lost if the application crashes. The flush property
+	/// does not apply to group commit, as the buffer is written directly
+	/// to the file.
+	///
+	/// Additionally, the syncInterval property can be used to specify
+	/// how often the log file's data is synchronized with the storage device
+	/// (using fdatasync() or fsync() on POSIX platforms), which ensures that
+	/// the data survives a system crash. If syncInterval is a number of
+	/// milliseconds, the data is synchronized when the buffer is written, if
+	/// at least syncInterval milliseconds have elapsed since the last
+	/// synchronization (0 synchronizes every time the buffer is written).
+	/// If syncInterval is "none" (default), the data is never explicitly
+	/// synchronized.
+	///
 	/// The rotateOnOpen property specifies whether an existing log file should be 
 	/// rotated (and archived) when the channel is opened. Valid values are:
 	///
@@ -181,6 +215,10 @@ public:
 
 	void log(const Message& msg);
 		/// Logs the given message to the file.
+
+	void logBatch(const Message* pMessages, std::size_t count);
+		/// Logs the given messages to the file, acquiring
+		/// the channel's lock only once.
 		
 	void setProperty(const std::string& name, const std::string& value);
 		/// Sets the property with the given name. 
@@ -207,6 +245,17 @@ public:
 		///                   for details.
 		///   * rotateOnOpen: Specifies whether an existing log file should be 
 		///                   rotated and archived when the channel is opened.
+		///   * groupCommit:  Enables or disables group commit. See the
+		///                   FileChannel class for details.
+		///   * commitMessages: Maximum number of buffered messages
+		///                   with group commit.
+		///   * commitBytes:  Maximum number of buffered bytes with
+		///                   group commit.
+		///   * commitInterval: Maximum time in milliseconds messages
+		///                   are buffered with group commit.
+		///   * syncInterval: Minimum time in milliseconds between
+		///                   synchronizations of the log file with the
+		///                   storage device, or "none".
 
 	std::string getProperty(const std::string& name) const;
 		/// Returns the value of the property with the given name.
@@ -231,6 +280,11 @@ public:
 	static const std::string PROP_PURGECOUNT;
 	static const std::string PROP_FLUSH;
 	static const std::string PROP_ROTATEONOPEN;
+	static const std::string PROP_GROUPCOMMIT;
+	static const std::string PROP_COMMITMESSAGES;
+	static const std::string PROP_COMMITBYTES;
+	static const std::string PROP_COMMITINTERVAL;
+	static const std::string PROP_SYNCINTERVAL;
 
 protected:
 	~FileChannel();
@@ -241,9 +295,21 @@ protected:
 	void setPurgeCount(const std::string& count);
 	void setFlush(const std::string& flush);
 	void setRotateOnOpen(const std::string& rotateOnOpen);
+	void setGroupCommit(const std::string& groupCommit);
+	void setCommitMessages(const std::string& messages);
+	void setCommitBytes(const std::string& bytes);
+	void setCommitInterval(const std::string& interval);
+	void setSyncInterval(const std::string& interval);
 	void purge();
 
 private:
+	void logImpl(const Message& msg);
+	void commit();
+	void onCommitTimer(Timer& timer);
+	void stopCommitTimer();
+		/// Stops and deletes the commit timer.
+		/// Must be called without the mutex locked.
+
 	bool setNoPurge(const std::string& value);
 	int extractDigit(const std::string& value, std::string::const_iterator* nextToDigit = NULL) const;
 	void setPurgeStrategy(PurgeStrategy* strategy);
@@ -262,6 +328,14 @@ private:
 	RotateStrategy*  _pRotateStrategy;
 	ArchiveStrategy* _pArchiveStrategy;
 	PurgeStrategy*   _pPurgeStrategy;
+	bool             _groupCommit;
+	std::size_t      _commitMessages;
+	std::size_t      _commitBytes;
+	long             _commitInterval;
+	long             _syncInterval;
+	Timestamp        _lastSync;
+	bool             _unsynced;
+	Timer*           _pTimer;
 	FastMutex        _mutex;
 };
 
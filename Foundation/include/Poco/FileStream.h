@@ -73,6 +73,10 @@ public:
 	FileStreamBuf* rdbuf();
 		/// Returns a pointer to the underlying streambuf.
 
+	FileStreamBuf::NativeHandle nativeHandle() const;
+		/// Returns the native handle of the open file.
+		/// See FileStreamBuf::nativeHandle().
+
 protected:
 	FileStreamBuf _buf;
 	std::ios::openmode _defaultMode;
@@ -33,6 +33,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef int NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 		
@@ -52,6 +54,12 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// Change to specified position, according to mode.
 
+	NativeHandle nativeHandle() const;
+		/// Returns the native file handle (file descriptor) of the open file.
+		///
+		/// The handle must not be closed by the caller, and any
+		/// reads or writes using it bypass the stream buffer.
+
 protected:
 	enum
 	{
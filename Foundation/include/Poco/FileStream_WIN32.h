@@ -32,6 +32,8 @@ class Foundation_API FileStreamBuf: public BufferedBidirectionalStreamBuf
 	/// This stream buffer handles Fileio
 {
 public:
+	typedef HANDLE NativeHandle;
+
 	FileStreamBuf();
 		/// Creates a FileStreamBuf.
 
@@ -51,6 +53,12 @@ public:
 	std::streampos seekpos(std::streampos pos, std::ios::openmode mode = std::ios::in | std::ios::out);
 		/// change to specified position, according to mode
 
+	NativeHandle nativeHandle() const;
+		/// Returns the native file handle (HANDLE) of the open file.
+		///
+		/// The handle must not be closed by the caller, and any
+		/// reads or writes using it bypass the stream buffer.
+
 protected:
 	enum
 	{
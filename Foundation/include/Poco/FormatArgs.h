@@ -0,0 +1,227 @@
+//
+// FormatArgs.h
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Core
+// Module:  FormatArgs
+//
+// Definition of the FormatArgs class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_FormatArgs_INCLUDED
+#define Foundation_FormatArgs_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include <string>
+#include <cstring>
+
+
+namespace Poco {
+
+
+class Foundation_API FormatArgs
+	/// FormatArgs captures the arguments for a later call to
+	/// Poco::format() by value into a caller-supplied string
+	/// buffer, in a compact binary form.
+	///
+	/// This allows the (comparatively expensive) formatting
+	/// to be deferred, e.g. to the thread of an AsyncChannel.
+	/// Capturing the arguments does not allocate memory as
+	/// long as the buffer has sufficient capacity.
+	///
+	/// Only the argument types supported by Poco::format() can
+	/// be captured. Attempting to capture an argument of any
+	/// other type (including pointers other than C strings)
+	/// results in a compile-time error. Strings are copied
+	/// into the buffer.
+	///
+	/// The buffer contents are only meaningful to format(),
+	/// within the same process.
+	///
+	/// Usage example:
+	///     std::string args;
+	///     FormatArgs formatArgs(args);
+	///     formatArgs << 42 << std::string("foo");
+	///     ...
+	///     std::string result;
+	///     FormatArgs::format(result, "%d %s", args); // "42 foo"
+{
+public:
+	explicit FormatArgs(std::string& buffer);
+		/// Creates the FormatArgs. The given buffer is cleared
+		/// and receives the captured arguments.
+
+	~FormatArgs();
+		/// Destroys the FormatArgs.
+
+	FormatArgs& operator << (bool value);
+	FormatArgs& operator << (char value);
+	FormatArgs& operator << (short value);
+	FormatArgs& operator << (unsigned short value);
+	FormatArgs& operator << (int value);
+	FormatArgs& operator << (unsigned value);
+	FormatArgs& operator << (long value);
+	FormatArgs& operator << (unsigned long value);
+#if defined(POCO_HAVE_INT64) && !defined(POCO_LONG_IS_64_BIT)
+	FormatArgs& operator << (Int64 value);
+	FormatArgs& operator << (UInt64 value);
+#endif
+	FormatArgs& operator << (float value);
+	FormatArgs& operator << (double value);
+	FormatArgs& operator << (const char* value);
+	FormatArgs& operator << (const std::string& value);
+		/// Captures the given argument. C strings are captured
+		/// as std::string, as expected by Poco::format() for %s.
+
+	static void format(std::string& result, const std::string& fmt, const std::string& buffer);
+		/// Formats the arguments captured in buffer according to the
+		/// format string fmt, using Poco::format(), and appends the
+		/// result to result.
+		///
+		/// Throws a DataFormatException if the buffer does not contain
+		/// valid captured arguments.
+
+	enum Type
+	{
+		ARG_BOOL = 1,
+		ARG_CHAR,
+		ARG_SHORT,
+		ARG_USHORT,
+		ARG_INT,
+		ARG_UINT,
+		ARG_LONG,
+		ARG_ULONG,
+		ARG_INT64,
+		ARG_UINT64,
+		ARG_FLOAT,
+		ARG_DOUBLE,
+		ARG_STRING
+	};
+
+private:
+	FormatArgs();
+	FormatArgs(const FormatArgs&);
+	FormatArgs& operator = (const FormatArgs&);
+
+	FormatArgs& operator << (const void* value);
+		/// Not implemented. Prevents pointers from being
+		/// captured as bool.
+
+	template <typename T>
+	FormatArgs& append(Type type, T value)
+	{
+		char buffer[sizeof(T) + 1];
+		buffer[0] = static_cast<char>(type);
+		std::memcpy(buffer + 1, &value, sizeof(T));
+		_buffer.append(buffer, sizeof(buffer));
+		return *this;
+	}
+
+	FormatArgs& appendString(const char* value, std::size_t length);
+
+	std::string& _buffer;
+};
+
+
+//
+// inlines
+//
+inline FormatArgs& FormatArgs::operator << (bool value)
+{
+	return append(ARG_BOOL, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (char value)
+{
+	return append(ARG_CHAR, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (short value)
+{
+	return append(ARG_SHORT, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (unsigned short value)
+{
+	return append(ARG_USHORT, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (int value)
+{
+	return append(ARG_INT, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (unsigned value)
+{
+	return append(ARG_UINT, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (long value)
+{
+	return append(ARG_LONG, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (unsigned long value)
+{
+	return append(ARG_ULONG, value);
+}
+
+
+#if defined(POCO_HAVE_INT64) && !defined(POCO_LONG_IS_64_BIT)
+inline FormatArgs& FormatArgs::operator << (Int64 value)
+{
+	return append(ARG_INT64, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (UInt64 value)
+{
+	return append(ARG_UINT64, value);
+}
+#endif
+
+
+inline FormatArgs& FormatArgs::operator << (float value)
+{
+	return append(ARG_FLOAT, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (double value)
+{
+	return append(ARG_DOUBLE, value);
+}
+
+
+inline FormatArgs& FormatArgs::operator << (const char* value)
+{
+	return appendString(value, std::strlen(value));
+}
+
+
+inline FormatArgs& FormatArgs::operator << (const std::string& value)
+{
+	return appendString(value.data(), value.size());
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_FormatArgs_INCLUDED
@@ -0,0 +1,218 @@
+//
+// LockFreeNotificationQueue.h
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Notifications
+// Module:  LockFreeNotificationQueue
+//
+// Definition of the LockFreeNotificationQueue class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Foundation_LockFreeNotificationQueue_INCLUDED
+#define Foundation_LockFreeNotificationQueue_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/Notification.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include <cstddef>
+
+
+#if !defined(POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE) && !defined(POCO_NO_LOCKFREE_NOTIFICATIONQUEUE)
+	#if defined(POCO_HAVE_STD_ATOMICS) || __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+		#define POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE
+	#endif
+#endif
+#if defined(POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE)
+#include <atomic>
+#endif
+
+
+namespace Poco {
+
+
+class Foundation_API LockFreeNotificationQueue
+	/// A bounded multi-producer, multi-consumer notification queue
+	/// that can be used as a drop-in replacement for NotificationQueue
+	/// in situations where many threads enqueue and dequeue
+	/// notifications concurrently.
+	///
+	/// Notifications are stored in a preallocated ring buffer.
+	/// Enqueueing and dequeueing notifications does not acquire
+	/// a lock, and does not allocate memory. A mutex is only
+	/// used to put consumer threads to sleep if the queue is empty,
+	/// and to wake them up again. Producers only acquire this mutex
+	/// if there is at least one waiting consumer.
+	///
+	/// In contrast to NotificationQueue, the capacity of the queue
+	/// is fixed, and urgent (LIFO) notifications are not supported.
+	///
+	/// The lock-free implementation requires std::atomic (C++11).
+	/// If std::atomic is not available, or if POCO_NO_LOCKFREE_NOTIFICATIONQUEUE
+	/// is defined, a ring buffer protected by a mutex is used instead.
+	///
+	/// The recommended sequence to shut down and destroy the queue
+	/// is the same as for NotificationQueue:
+	///   1. set a termination flag for every worker thread
+	///   2. call the wakeUpAll() method
+	///   3. join each worker thread
+	///   4. destroy the notification queue.
+{
+public:
+	enum
+	{
+		DEFAULT_CAPACITY = 1024
+	};
+
+	explicit LockFreeNotificationQueue(std::size_t capacity = DEFAULT_CAPACITY);
+		/// Creates the LockFreeNotificationQueue, able to hold the
+		/// given number of notifications. The capacity is rounded up
+		/// to the next power of two.
+
+	~LockFreeNotificationQueue();
+		/// Destroys the LockFreeNotificationQueue, and releases
+		/// all notifications still in the queue.
+
+	void enqueueNotification(Notification::Ptr pNotification);
+		/// Enqueues the given notification by adding it to
+		/// the end of the queue (FIFO).
+		/// The queue takes ownership of the notification, thus
+		/// a call like
+		///     notificationQueue.enqueueNotification(new MyNotification);
+		/// does not result in a memory leak.
+		///
+		/// Throws a PoolOverflowException if the queue is full.
+
+	bool tryEnqueueNotification(Notification::Ptr pNotification);
+		/// Enqueues the given notification by adding it to
+		/// the end of the queue (FIFO).
+		///
+		/// Returns true if the notification has been enqueued,
+		/// or false if the queue is full.
+
+	Notification* dequeueNotification();
+		/// Dequeues the next pending notification.
+		/// Returns 0 (null) if no notification is available.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	Notification* waitDequeueNotification();
+		/// Dequeues the next pending notification.
+		/// If no notification is available, waits for a notification
+		/// to be enqueued.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		/// This method returns 0 (null) if wakeUpAll()
+		/// has been called by another thread.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	Notification* waitDequeueNotification(long milliseconds);
+		/// Dequeues the next pending notification.
+		/// If no notification is available, waits for a notification
+		/// to be enqueued up to the specified time.
+		/// Returns 0 (null) if no notification is available.
+		/// The caller gains ownership of the notification and
+		/// is expected to release it when done with it.
+		///
+		/// It is highly recommended that the result is immediately
+		/// assigned to a Notification::Ptr, to avoid potential
+		/// memory management issues.
+
+	void wakeUpAll();
+		/// Wakes up all threads that wait for a notification.
+
+	bool empty() const;
+		/// Returns true iff the queue is empty.
+
+	int size() const;
+		/// Returns the number of notifications in the queue.
+		///
+		/// If other threads are concurrently modifying the queue,
+		/// the result is only an approximation.
+
+	std::size_t capacity() const;
+		/// Returns the maximum number of notifications the
+		/// queue can hold.
+
+	void clear();
+		/// Removes all notifications from the queue.
+
+	bool hasIdleThreads() const;
+		/// Returns true if the queue has at least one thread waiting
+		/// for a notification.
+
+private:
+	LockFreeNotificationQueue(const LockFreeNotificationQueue&);
+	LockFreeNotificationQueue& operator = (const LockFreeNotificationQueue&);
+
+	Notification* dequeueOne();
+	Notification* waitDequeueOne(long milliseconds);
+	void wakeUpOne();
+
+	enum
+	{
+		CACHE_LINE_SIZE = 64
+	};
+
+#if defined(POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE)
+	struct Cell
+	{
+		std::atomic<std::size_t> sequence;
+		Notification*            pNf;
+	};
+
+	Cell*                    _pCells;
+	std::size_t              _mask;
+	char                     _pad1[CACHE_LINE_SIZE];
+	std::atomic<std::size_t> _enqueuePos;
+	char                     _pad2[CACHE_LINE_SIZE];
+	std::atomic<std::size_t> _dequeuePos;
+	char                     _pad3[CACHE_LINE_SIZE];
+	std::atomic<int>         _waiters;
+#else
+	struct Cell
+	{
+		Notification* pNf;
+	};
+
+	Cell*       _pCells;
+	std::size_t _mask;
+	std::size_t _enqueuePos;
+	std::size_t _dequeuePos;
+	int         _waiters;
+#endif
+	int               _generation;
+	mutable FastMutex _mutex;
+	Condition         _nfAvailable;
+};
+
+
+//
+// inlines
+//
+inline std::size_t LockFreeNotificationQueue::capacity() const
+{
+	return _mask + 1;
+}
+
+
+} // namespace Poco
+
+
+#endif // Foundation_LockFreeNotificationQueue_INCLUDED
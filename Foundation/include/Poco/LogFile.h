@@ -52,15 +52,41 @@ public:
 		/// Writes the given text to the log file.
 		/// If flush is true, the text will be immediately
 		/// flushed to the file.
+		///
+		/// Any text buffered with append() is written first.
+
+	void append(const std::string& text);
+		/// Appends the given text, followed by a line ending, to
+		/// the log file's internal buffer. The text is not written
+		/// to the file until commit() is called.
+
+	void commit(bool sync = false);
+		/// Writes all buffered text to the log file with a single
+		/// write operation and clears the buffer.
+		///
+		/// If sync is true, the file's data is also synchronized
+		/// with the storage device (fdatasync() on POSIX platforms),
+		/// even if the buffer was empty.
+
+	std::size_t buffered() const;
+		/// Returns the number of bytes in the buffer.
+
+	std::size_t bufferedMessages() const;
+		/// Returns the number of messages in the buffer.
 
 	UInt64 size() const;
-		/// Returns the current size in bytes of the log file.
+		/// Returns the current size in bytes of the log file,
+		/// including buffered text.
 	
 	Timestamp creationDate() const;
 		/// Returns the date and time the log file was created.
 	
 	const std::string& path() const;
 		/// Returns the path given in the constructor.
+
+private:
+	std::string _buffer;
+	std::size_t _bufferedMessages;
 };
 
 
@@ -69,13 +95,26 @@ public:
 //
 inline void LogFile::write(const std::string& text, bool flush)
 {
+	if (!_buffer.empty()) commit();
 	writeImpl(text, flush);
 }
 
 
+inline std::size_t LogFile::buffered() const
+{
+	return _buffer.size();
+}
+
+
+inline std::size_t LogFile::bufferedMessages() const
+{
+	return _bufferedMessages;
+}
+
+
 inline UInt64 LogFile::size() const
 {
-	return sizeImpl();
+	return sizeImpl() + _buffer.size();
 }
 
 
@@ -37,6 +37,8 @@ public:
 	LogFileImpl(const std::string& path);
 	~LogFileImpl();
 	void writeImpl(const std::string& text, bool flush);
+	void writeBinaryImpl(const char* data, std::size_t length);
+	void syncImpl();
 	UInt64 sizeImpl() const;
 	Timestamp creationDateImpl() const;
 	const std::string& pathImpl() const;
@@ -24,6 +24,7 @@
 #include "Poco/Channel.h"
 #include "Poco/Message.h"
 #include "Poco/Format.h"
+#include "Poco/FormatArgs.h"
 #include <map>
 #include <vector>
 #include <cstddef>
@@ -75,10 +76,14 @@ class Foundation_API Logger: public Channel
 	/// number into the log message so that it is available to formatters.
 	/// Variants of these macros that allow message formatting with Poco::format()
 	/// are also available. Up to four arguments are supported.
+	/// The poco_<level>_df<n> variants defer the formatting to the
+	/// point where the message text is actually needed (see logDeferred());
+	/// their format string must be a string literal.
 	///
 	/// Examples:
 	///     poco_warning(logger, "This is a warning");
 	///     poco_information_f2(logger, "An informational message with args: %d, %d", 1, 2);
+	///     poco_information_df2(logger, "An informational message with deferred args: %d, %s", 1, name);
 {
 public:
 	const std::string& name() const;
@@ -136,6 +141,93 @@ public:
 		/// the __FILE__ macro. The string is not copied
 		/// internally for performance reasons.	
 		
+	template <typename T1>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1)
+		/// If the Logger's log level is at least prio, creates a
+		/// Message with the given priority, source file path and line,
+		/// whose text is formatted from the format string fmt and the
+		/// given arguments with Poco::format() (see Message::setDeferredText()),
+		/// and sends it to the attached channel.
+		///
+		/// The arguments are captured by value with FormatArgs; the
+		/// actual formatting takes place only when the message text
+		/// is required, e.g. in the thread of an AsyncChannel.
+		/// Where thread-local storage is available, a per-thread
+		/// Message is reused, so that messages whose arguments fit
+		/// into POCO_LOG_BUFFER_SIZE bytes are logged without heap
+		/// allocations (in the calling thread) once the Message has
+		/// been set up.
+		///
+		/// File and fmt must be static strings, such as the value of
+		/// the __FILE__ macro and a string literal, respectively.
+		/// The strings are not copied internally for performance reasons.
+		/// File may be 0.
+		///
+		/// Variants taking up to six arguments are available.
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1;
+			_pChannel->log(msg.message());
+		}
+	}
+
+	template <typename T1, typename T2>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1, const T2& arg2)
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1 << arg2;
+			_pChannel->log(msg.message());
+		}
+	}
+
+	template <typename T1, typename T2, typename T3>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1, const T2& arg2, const T3& arg3)
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1 << arg2 << arg3;
+			_pChannel->log(msg.message());
+		}
+	}
+
+	template <typename T1, typename T2, typename T3, typename T4>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1, const T2& arg2, const T3& arg3, const T4& arg4)
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1 << arg2 << arg3 << arg4;
+			_pChannel->log(msg.message());
+		}
+	}
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1, const T2& arg2, const T3& arg3, const T4& arg4, const T5& arg5)
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1 << arg2 << arg3 << arg4 << arg5;
+			_pChannel->log(msg.message());
+		}
+	}
+
+	template <typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+	void logDeferred(Message::Priority prio, const char* file, int line, const char* fmt, const T1& arg1, const T2& arg2, const T3& arg3, const T4& arg4, const T5& arg5, const T6& arg6)
+	{
+		if (_level >= prio && _pChannel)
+		{
+			DeferredMessage msg(_name, prio, file, line, fmt);
+			msg.args() << arg1 << arg2 << arg3 << arg4 << arg5 << arg6;
+			_pChannel->log(msg.message());
+		}
+	}
+
 	void fatal(const std::string& msg);
 		/// If the Logger's log level is at least PRIO_FATAL,
 		/// creates a Message with priority PRIO_FATAL
@@ -535,6 +627,30 @@ protected:
 	void log(const std::string& text, Message::Priority prio);
 	void log(const std::string& text, Message::Priority prio, const char* file, int line);
 
+	class Foundation_API DeferredMessage
+		/// Provides the Message used by logDeferred().
+		///
+		/// If available, the calling thread's Message is used;
+		/// otherwise, e.g. if logDeferred() is called recursively
+		/// by a channel, a new Message is created.
+	{
+	public:
+		DeferredMessage(const std::string& source, Message::Priority prio, const char* file, int line, const char* fmt);
+		~DeferredMessage();
+
+		Message& message();
+		FormatArgs& args();
+
+	private:
+		DeferredMessage(const DeferredMessage&);
+		DeferredMessage& operator = (const DeferredMessage&);
+
+		static Message* acquire();
+
+		Message*   _pMsg;
+		FormatArgs _args;
+	};
+
 	static std::string format(const std::string& fmt, int argc, std::string argv[]);
 	static Logger& parent(const std::string& name);
 	static void add(Logger* pLogger);
@@ -572,6 +688,18 @@ private:
 #define poco_fatal_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).fatal()) (logger).fatal(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+#define poco_fatal_df1(logger, fmt, arg1) \
+	if ((logger).fatal()) (logger).logDeferred(Poco::Message::PRIO_FATAL, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_fatal_df2(logger, fmt, arg1, arg2) \
+	if ((logger).fatal()) (logger).logDeferred(Poco::Message::PRIO_FATAL, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_fatal_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).fatal()) (logger).logDeferred(Poco::Message::PRIO_FATAL, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_fatal_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).fatal()) (logger).logDeferred(Poco::Message::PRIO_FATAL, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 #define poco_critical(logger, msg) \
 	if ((logger).critical()) (logger).critical(msg, __FILE__, __LINE__); else (void) 0
 
@@ -587,6 +715,18 @@ private:
 #define poco_critical_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).critical()) (logger).critical(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+#define poco_critical_df1(logger, fmt, arg1) \
+	if ((logger).critical()) (logger).logDeferred(Poco::Message::PRIO_CRITICAL, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_critical_df2(logger, fmt, arg1, arg2) \
+	if ((logger).critical()) (logger).logDeferred(Poco::Message::PRIO_CRITICAL, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_critical_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).critical()) (logger).logDeferred(Poco::Message::PRIO_CRITICAL, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_critical_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).critical()) (logger).logDeferred(Poco::Message::PRIO_CRITICAL, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 #define poco_error(logger, msg) \
 	if ((logger).error()) (logger).error(msg, __FILE__, __LINE__); else (void) 0
 
@@ -602,6 +742,18 @@ private:
 #define poco_error_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).error()) (logger).error(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+#define poco_error_df1(logger, fmt, arg1) \
+	if ((logger).error()) (logger).logDeferred(Poco::Message::PRIO_ERROR, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_error_df2(logger, fmt, arg1, arg2) \
+	if ((logger).error()) (logger).logDeferred(Poco::Message::PRIO_ERROR, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_error_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).error()) (logger).logDeferred(Poco::Message::PRIO_ERROR, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_error_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).error()) (logger).logDeferred(Poco::Message::PRIO_ERROR, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 #define poco_warning(logger, msg) \
 	if ((logger).warning()) (logger).warning(msg, __FILE__, __LINE__); else (void) 0
 
@@ -616,6 +768,18 @@ private:
 
 #define poco_warning_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).warning()) (logger).warning(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
+
+#define poco_warning_df1(logger, fmt, arg1) \
+	if ((logger).warning()) (logger).logDeferred(Poco::Message::PRIO_WARNING, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_warning_df2(logger, fmt, arg1, arg2) \
+	if ((logger).warning()) (logger).logDeferred(Poco::Message::PRIO_WARNING, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_warning_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).warning()) (logger).logDeferred(Poco::Message::PRIO_WARNING, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_warning_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).warning()) (logger).logDeferred(Poco::Message::PRIO_WARNING, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
 	
 #define poco_notice(logger, msg) \
 	if ((logger).notice()) (logger).notice(msg, __FILE__, __LINE__); else (void) 0
@@ -632,6 +796,18 @@ private:
 #define poco_notice_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).notice()) (logger).notice(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+#define poco_notice_df1(logger, fmt, arg1) \
+	if ((logger).notice()) (logger).logDeferred(Poco::Message::PRIO_NOTICE, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_notice_df2(logger, fmt, arg1, arg2) \
+	if ((logger).notice()) (logger).logDeferred(Poco::Message::PRIO_NOTICE, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_notice_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).notice()) (logger).logDeferred(Poco::Message::PRIO_NOTICE, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_notice_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).notice()) (logger).logDeferred(Poco::Message::PRIO_NOTICE, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 #define poco_information(logger, msg) \
 	if ((logger).information()) (logger).information(msg, __FILE__, __LINE__); else (void) 0
 
@@ -647,6 +823,18 @@ private:
 #define poco_information_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 	if ((logger).information()) (logger).information(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+#define poco_information_df1(logger, fmt, arg1) \
+	if ((logger).information()) (logger).logDeferred(Poco::Message::PRIO_INFORMATION, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+#define poco_information_df2(logger, fmt, arg1, arg2) \
+	if ((logger).information()) (logger).logDeferred(Poco::Message::PRIO_INFORMATION, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+#define poco_information_df3(logger, fmt, arg1, arg2, arg3) \
+	if ((logger).information()) (logger).logDeferred(Poco::Message::PRIO_INFORMATION, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+#define poco_information_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+	if ((logger).information()) (logger).logDeferred(Poco::Message::PRIO_INFORMATION, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 #if defined(_DEBUG) || defined(POCO_LOG_DEBUG)
 	#define poco_debug(logger, msg) \
 		if ((logger).debug()) (logger).debug(msg, __FILE__, __LINE__); else (void) 0
@@ -663,6 +851,18 @@ private:
 	#define poco_debug_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 		if ((logger).debug()) (logger).debug(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
 
+	#define poco_debug_df1(logger, fmt, arg1) \
+		if ((logger).debug()) (logger).logDeferred(Poco::Message::PRIO_DEBUG, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+	#define poco_debug_df2(logger, fmt, arg1, arg2) \
+		if ((logger).debug()) (logger).logDeferred(Poco::Message::PRIO_DEBUG, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+	#define poco_debug_df3(logger, fmt, arg1, arg2, arg3) \
+		if ((logger).debug()) (logger).logDeferred(Poco::Message::PRIO_DEBUG, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+	#define poco_debug_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+		if ((logger).debug()) (logger).logDeferred(Poco::Message::PRIO_DEBUG, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
+
 	#define poco_trace(logger, msg) \
 		if ((logger).trace()) (logger).trace(msg, __FILE__, __LINE__); else (void) 0
 
@@ -677,17 +877,37 @@ private:
 
 	#define poco_trace_f4(logger, fmt, arg1, arg2, arg3, arg4) \
 		if ((logger).trace()) (logger).trace(Poco::format((fmt), (arg1), (arg2), (arg3), (arg4)), __FILE__, __LINE__); else (void) 0
+
+	#define poco_trace_df1(logger, fmt, arg1) \
+		if ((logger).trace()) (logger).logDeferred(Poco::Message::PRIO_TRACE, __FILE__, __LINE__, fmt, (arg1)); else (void) 0
+
+	#define poco_trace_df2(logger, fmt, arg1, arg2) \
+		if ((logger).trace()) (logger).logDeferred(Poco::Message::PRIO_TRACE, __FILE__, __LINE__, fmt, (arg1), (arg2)); else (void) 0
+
+	#define poco_trace_df3(logger, fmt, arg1, arg2, arg3) \
+		if ((logger).trace()) (logger).logDeferred(Poco::Message::PRIO_TRACE, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3)); else (void) 0
+
+	#define poco_trace_df4(logger, fmt, arg1, arg2, arg3, arg4) \
+		if ((logger).trace()) (logger).logDeferred(Poco::Message::PRIO_TRACE, __FILE__, __LINE__, fmt, (arg1), (arg2), (arg3), (arg4)); else (void) 0
 #else
 	#define poco_debug(logger, msg)
 	#define poco_debug_f1(logger, fmt, arg1)
 	#define poco_debug_f2(logger, fmt, arg1, arg2)
 	#define poco_debug_f3(logger, fmt, arg1, arg2, arg3)
 	#define poco_debug_f4(logger, fmt, arg1, arg2, arg3, arg4)
+	#define poco_debug_df1(logger, fmt, arg1)
+	#define poco_debug_df2(logger, fmt, arg1, arg2)
+	#define poco_debug_df3(logger, fmt, arg1, arg2, arg3)
+	#define poco_debug_df4(logger, fmt, arg1, arg2, arg3, arg4)
 	#define poco_trace(logger, msg)
 	#define poco_trace_f1(logger, fmt, arg1)
 	#define poco_trace_f2(logger, fmt, arg1, arg2)
 	#define poco_trace_f3(logger, fmt, arg1, arg2, arg3)
 	#define poco_trace_f4(logger, fmt, arg1, arg2, arg3, arg4)
+	#define poco_trace_df1(logger, fmt, arg1)
+	#define poco_trace_df2(logger, fmt, arg1, arg2)
+	#define poco_trace_df3(logger, fmt, arg1, arg2, arg3)
+	#define poco_trace_df4(logger, fmt, arg1, arg2, arg3, arg4)
 #endif
 
 
@@ -706,6 +926,18 @@ inline int Logger::getLevel() const
 }
 
 
+inline Message& Logger::DeferredMessage::message()
+{
+	return *_pMsg;
+}
+
+
+inline FormatArgs& Logger::DeferredMessage::args()
+{
+	return _args;
+}
+
+
 inline void Logger::log(const std::string& text, Message::Priority prio)
 {
 	if (_level >= prio && _pChannel)
@@ -43,6 +43,13 @@ class Foundation_API Message
 	/// A Message can also contain any number of named parameters
 	/// that contain additional information about the event that
 	/// caused the message.
+	///
+	/// The formatting of the message text can be deferred
+	/// (see setDeferredText()). The text is then formatted
+	/// when getText() is called for the first time, usually
+	/// by a Formatter or the final channel. A Message with
+	/// deferred text must not be shared between threads
+	/// without copying it.
 {
 public:
 	enum Priority
@@ -100,9 +107,28 @@ public:
 		
 	void setText(const std::string& text);
 		/// Sets the text of the message.
+
+	std::string& setDeferredText(const char* format);
+		/// Sets a format string for the deferred formatting of
+		/// the message text with Poco::format(), and returns a
+		/// reference to the (cleared) argument buffer, into which
+		/// the format arguments must be captured with a FormatArgs
+		/// object.
+		///
+		/// The format string must be a static string, such as a
+		/// string literal. The string is not copied internally
+		/// for performance reasons.
+
+	bool hasDeferredText() const;
+		/// Returns true if the message text has not been
+		/// formatted yet.
 		
 	const std::string& getText() const;
 		/// Returns the text of the message.
+		///
+		/// If the message text is deferred, it is formatted
+		/// first. Throws a DataFormatException if the captured
+		/// format arguments are invalid.
 		
 	void setPriority(Priority prio);
 		/// Sets the priority of the message.
@@ -128,6 +154,9 @@ public:
 	long getTid() const;
 		/// Returns the numeric thread identifier for the message.
 	
+	void setOsTid(IntPtr tid);
+		/// Sets the numeric OS thread identifier for the message.
+
 	IntPtr getOsTid() const;
 		/// Returns the numeric OS thread identifier for the message.
 	
@@ -189,13 +218,20 @@ public:
 		/// If the parameter does not exist, it is created with an
 		/// empty string value.
 
+	typedef std::map<std::string, std::string> StringMap;
+
+	const StringMap& getAll() const;
+		/// Returns a const reference to a map containing
+		/// all parameters of the message.
+
 protected:
 	void init();
-	typedef std::map<std::string, std::string> StringMap;
+	void formatText() const;
 
 private:	
 	std::string _source;
-	std::string _text;
+	mutable std::string _text;
+	mutable const char* _format;
 	Priority    _prio;
 	Timestamp   _time;
 	int         _tid;
@@ -217,8 +253,15 @@ inline const std::string& Message::getSource() const
 }
 
 
+inline bool Message::hasDeferredText() const
+{
+	return _format != 0;
+}
+
+
 inline const std::string& Message::getText() const
 {
+	if (_format) formatText();
 	return _text;
 }
 
@@ -23,6 +23,9 @@
 #include "Poco/Foundation.h"
 #include "Poco/Formatter.h"
 #include "Poco/Message.h"
+#include "Poco/DateTime.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Mutex.h"
 #include <vector>
 
 
@@ -77,6 +80,14 @@ class Foundation_API PatternFormatter: public Formatter
 	///   * %v[width] - the message source (%s) but text length is padded/cropped to 'width'
 	///   * %[name] - the value of the message parameter with the given name
 	///   * %% - percent sign
+	///
+	/// The pattern is compiled when it is set. Date/time fields are only
+	/// computed if the pattern contains any. A run of date/time fields with
+	/// a resolution of one second (e.g., "%Y-%m-%d %H:%M:%S") is rendered at
+	/// most once per second and then reused for all messages with a time
+	/// in the same second. The local time zone differential is determined
+	/// at most once per minute. Access to these caches is serialized, so
+	/// a PatternFormatter can still be shared by multiple threads.
 
 {
 public:
@@ -127,7 +138,7 @@ protected:
 private:
 	struct PatternAction
 	{
-		PatternAction(): key(0), length(0) 
+		PatternAction(): key(0), length(0), group(-1)
 		{
 		}
 
@@ -135,6 +146,22 @@ private:
 		int length;
 		std::string property;
 		std::string prepend;
+		int group;
+	};
+
+	struct DateTimeGroup
+		/// A run of consecutive date/time fields with a resolution
+		/// of one second, together with its cached rendering.
+	{
+		DateTimeGroup(): first(0), last(0), second(0), valid(false)
+		{
+		}
+
+		std::size_t first;
+		std::size_t last;
+		Timestamp::TimeVal second;
+		bool valid;
+		std::string text;
 	};
 
 	void parsePattern();
@@ -142,10 +169,47 @@ private:
 		/// which contains the message key, any text that needs to be written first
 		/// a property in case of %[] and required length.
 
+	void compilePattern();
+		/// Groups runs of date/time fields in _patternActions
+		/// and determines which time values format() needs.
+
+	void formatImpl(const Message& msg, std::string& text);
+		/// Formats the message. Must be called with the
+		/// cache mutex locked if the pattern uses date/time fields.
+
+	int updateDateTime(const Timestamp& timestamp);
+		/// Updates the cached DateTime to the second of the given
+		/// timestamp and returns the fractional part in microseconds.
+
+	int tzd(const Timestamp& timestamp);
+		/// Returns the local time zone differential, determined
+		/// at most once per minute.
+
+	const std::string& renderGroup(int group);
+		/// Returns the rendering of the given DateTimeGroup
+		/// for the currently cached DateTime.
+
+	static void appendDateTime(std::string& text, char key, const DateTime& dateTime);
+		/// Appends the date/time field with the given key.
+
+	static bool isDateTimeKey(char key);
+		/// Returns true if the key denotes a date/time field
+		/// with a resolution of one second.
+
 	void parsePriorityNames();
 
 	std::vector<PatternAction> _patternActions;
+	std::vector<DateTimeGroup> _groups;
 	bool _localTime;
+	bool _usesDateTime;
+	bool _usesTimezone;
+	DateTime _dateTime;
+	Timestamp::TimeVal _dateTimeSecond;
+	bool _dateTimeValid;
+	Timestamp::TimeVal _tzdMinute;
+	int _tzd;
+	bool _tzdValid;
+	FastMutex _cacheMutex;
 	std::string _pattern;
 	std::string _priorityNames;
 	std::string _priorities[9];
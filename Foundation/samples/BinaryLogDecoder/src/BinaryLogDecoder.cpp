@@ -0,0 +1,90 @@
+//
+// BinaryLogDecoder.cpp
+//
+// $Id$
+//
+// This sample decodes log files written by BinaryLogChannel and
+// writes the messages, formatted with a Formatter, to standard output.
+//
+// Usage: BinaryLogDecoder [-f <formatter>] [-p <pattern>] [-l] <file>...
+//
+//   -f <formatter>  The class name of the Formatter, as registered
+//                   with the LoggingFactory (default: PatternFormatter).
+//   -p <pattern>    The value of the Formatter's "pattern" property
+//                   (default: "%Y-%m-%d %H:%M:%S.%i [%p] %s: %t").
+//   -l              Format times as local times (sets the Formatter's
+//                   "times" property to "local").
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BinaryLogReader.h"
+#include "Poco/LoggingFactory.h"
+#include "Poco/Formatter.h"
+#include "Poco/FileStream.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+
+
+using Poco::BinaryLogReader;
+using Poco::LoggingFactory;
+using Poco::Formatter;
+using Poco::FileInputStream;
+using Poco::AutoPtr;
+
+
+int main(int argc, char** argv)
+{
+	std::string formatterClass = "PatternFormatter";
+	std::string pattern = "%Y-%m-%d %H:%M:%S.%i [%p] %s: %t";
+	bool localTime = false;
+	bool valid = true;
+	std::vector<std::string> files;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string arg(argv[i]);
+		if (arg == "-f" && i + 1 < argc)
+			formatterClass = argv[++i];
+		else if (arg == "-p" && i + 1 < argc)
+			pattern = argv[++i];
+		else if (arg == "-l")
+			localTime = true;
+		else if (!arg.empty() && arg[0] != '-')
+			files.push_back(arg);
+		else
+			valid = false;
+	}
+	if (!valid || files.empty())
+	{
+		std::cout << "usage: " << argv[0] << " [-f <formatter>] [-p <pattern>] [-l] <file>..." << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		AutoPtr<Formatter> pFormatter = LoggingFactory::defaultFactory().createFormatter(formatterClass);
+		pFormatter->setProperty("pattern", pattern);
+		if (localTime) pFormatter->setProperty("times", "local");
+
+		for (std::vector<std::string>::const_iterator it = files.begin(); it != files.end(); ++it)
+		{
+			FileInputStream istr(*it);
+			BinaryLogReader reader(istr);
+			reader.format(*pFormatter, std::cout);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	std::cout.flush();
+	return 0;
+}
@@ -0,0 +1,153 @@
+//
+// FileChannelBenchmark.cpp
+//
+// $Id$
+//
+// This sample compares the throughput of FileChannel writing
+// every message separately (with and without flushing) with
+// the throughput of FileChannel using group commit (with and
+// without periodic synchronization to the storage device),
+// with a growing number of logging threads.
+//
+// Every thread logs the same number of messages; the time
+// needed until all messages have been written to the log
+// file (i.e., until the channel has been closed) is measured.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/FileChannel.h"
+#include "Poco/Message.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/File.h"
+#include "Poco/NumberParser.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::FileChannel;
+using Poco::Message;
+using Poco::AutoPtr;
+using Poco::Runnable;
+using Poco::Thread;
+using Poco::Stopwatch;
+using Poco::TemporaryFile;
+
+
+class Producer: public Runnable
+{
+public:
+	Producer(FileChannel& channel, int count):
+		_channel(channel),
+		_count(count)
+	{
+	}
+
+	void run()
+	{
+		Message msg("FileChannelBenchmark", "2016-11-28 12:00:00.000 [Information] This is a typical log message of moderate length", Message::PRIO_INFORMATION);
+		for (int i = 0; i < _count; ++i)
+		{
+			_channel.log(msg);
+		}
+	}
+
+private:
+	FileChannel& _channel;
+	int          _count;
+};
+
+
+struct Mode
+{
+	const char* name;
+	const char* flush;
+	const char* groupCommit;
+	const char* syncInterval;
+};
+
+
+Poco::Clock::ClockDiff benchmark(const Mode& mode, int threads, int total)
+{
+	std::string path = TemporaryFile::tempName();
+	AutoPtr<FileChannel> pChannel = new FileChannel(path);
+	pChannel->setProperty(FileChannel::PROP_FLUSH, mode.flush);
+	pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, mode.groupCommit);
+	pChannel->setProperty(FileChannel::PROP_SYNCINTERVAL, mode.syncInterval);
+	pChannel->open();
+
+	int perProducer = total/threads;
+	std::vector<Thread*> producerThreads;
+	std::vector<Producer*> producers;
+	for (int i = 0; i < threads; ++i)
+	{
+		producers.push_back(new Producer(*pChannel, perProducer));
+		producerThreads.push_back(new Thread);
+	}
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < threads; ++i)
+	{
+		producerThreads[i]->start(*producers[i]);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		producerThreads[i]->join();
+	}
+	pChannel->close();
+	sw.stop();
+
+	for (int i = 0; i < threads; ++i)
+	{
+		delete producerThreads[i];
+		delete producers[i];
+	}
+	Poco::File(path).remove();
+	return sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	int total = 200000;
+	if (argc > 1) total = Poco::NumberParser::parse(argv[1]);
+
+	static const Mode modes[] =
+	{
+		{"per line, flush", "true",  "false", "none"},
+		{"per line",        "false", "false", "none"},
+		{"group commit",    "true",  "true",  "none"},
+		{"group, sync",     "true",  "true",  "100"}
+	};
+	const int modeCount = sizeof(modes)/sizeof(modes[0]);
+
+	std::cout << std::setw(10) << "threads";
+	for (int m = 0; m < modeCount; ++m)
+	{
+		std::cout << std::setw(20) << modes[m].name;
+	}
+	std::cout << "   [ns/message]" << std::endl;
+
+	for (int threads = 1; threads <= 8; threads *= 2)
+	{
+		std::cout << std::setw(10) << threads;
+		for (int m = 0; m < modeCount; ++m)
+		{
+			Poco::Clock::ClockDiff time = benchmark(modes[m], threads, total);
+			std::cout << std::setw(20) << std::fixed << std::setprecision(1) << 1000.0*time/total << std::flush;
+		}
+		std::cout << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+//
+// QueueBenchmark.cpp
+//
+// $Id$
+//
+// This sample compares the throughput of NotificationQueue and
+// LockFreeNotificationQueue with a growing number of producer
+// and consumer threads.
+//
+// Every producer enqueues the same number of notifications;
+// the consumers dequeue them until they receive a quit
+// notification. The time needed to pass all notifications
+// through the queue is measured.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/NotificationQueue.h"
+#include "Poco/LockFreeNotificationQueue.h"
+#include "Poco/Notification.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Notification;
+using Poco::NotificationQueue;
+using Poco::LockFreeNotificationQueue;
+using Poco::AutoPtr;
+using Poco::Runnable;
+using Poco::Thread;
+using Poco::AtomicCounter;
+using Poco::Stopwatch;
+
+
+class WorkNotification: public Notification
+{
+};
+
+
+class QuitNotification: public Notification
+{
+};
+
+
+void enqueue(NotificationQueue& queue, Notification::Ptr pNf)
+{
+	queue.enqueueNotification(pNf);
+}
+
+
+void enqueue(LockFreeNotificationQueue& queue, Notification::Ptr pNf)
+{
+	while (!queue.tryEnqueueNotification(pNf))
+	{
+		Thread::yield();
+	}
+}
+
+
+template <class Q>
+class Producer: public Runnable
+{
+public:
+	Producer(Q& queue, int count):
+		_queue(queue),
+		_count(count)
+	{
+	}
+
+	void run()
+	{
+		Notification::Ptr pNf = new WorkNotification;
+		for (int i = 0; i < _count; ++i)
+		{
+			enqueue(_queue, pNf);
+		}
+	}
+
+private:
+	Q&  _queue;
+	int _count;
+};
+
+
+template <class Q>
+class Consumer: public Runnable
+{
+public:
+	Consumer(Q& queue, AtomicCounter& counter):
+		_queue(queue),
+		_counter(counter)
+	{
+	}
+
+	void run()
+	{
+		for (;;)
+		{
+			AutoPtr<Notification> pNf(_queue.waitDequeueNotification());
+			if (!pNf || dynamic_cast<QuitNotification*>(pNf.get())) break;
+			++_counter;
+		}
+	}
+
+private:
+	Q&             _queue;
+	AtomicCounter& _counter;
+};
+
+
+template <class Q>
+Poco::Clock::ClockDiff benchmark(Q& queue, int threads, int total)
+{
+	typedef Producer<Q> P;
+	typedef Consumer<Q> C;
+
+	AtomicCounter counter;
+	int perProducer = total/threads;
+	std::vector<Thread*> producerThreads;
+	std::vector<Thread*> consumerThreads;
+	std::vector<P*> producers;
+	std::vector<C*> consumers;
+	for (int i = 0; i < threads; ++i)
+	{
+		producers.push_back(new P(queue, perProducer));
+		consumers.push_back(new C(queue, counter));
+		producerThreads.push_back(new Thread);
+		consumerThreads.push_back(new Thread);
+	}
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < threads; ++i)
+	{
+		consumerThreads[i]->start(*consumers[i]);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		producerThreads[i]->start(*producers[i]);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		producerThreads[i]->join();
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		enqueue(queue, new QuitNotification);
+	}
+	for (int i = 0; i < threads; ++i)
+	{
+		consumerThreads[i]->join();
+	}
+	sw.stop();
+
+	poco_assert (counter.value() == perProducer*threads);
+
+	for (int i = 0; i < threads; ++i)
+	{
+		delete producerThreads[i];
+		delete consumerThreads[i];
+		delete producers[i];
+		delete consumers[i];
+	}
+	return sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	int total = 1000000;
+	if (argc > 1) total = Poco::NumberParser::parse(argv[1]);
+
+	std::cout << std::setw(10) << "threads" << std::setw(24) << "NotificationQueue [ns]"
+	          << std::setw(32) << "LockFreeNotificationQueue [ns]" << std::endl;
+
+	for (int threads = 1; threads <= 64; threads *= 2)
+	{
+		NotificationQueue queue;
+		LockFreeNotificationQueue lockFreeQueue;
+
+		Poco::Clock::ClockDiff queueTime = benchmark(queue, threads, total);
+		Poco::Clock::ClockDiff lockFreeTime = benchmark(lockFreeQueue, threads, total);
+
+		std::cout << std::setw(10) << threads
+		          << std::setw(24) << std::fixed << std::setprecision(1) << 1000.0*queueTime/total
+		          << std::setw(32) << std::fixed << std::setprecision(1) << 1000.0*lockFreeTime/total << std::endl;
+	}
+
+	return 0;
+}
@@ -15,43 +15,51 @@
 
 
 #include "Poco/AsyncChannel.h"
-#include "Poco/Notification.h"
 #include "Poco/Message.h"
 #include "Poco/Formatter.h"
 #include "Poco/AutoPtr.h"
 #include "Poco/LoggingRegistry.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
 #include "Poco/Exception.h"
 
 
 namespace Poco {
 
 
-class MessageNotification: public Notification
+namespace
 {
-public:
-	MessageNotification(const Message& msg):
-		_msg(msg)
+	std::size_t roundUpToPowerOfTwo(std::size_t n)
 	{
+		std::size_t result = 2;
+		while (result < n) result <<= 1;
+		return result;
 	}
-	
-	~MessageNotification()
-	{
-	}
-	
-	const Message& message() const
-	{
-		return _msg;
-	}
-	
-private:
-	Message _msg;
-};
+}
 
 
 AsyncChannel::AsyncChannel(Channel* pChannel, Thread::Priority prio): 
 	_pChannel(pChannel), 
-	_thread("AsyncChannel")
+	_thread("AsyncChannel"),
+	_pMessages(0),
+	_mask(0),
+	_batchSize(DEFAULT_BATCH_SIZE),
+	_overflowPolicy(OVERFLOW_BLOCK),
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	_pSequences(0),
+	_enqueuePos(0),
+	_dequeuePos(0),
+#else
+	_enqueuePos(0),
+	_dequeuePos(0),
+#endif
+	_waitingProducers(0),
+	_waitingConsumer(false),
+	_stop(false),
+	_dropped(0)
 {
+	allocate(DEFAULT_QUEUE_SIZE);
 	if (_pChannel) _pChannel->duplicate();
 	_thread.setPriority(prio);
 }
@@ -68,6 +76,10 @@ AsyncChannel::~AsyncChannel()
 	{
 		poco_unexpected();
 	}
+	delete [] _pMessages;
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	delete [] _pSequences;
+#endif
 }
 
 
@@ -92,30 +104,129 @@ void AsyncChannel::open()
 	FastMutex::ScopedLock lock(_threadMutex);
 
 	if (!_thread.isRunning())
+	{
+		_stop = false;
 		_thread.start(*this);
+	}
 }
 
 
 void AsyncChannel::close()
 {
+	FastMutex::ScopedLock lock(_threadMutex);
+
 	if (_thread.isRunning())
 	{
-		while (!_queue.empty()) Thread::sleep(100);
-		
-		do 
 		{
-			_queue.wakeUpAll(); 
+			FastMutex::ScopedLock lock(_mutex);
+			_stop = true;
+			_messageAvailable.signal();
 		}
-		while (!_thread.tryJoin(100));
+		_thread.join();
 	}
 }
 
 
 void AsyncChannel::log(const Message& msg)
 {
-	open();
+	if (!_thread.isRunning()) open();
+
+	OverflowPolicy policy = getOverflowPolicy();
+	for (;;)
+	{
+		if (tryEnqueue(msg)) return;
+
+		if (policy == OVERFLOW_DROP_OLDEST && dropOldest())
+		{
+			continue;
+		}
+		else if (policy == OVERFLOW_BLOCK && Thread::current() != &_thread)
+		{
+			waitForSpace();
+		}
+		else
+		{
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+			_dropped.fetch_add(1, std::memory_order_relaxed);
+#else
+			FastMutex::ScopedLock lock(_mutex);
+			++_dropped;
+#endif
+			return;
+		}
+	}
+}
+
+
+void AsyncChannel::setQueueSize(std::size_t size)
+{
+	FastMutex::ScopedLock lock(_threadMutex);
+
+	if (_thread.isRunning()) throw IllegalStateException("Cannot change the queue size of an open AsyncChannel");
+	allocate(size);
+}
+
+
+std::size_t AsyncChannel::getQueueSize() const
+{
+	return _mask + 1;
+}
+
+
+void AsyncChannel::setBatchSize(std::size_t size)
+{
+	if (size == 0) throw InvalidArgumentException("batch size must be greater than zero");
+
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	_batchSize.store(size, std::memory_order_relaxed);
+#else
+	FastMutex::ScopedLock lock(_mutex);
+	_batchSize = size;
+#endif
+}
+
+
+std::size_t AsyncChannel::getBatchSize() const
+{
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	return _batchSize.load(std::memory_order_relaxed);
+#else
+	FastMutex::ScopedLock lock(_mutex);
+	return _batchSize;
+#endif
+}
+
+
+void AsyncChannel::setOverflowPolicy(OverflowPolicy policy)
+{
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	_overflowPolicy.store(policy, std::memory_order_relaxed);
+#else
+	FastMutex::ScopedLock lock(_mutex);
+	_overflowPolicy = policy;
+#endif
+}
+
+
+AsyncChannel::OverflowPolicy AsyncChannel::getOverflowPolicy() const
+{
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	return static_cast<OverflowPolicy>(_overflowPolicy.load(std::memory_order_relaxed));
+#else
+	FastMutex::ScopedLock lock(_mutex);
+	return _overflowPolicy;
+#endif
+}
 
-	_queue.enqueueNotification(new MessageNotification(msg));
+
+Poco::UInt64 AsyncChannel::droppedMessages() const
+{
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+	return _dropped.load(std::memory_order_relaxed);
+#else
+	FastMutex::ScopedLock lock(_mutex);
+	return _dropped;
+#endif
 }
 
 
@@ -125,26 +236,83 @@ void AsyncChannel::setProperty(const std::string& name, const std::string& value
 		setChannel(LoggingRegistry::defaultRegistry().channelForName(value));
 	else if (name == "priority")
 		setPriority(value);
+	else if (name == "queueSize")
+		setQueueSize(NumberParser::parseUnsigned(value));
+	else if (name == "batchSize")
+		setBatchSize(NumberParser::parseUnsigned(value));
+	else if (name == "overflow")
+	{
+		if (value == "block")
+			setOverflowPolicy(OVERFLOW_BLOCK);
+		else if (value == "dropNewest")
+			setOverflowPolicy(OVERFLOW_DROP_NEWEST);
+		else if (value == "dropOldest")
+			setOverflowPolicy(OVERFLOW_DROP_OLDEST);
+		else
+			throw InvalidArgumentException("overflow policy", value);
+	}
 	else
 		Channel::setProperty(name, value);
 }
 
 
+std::string AsyncChannel::getProperty(const std::string& name) const
+{
+	if (name == "queueSize")
+		return NumberFormatter::format(getQueueSize());
+	else if (name == "batchSize")
+		return NumberFormatter::format(getBatchSize());
+	else if (name == "overflow")
+	{
+		switch (getOverflowPolicy())
+		{
+		case OVERFLOW_DROP_NEWEST:
+			return "dropNewest";
+		case OVERFLOW_DROP_OLDEST:
+			return "dropOldest";
+		default:
+			return "block";
+		}
+	}
+	else
+		return Channel::getProperty(name);
+}
+
+
 void AsyncChannel::run()
 {
-	AutoPtr<Notification> nf = _queue.waitDequeueNotification();
-	while (nf)
+	for (;;)
 	{
-		MessageNotification* pNf = dynamic_cast<MessageNotification*>(nf.get());
+		std::size_t count = dequeueBatch();
+		if (count > 0)
 		{
-			FastMutex::ScopedLock lock(_channelMutex);
+			try
+			{
+				FastMutex::ScopedLock lock(_channelMutex);
 
-			if (pNf && _pChannel) _pChannel->log(pNf->message());
+				if (_pChannel) _pChannel->logBatch(&_batch[0], count);
+			}
+			catch (Exception& exc)
+			{
+				ErrorHandler::handle(exc);
+			}
+			catch (std::exception& exc)
+			{
+				ErrorHandler::handle(exc);
+			}
+			catch (...)
+			{
+				ErrorHandler::handle();
+			}
+		}
+		else if (_stop)
+		{
+			break;
 		}
-		nf = _queue.waitDequeueNotification();
+		else waitForMessages();
 	}
 }
-		
+
 		
 void AsyncChannel::setPriority(const std::string& value)
 {
@@ -167,4 +335,260 @@ void AsyncChannel::setPriority(const std::string& value)
 }
 
 
+#if defined(POCO_HAVE_LOCKFREE_ASYNCCHANNEL)
+
+
+//
+// The ring buffer uses the same sequence number scheme as
+// LockFreeNotificationQueue (after Dmitry Vyukov's bounded MPMC
+// queue). The logging thread claims a whole range of slots with a
+// single compare-and-swap; producers discarding the oldest message
+// compete with it for the slot at the dequeue position.
+//
+
+
+void AsyncChannel::allocate(std::size_t size)
+{
+	std::size_t capacity = roundUpToPowerOfTwo(size);
+	Message* pMessages = new Message[capacity];
+	std::atomic<std::size_t>* pSequences = new std::atomic<std::size_t>[capacity];
+	for (std::size_t i = 0; i < capacity; ++i)
+	{
+		pSequences[i].store(i, std::memory_order_relaxed);
+	}
+	delete [] _pMessages;
+	delete [] _pSequences;
+	_pMessages = pMessages;
+	_pSequences = pSequences;
+	_mask = capacity - 1;
+	_enqueuePos.store(0, std::memory_order_relaxed);
+	_dequeuePos.store(0, std::memory_order_relaxed);
+}
+
+
+bool AsyncChannel::tryEnqueue(const Message& msg)
+{
+	std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		std::size_t seq = _pSequences[pos & _mask].load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+		if (diff == 0)
+		{
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else pos = _enqueuePos.load(std::memory_order_relaxed);
+	}
+	try
+	{
+		_pMessages[pos & _mask] = msg;
+	}
+	catch (...)
+	{
+		// The slot has been claimed and must be published;
+		// the logging thread gets an empty message.
+		_pMessages[pos & _mask].setText(std::string());
+		_pSequences[pos & _mask].store(pos + 1, std::memory_order_release);
+		throw;
+	}
+	_pSequences[pos & _mask].store(pos + 1, std::memory_order_release);
+
+	// Pairs with the fence in waitForMessages(): either the logging
+	// thread sees the new message, or we see the waiting thread.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_waitingConsumer.load(std::memory_order_relaxed))
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		_messageAvailable.signal();
+	}
+	return true;
+}
+
+
+bool AsyncChannel::dropOldest()
+{
+	std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		std::size_t seq = _pSequences[pos & _mask].load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+		if (diff == 0)
+		{
+			if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else pos = _dequeuePos.load(std::memory_order_relaxed);
+	}
+	_pSequences[pos & _mask].store(pos + _mask + 1, std::memory_order_release);
+	_dropped.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+
+std::size_t AsyncChannel::dequeueBatch()
+{
+	std::size_t batchSize = getBatchSize();
+	if (_batch.size() != batchSize) _batch.resize(batchSize);
+
+	std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+	std::size_t count = 0;
+	for (;;)
+	{
+		count = 0;
+		while (count < batchSize && _pSequences[(pos + count) & _mask].load(std::memory_order_acquire) == pos + count + 1)
+		{
+			++count;
+		}
+		if (count == 0)
+		{
+			std::size_t current = _dequeuePos.load(std::memory_order_relaxed);
+			if (current == pos) return 0;
+			pos = current;
+		}
+		else if (_dequeuePos.compare_exchange_weak(pos, pos + count, std::memory_order_relaxed))
+		{
+			break;
+		}
+	}
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t index = (pos + i) & _mask;
+		_batch[i].swap(_pMessages[index]);
+		_pSequences[index].store(pos + i + _mask + 1, std::memory_order_release);
+	}
+
+	// Pairs with the fence in waitForSpace().
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_waitingProducers.load(std::memory_order_relaxed) > 0)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		_spaceAvailable.broadcast();
+	}
+	return count;
+}
+
+
+void AsyncChannel::waitForMessages()
+{
+	FastMutex::ScopedLock lock(_mutex);
+	_waitingConsumer.store(true, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+	if (!_stop && _pSequences[pos & _mask].load(std::memory_order_acquire) != pos + 1)
+	{
+		_messageAvailable.tryWait(_mutex, 1000);
+	}
+	_waitingConsumer.store(false, std::memory_order_relaxed);
+}
+
+
+void AsyncChannel::waitForSpace()
+{
+	FastMutex::ScopedLock lock(_mutex);
+	_waitingProducers.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	if (_pSequences[pos & _mask].load(std::memory_order_acquire) != pos)
+	{
+		_spaceAvailable.tryWait(_mutex, 1000);
+	}
+	_waitingProducers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+
+#else
+
+
+void AsyncChannel::allocate(std::size_t size)
+{
+	std::size_t capacity = roundUpToPowerOfTwo(size);
+	Message* pMessages = new Message[capacity];
+	delete [] _pMessages;
+	_pMessages = pMessages;
+	_mask = capacity - 1;
+	_enqueuePos = 0;
+	_dequeuePos = 0;
+}
+
+
+bool AsyncChannel::tryEnqueue(const Message& msg)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_enqueuePos - _dequeuePos > _mask) return false;
+	_pMessages[_enqueuePos & _mask] = msg;
+	++_enqueuePos;
+	if (_waitingConsumer) _messageAvailable.signal();
+	return true;
+}
+
+
+bool AsyncChannel::dropOldest()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_dequeuePos == _enqueuePos) return false;
+	++_dequeuePos;
+	++_dropped;
+	return true;
+}
+
+
+std::size_t AsyncChannel::dequeueBatch()
+{
+	std::size_t batchSize = getBatchSize();
+	if (_batch.size() != batchSize) _batch.resize(batchSize);
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	std::size_t count = _enqueuePos - _dequeuePos;
+	if (count > batchSize) count = batchSize;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		_batch[i].swap(_pMessages[_dequeuePos & _mask]);
+		++_dequeuePos;
+	}
+	if (count > 0 && _waitingProducers > 0) _spaceAvailable.broadcast();
+	return count;
+}
+
+
+void AsyncChannel::waitForMessages()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (!_stop && _dequeuePos == _enqueuePos)
+	{
+		_waitingConsumer = true;
+		_messageAvailable.tryWait(_mutex, 1000);
+		_waitingConsumer = false;
+	}
+}
+
+
+void AsyncChannel::waitForSpace()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_enqueuePos - _dequeuePos > _mask)
+	{
+		++_waitingProducers;
+		_spaceAvailable.tryWait(_mutex, 1000);
+		--_waitingProducers;
+	}
+}
+
+
+#endif // POCO_HAVE_LOCKFREE_ASYNCCHANNEL
+
+
 } // namespace Poco
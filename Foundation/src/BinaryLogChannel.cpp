@@ -0,0 +1,345 @@
+//
+// BinaryLogChannel.cpp
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogChannel
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/Message.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+namespace
+{
+	void append7BitEncoded(std::string& buffer, UInt64 value)
+	{
+		do
+		{
+			unsigned char c = (unsigned char) (value & 0x7F);
+			value >>= 7;
+			if (value) c |= 0x80;
+			buffer += (char) c;
+		}
+		while (value);
+	}
+
+
+	void appendSigned(std::string& buffer, Int64 value)
+	{
+		append7BitEncoded(buffer, (static_cast<UInt64>(value) << 1) ^ static_cast<UInt64>(value >> 63));
+	}
+
+
+	void appendString(std::string& buffer, const std::string& value)
+	{
+		append7BitEncoded(buffer, value.size());
+		buffer.append(value);
+	}
+
+
+	void beginRecord(std::string& record, BinaryLogChannel::RecordType type)
+	{
+		record.assign(4, '\0');
+		record += (char) type;
+	}
+
+
+	bool read7BitEncoded(const std::string& buffer, std::size_t& pos, UInt64& value)
+	{
+		value = 0;
+		int shift = 0;
+		unsigned char c;
+		do
+		{
+			if (pos >= buffer.size() || shift > 63) return false;
+			c = (unsigned char) buffer[pos++];
+			value |= static_cast<UInt64>(c & 0x7F) << shift;
+			shift += 7;
+		}
+		while (c & 0x80);
+		return true;
+	}
+}
+
+
+const char BinaryLogChannel::SIGNATURE[SIGNATURE_SIZE + 1] = "PocoBLog";
+const std::string BinaryLogChannel::PROP_PATH  = "path";
+const std::string BinaryLogChannel::PROP_FLUSH = "flush";
+
+
+BinaryLogChannel::BinaryLogChannel():
+	_flush(true),
+	_pStr(0),
+	_nextId(1)
+{
+}
+
+
+BinaryLogChannel::BinaryLogChannel(const std::string& rPath):
+	_path(rPath),
+	_flush(true),
+	_pStr(0),
+	_nextId(1)
+{
+}
+
+
+BinaryLogChannel::~BinaryLogChannel()
+{
+	try
+	{
+		close();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void BinaryLogChannel::open()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	openImpl();
+}
+
+
+void BinaryLogChannel::close()
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	delete _pStr;
+	_pStr = 0;
+}
+
+
+void BinaryLogChannel::log(const Message& msg)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	openImpl();
+	writeMessage(msg);
+	if (_flush) _pStr->flush();
+	if (!_pStr->good()) throw WriteFileException(_path);
+}
+
+
+void BinaryLogChannel::logBatch(const Message* pMessages, std::size_t count)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	openImpl();
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		writeMessage(pMessages[i]);
+	}
+	if (_flush) _pStr->flush();
+	if (!_pStr->good()) throw WriteFileException(_path);
+}
+
+
+void BinaryLogChannel::setProperty(const std::string& name, const std::string& value)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (name == PROP_PATH)
+		_path = value;
+	else if (name == PROP_FLUSH)
+		_flush = icompare(value, "true") == 0;
+	else
+		Channel::setProperty(name, value);
+}
+
+
+std::string BinaryLogChannel::getProperty(const std::string& name) const
+{
+	if (name == PROP_PATH)
+		return _path;
+	else if (name == PROP_FLUSH)
+		return std::string(_flush ? "true" : "false");
+	else
+		return Channel::getProperty(name);
+}
+
+
+void BinaryLogChannel::openImpl()
+{
+	if (!_pStr)
+	{
+		_stringIds.clear();
+		_fileIds.clear();
+		_nextId = 1;
+		recover();
+		FileOutputStream* pStr = new FileOutputStream(_path, std::ios::app);
+		if (pStr->tellp() == std::streampos(0))
+		{
+			pStr->write(SIGNATURE, SIGNATURE_SIZE);
+			pStr->put((char) FORMAT_VERSION);
+			pStr->flush();
+		}
+		if (!pStr->good())
+		{
+			delete pStr;
+			throw OpenFileException(_path);
+		}
+		_pStr = pStr;
+	}
+}
+
+
+void BinaryLogChannel::recover()
+{
+	File file(_path);
+	if (!file.exists()) return;
+
+	File::FileSize size = file.getSize();
+	File::FileSize valid = 0;
+	{
+		FileInputStream istr(_path);
+		char header[SIGNATURE_SIZE + 1];
+		istr.read(header, sizeof(header));
+		std::size_t n = static_cast<std::size_t>(istr.gcount());
+		char expected[SIGNATURE_SIZE + 1];
+		std::memcpy(expected, SIGNATURE, SIGNATURE_SIZE);
+		expected[SIGNATURE_SIZE] = (char) FORMAT_VERSION;
+		// an incomplete header is removed below, but only if it
+		// is the beginning of a valid header
+		if (std::memcmp(header, expected, n) != 0)
+			throw OpenFileException("Not a binary log file of the current format version", _path);
+		if (n == sizeof(header)) valid = sizeof(header);
+		std::string record;
+		while (valid > 0)
+		{
+			unsigned char lengthBytes[4];
+			istr.read(reinterpret_cast<char*>(lengthBytes), sizeof(lengthBytes));
+			if (istr.gcount() != sizeof(lengthBytes)) break;
+			UInt32 length = lengthBytes[0] | (lengthBytes[1] << 8) | (lengthBytes[2] << 16) | (static_cast<UInt32>(lengthBytes[3]) << 24);
+			if (length == 0 || length > size - valid - sizeof(lengthBytes)) break;
+			int type = istr.get();
+			if (type == RECORD_STRING)
+			{
+				record.resize(length - 1);
+				istr.read(&record[0], length - 1);
+				if (static_cast<UInt32>(istr.gcount()) != length - 1) break;
+				recoverString(record);
+			}
+			else istr.seekg(length - 1, std::ios::cur);
+			if (!istr.good()) break;
+			valid += sizeof(lengthBytes) + length;
+		}
+	}
+	// An incomplete record at the end of the file (or an incomplete
+	// header) is left over from a crash and is removed, so that new
+	// records can be read.
+	if (valid < size) file.setSize(valid);
+}
+
+
+void BinaryLogChannel::recoverString(const std::string& payload)
+{
+	std::size_t pos = 0;
+	UInt64 id;
+	UInt64 length;
+	if (read7BitEncoded(payload, pos, id) && id > 0 && id < 0xFFFFFFFFu && read7BitEncoded(payload, pos, length) && length <= payload.size() - pos)
+	{
+		_stringIds[payload.substr(pos, static_cast<std::size_t>(length))] = static_cast<UInt32>(id);
+		if (id >= _nextId) _nextId = static_cast<UInt32>(id) + 1;
+	}
+}
+
+
+void BinaryLogChannel::writeMessage(const Message& msg)
+{
+	// string records must precede the message record referring to them
+	UInt32 sourceId = stringId(msg.getSource());
+	UInt32 threadId = stringId(msg.getThread());
+	UInt32 sourceFileId = fileId(msg.getSourceFile());
+	const Message::StringMap& params = msg.getAll();
+	for (Message::StringMap::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		stringId(it->first);
+	}
+
+	beginRecord(_record, RECORD_MESSAGE);
+	appendSigned(_record, msg.getTime().epochMicroseconds());
+	_record += (char) msg.getPriority();
+	append7BitEncoded(_record, sourceId);
+	append7BitEncoded(_record, threadId);
+	appendSigned(_record, msg.getTid());
+	appendSigned(_record, msg.getOsTid());
+	appendSigned(_record, msg.getPid());
+	append7BitEncoded(_record, sourceFileId);
+	appendSigned(_record, msg.getSourceLine());
+	append7BitEncoded(_record, params.size());
+	for (Message::StringMap::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		append7BitEncoded(_record, _stringIds[it->first]);
+		appendString(_record, it->second);
+	}
+	appendString(_record, msg.getText());
+	writeRecord(_record);
+}
+
+
+UInt32 BinaryLogChannel::stringId(const std::string& str)
+{
+	StringIdMap::iterator it = _stringIds.find(str);
+	if (it != _stringIds.end()) return it->second;
+
+	UInt32 id = _nextId++;
+	beginRecord(_stringRecord, RECORD_STRING);
+	append7BitEncoded(_stringRecord, id);
+	appendString(_stringRecord, str);
+	writeRecord(_stringRecord);
+	_stringIds[str] = id;
+	return id;
+}
+
+
+UInt32 BinaryLogChannel::fileId(const char* file)
+{
+	if (!file) return 0;
+
+	// source file paths are static strings (see Message::setSourceFile()),
+	// so they can be looked up by address
+	FileIdMap::iterator it = _fileIds.find(file);
+	if (it != _fileIds.end()) return it->second;
+
+	UInt32 id = stringId(std::string(file));
+	_fileIds[file] = id;
+	return id;
+}
+
+
+void BinaryLogChannel::writeRecord(std::string& record)
+{
+	if (record.size() - 4 > MAX_RECORD_SIZE) throw InvalidArgumentException("Record too large for binary log file", _path);
+
+	UInt32 length = static_cast<UInt32>(record.size() - 4);
+	record[0] = (char) (length & 0xFF);
+	record[1] = (char) ((length >> 8) & 0xFF);
+	record[2] = (char) ((length >> 16) & 0xFF);
+	record[3] = (char) ((length >> 24) & 0xFF);
+	_pStr->write(record.data(), static_cast<std::streamsize>(record.size()));
+}
+
+
+} // namespace Poco
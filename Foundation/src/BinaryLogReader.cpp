@@ -0,0 +1,177 @@
+//
+// BinaryLogReader.cpp
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Logging
+// Module:  BinaryLogReader
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/BinaryLogReader.h"
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/Formatter.h"
+#include "Poco/Exception.h"
+#include <cstring>
+
+
+namespace Poco {
+
+
+BinaryLogReader::BinaryLogReader(std::istream& istr):
+	_istr(istr),
+	_version(0),
+	_pos(0)
+{
+	char header[BinaryLogChannel::SIGNATURE_SIZE + 1];
+	_istr.read(header, sizeof(header));
+	if (_istr.gcount() != sizeof(header) || std::memcmp(header, BinaryLogChannel::SIGNATURE, BinaryLogChannel::SIGNATURE_SIZE) != 0)
+		throw DataFormatException("Not a binary log file");
+	_version = (unsigned char) header[BinaryLogChannel::SIGNATURE_SIZE];
+	if (_version < 1 || _version > BinaryLogChannel::FORMAT_VERSION)
+		throw DataFormatException("Unsupported binary log file version");
+}
+
+
+BinaryLogReader::~BinaryLogReader()
+{
+}
+
+
+bool BinaryLogReader::read(Message& msg)
+{
+	while (readRecord())
+	{
+		if (readMessage(msg)) return true;
+	}
+	return false;
+}
+
+
+std::size_t BinaryLogReader::format(Formatter& formatter, std::ostream& ostr)
+{
+	std::size_t count = 0;
+	Message msg;
+	std::string text;
+	while (read(msg))
+	{
+		text.clear();
+		formatter.format(msg, text);
+		text += '\n';
+		ostr.write(text.data(), static_cast<std::streamsize>(text.size()));
+		++count;
+	}
+	return count;
+}
+
+
+bool BinaryLogReader::readRecord()
+{
+	unsigned char header[4];
+	_istr.read(reinterpret_cast<char*>(header), sizeof(header));
+	if (_istr.gcount() != sizeof(header)) return false;
+	UInt32 length = header[0] | (header[1] << 8) | (header[2] << 16) | (static_cast<UInt32>(header[3]) << 24);
+	if (length == 0 || length > BinaryLogChannel::MAX_RECORD_SIZE) throw DataFormatException("Invalid record length in binary log file");
+	_record.resize(length);
+	_istr.read(&_record[0], length);
+	if (static_cast<UInt32>(_istr.gcount()) != length) return false;
+	_pos = 0;
+	return true;
+}
+
+
+bool BinaryLogReader::readMessage(Message& msg)
+{
+	int type = (unsigned char) _record[_pos++];
+	switch (type)
+	{
+	case BinaryLogChannel::RECORD_STRING:
+		{
+			UInt64 id = read7BitEncoded();
+			if (id == 0 || id > 0xFFFFFFFFu) throw DataFormatException("Invalid string identifier in binary log file");
+			readString(_strings[static_cast<UInt32>(id)]);
+		}
+		return false;
+	case BinaryLogChannel::RECORD_MESSAGE:
+		{
+			Message m;
+			m.setTime(Timestamp(readSigned()));
+			if (_pos >= _record.size()) throw DataFormatException("Truncated record in binary log file");
+			int prio = (unsigned char) _record[_pos++];
+			if (prio < Message::PRIO_FATAL || prio > Message::PRIO_TRACE) throw DataFormatException("Invalid priority in binary log file");
+			m.setPriority(static_cast<Message::Priority>(prio));
+			m.setSource(lookup(read7BitEncoded()));
+			m.setThread(lookup(read7BitEncoded()));
+			m.setTid(static_cast<long>(readSigned()));
+			m.setOsTid(static_cast<IntPtr>(readSigned()));
+			m.setPid(static_cast<long>(readSigned()));
+			UInt64 fileId = read7BitEncoded();
+			m.setSourceFile(fileId ? _sourceFiles.insert(lookup(fileId)).first->c_str() : 0);
+			m.setSourceLine(static_cast<int>(readSigned()));
+			UInt64 paramCount = read7BitEncoded();
+			for (UInt64 i = 0; i < paramCount; ++i)
+			{
+				const std::string& name = lookup(read7BitEncoded());
+				readString(m[name]);
+			}
+			std::string text;
+			readString(text);
+			m.setText(text);
+			msg.swap(m);
+		}
+		return true;
+	default:
+		// skip records of unknown types
+		return false;
+	}
+}
+
+
+UInt64 BinaryLogReader::read7BitEncoded()
+{
+	UInt64 value = 0;
+	int shift = 0;
+	unsigned char c;
+	do
+	{
+		if (_pos >= _record.size() || shift > 63) throw DataFormatException("Truncated record in binary log file");
+		c = (unsigned char) _record[_pos++];
+		value |= static_cast<UInt64>(c & 0x7F) << shift;
+		shift += 7;
+	}
+	while (c & 0x80);
+	return value;
+}
+
+
+Int64 BinaryLogReader::readSigned()
+{
+	UInt64 value = read7BitEncoded();
+	return static_cast<Int64>(value >> 1) ^ -static_cast<Int64>(value & 1);
+}
+
+
+void BinaryLogReader::readString(std::string& value)
+{
+	UInt64 length = read7BitEncoded();
+	if (length > _record.size() - _pos) throw DataFormatException("Truncated record in binary log file");
+	value.assign(_record, _pos, static_cast<std::size_t>(length));
+	_pos += static_cast<std::size_t>(length);
+}
+
+
+const std::string& BinaryLogReader::lookup(UInt64 id) const
+{
+	StringMap::const_iterator it = id <= 0xFFFFFFFFu ? _strings.find(static_cast<UInt32>(id)) : _strings.end();
+	if (it == _strings.end()) throw DataFormatException("Undefined string identifier in binary log file");
+	return it->second;
+}
+
+
+} // namespace Poco
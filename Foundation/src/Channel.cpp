@@ -15,6 +15,9 @@
 
 
 #include "Poco/Channel.h"
+#include "Poco/Message.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
 
 
 namespace Poco {
@@ -40,6 +43,32 @@ void Channel::close()
 }
 
 
+void Channel::logBatch(const Message* pMessages, std::size_t count)
+{
+	SharedPtr<Exception> pException;
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		try
+		{
+			log(pMessages[i]);
+		}
+		catch (Exception& exc)
+		{
+			if (!pException) pException = exc.clone();
+		}
+		catch (std::exception& exc)
+		{
+			if (!pException) pException = new SystemException(exc.what());
+		}
+		catch (...)
+		{
+			if (!pException) pException = new UnhandledException("unknown exception");
+		}
+	}
+	if (pException) pException->rethrow();
+}
+
+
 void Channel::setProperty(const std::string& name, const std::string& value)
 {
 	throw PropertyNotSupportedException(name);
@@ -20,12 +20,14 @@
 #include "Poco/PurgeStrategy.h"
 #include "Poco/Message.h"
 #include "Poco/NumberParser.h"
+#include "Poco/NumberFormatter.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTime.h"
 #include "Poco/LocalDateTime.h"
 #include "Poco/String.h"
 #include "Poco/Exception.h"
 #include "Poco/Ascii.h"
+#include "Poco/Timer.h"
 
 
 namespace Poco {
@@ -40,6 +42,12 @@ const std::string FileChannel::PROP_PURGEAGE     = "purgeAge";
 const std::string FileChannel::PROP_PURGECOUNT   = "purgeCount";
 const std::string FileChannel::PROP_FLUSH        = "flush";
 const std::string FileChannel::PROP_ROTATEONOPEN = "rotateOnOpen";
+const std::string FileChannel::PROP_GROUPCOMMIT    = "groupCommit";
+const std::string FileChannel::PROP_COMMITMESSAGES = "commitMessages";
+const std::string FileChannel::PROP_COMMITBYTES    = "commitBytes";
+const std::string FileChannel::PROP_COMMITINTERVAL = "commitInterval";
+const std::string FileChannel::PROP_SYNCINTERVAL   = "syncInterval";
+
 
 FileChannel::FileChannel(): 
 	_times("utc"),
@@ -49,7 +57,14 @@ FileChannel::FileChannel():
 	_pFile(0),
 	_pRotateStrategy(0),
 	_pArchiveStrategy(new ArchiveByNumberStrategy),
-	_pPurgeStrategy(0)
+	_pPurgeStrategy(0),
+	_groupCommit(false),
+	_commitMessages(0),
+	_commitBytes(65536),
+	_commitInterval(100),
+	_syncInterval(-1),
+	_unsynced(false),
+	_pTimer(0)
 {
 }
 
@@ -63,7 +78,14 @@ FileChannel::FileChannel(const std::string& rPath):
 	_pFile(0),
 	_pRotateStrategy(0),
 	_pArchiveStrategy(new ArchiveByNumberStrategy),
-	_pPurgeStrategy(0)
+	_pPurgeStrategy(0),
+	_groupCommit(false),
+	_commitMessages(0),
+	_commitBytes(65536),
+	_commitInterval(100),
+	_syncInterval(-1),
+	_unsynced(false),
+	_pTimer(0)
 {
 }
 
@@ -109,9 +131,22 @@ void FileChannel::open()
 
 void FileChannel::close()
 {
+	stopCommitTimer();
+
 	FastMutex::ScopedLock lock(_mutex);
 
-	delete _pFile;
+	if (_pFile && _unsynced)
+	{
+		try
+		{
+			_pFile->commit(true);
+		}
+		catch (...)
+		{
+		}
+		_unsynced = false;
+	}
+	delete _pFile; // writes any buffered messages
 	_pFile = 0;
 }
 
@@ -122,8 +157,32 @@ void FileChannel::log(const Message& msg)
 
 	FastMutex::ScopedLock lock(_mutex);
 
+	logImpl(msg);
+}
+
+
+void FileChannel::logBatch(const Message* pMessages, std::size_t count)
+{
+	open();
+
+	FastMutex::ScopedLock lock(_mutex);
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		logImpl(pMessages[i]);
+	}
+}
+
+
+void FileChannel::logImpl(const Message& msg)
+{
 	if (_pRotateStrategy && _pArchiveStrategy && _pRotateStrategy->mustRotate(_pFile))
 	{
+		if (_pFile->buffered() > 0 || _unsynced)
+		{
+			_pFile->commit(_syncInterval >= 0);
+			_unsynced = false;
+		}
 		try
 		{
 			_pFile = _pArchiveStrategy->archive(_pFile);
@@ -138,12 +197,76 @@ void FileChannel::log(const Message& msg)
 		// to the new file.
 		_pRotateStrategy->mustRotate(_pFile);
 	}
-	_pFile->write(msg.getText(), _flush);
+	if (_groupCommit)
+	{
+		if (!_pTimer && _commitInterval > 0)
+		{
+			_pTimer = new Timer(_commitInterval, _commitInterval);
+			_pTimer->start(TimerCallback<FileChannel>(*this, &FileChannel::onCommitTimer));
+		}
+		_pFile->append(msg.getText());
+		if ((_commitMessages > 0 && _pFile->bufferedMessages() >= _commitMessages) || (_commitBytes > 0 && _pFile->buffered() >= _commitBytes))
+		{
+			commit();
+		}
+	}
+	else _pFile->write(msg.getText(), _flush);
+}
+
+
+void FileChannel::commit()
+{
+	if (_pFile->buffered() > 0)
+	{
+		_pFile->commit();
+		_unsynced = _syncInterval >= 0;
+	}
+	if (_unsynced && _lastSync.isElapsed(static_cast<Timestamp::TimeDiff>(_syncInterval)*1000))
+	{
+		_pFile->commit(true);
+		_lastSync.update();
+		_unsynced = false;
+	}
+}
+
+
+void FileChannel::onCommitTimer(Timer&)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	if (_pFile && _groupCommit) commit();
+}
+
+
+void FileChannel::stopCommitTimer()
+{
+	Timer* pTimer = 0;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		pTimer = _pTimer;
+		_pTimer = 0;
+	}
+	if (pTimer)
+	{
+		// must not hold the mutex here, as the timer
+		// callback may be waiting for it
+		pTimer->stop();
+		delete pTimer;
+	}
 }
 
 	
 void FileChannel::setProperty(const std::string& name, const std::string& value)
 {
+	if (name == PROP_GROUPCOMMIT)
+	{
+		// setGroupCommit() locks the mutex itself, as it
+		// may have to stop the commit timer
+		setGroupCommit(value);
+		return;
+	}
+
 	FastMutex::ScopedLock lock(_mutex);
 
 	if (name == PROP_TIMES)
@@ -172,6 +295,14 @@ void FileChannel::setProperty(const std::string& name, const std::string& value)
 		setFlush(value);
 	else if (name == PROP_ROTATEONOPEN)
 		setRotateOnOpen(value);
+	else if (name == PROP_COMMITMESSAGES)
+		setCommitMessages(value);
+	else if (name == PROP_COMMITBYTES)
+		setCommitBytes(value);
+	else if (name == PROP_COMMITINTERVAL)
+		setCommitInterval(value);
+	else if (name == PROP_SYNCINTERVAL)
+		setSyncInterval(value);
 	else
 		Channel::setProperty(name, value);
 }
@@ -197,6 +328,16 @@ std::string FileChannel::getProperty(const std::string& name) const
 		return std::string(_flush ? "true" : "false");
 	else if (name == PROP_ROTATEONOPEN)
 		return std::string(_rotateOnOpen ? "true" : "false");
+	else if (name == PROP_GROUPCOMMIT)
+		return std::string(_groupCommit ? "true" : "false");
+	else if (name == PROP_COMMITMESSAGES)
+		return NumberFormatter::format(_commitMessages);
+	else if (name == PROP_COMMITBYTES)
+		return NumberFormatter::format(_commitBytes);
+	else if (name == PROP_COMMITINTERVAL)
+		return NumberFormatter::format(_commitInterval);
+	else if (name == PROP_SYNCINTERVAL)
+		return _syncInterval < 0 ? std::string("none") : NumberFormatter::format(_syncInterval);
 	else
 		return Channel::getProperty(name);
 }
@@ -345,6 +486,54 @@ void FileChannel::setRotateOnOpen(const std::string& rotateOnOpen)
 }
 
 
+void FileChannel::setGroupCommit(const std::string& groupCommit)
+{
+	bool enable = icompare(groupCommit, "true") == 0;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+
+		_groupCommit = enable;
+		if (!_groupCommit && _pFile) commit();
+	}
+	if (!enable) stopCommitTimer();
+}
+
+
+void FileChannel::setCommitMessages(const std::string& messages)
+{
+	_commitMessages = NumberParser::parseUnsigned(messages);
+}
+
+
+void FileChannel::setCommitBytes(const std::string& bytes)
+{
+	_commitBytes = NumberParser::parseUnsigned(bytes);
+}
+
+
+void FileChannel::setCommitInterval(const std::string& interval)
+{
+	int n = NumberParser::parse(interval);
+	if (n < 0) throw InvalidArgumentException("commitInterval", interval);
+	_commitInterval = n;
+}
+
+
+void FileChannel::setSyncInterval(const std::string& interval)
+{
+	if (interval.empty() || icompare(interval, "none") == 0)
+	{
+		_syncInterval = -1;
+	}
+	else
+	{
+		int n = NumberParser::parse(interval);
+		if (n < 0) throw InvalidArgumentException("syncInterval", interval);
+		_syncInterval = n;
+	}
+}
+
+
 void FileChannel::purge()
 {
 	if (_pPurgeStrategy)
@@ -0,0 +1,126 @@
+//
+// FormatArgs.cpp
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Core
+// Module:  FormatArgs
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/FormatArgs.h"
+#include "Poco/Format.h"
+#include "Poco/Exception.h"
+#include <vector>
+
+
+namespace Poco {
+
+
+namespace
+{
+	template <typename T>
+	void extract(const std::string& buffer, std::size_t& pos, std::vector<Any>& values)
+	{
+		T value;
+		if (buffer.size() - pos < sizeof(T)) throw DataFormatException("Truncated format arguments");
+		std::memcpy(&value, buffer.data() + pos, sizeof(T));
+		pos += sizeof(T);
+		values.push_back(value);
+	}
+}
+
+
+FormatArgs::FormatArgs(std::string& buffer):
+	_buffer(buffer)
+{
+	_buffer.clear();
+}
+
+
+FormatArgs::~FormatArgs()
+{
+}
+
+
+FormatArgs& FormatArgs::appendString(const char* value, std::size_t length)
+{
+	append(ARG_STRING, length);
+	_buffer.append(value, length);
+	return *this;
+}
+
+
+void FormatArgs::format(std::string& result, const std::string& fmt, const std::string& buffer)
+{
+	std::vector<Any> values;
+	std::size_t pos = 0;
+	while (pos < buffer.size())
+	{
+		int type = static_cast<unsigned char>(buffer[pos++]);
+		switch (type)
+		{
+		case ARG_BOOL:
+			extract<bool>(buffer, pos, values);
+			break;
+		case ARG_CHAR:
+			extract<char>(buffer, pos, values);
+			break;
+		case ARG_SHORT:
+			extract<short>(buffer, pos, values);
+			break;
+		case ARG_USHORT:
+			extract<unsigned short>(buffer, pos, values);
+			break;
+		case ARG_INT:
+			extract<int>(buffer, pos, values);
+			break;
+		case ARG_UINT:
+			extract<unsigned>(buffer, pos, values);
+			break;
+		case ARG_LONG:
+			extract<long>(buffer, pos, values);
+			break;
+		case ARG_ULONG:
+			extract<unsigned long>(buffer, pos, values);
+			break;
+#if defined(POCO_HAVE_INT64) && !defined(POCO_LONG_IS_64_BIT)
+		case ARG_INT64:
+			extract<Int64>(buffer, pos, values);
+			break;
+		case ARG_UINT64:
+			extract<UInt64>(buffer, pos, values);
+			break;
+#endif
+		case ARG_FLOAT:
+			extract<float>(buffer, pos, values);
+			break;
+		case ARG_DOUBLE:
+			extract<double>(buffer, pos, values);
+			break;
+		case ARG_STRING:
+			{
+				std::size_t length;
+				if (buffer.size() - pos < sizeof(length)) throw DataFormatException("Truncated format arguments");
+				std::memcpy(&length, buffer.data() + pos, sizeof(length));
+				pos += sizeof(length);
+				if (buffer.size() - pos < length) throw DataFormatException("Truncated format arguments");
+				values.push_back(std::string(buffer, pos, length));
+				pos += length;
+			}
+			break;
+		default:
+			throw DataFormatException("Invalid format argument type");
+		}
+	}
+	Poco::format(result, fmt, values);
+}
+
+
+} // namespace Poco
@@ -0,0 +1,352 @@
+//
+// LockFreeNotificationQueue.cpp
+//
+// $Id$
+//
+// Library: Foundation
+// Package: Notifications
+// Module:  LockFreeNotificationQueue
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/LockFreeNotificationQueue.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+
+
+namespace
+{
+	std::size_t roundUpToPowerOfTwo(std::size_t n)
+	{
+		std::size_t result = 2;
+		while (result < n) result <<= 1;
+		return result;
+	}
+}
+
+
+#if defined(POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE)
+
+
+//
+// The ring buffer follows the bounded MPMC queue design by Dmitry Vyukov.
+// Every cell carries a sequence number that tells producers and consumers
+// whether the cell is ready to be written or read for their current position.
+//
+
+
+LockFreeNotificationQueue::LockFreeNotificationQueue(std::size_t capacity):
+	_pCells(0),
+	_mask(roundUpToPowerOfTwo(capacity) - 1),
+	_enqueuePos(0),
+	_dequeuePos(0),
+	_waiters(0),
+	_generation(0)
+{
+	_pCells = new Cell[_mask + 1];
+	for (std::size_t i = 0; i <= _mask; i++)
+	{
+		_pCells[i].sequence.store(i, std::memory_order_relaxed);
+		_pCells[i].pNf = 0;
+	}
+}
+
+
+bool LockFreeNotificationQueue::tryEnqueueNotification(Notification::Ptr pNotification)
+{
+	poco_check_ptr (pNotification);
+
+	Cell* pCell;
+	std::size_t pos = _enqueuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		pCell = &_pCells[pos & _mask];
+		std::size_t seq = pCell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+		if (diff == 0)
+		{
+			if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else pos = _enqueuePos.load(std::memory_order_relaxed);
+	}
+	pCell->pNf = pNotification.duplicate();
+	pCell->sequence.store(pos + 1, std::memory_order_release);
+
+	wakeUpOne();
+	return true;
+}
+
+
+Notification* LockFreeNotificationQueue::dequeueOne()
+{
+	Cell* pCell;
+	std::size_t pos = _dequeuePos.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		pCell = &_pCells[pos & _mask];
+		std::size_t seq = pCell->sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+		if (diff == 0)
+		{
+			if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		}
+		else if (diff < 0)
+		{
+			return 0;
+		}
+		else pos = _dequeuePos.load(std::memory_order_relaxed);
+	}
+	Notification* pNf = pCell->pNf;
+	pCell->pNf = 0;
+	pCell->sequence.store(pos + _mask + 1, std::memory_order_release);
+	return pNf;
+}
+
+
+void LockFreeNotificationQueue::wakeUpOne()
+{
+	// Pairs with the fence in waitDequeueOne(): either the waiting
+	// consumer sees the new notification, or we see the consumer.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (_waiters.load(std::memory_order_relaxed) > 0)
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		_nfAvailable.signal();
+	}
+}
+
+
+Notification* LockFreeNotificationQueue::waitDequeueOne(long milliseconds)
+{
+	Notification* pNf = dequeueOne();
+	if (pNf) return pNf;
+
+	Timestamp start;
+	FastMutex::ScopedLock lock(_mutex);
+	int generation = _generation;
+	_waiters.fetch_add(1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	try
+	{
+		for (;;)
+		{
+			pNf = dequeueOne();
+			if (pNf || generation != _generation) break;
+			if (milliseconds < 0)
+			{
+				_nfAvailable.wait(_mutex);
+			}
+			else
+			{
+				long remaining = milliseconds - static_cast<long>(start.elapsed()/1000);
+				if (remaining <= 0) break;
+				_nfAvailable.tryWait(_mutex, remaining);
+			}
+		}
+	}
+	catch (...)
+	{
+		_waiters.fetch_sub(1, std::memory_order_relaxed);
+		throw;
+	}
+	_waiters.fetch_sub(1, std::memory_order_relaxed);
+	return pNf;
+}
+
+
+int LockFreeNotificationQueue::size() const
+{
+	std::size_t dequeuePos = _dequeuePos.load(std::memory_order_relaxed);
+	std::size_t enqueuePos = _enqueuePos.load(std::memory_order_relaxed);
+	std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(enqueuePos - dequeuePos);
+	return diff > 0 ? static_cast<int>(diff) : 0;
+}
+
+
+bool LockFreeNotificationQueue::hasIdleThreads() const
+{
+	return _waiters.load(std::memory_order_relaxed) > 0;
+}
+
+
+#else
+
+
+LockFreeNotificationQueue::LockFreeNotificationQueue(std::size_t capacity):
+	_pCells(0),
+	_mask(roundUpToPowerOfTwo(capacity) - 1),
+	_enqueuePos(0),
+	_dequeuePos(0),
+	_waiters(0),
+	_generation(0)
+{
+	_pCells = new Cell[_mask + 1];
+	for (std::size_t i = 0; i <= _mask; i++)
+	{
+		_pCells[i].pNf = 0;
+	}
+}
+
+
+bool LockFreeNotificationQueue::tryEnqueueNotification(Notification::Ptr pNotification)
+{
+	poco_check_ptr (pNotification);
+
+	FastMutex::ScopedLock lock(_mutex);
+	if (_enqueuePos - _dequeuePos > _mask) return false;
+	_pCells[_enqueuePos & _mask].pNf = pNotification.duplicate();
+	++_enqueuePos;
+	if (_waiters > 0) _nfAvailable.signal();
+	return true;
+}
+
+
+Notification* LockFreeNotificationQueue::dequeueOne()
+{
+	if (_enqueuePos == _dequeuePos) return 0;
+	Cell& cell = _pCells[_dequeuePos & _mask];
+	Notification* pNf = cell.pNf;
+	cell.pNf = 0;
+	++_dequeuePos;
+	return pNf;
+}
+
+
+void LockFreeNotificationQueue::wakeUpOne()
+{
+}
+
+
+Notification* LockFreeNotificationQueue::waitDequeueOne(long milliseconds)
+{
+	Timestamp start;
+	FastMutex::ScopedLock lock(_mutex);
+	int generation = _generation;
+	Notification* pNf = 0;
+	++_waiters;
+	try
+	{
+		for (;;)
+		{
+			pNf = dequeueOne();
+			if (pNf || generation != _generation) break;
+			if (milliseconds < 0)
+			{
+				_nfAvailable.wait(_mutex);
+			}
+			else
+			{
+				long remaining = milliseconds - static_cast<long>(start.elapsed()/1000);
+				if (remaining <= 0) break;
+				_nfAvailable.tryWait(_mutex, remaining);
+			}
+		}
+	}
+	catch (...)
+	{
+		--_waiters;
+		throw;
+	}
+	--_waiters;
+	return pNf;
+}
+
+
+int LockFreeNotificationQueue::size() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return static_cast<int>(_enqueuePos - _dequeuePos);
+}
+
+
+bool LockFreeNotificationQueue::hasIdleThreads() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _waiters > 0;
+}
+
+
+#endif // POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE
+
+
+LockFreeNotificationQueue::~LockFreeNotificationQueue()
+{
+	try
+	{
+		clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+	delete [] _pCells;
+}
+
+
+void LockFreeNotificationQueue::enqueueNotification(Notification::Ptr pNotification)
+{
+	if (!tryEnqueueNotification(pNotification))
+		throw PoolOverflowException("Notification queue is full");
+}
+
+
+Notification* LockFreeNotificationQueue::dequeueNotification()
+{
+#if !defined(POCO_HAVE_LOCKFREE_NOTIFICATIONQUEUE)
+	FastMutex::ScopedLock lock(_mutex);
+#endif
+	return dequeueOne();
+}
+
+
+Notification* LockFreeNotificationQueue::waitDequeueNotification()
+{
+	return waitDequeueOne(-1);
+}
+
+
+Notification* LockFreeNotificationQueue::waitDequeueNotification(long milliseconds)
+{
+	return waitDequeueOne(milliseconds < 0 ? 0 : milliseconds);
+}
+
+
+void LockFreeNotificationQueue::wakeUpAll()
+{
+	FastMutex::ScopedLock lock(_mutex);
+	++_generation;
+	_nfAvailable.broadcast();
+}
+
+
+bool LockFreeNotificationQueue::empty() const
+{
+	return size() == 0;
+}
+
+
+void LockFreeNotificationQueue::clear()
+{
+	Notification* pNf;
+	while ((pNf = dequeueNotification()))
+	{
+		pNf->release();
+	}
+}
+
+
+} // namespace Poco
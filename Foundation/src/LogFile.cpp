@@ -31,13 +31,62 @@
 namespace Poco {
 
 
-LogFile::LogFile(const std::string& rPath): LogFileImpl(rPath)
+namespace
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	const char LINE_ENDING[] = "\r\n";
+#else
+	const char LINE_ENDING[] = "\n";
+#endif
+}
+
+
+LogFile::LogFile(const std::string& rPath):
+	LogFileImpl(rPath),
+	_bufferedMessages(0)
 {
 }
 
 
 LogFile::~LogFile()
 {
+	try
+	{
+		commit();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void LogFile::append(const std::string& text)
+{
+	_buffer.append(text);
+	_buffer.append(LINE_ENDING, sizeof(LINE_ENDING) - 1);
+	++_bufferedMessages;
+}
+
+
+void LogFile::commit(bool sync)
+{
+	if (!_buffer.empty())
+	{
+		try
+		{
+			writeBinaryImpl(_buffer.data(), _buffer.size());
+		}
+		catch (...)
+		{
+			_buffer.clear();
+			_bufferedMessages = 0;
+			throw;
+		}
+		_buffer.clear();
+		_bufferedMessages = 0;
+	}
+	if (sync) syncImpl();
 }
 
 
@@ -17,6 +17,8 @@
 #include "Poco/LogFile_STD.h"
 #include "Poco/File.h"
 #include "Poco/Exception.h"
+#include <unistd.h>
+#include <errno.h>
 
 
 namespace Poco {
@@ -57,6 +59,45 @@ void LogFileImpl::writeImpl(const std::string& text, bool flush)
 }
 
 
+void LogFileImpl::writeBinaryImpl(const char* data, std::size_t length)
+{
+	if (!_str.good())
+	{
+		_str.close();
+		_str.open(_path, std::ios::app);
+	}
+	if (!_str.good()) throw WriteFileException(_path);
+	_str.flush();
+	// bypass the stream buffer so that the data is
+	// written with as few system calls as possible
+	int fd = _str.nativeHandle();
+	while (length > 0)
+	{
+		ssize_t n = ::write(fd, data, length);
+		if (n < 0)
+		{
+			if (errno == EINTR) continue;
+			throw WriteFileException(_path);
+		}
+		data += n;
+		length -= static_cast<std::size_t>(n);
+	}
+	_size = (UInt64) _str.tellp();
+}
+
+
+void LogFileImpl::syncImpl()
+{
+	_str.flush();
+#if POCO_OS == POCO_OS_LINUX || POCO_OS == POCO_OS_SOLARIS
+	int rc = ::fdatasync(_str.nativeHandle());
+#else
+	int rc = ::fsync(_str.nativeHandle());
+#endif
+	if (rc != 0) throw WriteFileException(_path);
+}
+
+
 UInt64 LogFileImpl::sizeImpl() const
 {
 	return _size;
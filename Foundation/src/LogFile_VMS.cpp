@@ -17,6 +17,7 @@
 #include "Poco/LogFile_VMS.h"
 #include "Poco/File.h"
 #include "Poco/Exception.h"
+#include <unistd.h>
 
 
 namespace Poco {
@@ -53,6 +54,24 @@ void LogFileImpl::writeImpl(const std::string& text, bool flush)
 }
 
 
+void LogFileImpl::writeBinaryImpl(const char* data, std::size_t length)
+{
+	std::size_t n = fwrite(data, 1, length, _file);
+	if (n != length) throw WriteFileException(_path);
+	int rc = fflush(_file);
+	if (rc == EOF) throw WriteFileException(_path);
+}
+
+
+void LogFileImpl::syncImpl()
+{
+	int rc = fflush(_file);
+	if (rc == EOF) throw WriteFileException(_path);
+	rc = fsync(fileno(_file));
+	if (rc != 0) throw WriteFileException(_path);
+}
+
+
 UInt64 LogFileImpl::sizeImpl() const
 {
 	return (UInt64) ftell(_file);
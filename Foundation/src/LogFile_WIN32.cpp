@@ -58,6 +58,30 @@ void LogFileImpl::writeImpl(const std::string& text, bool flush)
 }
 
 
+void LogFileImpl::writeBinaryImpl(const char* data, std::size_t length)
+{
+	if (INVALID_HANDLE_VALUE == _hFile)	createFile();
+
+	while (length > 0)
+	{
+		DWORD bytesWritten;
+		BOOL res = WriteFile(_hFile, data, (DWORD) length, &bytesWritten, NULL);
+		if (!res) throw WriteFileException(_path);
+		data += bytesWritten;
+		length -= bytesWritten;
+	}
+}
+
+
+void LogFileImpl::syncImpl()
+{
+	if (INVALID_HANDLE_VALUE == _hFile) return;
+
+	BOOL res = FlushFileBuffers(_hFile);
+	if (!res) throw WriteFileException(_path);
+}
+
+
 UInt64 LogFileImpl::sizeImpl() const
 {
 	if (INVALID_HANDLE_VALUE == _hFile)
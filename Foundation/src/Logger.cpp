@@ -26,6 +26,32 @@
 namespace Poco {
 
 
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+	#define POCO_LOGGER_THREAD_LOCAL_MESSAGE
+#endif
+
+
+#if defined(POCO_LOGGER_THREAD_LOCAL_MESSAGE)
+namespace
+{
+	struct LocalMessage
+		/// The per-thread Message used by Logger::logDeferred().
+	{
+		LocalMessage(): inUse(false)
+		{
+			// the argument buffer keeps its capacity when reused
+			message.setDeferredText("").reserve(POCO_LOG_BUFFER_SIZE);
+		}
+
+		Message message;
+		bool inUse;
+	};
+
+	thread_local LocalMessage localMessage;
+}
+#endif
+
+
 Logger::LoggerMap* Logger::_pLoggerMap = 0;
 Mutex Logger::_mapMtx;
 const std::string Logger::ROOT;
@@ -482,4 +508,42 @@ void Logger::add(Logger* pLogger)
 }
 
 
+Logger::DeferredMessage::DeferredMessage(const std::string& source, Message::Priority prio, const char* file, int line, const char* fmt):
+	_pMsg(acquire()),
+	_args(_pMsg->setDeferredText(fmt))
+{
+	_pMsg->setSource(source);
+	_pMsg->setPriority(prio);
+	_pMsg->setTime(Timestamp());
+	_pMsg->setSourceFile(file);
+	_pMsg->setSourceLine(line);
+}
+
+
+Logger::DeferredMessage::~DeferredMessage()
+{
+#if defined(POCO_LOGGER_THREAD_LOCAL_MESSAGE)
+	if (_pMsg == &localMessage.message)
+	{
+		localMessage.inUse = false;
+		return;
+	}
+#endif
+	delete _pMsg;
+}
+
+
+Message* Logger::DeferredMessage::acquire()
+{
+#if defined(POCO_LOGGER_THREAD_LOCAL_MESSAGE)
+	if (!localMessage.inUse)
+	{
+		localMessage.inUse = true;
+		return &localMessage.message;
+	}
+#endif
+	return new Message;
+}
+
+
 } // namespace Poco
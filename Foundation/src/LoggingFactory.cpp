@@ -17,6 +17,7 @@
 #include "Poco/LoggingFactory.h"
 #include "Poco/SingletonHolder.h"
 #include "Poco/AsyncChannel.h"
+#include "Poco/BinaryLogChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/FileChannel.h"
 #include "Poco/FormattingChannel.h"
@@ -98,6 +99,7 @@ void LoggingFactory::registerBuiltins()
 #endif
 #ifndef POCO_NO_FILECHANNEL
 	_channelFactory.registerClass("FileChannel", new Instantiator<FileChannel, Channel>);
+	_channelFactory.registerClass("BinaryLogChannel", new Instantiator<BinaryLogChannel, Channel>);
 #endif
 	_channelFactory.registerClass("FormattingChannel", new Instantiator<FormattingChannel, Channel>);
 #ifndef POCO_NO_SPLITTERCHANNEL
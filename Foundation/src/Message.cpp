@@ -15,6 +15,7 @@
 
 
 #include "Poco/Message.h"
+#include "Poco/FormatArgs.h"
 #include "Poco/Exception.h"
 #if !defined(POCO_VXWORKS)
 #include "Poco/Process.h"
@@ -26,7 +27,14 @@
 namespace Poco {
 
 
+namespace
+{
+	const Message::StringMap EMPTY_MAP;
+}
+
+
 Message::Message(): 
+	_format(0),
 	_prio(PRIO_FATAL), 
 	_tid(0), 
 	_ostid(0), 
@@ -42,6 +50,7 @@ Message::Message():
 Message::Message(const std::string& source, const std::string& text, Priority prio): 
 	_source(source), 
 	_text(text), 
+	_format(0),
 	_prio(prio), 
 	_tid(0),
 	_ostid(0),
@@ -57,6 +66,7 @@ Message::Message(const std::string& source, const std::string& text, Priority pr
 Message::Message(const std::string& source, const std::string& text, Priority prio, const char* file, int line):
 	_source(source), 
 	_text(text), 
+	_format(0),
 	_prio(prio), 
 	_tid(0),
 	_ostid(0),
@@ -72,6 +82,7 @@ Message::Message(const std::string& source, const std::string& text, Priority pr
 Message::Message(const Message& msg):
 	_source(msg._source),
 	_text(msg._text),
+	_format(msg._format),
 	_prio(msg._prio),
 	_time(msg._time),
 	_tid(msg._tid),
@@ -91,6 +102,7 @@ Message::Message(const Message& msg):
 Message::Message(const Message& msg, const std::string& text):
 	_source(msg._source),
 	_text(text),
+	_format(0),
 	_prio(msg._prio),
 	_time(msg._time),
 	_tid(msg._tid),
@@ -132,8 +144,31 @@ Message& Message::operator = (const Message& msg)
 {
 	if (&msg != this)
 	{
-		Message tmp(msg);
-		swap(tmp);
+		// Assign member-wise, so that the strings (and the parameter
+		// map) can reuse their storage if the message is recycled.
+		_source = msg._source;
+		_text   = msg._text;
+		_format = msg._format;
+		_prio   = msg._prio;
+		_time   = msg._time;
+		_tid    = msg._tid;
+		_ostid  = msg._ostid;
+		_thread = msg._thread;
+		_pid    = msg._pid;
+		_file   = msg._file;
+		_line   = msg._line;
+		if (msg._pMap)
+		{
+			if (_pMap)
+				*_pMap = *msg._pMap;
+			else
+				_pMap = new StringMap(*msg._pMap);
+		}
+		else
+		{
+			delete _pMap;
+			_pMap = 0;
+		}
 	}
 	return *this;
 }
@@ -144,9 +179,11 @@ void Message::swap(Message& msg)
 	using std::swap;
 	swap(_source, msg._source);
 	swap(_text, msg._text);
+	swap(_format, msg._format);
 	swap(_prio, msg._prio);
 	swap(_time, msg._time);
 	swap(_tid, msg._tid);
+	swap(_ostid, msg._ostid);
 	swap(_thread, msg._thread);
 	swap(_pid, msg._pid);
 	swap(_file, msg._file);
@@ -164,6 +201,27 @@ void Message::setSource(const std::string& src)
 void Message::setText(const std::string& text)
 {
 	_text = text;
+	_format = 0;
+}
+
+
+std::string& Message::setDeferredText(const char* format)
+{
+	poco_check_ptr (format);
+
+	_text.clear();
+	_format = format;
+	return _text;
+}
+
+
+void Message::formatText() const
+{
+	std::string text;
+	FormatArgs::format(text, std::string(_format), _text);
+	// assign, so that the buffer's storage can be reused
+	_text.assign(text);
+	_format = 0;
 }
 
 
@@ -191,6 +249,12 @@ void Message::setTid(long tid)
 }
 
 
+void Message::setOsTid(IntPtr tid)
+{
+	_ostid = tid;
+}
+
+
 void Message::setPid(long pid)
 {
 	_pid = pid;
@@ -272,4 +336,13 @@ std::string& Message::operator [] (const std::string& param)
 }
 
 
+const Message::StringMap& Message::getAll() const
+{
+	if (_pMap)
+		return *_pMap;
+	else
+		return EMPTY_MAP;
+}
+
+
 } // namespace Poco
@@ -19,8 +19,6 @@
 #include "Poco/NumberFormatter.h"
 #include "Poco/DateTimeFormat.h"
 #include "Poco/DateTimeFormatter.h"
-#include "Poco/DateTime.h"
-#include "Poco/Timestamp.h"
 #include "Poco/Timezone.h"
 #include "Poco/Environment.h"
 #include "Poco/NumberParser.h"
@@ -36,7 +34,14 @@ const std::string PatternFormatter::PROP_PRIORITY_NAMES = "priorityNames";
 
 
 PatternFormatter::PatternFormatter():
-	_localTime(false)
+	_localTime(false),
+	_usesDateTime(false),
+	_usesTimezone(false),
+	_dateTimeSecond(0),
+	_dateTimeValid(false),
+	_tzdMinute(0),
+	_tzd(0),
+	_tzdValid(false)
 {
 	parsePriorityNames();
 }
@@ -44,6 +49,13 @@ PatternFormatter::PatternFormatter():
 
 PatternFormatter::PatternFormatter(const std::string& rFormat):
 	_localTime(false),
+	_usesDateTime(false),
+	_usesTimezone(false),
+	_dateTimeSecond(0),
+	_dateTimeValid(false),
+	_tzdMinute(0),
+	_tzd(0),
+	_tzdValid(false),
 	_pattern(rFormat)
 {
 	parsePriorityNames();
@@ -57,19 +69,38 @@ PatternFormatter::~PatternFormatter()
 
 
 void PatternFormatter::format(const Message& msg, std::string& text)
+{
+	if (_usesDateTime || _usesTimezone)
+	{
+		FastMutex::ScopedLock lock(_cacheMutex);
+
+		formatImpl(msg, text);
+	}
+	else formatImpl(msg, text);
+}
+
+
+void PatternFormatter::formatImpl(const Message& msg, std::string& text)
 {
 	Timestamp timestamp = msg.getTime();
 	bool localTime = _localTime;
-	if (localTime)
+	int fraction = 0;
+	if (_usesDateTime || _usesTimezone)
 	{
-		timestamp += Timezone::utcOffset()*Timestamp::resolution();
-		timestamp += Timezone::dst()*Timestamp::resolution();
+		if (localTime) timestamp += tzd(msg.getTime())*Timestamp::resolution();
+		if (_usesDateTime) fraction = updateDateTime(timestamp);
 	}
-	DateTime dateTime = timestamp;
-	for (std::vector<PatternAction>::iterator ip = _patternActions.begin(); ip != _patternActions.end(); ++ip)
+	for (std::size_t i = 0; i < _patternActions.size(); ++i)
 	{
-		text.append(ip->prepend);
-		switch (ip->key)
+		const PatternAction& act = _patternActions[i];
+		if (act.group >= 0)
+		{
+			text.append(renderGroup(act.group));
+			i = _groups[act.group].last;
+			continue;
+		}
+		text.append(act.prepend);
+		switch (act.key)
 		{
 		case 's': text.append(msg.getSource()); break;
 		case 't': text.append(msg.getText()); break;
@@ -83,42 +114,24 @@ void PatternFormatter::format(const Message& msg, std::string& text)
 		case 'N': text.append(Environment::nodeName()); break;
 		case 'U': text.append(msg.getSourceFile() ? msg.getSourceFile() : ""); break;
 		case 'u': NumberFormatter::append(text, msg.getSourceLine()); break;
-		case 'w': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()], 0, 3); break;
-		case 'W': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()]); break;
-		case 'b': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1], 0, 3); break;
-		case 'B': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1]); break;
-		case 'd': NumberFormatter::append0(text, dateTime.day(), 2); break;
-		case 'e': NumberFormatter::append(text, dateTime.day()); break;
-		case 'f': NumberFormatter::append(text, dateTime.day(), 2); break;
-		case 'm': NumberFormatter::append0(text, dateTime.month(), 2); break;
-		case 'n': NumberFormatter::append(text, dateTime.month()); break;
-		case 'o': NumberFormatter::append(text, dateTime.month(), 2); break;
-		case 'y': NumberFormatter::append0(text, dateTime.year() % 100, 2); break;
-		case 'Y': NumberFormatter::append0(text, dateTime.year(), 4); break;
-		case 'H': NumberFormatter::append0(text, dateTime.hour(), 2); break;
-		case 'h': NumberFormatter::append0(text, dateTime.hourAMPM(), 2); break;
-		case 'a': text.append(dateTime.isAM() ? "am" : "pm"); break;
-		case 'A': text.append(dateTime.isAM() ? "AM" : "PM"); break;
-		case 'M': NumberFormatter::append0(text, dateTime.minute(), 2); break;
-		case 'S': NumberFormatter::append0(text, dateTime.second(), 2); break;
-		case 'i': NumberFormatter::append0(text, dateTime.millisecond(), 3); break;
-		case 'c': NumberFormatter::append(text, dateTime.millisecond()/100); break;
-		case 'F': NumberFormatter::append0(text, dateTime.millisecond()*1000 + dateTime.microsecond(), 6); break;
-		case 'z': text.append(DateTimeFormatter::tzdISO(localTime ? Timezone::tzd() : DateTimeFormatter::UTC)); break;
-		case 'Z': text.append(DateTimeFormatter::tzdRFC(localTime ? Timezone::tzd() : DateTimeFormatter::UTC)); break;
+		case 'i': NumberFormatter::append0(text, fraction/1000, 3); break;
+		case 'c': NumberFormatter::append(text, fraction/100000); break;
+		case 'F': NumberFormatter::append0(text, fraction, 6); break;
+		case 'z': text.append(DateTimeFormatter::tzdISO(localTime ? tzd(msg.getTime()) : DateTimeFormatter::UTC)); break;
+		case 'Z': text.append(DateTimeFormatter::tzdRFC(localTime ? tzd(msg.getTime()) : DateTimeFormatter::UTC)); break;
 		case 'E': NumberFormatter::append(text, msg.getTime().epochTime()); break;
 		case 'v':
-			if (ip->length > msg.getSource().length())	//append spaces
-				text.append(msg.getSource()).append(ip->length - msg.getSource().length(), ' ');
-			else if (ip->length && ip->length < msg.getSource().length()) // crop
-				text.append(msg.getSource(), msg.getSource().length()-ip->length, ip->length);
+			if (act.length > msg.getSource().length())	//append spaces
+				text.append(msg.getSource()).append(act.length - msg.getSource().length(), ' ');
+			else if (act.length && act.length < msg.getSource().length()) // crop
+				text.append(msg.getSource(), msg.getSource().length()-act.length, act.length);
 			else
 				text.append(msg.getSource());
 			break;
 		case 'x':
 			try
 			{
-				text.append(msg[ip->property]);
+				text.append(msg[act.property]);
 			}
 			catch (...)
 			{
@@ -128,9 +141,8 @@ void PatternFormatter::format(const Message& msg, std::string& text)
 			if (!localTime)
 			{
 				localTime = true;
-				timestamp += Timezone::utcOffset()*Timestamp::resolution();
-				timestamp += Timezone::dst()*Timestamp::resolution();
-				dateTime = timestamp;
+				timestamp += tzd(msg.getTime())*Timestamp::resolution();
+				if (_usesDateTime) fraction = updateDateTime(timestamp);
 			}
 			break;
 		}
@@ -138,6 +150,100 @@ void PatternFormatter::format(const Message& msg, std::string& text)
 }
 
 
+int PatternFormatter::updateDateTime(const Timestamp& timestamp)
+{
+	Timestamp::TimeVal us = timestamp.epochMicroseconds();
+	Timestamp::TimeVal second = us/Timestamp::resolution();
+	Timestamp::TimeVal fraction = us % Timestamp::resolution();
+	if (fraction < 0)
+	{
+		fraction += Timestamp::resolution();
+		--second;
+	}
+	if (!_dateTimeValid || second != _dateTimeSecond)
+	{
+		_dateTime = Timestamp(second*Timestamp::resolution());
+		_dateTimeSecond = second;
+		_dateTimeValid = true;
+	}
+	return static_cast<int>(fraction);
+}
+
+
+int PatternFormatter::tzd(const Timestamp& timestamp)
+{
+	Timestamp::TimeVal minute = timestamp.epochMicroseconds()/(60*Timestamp::resolution());
+	if (!_tzdValid || minute != _tzdMinute)
+	{
+		_tzd = Timezone::tzd();
+		_tzdMinute = minute;
+		_tzdValid = true;
+	}
+	return _tzd;
+}
+
+
+const std::string& PatternFormatter::renderGroup(int group)
+{
+	DateTimeGroup& grp = _groups[group];
+	if (!grp.valid || grp.second != _dateTimeSecond)
+	{
+		grp.text.clear();
+		for (std::size_t i = grp.first; i <= grp.last; ++i)
+		{
+			grp.text.append(_patternActions[i].prepend);
+			appendDateTime(grp.text, _patternActions[i].key, _dateTime);
+		}
+		grp.second = _dateTimeSecond;
+		grp.valid = true;
+	}
+	return grp.text;
+}
+
+
+void PatternFormatter::appendDateTime(std::string& text, char key, const DateTime& dateTime)
+{
+	switch (key)
+	{
+	case 'w': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()], 0, 3); break;
+	case 'W': text.append(DateTimeFormat::WEEKDAY_NAMES[dateTime.dayOfWeek()]); break;
+	case 'b': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1], 0, 3); break;
+	case 'B': text.append(DateTimeFormat::MONTH_NAMES[dateTime.month() - 1]); break;
+	case 'd': NumberFormatter::append0(text, dateTime.day(), 2); break;
+	case 'e': NumberFormatter::append(text, dateTime.day()); break;
+	case 'f': NumberFormatter::append(text, dateTime.day(), 2); break;
+	case 'm': NumberFormatter::append0(text, dateTime.month(), 2); break;
+	case 'n': NumberFormatter::append(text, dateTime.month()); break;
+	case 'o': NumberFormatter::append(text, dateTime.month(), 2); break;
+	case 'y': NumberFormatter::append0(text, dateTime.year() % 100, 2); break;
+	case 'Y': NumberFormatter::append0(text, dateTime.year(), 4); break;
+	case 'H': NumberFormatter::append0(text, dateTime.hour(), 2); break;
+	case 'h': NumberFormatter::append0(text, dateTime.hourAMPM(), 2); break;
+	case 'a': text.append(dateTime.isAM() ? "am" : "pm"); break;
+	case 'A': text.append(dateTime.isAM() ? "AM" : "PM"); break;
+	case 'M': NumberFormatter::append0(text, dateTime.minute(), 2); break;
+	case 'S': NumberFormatter::append0(text, dateTime.second(), 2); break;
+	}
+}
+
+
+bool PatternFormatter::isDateTimeKey(char key)
+{
+	switch (key)
+	{
+	case 'w': case 'W': case 'b': case 'B':
+	case 'd': case 'e': case 'f':
+	case 'm': case 'n': case 'o':
+	case 'y': case 'Y':
+	case 'H': case 'h': case 'a': case 'A':
+	case 'M': case 'S':
+		return true;
+	default:
+		return false;
+	}
+}
+
+
 void PatternFormatter::parsePattern()
 {
 	_patternActions.clear();
@@ -194,6 +300,47 @@ void PatternFormatter::parsePattern()
 	{
 		_patternActions.push_back(endAct);
 	}
+	compilePattern();
+}
+
+
+void PatternFormatter::compilePattern()
+{
+	_groups.clear();
+	_usesDateTime = false;
+	_usesTimezone = false;
+	for (std::size_t i = 0; i < _patternActions.size(); ++i)
+	{
+		PatternAction& act = _patternActions[i];
+		switch (act.key)
+		{
+		case 'i': case 'c': case 'F':
+			_usesDateTime = true;
+			break;
+		case 'z': case 'Z': case 'L':
+			_usesTimezone = true;
+			break;
+		default:
+			if (isDateTimeKey(act.key))
+			{
+				_usesDateTime = true;
+				if (i > 0 && _patternActions[i - 1].group >= 0)
+				{
+					act.group = _patternActions[i - 1].group;
+					_groups.back().last = i;
+				}
+				else
+				{
+					act.group = static_cast<int>(_groups.size());
+					DateTimeGroup grp;
+					grp.first = i;
+					grp.last  = i;
+					_groups.push_back(grp);
+				}
+			}
+		}
+	}
+	_dateTimeValid = false;
 }
 
 	
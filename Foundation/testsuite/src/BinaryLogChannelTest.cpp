@@ -0,0 +1,360 @@
+//
+// BinaryLogChannelTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "BinaryLogChannelTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/BinaryLogChannel.h"
+#include "Poco/BinaryLogReader.h"
+#include "Poco/PatternFormatter.h"
+#include "Poco/Message.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/File.h"
+#include "Poco/DateTime.h"
+#include "Poco/Exception.h"
+#include <sstream>
+#include <cstring>
+
+
+using Poco::BinaryLogChannel;
+using Poco::BinaryLogReader;
+using Poco::PatternFormatter;
+using Poco::Message;
+using Poco::AutoPtr;
+using Poco::TemporaryFile;
+using Poco::FileInputStream;
+using Poco::FileOutputStream;
+using Poco::DateTime;
+
+
+namespace
+{
+	static const char* SOURCE_FILE = "BinaryLogChannelTest.cpp";
+}
+
+
+BinaryLogChannelTest::BinaryLogChannelTest(const std::string& rName): CppUnit::TestCase(rName)
+{
+}
+
+
+BinaryLogChannelTest::~BinaryLogChannelTest()
+{
+}
+
+
+void BinaryLogChannelTest::testWriteRead()
+{
+	TemporaryFile file;
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(file.path());
+	pChannel->open();
+
+	Message msg1("Source1", "Message text 1", Message::PRIO_ERROR, SOURCE_FILE, 42);
+	msg1.setTime(DateTime(2016, 11, 28, 12, 30, 15, 123, 456).timestamp());
+	msg1.setThread("Thread1");
+	msg1.setTid(7);
+	msg1.setPid(1234);
+	msg1["user"] = "guest";
+	msg1["request"] = "4711";
+	pChannel->log(msg1);
+
+	Message msg2("Source2", "Message text 2", Message::PRIO_TRACE);
+	msg2.setTime(DateTime(1960, 1, 1).timestamp());
+	msg2.setThread("");
+	msg2.setTid(0);
+	pChannel->log(msg2);
+
+	Message msg3("Source1", "", Message::PRIO_INFORMATION, SOURCE_FILE, 43);
+	msg3.setThread("Thread1");
+	msg3["user"] = "admin";
+	pChannel->log(msg3);
+	pChannel->close();
+
+	FileInputStream istr(file.path());
+	BinaryLogReader reader(istr);
+	assert (reader.version() == BinaryLogChannel::FORMAT_VERSION);
+
+	Message msg;
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1");
+	assert (msg.getText() == "Message text 1");
+	assert (msg.getPriority() == Message::PRIO_ERROR);
+	assert (msg.getTime() == msg1.getTime());
+	assert (msg.getThread() == "Thread1");
+	assert (msg.getTid() == 7);
+	assert (msg.getOsTid() == msg1.getOsTid());
+	assert (msg.getPid() == 1234);
+	assert (std::strcmp(msg.getSourceFile(), SOURCE_FILE) == 0);
+	assert (msg.getSourceLine() == 42);
+	assert (msg.getAll().size() == 2);
+	assert (msg["user"] == "guest");
+	assert (msg["request"] == "4711");
+
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source2");
+	assert (msg.getText() == "Message text 2");
+	assert (msg.getPriority() == Message::PRIO_TRACE);
+	assert (msg.getTime() == msg2.getTime());
+	assert (msg.getThread() == "");
+	assert (msg.getSourceFile() == 0);
+	assert (msg.getSourceLine() == 0);
+	assert (msg.getAll().empty());
+
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1");
+	assert (msg.getText() == "");
+	assert (std::strcmp(msg.getSourceFile(), SOURCE_FILE) == 0);
+	assert (msg.getSourceLine() == 43);
+	assert (msg.getAll().size() == 1);
+	assert (msg["user"] == "admin");
+
+	assert (!reader.read(msg));
+}
+
+
+void BinaryLogChannelTest::testReopen()
+{
+	TemporaryFile file;
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel;
+	pChannel->setProperty(BinaryLogChannel::PROP_PATH, file.path());
+	pChannel->setProperty(BinaryLogChannel::PROP_FLUSH, "false");
+	assert (pChannel->getProperty(BinaryLogChannel::PROP_FLUSH) == "false");
+
+	Message msg1("Source1", "Text 1", Message::PRIO_ERROR);
+	pChannel->log(msg1);
+	pChannel->close();
+
+	Poco::File::FileSize size = Poco::File(file.path()).getSize();
+
+	// string identifiers defined before are reused after reopening
+	Message msg3("Source1", "Text 3", Message::PRIO_NOTICE);
+	pChannel->log(msg3);
+	pChannel->close();
+	// only the message record has been appended
+	assert (Poco::File(file.path()).getSize() - size < size - BinaryLogChannel::SIGNATURE_SIZE - 1);
+
+	Message msg2("Source2", "Text 2", Message::PRIO_WARNING);
+	pChannel->log(msg2);
+	pChannel->log(msg3);
+	pChannel->close();
+
+	FileInputStream istr(file.path());
+	BinaryLogReader reader(istr);
+	Message msg;
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1" && msg.getText() == "Text 1");
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1" && msg.getText() == "Text 3");
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source2" && msg.getText() == "Text 2");
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1" && msg.getText() == "Text 3");
+	assert (!reader.read(msg));
+}
+
+
+void BinaryLogChannelTest::testFormat()
+{
+	TemporaryFile file;
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(file.path());
+	Message msgs[2];
+	msgs[0] = Message("Source", "Text 1", Message::PRIO_ERROR);
+	msgs[0].setTime(DateTime(2016, 11, 28, 12, 30, 15, 500).timestamp());
+	msgs[0]["param"] = "value";
+	msgs[1] = Message("Source", "Text 2", Message::PRIO_WARNING);
+	msgs[1].setTime(DateTime(2016, 11, 28, 12, 30, 16, 0).timestamp());
+	pChannel->logBatch(msgs, 2);
+	pChannel->close();
+
+	FileInputStream istr(file.path());
+	BinaryLogReader reader(istr);
+	AutoPtr<PatternFormatter> pFormatter = new PatternFormatter("%H:%M:%S.%i [%p] %s: %t %[param]");
+	std::ostringstream ostr;
+	assert (reader.format(*pFormatter, ostr) == 2);
+	assert (ostr.str() == "12:30:15.500 [Error] Source: Text 1 value\n12:30:16.000 [Warning] Source: Text 2 \n");
+}
+
+
+void BinaryLogChannelTest::testTruncated()
+{
+	TemporaryFile file;
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(file.path());
+	Message msg1("Source", "Text 1", Message::PRIO_ERROR);
+	pChannel->log(msg1);
+	pChannel->log(msg1);
+	pChannel->close();
+
+	std::string data;
+	{
+		FileInputStream istr(file.path());
+		std::ostringstream ostr;
+		ostr << istr.rdbuf();
+		data = ostr.str();
+	}
+	data.resize(data.size() - 3);
+
+	std::istringstream istr(data);
+	BinaryLogReader reader(istr);
+	Message msg;
+	assert (reader.read(msg));
+	assert (msg.getText() == "Text 1");
+	assert (!reader.read(msg));
+}
+
+
+void BinaryLogChannelTest::testRecover()
+{
+	TemporaryFile file;
+	AutoPtr<BinaryLogChannel> pChannel = new BinaryLogChannel(file.path());
+	Message msg1("Source1", "Text 1", Message::PRIO_ERROR, SOURCE_FILE, 1);
+	pChannel->log(msg1);
+	pChannel->close();
+
+	// simulate a crash while writing a record
+	{
+		FileOutputStream ostr(file.path(), std::ios::app);
+		const char record[] = {20, 0, 0, 0, BinaryLogChannel::RECORD_MESSAGE, 0, 3};
+		ostr.write(record, sizeof(record));
+	}
+
+	Message msg2("Source2", "Text 2", Message::PRIO_WARNING, SOURCE_FILE, 2);
+	pChannel->log(msg2);
+	pChannel->close();
+
+	FileInputStream istr(file.path());
+	BinaryLogReader reader(istr);
+	Message msg;
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source1" && msg.getText() == "Text 1");
+	const char* pSourceFile = msg.getSourceFile();
+	assert (std::strcmp(pSourceFile, SOURCE_FILE) == 0);
+	assert (reader.read(msg));
+	assert (msg.getSource() == "Source2" && msg.getText() == "Text 2");
+	assert (msg.getSourceFile() == pSourceFile);
+	assert (std::strcmp(pSourceFile, SOURCE_FILE) == 0);
+	assert (!reader.read(msg));
+
+	// not a binary log file
+	{
+		FileOutputStream ostr(file.path());
+		ostr << "This is not a binary log file";
+	}
+	try
+	{
+		pChannel->open();
+		fail("not a binary log file - must throw");
+	}
+	catch (Poco::OpenFileException&)
+	{
+	}
+
+	// a file shorter than the header is only truncated if it
+	// starts like a binary log file
+	{
+		FileOutputStream ostr(file.path());
+		ostr << "Text";
+	}
+	try
+	{
+		pChannel->open();
+		fail("not a binary log file - must throw");
+	}
+	catch (Poco::OpenFileException&)
+	{
+	}
+	assert (Poco::File(file.path()).getSize() == 4);
+
+	{
+		FileOutputStream ostr(file.path());
+		ostr << "PocoB";
+	}
+	pChannel->log(msg1);
+	pChannel->close();
+	FileInputStream istr2(file.path());
+	BinaryLogReader reader2(istr2);
+	assert (reader2.read(msg));
+	assert (msg.getText() == "Text 1");
+	assert (!reader2.read(msg));
+}
+
+
+void BinaryLogChannelTest::testInvalid()
+{
+	std::istringstream istr1("This is not a binary log file");
+	try
+	{
+		BinaryLogReader reader(istr1);
+		fail("not a binary log file - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+
+	std::string data(BinaryLogChannel::SIGNATURE);
+	data += (char) BinaryLogChannel::FORMAT_VERSION;
+	// message record referring to an undefined source string
+	const char record[] = {12, 0, 0, 0, BinaryLogChannel::RECORD_MESSAGE, 0, 3, 5, 0, 0, 0, 0, 0, 0, 0, 0};
+	data.append(record, sizeof(record));
+	std::istringstream istr2(data);
+	BinaryLogReader reader(istr2);
+	Message msg;
+	try
+	{
+		reader.read(msg);
+		fail("undefined string - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+
+	data.resize(BinaryLogChannel::SIGNATURE_SIZE + 1);
+	// record length exceeding the maximum
+	const char hugeRecord[] = {'\xFF', '\xFF', '\xFF', '\xFF', BinaryLogChannel::RECORD_STRING, 1, 0};
+	data.append(hugeRecord, sizeof(hugeRecord));
+	std::istringstream istr3(data);
+	BinaryLogReader reader3(istr3);
+	try
+	{
+		reader3.read(msg);
+		fail("record too large - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+}
+
+
+void BinaryLogChannelTest::setUp()
+{
+}
+
+
+void BinaryLogChannelTest::tearDown()
+{
+}
+
+
+CppUnit::Test* BinaryLogChannelTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("BinaryLogChannelTest");
+
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testWriteRead);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testReopen);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testFormat);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testTruncated);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testRecover);
+	CppUnit_addTest(pSuite, BinaryLogChannelTest, testInvalid);
+
+	return pSuite;
+}
@@ -0,0 +1,45 @@
+//
+// BinaryLogChannelTest.h
+//
+// $Id$
+//
+// Definition of the BinaryLogChannelTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef BinaryLogChannelTest_INCLUDED
+#define BinaryLogChannelTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class BinaryLogChannelTest: public CppUnit::TestCase
+{
+public:
+	BinaryLogChannelTest(const std::string& name);
+	~BinaryLogChannelTest();
+
+	void testWriteRead();
+	void testReopen();
+	void testFormat();
+	void testTruncated();
+	void testRecover();
+	void testInvalid();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // BinaryLogChannelTest_INCLUDED
@@ -21,8 +21,16 @@
 #include "Poco/FormattingChannel.h"
 #include "Poco/ConsoleChannel.h"
 #include "Poco/StreamChannel.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Mutex.h"
+#include "Poco/Exception.h"
 #include "TestChannel.h"
 #include <sstream>
+#include <vector>
 
 
 using Poco::SplitterChannel;
@@ -33,6 +41,11 @@ using Poco::StreamChannel;
 using Poco::Formatter;
 using Poco::Message;
 using Poco::AutoPtr;
+using Poco::NumberFormatter;
+using Poco::NumberParser;
+using Poco::Thread;
+using Poco::Event;
+using Poco::FastMutex;
 
 
 class SimpleFormatter: public Formatter
@@ -47,6 +60,118 @@ public:
 };
 
 
+namespace
+{
+	class GateChannel: public Poco::Channel
+		/// Records the messages and batches passed to it.
+		/// The first batch is held until open() is called.
+	{
+	public:
+		GateChannel():
+			_gateOpen(false)
+		{
+		}
+
+		void log(const Message& msg)
+		{
+			logBatch(&msg, 1);
+		}
+
+		void logBatch(const Message* pMessages, std::size_t count)
+		{
+			if (!_gateOpen)
+			{
+				_entered.set();
+				_gate.wait();
+				_gateOpen = true;
+			}
+			FastMutex::ScopedLock lock(_mutex);
+			_batches.push_back(count);
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				_texts.push_back(pMessages[i].getText());
+			}
+		}
+
+		void waitEntered()
+		{
+			_entered.wait();
+		}
+
+		void openGate()
+		{
+			_gate.set();
+		}
+
+		std::vector<std::size_t> batches()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _batches;
+		}
+
+		std::vector<std::string> texts()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _texts;
+		}
+
+	private:
+		bool _gateOpen;
+		Event _entered;
+		Event _gate;
+		FastMutex _mutex;
+		std::vector<std::size_t> _batches;
+		std::vector<std::string> _texts;
+	};
+
+	class FailingChannel: public Poco::Channel
+		/// Records the texts of the messages passed to it,
+		/// except for messages with the text "fail", for
+		/// which log() throws.
+	{
+	public:
+		void log(const Message& msg)
+		{
+			if (msg.getText() == "fail") throw Poco::WriteFileException("fail");
+			FastMutex::ScopedLock lock(_mutex);
+			_texts.push_back(msg.getText());
+		}
+
+		std::vector<std::string> texts()
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			return _texts;
+		}
+
+	private:
+		FastMutex _mutex;
+		std::vector<std::string> _texts;
+	};
+
+	class Producer: public Poco::Runnable
+	{
+	public:
+		Producer(Poco::Channel& channel, int count):
+			_channel(channel),
+			_count(count)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < _count; ++i)
+			{
+				_channel.log(Message("Producer", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+			}
+		}
+
+	private:
+		Poco::Channel& _channel;
+		int _count;
+	};
+}
+
+
 ChannelTest::ChannelTest(const std::string& rName): CppUnit::TestCase(rName)
 {
 }
@@ -82,6 +207,154 @@ void ChannelTest::testAsync()
 }
 
 
+void ChannelTest::testAsyncBatch()
+{
+	AutoPtr<GateChannel> pChannel = new GateChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel.get());
+	pAsync->log(Message("Source", "first", Message::PRIO_INFORMATION));
+	pChannel->waitEntered();
+	for (int i = 0; i < 100; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	pChannel->openGate();
+	pAsync->close();
+
+	std::vector<std::size_t> batches = pChannel->batches();
+	assert (batches.size() == 3);
+	assert (batches[0] == 1);
+	assert (batches[1] == AsyncChannel::DEFAULT_BATCH_SIZE);
+	assert (batches[2] == 100 - AsyncChannel::DEFAULT_BATCH_SIZE);
+	std::vector<std::string> texts = pChannel->texts();
+	assert (texts.size() == 101);
+	assert (texts[0] == "first");
+	for (int i = 0; i < 100; ++i)
+	{
+		assert (NumberParser::parse(texts[i + 1]) == i);
+	}
+	assert (pAsync->droppedMessages() == 0);
+}
+
+
+void ChannelTest::testLogBatchError()
+{
+	AutoPtr<FailingChannel> pFailing = new FailingChannel;
+	Message msgs[3];
+	msgs[0].setText("a");
+	msgs[1].setText("fail");
+	msgs[2].setText("b");
+	try
+	{
+		pFailing->logBatch(msgs, 3);
+		fail("must throw");
+	}
+	catch (Poco::WriteFileException&)
+	{
+	}
+	assert (pFailing->texts().size() == 2);
+	assert (pFailing->texts()[0] == "a");
+	assert (pFailing->texts()[1] == "b");
+
+	AutoPtr<FailingChannel> pFailing2 = new FailingChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pFailing2);
+	pAsync->setBatchSize(16);
+	pAsync->open();
+	pAsync->log(Message("source", "a", Message::PRIO_INFORMATION));
+	pAsync->log(Message("source", "fail", Message::PRIO_INFORMATION));
+	pAsync->log(Message("source", "b", Message::PRIO_INFORMATION));
+	pAsync->close();
+	assert (pFailing2->texts().size() == 2);
+	assert (pFailing2->texts()[1] == "b");
+}
+
+
+void ChannelTest::testAsyncDropNewest()
+{
+	AutoPtr<GateChannel> pChannel = new GateChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel.get());
+	pAsync->setProperty("queueSize", "8");
+	pAsync->setProperty("overflow", "dropNewest");
+	pAsync->log(Message("Source", "first", Message::PRIO_INFORMATION));
+	pChannel->waitEntered();
+	for (int i = 0; i < 20; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	pChannel->openGate();
+	pAsync->close();
+
+	assert (pAsync->droppedMessages() == 12);
+	std::vector<std::string> texts = pChannel->texts();
+	assert (texts.size() == 9);
+	for (int i = 0; i < 8; ++i)
+	{
+		assert (NumberParser::parse(texts[i + 1]) == i);
+	}
+}
+
+
+void ChannelTest::testAsyncDropOldest()
+{
+	AutoPtr<GateChannel> pChannel = new GateChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel.get());
+	pAsync->setQueueSize(8);
+	pAsync->setOverflowPolicy(AsyncChannel::OVERFLOW_DROP_OLDEST);
+	pAsync->log(Message("Source", "first", Message::PRIO_INFORMATION));
+	pChannel->waitEntered();
+	for (int i = 0; i < 20; ++i)
+	{
+		pAsync->log(Message("Source", NumberFormatter::format(i), Message::PRIO_INFORMATION));
+	}
+	pChannel->openGate();
+	pAsync->close();
+
+	assert (pAsync->droppedMessages() == 12);
+	std::vector<std::string> texts = pChannel->texts();
+	assert (texts.size() == 9);
+	assert (texts[0] == "first");
+	for (int i = 0; i < 8; ++i)
+	{
+		assert (NumberParser::parse(texts[i + 1]) == i + 12);
+	}
+}
+
+
+void ChannelTest::testAsyncBlock()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	AutoPtr<AsyncChannel> pAsync = new AsyncChannel(pChannel.get());
+	pAsync->setQueueSize(16);
+	pAsync->setBatchSize(4);
+	assert (pAsync->getProperty("queueSize") == "16");
+	assert (pAsync->getProperty("batchSize") == "4");
+	assert (pAsync->getProperty("overflow") == "block");
+	pAsync->open();
+	try
+	{
+		pAsync->setQueueSize(32);
+		fail("channel is open - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+
+	Producer producer(*pAsync, 2000);
+	Thread thread1;
+	Thread thread2;
+	Thread thread3;
+	thread1.start(producer);
+	thread2.start(producer);
+	thread3.start(producer);
+	producer.run();
+	thread1.join();
+	thread2.join();
+	thread3.join();
+	pAsync->close();
+	assert (pChannel->list().size() == 8000);
+	assert (pAsync->droppedMessages() == 0);
+}
+
+
 void ChannelTest::testFormatting()
 {
 	AutoPtr<TestChannel> pChannel = new TestChannel;
@@ -132,6 +405,11 @@ CppUnit::Test* ChannelTest::suite()
 
 	CppUnit_addTest(pSuite, ChannelTest, testSplitter);
 	CppUnit_addTest(pSuite, ChannelTest, testAsync);
+	CppUnit_addTest(pSuite, ChannelTest, testAsyncBatch);
+	CppUnit_addTest(pSuite, ChannelTest, testLogBatchError);
+	CppUnit_addTest(pSuite, ChannelTest, testAsyncDropNewest);
+	CppUnit_addTest(pSuite, ChannelTest, testAsyncDropOldest);
+	CppUnit_addTest(pSuite, ChannelTest, testAsyncBlock);
 	CppUnit_addTest(pSuite, ChannelTest, testFormatting);
 	CppUnit_addTest(pSuite, ChannelTest, testConsole);
 	CppUnit_addTest(pSuite, ChannelTest, testStream);
@@ -28,6 +28,11 @@ public:
 
 	void testSplitter();
 	void testAsync();
+	void testAsyncBatch();
+	void testLogBatchError();
+	void testAsyncDropNewest();
+	void testAsyncDropOldest();
+	void testAsyncBlock();
 	void testFormatting();
 	void testConsole();
 	void testStream();
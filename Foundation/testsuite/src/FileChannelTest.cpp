@@ -546,6 +546,135 @@ void FileChannelTest::testWrongPurgeOption()
 }
 
 
+void FileChannelTest::testGroupCommit()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "true");
+		pChannel->setProperty(FileChannel::PROP_COMMITMESSAGES, "10");
+		pChannel->setProperty(FileChannel::PROP_COMMITBYTES, "0");
+		pChannel->setProperty(FileChannel::PROP_COMMITINTERVAL, "0");
+		pChannel->setProperty(FileChannel::PROP_SYNCINTERVAL, "0");
+		assert (pChannel->getProperty(FileChannel::PROP_GROUPCOMMIT) == "true");
+		assert (pChannel->getProperty(FileChannel::PROP_COMMITMESSAGES) == "10");
+		assert (pChannel->getProperty(FileChannel::PROP_SYNCINTERVAL) == "0");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		const Poco::File::FileSize lineSize = msg.getText().size() + 1;
+		for (int i = 0; i < 9; ++i)
+		{
+			pChannel->log(msg);
+		}
+		File f(name);
+		assert (f.getSize() == 0);
+		assert (pChannel->size() == 9*lineSize);
+		pChannel->log(msg);
+		assert (f.getSize() == 10*lineSize);
+		for (int i = 0; i < 3; ++i)
+		{
+			pChannel->log(msg);
+		}
+		assert (f.getSize() == 10*lineSize);
+		pChannel->close();
+		assert (f.getSize() == 13*lineSize);
+
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "false");
+		pChannel->log(msg);
+		assert (f.getSize() == 14*lineSize);
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void FileChannelTest::testGroupCommitInterval()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "true");
+		pChannel->setProperty(FileChannel::PROP_COMMITBYTES, "0");
+		pChannel->setProperty(FileChannel::PROP_COMMITINTERVAL, "50");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		pChannel->log(msg);
+		File f(name);
+		assert (f.getSize() == 0);
+		int n = 0;
+		while (f.getSize() == 0 && n++ < 100) Thread::sleep(20);
+		const Poco::File::FileSize lineSize = msg.getText().size() + 1;
+		assert (f.getSize() == lineSize);
+
+		// disabling group commit writes the buffer and stops the timer
+		pChannel->log(msg);
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "false");
+		assert (f.getSize() == 2*lineSize);
+		pChannel->log(msg);
+		assert (f.getSize() == 3*lineSize);
+
+		// enabling it again starts a new timer
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "true");
+		pChannel->log(msg);
+		assert (f.getSize() == 3*lineSize);
+		n = 0;
+		while (f.getSize() == 3*lineSize && n++ < 100) Thread::sleep(20);
+		assert (f.getSize() == 4*lineSize);
+		pChannel->close();
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
+void FileChannelTest::testGroupCommitRotate()
+{
+	std::string name = filename();
+	try
+	{
+		AutoPtr<FileChannel> pChannel = new FileChannel(name);
+		pChannel->setProperty(FileChannel::PROP_ROTATION, "2 K");
+		pChannel->setProperty(FileChannel::PROP_GROUPCOMMIT, "true");
+		pChannel->setProperty(FileChannel::PROP_COMMITBYTES, "1000");
+		pChannel->open();
+		Message msg("source", "This is a log file entry", Message::PRIO_INFORMATION);
+		for (int i = 0; i < 200; ++i)
+		{
+			pChannel->log(msg);
+		}
+		pChannel->close();
+		File f(name + ".0");
+		assert (f.exists());
+		assert (f.getSize() >= 2048 && f.getSize() < 2048 + msg.getText().size() + 1);
+		Poco::File::FileSize total = f.getSize();
+		f = name + ".1";
+		assert (f.exists());
+		total += f.getSize();
+		f = name + ".2";
+		assert (!f.exists());
+		f = name;
+		total += f.getSize();
+		assert (total == 200*(msg.getText().size() + 1));
+	}
+	catch (...)
+	{
+		remove(name);
+		throw;
+	}
+	remove(name);
+}
+
+
 void FileChannelTest::setUp()
 {
 }
@@ -649,6 +778,9 @@ CppUnit::Test* FileChannelTest::suite()
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeAge);
 	CppUnit_addTest(pSuite, FileChannelTest, testPurgeCount);
 	CppUnit_addTest(pSuite, FileChannelTest, testWrongPurgeOption);
+	CppUnit_addTest(pSuite, FileChannelTest, testGroupCommit);
+	CppUnit_addTest(pSuite, FileChannelTest, testGroupCommitInterval);
+	CppUnit_addTest(pSuite, FileChannelTest, testGroupCommitRotate);
 
 	return pSuite;
 }
@@ -46,6 +46,9 @@ public:
 	void testPurgeAge();
 	void testPurgeCount();
 	void testWrongPurgeOption();
+	void testGroupCommit();
+	void testGroupCommitInterval();
+	void testGroupCommitRotate();
 
 	void setUp();
 	void tearDown();
@@ -15,10 +15,12 @@
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Any.h"
 #include "Poco/Format.h"
+#include "Poco/FormatArgs.h"
 #include "Poco/Exception.h"
 
 
 using Poco::format;
+using Poco::FormatArgs;
 using Poco::BadCastException;
 using Poco::Int64;
 using Poco::UInt64;
@@ -355,6 +357,57 @@ void FormatTest::testIndex()
 }
 
 
+void FormatTest::testFormatArgs()
+{
+	std::string buffer("garbage");
+	FormatArgs args(buffer);
+	assert (buffer.empty());
+
+	std::string str("string");
+	args << 'c' << true << (short) -1 << (unsigned short) 2 << -3 << 4u << -5L << 6UL
+	     << (Int64) -7 << (UInt64) 8 << 1.5f << 2.25 << "literal" << str;
+	str = "changed";
+
+	std::string s;
+	FormatArgs::format(s, "%c %b %hd %hu %d %u %ld %lu %Ld %Lu %.1hf %.2f %s %s", buffer);
+	assert (s == "c 1 -1 2 -3 4 -5 6 -7 8 1.5 2.25 literal string");
+
+	FormatArgs args2(buffer);
+	args2 << "foo" << std::string("bar");
+	s = "result: ";
+	FormatArgs::format(s, "%[1]s%[0]s", buffer);
+	assert (s == "result: barfoo");
+
+	// arguments of the wrong type are reported by Poco::format()
+	s.clear();
+	FormatArgs::format(s, "%d", buffer);
+	assert (s == "[ERRFMT]");
+
+	s.clear();
+	FormatArgs args3(buffer);
+	args3 << 1;
+	buffer.resize(buffer.size() - 1);
+	try
+	{
+		FormatArgs::format(s, "%d", buffer);
+		fail("truncated arguments - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+
+	buffer.assign(1, '\x7F');
+	try
+	{
+		FormatArgs::format(s, "%d", buffer);
+		fail("invalid argument type - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+}
+
+
 void FormatTest::setUp()
 {
 }
@@ -378,6 +431,7 @@ CppUnit::Test* FormatTest::suite()
 	CppUnit_addTest(pSuite, FormatTest, testString);
 	CppUnit_addTest(pSuite, FormatTest, testMultiple);
 	CppUnit_addTest(pSuite, FormatTest, testIndex);
+	CppUnit_addTest(pSuite, FormatTest, testFormatArgs);
 
 	return pSuite;
 }
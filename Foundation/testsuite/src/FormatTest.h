@@ -32,6 +32,7 @@ public:
 	void testString();
 	void testMultiple();
 	void testIndex();
+	void testFormatArgs();
 
 	void setUp();
 	void tearDown();
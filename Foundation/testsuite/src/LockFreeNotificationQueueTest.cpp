@@ -0,0 +1,303 @@
+//
+// LockFreeNotificationQueueTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "LockFreeNotificationQueueTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/LockFreeNotificationQueue.h"
+#include "Poco/Notification.h"
+#include "Poco/Thread.h"
+#include "Poco/Runnable.h"
+#include "Poco/RunnableAdapter.h"
+#include "Poco/Random.h"
+#include "Poco/Exception.h"
+
+
+using Poco::LockFreeNotificationQueue;
+using Poco::Notification;
+using Poco::Thread;
+using Poco::RunnableAdapter;
+
+
+namespace
+{
+	class QTestNotification: public Notification
+	{
+	public:
+		QTestNotification(const std::string& data): _data(data)
+		{
+		}
+		~QTestNotification()
+		{
+		}
+		const std::string& data() const
+		{
+			return _data;
+		}
+
+	private:
+		std::string _data;
+	};
+
+	const int PRODUCER_COUNT = 4;
+	const int PRODUCER_NOTIFICATION_COUNT = 5000;
+}
+
+
+LockFreeNotificationQueueTest::LockFreeNotificationQueueTest(const std::string& rName):
+	CppUnit::TestCase(rName),
+	_queue(64)
+{
+}
+
+
+LockFreeNotificationQueueTest::~LockFreeNotificationQueueTest()
+{
+}
+
+
+void LockFreeNotificationQueueTest::testQueueDequeue()
+{
+	LockFreeNotificationQueue queue;
+	assert (queue.empty());
+	assert (queue.size() == 0);
+	Notification* pNf = queue.dequeueNotification();
+	assertNullPtr(pNf);
+	queue.enqueueNotification(new Notification);
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pNf = queue.dequeueNotification();
+	assertNotNullPtr(pNf);
+	assert (queue.empty());
+	assert (queue.size() == 0);
+	pNf->release();
+
+	queue.enqueueNotification(new QTestNotification("first"));
+	queue.enqueueNotification(new QTestNotification("second"));
+	assert (!queue.empty());
+	assert (queue.size() == 2);
+	QTestNotification* pTNf = dynamic_cast<QTestNotification*>(queue.dequeueNotification());
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "first");
+	pTNf->release();
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pTNf = dynamic_cast<QTestNotification*>(queue.dequeueNotification());
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "second");
+	pTNf->release();
+	assert (queue.empty());
+	assert (queue.size() == 0);
+
+	pNf = queue.dequeueNotification();
+	assertNullPtr(pNf);
+}
+
+
+void LockFreeNotificationQueueTest::testCapacity()
+{
+	LockFreeNotificationQueue queue(3);
+	assert (queue.capacity() == 4);
+
+	for (int i = 0; i < 4; i++)
+	{
+		assert (queue.tryEnqueueNotification(new Notification));
+	}
+	assert (queue.size() == 4);
+	assert (!queue.tryEnqueueNotification(new Notification));
+	try
+	{
+		queue.enqueueNotification(new Notification);
+		fail("queue is full - must throw");
+	}
+	catch (Poco::PoolOverflowException&)
+	{
+	}
+
+	// wrap around a few times
+	for (int i = 0; i < 10; i++)
+	{
+		Notification::Ptr pNf = queue.dequeueNotification();
+		assertNotNullPtr(pNf.get());
+		assert (queue.tryEnqueueNotification(new QTestNotification("x")));
+		assert (queue.size() == 4);
+	}
+	queue.clear();
+	assert (queue.empty());
+}
+
+
+void LockFreeNotificationQueueTest::testWaitDequeue()
+{
+	LockFreeNotificationQueue queue;
+	queue.enqueueNotification(new QTestNotification("third"));
+	queue.enqueueNotification(new QTestNotification("fourth"));
+	assert (!queue.empty());
+	assert (queue.size() == 2);
+	QTestNotification* pTNf = dynamic_cast<QTestNotification*>(queue.waitDequeueNotification(10));
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "third");
+	pTNf->release();
+	assert (!queue.empty());
+	assert (queue.size() == 1);
+	pTNf = dynamic_cast<QTestNotification*>(queue.waitDequeueNotification(10));
+	assertNotNullPtr(pTNf);
+	assert (pTNf->data() == "fourth");
+	pTNf->release();
+	assert (queue.empty());
+	assert (queue.size() == 0);
+
+	Notification* pNf = queue.waitDequeueNotification(10);
+	assertNullPtr(pNf);
+}
+
+
+void LockFreeNotificationQueueTest::testThreads()
+{
+	const int NOTIFICATION_COUNT = 5000;
+
+	Thread t1("thread1");
+	Thread t2("thread2");
+	Thread t3("thread3");
+
+	RunnableAdapter<LockFreeNotificationQueueTest> ra(*this, &LockFreeNotificationQueueTest::work);
+	t1.start(ra);
+	t2.start(ra);
+	t3.start(ra);
+	for (int i = 0; i < NOTIFICATION_COUNT; ++i)
+	{
+		while (!_queue.tryEnqueueNotification(new Notification)) Thread::yield();
+	}
+	while (!_queue.empty()) Thread::sleep(50);
+	Thread::sleep(20);
+	_queue.wakeUpAll();
+	t1.join();
+	t2.join();
+	t3.join();
+	assert (_handled.size() == NOTIFICATION_COUNT);
+	assert (_handled.count("thread1") > 0);
+	assert (_handled.count("thread2") > 0);
+	assert (_handled.count("thread3") > 0);
+}
+
+
+void LockFreeNotificationQueueTest::testProducersConsumers()
+{
+	RunnableAdapter<LockFreeNotificationQueueTest> producer(*this, &LockFreeNotificationQueueTest::produce);
+	RunnableAdapter<LockFreeNotificationQueueTest> consumer(*this, &LockFreeNotificationQueueTest::consume);
+
+	Thread producers[PRODUCER_COUNT];
+	Thread consumers[PRODUCER_COUNT];
+	for (int i = 0; i < PRODUCER_COUNT; i++)
+	{
+		consumers[i].start(consumer);
+	}
+	for (int i = 0; i < PRODUCER_COUNT; i++)
+	{
+		producers[i].start(producer);
+	}
+	for (int i = 0; i < PRODUCER_COUNT; i++)
+	{
+		producers[i].join();
+	}
+	while (!_queue.empty()) Thread::sleep(50);
+	Thread::sleep(20);
+	_queue.wakeUpAll();
+	for (int i = 0; i < PRODUCER_COUNT; i++)
+	{
+		consumers[i].join();
+	}
+	assert (_consumed.value() == PRODUCER_COUNT*PRODUCER_NOTIFICATION_COUNT);
+}
+
+
+void LockFreeNotificationQueueTest::testWakeUpAll()
+{
+	RunnableAdapter<LockFreeNotificationQueueTest> ra(*this, &LockFreeNotificationQueueTest::work);
+	Thread t1;
+	Thread t2;
+	t1.start(ra);
+	t2.start(ra);
+	Thread::sleep(200);
+	assert (_queue.hasIdleThreads());
+	_queue.wakeUpAll();
+	t1.join();
+	t2.join();
+	assert (!_queue.hasIdleThreads());
+	assert (_handled.empty());
+}
+
+
+void LockFreeNotificationQueueTest::setUp()
+{
+	_handled.clear();
+	_queue.clear();
+	_consumed = 0;
+}
+
+
+void LockFreeNotificationQueueTest::tearDown()
+{
+}
+
+
+void LockFreeNotificationQueueTest::work()
+{
+	Poco::Random rnd;
+	Thread::sleep(50);
+	Notification* pNf = _queue.waitDequeueNotification();
+	while (pNf)
+	{
+		pNf->release();
+		_mutex.lock();
+		_handled.insert(Thread::current()->name());
+		_mutex.unlock();
+		Thread::sleep(rnd.next(5));
+		pNf = _queue.waitDequeueNotification();
+	}
+}
+
+
+void LockFreeNotificationQueueTest::produce()
+{
+	for (int i = 0; i < PRODUCER_NOTIFICATION_COUNT; ++i)
+	{
+		while (!_queue.tryEnqueueNotification(new Notification)) Thread::yield();
+	}
+}
+
+
+void LockFreeNotificationQueueTest::consume()
+{
+	Notification* pNf = _queue.waitDequeueNotification();
+	while (pNf)
+	{
+		pNf->release();
+		++_consumed;
+		pNf = _queue.waitDequeueNotification();
+	}
+}
+
+
+CppUnit::Test* LockFreeNotificationQueueTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("LockFreeNotificationQueueTest");
+
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testQueueDequeue);
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testCapacity);
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testWaitDequeue);
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testThreads);
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testProducersConsumers);
+	CppUnit_addTest(pSuite, LockFreeNotificationQueueTest, testWakeUpAll);
+
+	return pSuite;
+}
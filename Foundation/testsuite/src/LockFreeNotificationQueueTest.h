@@ -0,0 +1,58 @@
+//
+// LockFreeNotificationQueueTest.h
+//
+// $Id$
+//
+// Definition of the LockFreeNotificationQueueTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef LockFreeNotificationQueueTest_INCLUDED
+#define LockFreeNotificationQueueTest_INCLUDED
+
+
+#include "Poco/Foundation.h"
+#include "Poco/CppUnit/TestCase.h"
+#include "Poco/LockFreeNotificationQueue.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include <set>
+
+
+class LockFreeNotificationQueueTest: public CppUnit::TestCase
+{
+public:
+	LockFreeNotificationQueueTest(const std::string& name);
+	~LockFreeNotificationQueueTest();
+
+	void testQueueDequeue();
+	void testCapacity();
+	void testWaitDequeue();
+	void testThreads();
+	void testProducersConsumers();
+	void testWakeUpAll();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+protected:
+	void work();
+	void produce();
+	void consume();
+
+private:
+	Poco::LockFreeNotificationQueue _queue;
+	std::multiset<std::string>      _handled;
+	Poco::FastMutex                 _mutex;
+	Poco::AtomicCounter             _consumed;
+};
+
+
+#endif // LockFreeNotificationQueueTest_INCLUDED
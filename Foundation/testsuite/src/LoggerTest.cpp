@@ -16,6 +16,7 @@
 #include "Poco/Logger.h"
 #include "Poco/AutoPtr.h"
 #include "TestChannel.h"
+#include <cstring>
 
 
 using Poco::Logger;
@@ -24,6 +25,40 @@ using Poco::Message;
 using Poco::AutoPtr;
 
 
+namespace
+{
+	class RecursiveChannel: public Channel
+		/// Logs a deferred message to another logger for
+		/// every message received.
+	{
+	public:
+		RecursiveChannel(Logger& logger): _logger(logger)
+		{
+		}
+
+		void log(const Message& msg)
+		{
+			_logger.logDeferred(Message::PRIO_ERROR, 0, 0, "forwarded: %s", msg.getText());
+			_text = msg.getText();
+		}
+
+		const std::string& text() const
+		{
+			return _text;
+		}
+
+	private:
+		Logger& _logger;
+		std::string _text;
+	};
+
+	int evaluate(int& count)
+	{
+		return ++count;
+	}
+}
+
+
 LoggerTest::LoggerTest(const std::string& rName): CppUnit::TestCase(rName)
 {
 }
@@ -291,6 +326,91 @@ void LoggerTest::testDump()
 }
 
 
+void LoggerTest::testLogDeferred()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	Logger& root = Logger::root();
+	root.setChannel(pChannel.get());
+	root.setLevel(Message::PRIO_WARNING);
+
+	int count = 0;
+	poco_information_df1(root, "%d", evaluate(count));
+	root.logDeferred(Message::PRIO_INFORMATION, __FILE__, __LINE__, "%d", 42);
+	assert (pChannel->list().empty());
+	assert (count == 0);
+
+	std::string str("string");
+	poco_warning_df4(root, "%d %s %s %.1f", evaluate(count), str, "literal", 1.5);
+	int line = __LINE__ - 1;
+	assert (count == 1);
+	str = "changed";
+	assert (pChannel->list().size() == 1);
+
+	const Message& msg = pChannel->list().front();
+	assert (msg.hasDeferredText());
+	assert (msg.getSource() == "");
+	assert (msg.getPriority() == Message::PRIO_WARNING);
+	assert (std::strcmp(msg.getSourceFile(), __FILE__) == 0);
+	assert (msg.getSourceLine() == line);
+
+	Message copy(msg);
+	Message swapped;
+	swapped.swap(copy);
+	assert (swapped.getText() == "1 string literal 1.5");
+	assert (!swapped.hasDeferredText());
+	assert (msg.hasDeferredText());
+	assert (msg.getText() == "1 string literal 1.5");
+	assert (!msg.hasDeferredText());
+
+	Message assigned;
+	assigned = pChannel->getLastMessage();
+	assert (assigned.getText() == "1 string literal 1.5");
+
+	pChannel->clear();
+	root.logDeferred(Message::PRIO_ERROR, 0, 0, "%d%d%d%d%d%d", 1, 2, 3, 4, 5, 6);
+	assert (pChannel->list().front().getSourceFile() == 0);
+	assert (pChannel->list().front().getText() == "123456");
+
+	Message changed(pChannel->list().front(), "text");
+	assert (!changed.hasDeferredText());
+	assert (changed.getText() == "text");
+	changed.setDeferredText("%s") = "invalid";
+	try
+	{
+		changed.getText();
+		fail("invalid arguments - must throw");
+	}
+	catch (Poco::DataFormatException&)
+	{
+	}
+	changed.setText("text");
+	assert (changed.getText() == "text");
+}
+
+
+void LoggerTest::testLogDeferredRecursive()
+{
+	AutoPtr<TestChannel> pChannel = new TestChannel;
+	Logger& logger1 = Logger::get("Logger1");
+	logger1.setChannel(pChannel.get());
+	logger1.setLevel(Message::PRIO_INFORMATION);
+	AutoPtr<RecursiveChannel> pRecursiveChannel = new RecursiveChannel(logger1);
+	Logger& logger2 = Logger::get("Logger2");
+	logger2.setChannel(pRecursiveChannel.get());
+	logger2.setLevel(Message::PRIO_INFORMATION);
+
+	logger2.logDeferred(Message::PRIO_INFORMATION, 0, 0, "message %d", 1);
+	assert (pRecursiveChannel->text() == "message 1");
+	assert (pChannel->list().size() == 1);
+	assert (pChannel->getLastMessage().getSource() == "Logger1");
+	assert (pChannel->getLastMessage().getText() == "forwarded: message 1");
+
+	logger2.logDeferred(Message::PRIO_INFORMATION, 0, 0, "message %d", 2);
+	assert (pRecursiveChannel->text() == "message 2");
+	assert (pChannel->getLastMessage().getText() == "forwarded: message 2");
+}
+
+
 void LoggerTest::setUp()
 {
 	Logger::shutdown();
@@ -310,6 +430,8 @@ CppUnit::Test* LoggerTest::suite()
 	CppUnit_addTest(pSuite, LoggerTest, testFormat);
 	CppUnit_addTest(pSuite, LoggerTest, testFormatAny);
 	CppUnit_addTest(pSuite, LoggerTest, testDump);
+	CppUnit_addTest(pSuite, LoggerTest, testLogDeferred);
+	CppUnit_addTest(pSuite, LoggerTest, testLogDeferredRecursive);
 
 	return pSuite;
 }
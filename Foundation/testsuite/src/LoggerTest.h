@@ -30,6 +30,8 @@ public:
 	void testFormat();
 	void testFormatAny();
 	void testDump();
+	void testLogDeferred();
+	void testLogDeferredRecursive();
 
 	void setUp();
 	void tearDown();
@@ -19,6 +19,7 @@
 #include "LoggingFactoryTest.h"
 #include "LoggingRegistryTest.h"
 #include "LogStreamTest.h"
+#include "BinaryLogChannelTest.h"
 
 
 CppUnit::Test* LoggingTestSuite::suite()
@@ -33,6 +34,7 @@ CppUnit::Test* LoggingTestSuite::suite()
 	pSuite->addTest(LoggingFactoryTest::suite());
 	pSuite->addTest(LoggingRegistryTest::suite());
 	pSuite->addTest(LogStreamTest::suite());
+	pSuite->addTest(BinaryLogChannelTest::suite());
 
 	return pSuite;
 }
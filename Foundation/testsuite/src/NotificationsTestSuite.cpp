@@ -15,6 +15,7 @@
 #include "NotificationQueueTest.h"
 #include "PriorityNotificationQueueTest.h"
 #include "TimedNotificationQueueTest.h"
+#include "LockFreeNotificationQueueTest.h"
 
 
 CppUnit::Test* NotificationsTestSuite::suite()
@@ -25,6 +26,7 @@ CppUnit::Test* NotificationsTestSuite::suite()
 	pSuite->addTest(NotificationQueueTest::suite());
 	pSuite->addTest(PriorityNotificationQueueTest::suite());
 	pSuite->addTest(TimedNotificationQueueTest::suite());
+	pSuite->addTest(LockFreeNotificationQueueTest::suite());
 
 	return pSuite;
 }
@@ -16,11 +16,16 @@
 #include "Poco/PatternFormatter.h"
 #include "Poco/Message.h"
 #include "Poco/DateTime.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/Timezone.h"
 
 
 using Poco::PatternFormatter;
 using Poco::Message;
 using Poco::DateTime;
+using Poco::DateTimeFormatter;
+using Poco::Timezone;
+using Poco::Timestamp;
 
 
 PatternFormatterTest::PatternFormatterTest(const std::string& rName): CppUnit::TestCase(rName)
@@ -111,6 +116,88 @@ void PatternFormatterTest::testPatternFormatter()
 }
 
 
+void PatternFormatterTest::testCachedDateTime()
+{
+	Message msg;
+	msg.setText("Text");
+	msg.setPriority(Message::PRIO_INFORMATION);
+	PatternFormatter fmt("%Y-%m-%d %H:%M:%S.%i %w %p: %t");
+
+	std::string result;
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 500).timestamp());
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:15.500 Sat Information: Text");
+
+	result.clear();
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 750, 25).timestamp());
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:15.750 Sat Information: Text");
+
+	result.clear();
+	msg.setTime(DateTime(2005, 1, 1, 23, 59, 59, 999).timestamp());
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 23:59:59.999 Sat Information: Text");
+
+	result.clear();
+	msg.setTime(DateTime(2005, 1, 2, 0, 0, 0, 1).timestamp());
+	fmt.format(msg, result);
+	assert (result == "2005-01-02 00:00:00.001 Sun Information: Text");
+
+	result.clear();
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 100).timestamp());
+	fmt.format(msg, result);
+	assert (result == "2005-01-01 14:30:15.100 Sat Information: Text");
+
+	result.clear();
+	fmt.setProperty("pattern", "%S.%F %c");
+	fmt.format(msg, result);
+	assert (result == "15.100000 1");
+
+	result.clear();
+	msg.setTime(DateTime(2005, 1, 1, 14, 30, 15, 123, 456).timestamp());
+	fmt.format(msg, result);
+	assert (result == "15.123456 1");
+
+	result.clear();
+	fmt.setProperty("pattern", "[%p] %t (%E)");
+	fmt.format(msg, result);
+	assert (result == "[Information] Text (1104589815)");
+
+	result.clear();
+	fmt.setProperty("pattern", "%z %Z");
+	fmt.format(msg, result);
+	assert (result == "Z GMT");
+}
+
+
+void PatternFormatterTest::testLocalTime()
+{
+	Message msg;
+	msg.setText("Text");
+	msg.setPriority(Message::PRIO_INFORMATION);
+	msg.setTime(DateTime(2005, 7, 1, 14, 30, 15, 500).timestamp());
+
+	DateTime local(msg.getTime() + Timezone::tzd()*Timestamp::resolution());
+	std::string expected = DateTimeFormatter::format(local, "%H:%M:%S.%i ") + DateTimeFormatter::tzdISO(Timezone::tzd()) + " Text";
+
+	PatternFormatter fmt("%H:%M:%S.%i %z %t");
+	fmt.setProperty("times", "local");
+	std::string result;
+	fmt.format(msg, result);
+	assert (result == expected);
+
+	result.clear();
+	fmt.setProperty("times", "UTC");
+	fmt.format(msg, result);
+	assert (result == "14:30:15.500 Z Text");
+
+	result.clear();
+	fmt.setProperty("pattern", "%H:%M:%S.%i %z %t %L%H:%M:%S.%i %z %t");
+	fmt.format(msg, result);
+	assert (result == "14:30:15.500 Z Text " + expected);
+}
+
+
 void PatternFormatterTest::setUp()
 {
 }
@@ -126,6 +213,8 @@ CppUnit::Test* PatternFormatterTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PatternFormatterTest");
 
 	CppUnit_addTest(pSuite, PatternFormatterTest, testPatternFormatter);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testCachedDateTime);
+	CppUnit_addTest(pSuite, PatternFormatterTest, testLocalTime);
 
 	return pSuite;
 }
@@ -27,6 +27,8 @@ public:
 	~PatternFormatterTest();
 
 	void testPatternFormatter();
+	void testCachedDateTime();
+	void testLocalTime();
 
 	void setUp();
 	void tearDown();
@@ -34,7 +34,8 @@ class Net_API DNS
 	/// This class provides an interface to the
 	/// domain name service.
 	///
-	/// An internal DNS cache is used to speed up name lookups.
+	/// Lookups are performed synchronously and are not cached.
+	/// For asynchronous lookups with caching, see DNSResolver.
 {
 public:
 	enum HintFlag
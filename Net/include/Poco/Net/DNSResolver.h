@@ -0,0 +1,226 @@
+//
+// DNSResolver.h
+//
+// $Id$
+//
+// Library: Net
+// Package: NetCore
+// Module:  DNSResolver
+//
+// Definition of the DNSResolver class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_DNSResolver_INCLUDED
+#define Net_DNSResolver_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/ActiveResult.h"
+#include "Poco/UniqueExpireLRUCache.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/ThreadPool.h"
+#include "Poco/Runnable.h"
+#include "Poco/Exception.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+#include <vector>
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API DNSResolver: private Poco::Runnable
+	/// DNSResolver resolves host names asynchronously, using a
+	/// fixed number of worker threads that call DNS::hostByName(),
+	/// and caches the results.
+	///
+	/// A lookup can be started with resolveAsync(), which either
+	/// returns a Poco::ActiveResult (a future) for the HostEntry,
+	/// or calls a Callback when the lookup has completed. Concurrent
+	/// lookups for the same name are coalesced into a single query.
+	///
+	/// Successful lookups are cached for the positive TTL, failed
+	/// lookups for the (usually much shorter) negative TTL. Since
+	/// getaddrinfo() does not report the TTL of the DNS records,
+	/// the TTLs are configured for the resolver. A TTL of zero
+	/// disables caching of the respective results.
+	///
+	/// HTTPClientSession (see HTTPClientSession::setResolver()) and
+	/// SocketConnector can use a DNSResolver to resolve the server's
+	/// host name.
+{
+public:
+	typedef Poco::ActiveResult<HostEntry> Result;
+
+	class Net_API Callback
+		/// The interface for receiving the result of
+		/// an asynchronous lookup.
+	{
+	public:
+		virtual ~Callback();
+			/// Destroys the Callback.
+
+		virtual void onResolved(const std::string& name, const HostEntry& entry) = 0;
+			/// Called when the given host name has been resolved.
+
+		virtual void onResolveError(const std::string& name, const Poco::Exception& exc) = 0;
+			/// Called when the given host name cannot be resolved.
+	};
+
+	enum
+	{
+		DEFAULT_THREADS = 4,
+		DEFAULT_CACHE_SIZE = 1024,
+		DEFAULT_POSITIVE_TTL = 300,
+			/// The default time in seconds for caching resolved names.
+		DEFAULT_NEGATIVE_TTL = 10
+			/// The default time in seconds for caching lookup failures.
+	};
+
+	DNSResolver(int threads = DEFAULT_THREADS, long cacheSize = DEFAULT_CACHE_SIZE);
+		/// Creates the DNSResolver, using the given number of worker
+		/// threads. At most cacheSize names are cached; when the cache
+		/// is full, the least recently used entry is removed.
+
+	~DNSResolver();
+		/// Stops the worker threads and destroys the DNSResolver.
+		///
+		/// Lookups that have not been completed fail
+		/// with a Poco::Net::DNSException.
+
+	HostEntry resolve(const std::string& name);
+		/// Returns the HostEntry for the given host name, from the
+		/// cache if possible. Otherwise, waits for the lookup to complete.
+		///
+		/// Throws the exception thrown by DNS::hostByName() if the
+		/// lookup fails, or a NoAddressFoundException if no address
+		/// has been found for the name.
+
+	SocketAddress resolveAddress(const std::string& host, Poco::UInt16 port);
+		/// Returns a SocketAddress for the first address of the given
+		/// host and the given port. If host is an IP address, no lookup
+		/// is performed.
+		///
+		/// Throws the same exceptions as resolve().
+
+	Result resolveAsync(const std::string& name);
+		/// Starts a lookup of the given host name and returns a
+		/// Poco::ActiveResult for the HostEntry. If the name is
+		/// cached, the returned result is already available.
+
+	void resolveAsync(const std::string& name, Callback& callback);
+		/// Starts a lookup of the given host name and calls the
+		/// given Callback when the lookup has completed.
+		///
+		/// If the name is cached, the callback is called immediately,
+		/// from the calling thread. Otherwise, the callback is called
+		/// from one of the resolver's worker threads.
+		///
+		/// The Callback object must remain valid until it has been
+		/// called, or until cancel() has been called for it.
+
+	void cancel(Callback& callback);
+		/// Removes the given Callback from all pending lookups.
+		///
+		/// When cancel() returns, the Callback will no longer be
+		/// called, even if the lookup completes concurrently.
+
+	void setPositiveTTL(const Poco::Timespan& ttl);
+		/// Sets the time successful lookups are cached.
+
+	Poco::Timespan getPositiveTTL() const;
+		/// Returns the time successful lookups are cached.
+
+	void setNegativeTTL(const Poco::Timespan& ttl);
+		/// Sets the time failed lookups are cached.
+
+	Poco::Timespan getNegativeTTL() const;
+		/// Returns the time failed lookups are cached.
+
+	void flushCache();
+		/// Removes all entries from the cache.
+
+	Poco::UInt64 cacheHits() const;
+		/// Returns the number of lookups answered from the cache.
+
+	Poco::UInt64 cacheMisses() const;
+		/// Returns the number of lookups that were not
+		/// answered from the cache.
+
+	static DNSResolver& defaultResolver();
+		/// Returns a reference to the default DNSResolver.
+
+protected:
+	void run();
+		/// The worker threads' main loop.
+
+	void lookup(const std::string& key);
+		/// Resolves the given name, caches the result and
+		/// completes the pending lookup for the name.
+
+private:
+	class CacheEntry
+	{
+	public:
+		CacheEntry(const HostEntry& entry, const Poco::Timespan& ttl);
+		CacheEntry(const Poco::Exception& exc, const Poco::Timespan& ttl);
+
+		const HostEntry& entry() const;
+		const Poco::Exception* exception() const;
+		const Poco::Timestamp& getExpiration() const;
+
+	private:
+		HostEntry _entry;
+		Poco::SharedPtr<Poco::Exception> _pException;
+		Poco::Timestamp _expiration;
+	};
+
+	struct PendingLookup
+	{
+		Result result;
+		std::vector<Callback*> callbacks;
+
+		PendingLookup();
+	};
+
+	typedef Poco::UniqueExpireLRUCache<std::string, CacheEntry> Cache;
+	typedef std::map<std::string, PendingLookup*> PendingMap;
+
+	DNSResolver(const DNSResolver&);
+	DNSResolver& operator = (const DNSResolver&);
+
+	PendingLookup* startLookup(const std::string& key);
+	static void complete(Result& result, const CacheEntry& entry);
+	static void notify(Callback& callback, const std::string& name, const CacheEntry& entry);
+	static std::string key(const std::string& name);
+
+	Cache                   _cache;
+	PendingMap              _pending;
+	Poco::NotificationQueue _queue;
+	Poco::ThreadPool        _threadPool;
+	Poco::Timespan          _positiveTTL;
+	Poco::Timespan          _negativeTTL;
+	Poco::UInt64            _hits;
+	Poco::UInt64            _misses;
+	bool                    _stopped;
+	mutable Poco::FastMutex _mutex;
+	Poco::Mutex             _callbackMutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_DNSResolver_INCLUDED
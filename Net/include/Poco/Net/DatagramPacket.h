@@ -0,0 +1,84 @@
+//
+// DatagramPacket.h
+//
+// $Id$
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramPacket
+//
+// Definition of the DatagramPacket class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_DatagramPacket_INCLUDED
+#define Net_DatagramPacket_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API DatagramPacket
+	/// A DatagramPacket describes a single datagram for
+	/// DatagramSocket::sendBatch() and DatagramSocket::receiveBatch(),
+	/// which transfer multiple datagrams with a single system call
+	/// where supported.
+	///
+	/// The packet does not own its buffer.
+{
+public:
+	DatagramPacket();
+		/// Creates an empty DatagramPacket.
+
+	DatagramPacket(void* buffer, int length);
+		/// Creates a DatagramPacket for receiving a datagram
+		/// of up to length bytes into the given buffer.
+
+	DatagramPacket(const void* buffer, int length, const SocketAddress& address);
+		/// Creates a DatagramPacket for sending length bytes
+		/// from the given buffer to the given address.
+
+	~DatagramPacket();
+		/// Destroys the DatagramPacket.
+
+	void*           buffer;
+		/// The datagram's data.
+	int             length;
+		/// When sending, the number of bytes to send.
+		/// When receiving, the size of the buffer.
+	int             received;
+		/// The number of bytes received.
+	bool            truncated;
+		/// Set when receiving if the datagram was larger than
+		/// the buffer, and has been truncated.
+	SocketAddress   address;
+		/// When sending, the destination address.
+		/// When receiving, the address of the sender.
+	Poco::Timestamp timestamp;
+		/// The time the kernel received the datagram, if receive
+		/// timestamps have been enabled with
+		/// DatagramSocket::setReceiveTimestamps(). Otherwise,
+		/// or if the platform does not support receive timestamps,
+		/// the timestamp is 0.
+};
+
+
+typedef std::vector<DatagramPacket> DatagramPacketVec;
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_DatagramPacket_INCLUDED
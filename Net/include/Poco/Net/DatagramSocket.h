@@ -22,6 +22,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/DatagramPacket.h"
 
 
 namespace Poco {
@@ -130,6 +131,30 @@ public:
 		///
 		/// Returns the number of bytes received.
 
+	int sendBatch(const DatagramPacketVec& packets, int flags = 0);
+		/// Sends the given datagrams, each to the address given
+		/// in its DatagramPacket. Where supported (Linux), up to
+		/// SocketImpl::MAX_BATCH_SIZE datagrams are sent with a
+		/// single system call.
+		///
+		/// Returns the number of datagrams sent, which may be
+		/// less than the number of packets given.
+
+	int receiveBatch(DatagramPacketVec& packets, int flags = 0);
+		/// Receives up to packets.size() datagrams into the buffers
+		/// given by the packets. Waits for the first datagram only;
+		/// any further datagrams are received only if they are
+		/// already available. Where supported (Linux), up to
+		/// SocketImpl::MAX_BATCH_SIZE datagrams are received with
+		/// a single system call.
+		///
+		/// For every datagram received, the number of bytes received,
+		/// the address of the sender and, if enabled with
+		/// setReceiveTimestamps(), the kernel receive timestamp
+		/// are stored in its packet.
+		///
+		/// Returns the number of datagrams received.
+
 	void setBroadcast(bool flag);
 		/// Sets the value of the SO_BROADCAST socket option.
 		///
@@ -139,6 +164,16 @@ public:
 	bool getBroadcast() const;
 		/// Returns the value of the SO_BROADCAST socket option.
 
+	void setReceiveTimestamps(bool flag);
+		/// Enables or disables kernel receive timestamps
+		/// for receiveBatch().
+		///
+		/// Throws a Poco::NotImplementedException if the
+		/// platform does not support receive timestamps.
+
+	bool getReceiveTimestamps() const;
+		/// Returns true if kernel receive timestamps are enabled.
+
 protected:
 	DatagramSocket(SocketImpl* pImpl);
 		/// Creates the Socket and attaches the given SocketImpl.
@@ -164,6 +199,18 @@ inline bool DatagramSocket::getBroadcast() const
 }
 
 
+inline void DatagramSocket::setReceiveTimestamps(bool flag)
+{
+	impl()->setReceiveTimestamps(flag);
+}
+
+
+inline bool DatagramSocket::getReceiveTimestamps() const
+{
+	return impl()->getReceiveTimestamps();
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -31,18 +31,63 @@ namespace Net {
 
 class Net_API HTTPBufferAllocator
 	/// A BufferAllocator for HTTP streams.
+	///
+	/// Buffers of the current buffer size (see setBufferSize())
+	/// are taken from a process-wide Poco::MemoryPool. To keep
+	/// threads from contending for the pool's mutex, up to
+	/// CACHE_SIZE free buffers are kept in each of CACHE_COUNT
+	/// caches in front of the pool. Every thread uses the cache
+	/// selected by its thread ID.
+	///
+	/// Buffers of other sizes are allocated from the heap.
 {
 public:
+	struct Statistics
+		/// Allocation counters, summed over all caches.
+	{
+		Poco::UInt64 allocations;     /// Number of buffers allocated.
+		Poco::UInt64 deallocations;   /// Number of buffers released.
+		Poco::UInt64 cacheHits;       /// Number of buffers taken from a cache.
+		Poco::UInt64 poolAllocations; /// Number of buffers taken from the MemoryPool.
+		Poco::UInt64 heapAllocations; /// Number of buffers not matching the buffer size.
+	};
+
 	static char* allocate(std::streamsize size);
+		/// Allocates a buffer of the given size.
+
 	static void deallocate(char* ptr, std::streamsize size);
+		/// Releases a buffer of the given size
+		/// obtained from allocate().
+
+	static void setBufferSize(std::streamsize size);
+		/// Sets the size of the buffers used by HTTPSession
+		/// and the HTTP streams. Larger buffers (e.g., 16 KB)
+		/// reduce the number of system calls when large
+		/// request or response bodies are transferred.
+		///
+		/// Only affects sessions and streams created afterwards.
+		/// If the size changes, all free buffers of the previous
+		/// size are freed.
+
+	static std::streamsize getBufferSize();
+		/// Returns the size of the buffers used by HTTPSession
+		/// and the HTTP streams. The default is BUFFER_SIZE.
+
+	static Statistics statistics();
+		/// Returns the allocation counters.
+
+	static void resetStatistics();
+		/// Resets all allocation counters to zero.
 
 	enum
 	{
-		BUFFER_SIZE = 4096
+		BUFFER_SIZE = 4096,
+			/// The default buffer size.
+		CACHE_COUNT = 16,
+			/// The number of buffer caches.
+		CACHE_SIZE  = 32
+			/// The maximum number of free buffers in each cache.
 	};
-
-private:
-	static Poco::MemoryPool _pool;
 };
 
 
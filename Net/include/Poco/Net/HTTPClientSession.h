@@ -34,6 +34,7 @@ namespace Net {
 
 class HTTPRequest;
 class HTTPResponse;
+class DNSResolver;
 
 
 class Net_API HTTPClientSession: public HTTPSession
@@ -182,6 +183,25 @@ public:
 		
 	const Poco::Timespan& getKeepAliveTimeout() const;
 		/// Returns the connection timeout for HTTP connections.
+
+	void setResolver(DNSResolver* pResolver);
+		/// Sets the DNSResolver used for resolving the host name
+		/// of the server (or proxy server) when connecting.
+		///
+		/// The DNSResolver caches the addresses it has resolved,
+		/// so reconnecting to the same server, or connecting with
+		/// another HTTPClientSession using the same DNSResolver,
+		/// does not require a new DNS lookup.
+		///
+		/// If no DNSResolver has been set (the default), or if a null
+		/// pointer is given, the host name is resolved by SocketAddress
+		/// with every connection attempt.
+		///
+		/// The DNSResolver must outlive the HTTPClientSession.
+
+	DNSResolver* getResolver() const;
+		/// Returns the DNSResolver set with setResolver(),
+		/// or a null pointer if none has been set.
 		
 	virtual std::ostream& sendRequest(HTTPRequest& request);
 		/// Sends the header for the given HTTP request to
@@ -310,6 +330,7 @@ private:
 	bool            _mustReconnect;
 	bool            _expectResponseBody;
 	bool            _responseReceived;
+	DNSResolver*    _pResolver;
 	Poco::SharedPtr<std::ostream> _pRequestStream;
 	Poco::SharedPtr<std::istream> _pResponseStream;
 
@@ -379,6 +400,12 @@ inline const Poco::Timespan& HTTPClientSession::getKeepAliveTimeout() const
 }
 
 
+inline DNSResolver* HTTPClientSession::getResolver() const
+{
+	return _pResolver;
+}
+
+
 } } // namespace Poco::Net
 
 
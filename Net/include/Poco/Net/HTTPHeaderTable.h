@@ -0,0 +1,267 @@
+//
+// HTTPHeaderTable.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTP
+// Module:  HTTPHeaderTable
+//
+// Definition of the HTTPHeaderTable class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPHeaderTable_INCLUDED
+#define Net_HTTPHeaderTable_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Buffer.h"
+#include <vector>
+#include <string>
+#include <cstddef>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPHeaderTable
+	/// A flat table containing the request line and the
+	/// header fields of a HTTP request.
+	///
+	/// The raw header is collected in an arena owned by the
+	/// table, by passing the received data to feed(). After
+	/// the complete header has been received, parseRequest()
+	/// splits it into the request line and the header fields.
+	/// Names and values are stored as references (Slice) into the
+	/// arena, so parsing a header neither copies the individual
+	/// names and values, nor does it allocate memory for them.
+	/// Lookups with find() and has() are case-insensitive and
+	/// do not allocate memory either.
+	///
+	/// The arena and the field table keep their memory when
+	/// reset() is called, so a table can be reused for all
+	/// requests received over a persistent connection.
+	///
+	/// The same sanity checks as in HTTPRequest::read() and
+	/// MessageHeader::read() are performed. In addition, the
+	/// size of the complete header is limited to the sum of
+	/// the maximum lengths of the request line and of all
+	/// header fields.
+{
+public:
+	struct Slice
+		/// A reference to a range of characters in the arena.
+	{
+		const char* data;
+		std::size_t length;
+	};
+
+	struct Field
+		/// A header field.
+	{
+		Slice name;
+		Slice value;
+	};
+
+	HTTPHeaderTable();
+		/// Creates an empty HTTPHeaderTable.
+
+	~HTTPHeaderTable();
+		/// Destroys the HTTPHeaderTable.
+
+	void reset();
+		/// Removes all data from the table, so that it can
+		/// be used for the next request.
+
+	std::size_t feed(const char* buffer, std::size_t length);
+		/// Appends the given data to the arena, up to and including
+		/// the empty line terminating the header.
+		///
+		/// Returns the number of bytes consumed from buffer. If this is
+		/// less than length, the remaining bytes belong to the
+		/// message body (or to the next request).
+		///
+		/// Whitespace preceding the request line is skipped.
+		///
+		/// Throws a MessageException if the header is too large.
+
+	bool complete() const;
+		/// Returns true iff the empty line terminating the
+		/// header has been received.
+
+	bool empty() const;
+		/// Returns true iff no header data has been received.
+
+	void parseRequest();
+		/// Parses the request line and the header fields
+		/// collected with feed().
+		///
+		/// Can also be called if the header is not complete,
+		/// because the peer has closed the connection. In this
+		/// case, the available data is parsed as far as possible,
+		/// just like HTTPRequest::read() would do.
+		///
+		/// Throws a NoMessageException if no data has been received,
+		/// or a MessageException if the header is malformed or
+		/// exceeds one of the limits.
+		///
+		/// Note that the arena may be modified in the process, as
+		/// folded field values are joined in place.
+
+	const Slice& method() const;
+		/// Returns the request method.
+
+	const Slice& uri() const;
+		/// Returns the request URI.
+
+	const Slice& version() const;
+		/// Returns the HTTP version string.
+
+	int count() const;
+		/// Returns the number of header fields.
+
+	const Field& operator [] (int index) const;
+		/// Returns the header field with the given index.
+
+	const Slice* find(const char* name, std::size_t length) const;
+		/// Returns the value of the first header field with the
+		/// given name (compared case-insensitively), or a null
+		/// pointer if no such field exists.
+
+	const Slice* find(const std::string& name) const;
+		/// Returns the value of the first header field with the
+		/// given name (compared case-insensitively), or a null
+		/// pointer if no such field exists.
+
+	bool has(const std::string& name) const;
+		/// Returns true iff the table contains a header field
+		/// with the given name.
+
+	int getFieldLimit() const;
+		/// Returns the maximum number of header fields
+		/// allowed.
+
+	void setFieldLimit(int limit);
+		/// Sets the maximum number of header fields
+		/// allowed. Specify 0 for unlimited (not recommended).
+		///
+		/// The default limit is 100, the same as
+		/// for MessageHeader.
+
+	static std::string toString(const Slice& slice);
+		/// Returns a std::string containing a copy of the
+		/// characters referenced by slice.
+
+	static bool equals(const Slice& slice, const char* str, std::size_t length);
+		/// Returns true iff slice and str are equal,
+		/// ignoring case.
+
+	enum Limits
+		/// Limits for basic sanity checks, the same as
+		/// used by HTTPRequest and MessageHeader.
+	{
+		MAX_METHOD_LENGTH  = 32,
+		MAX_URI_LENGTH     = 16384,
+		MAX_VERSION_LENGTH = 8,
+		MAX_NAME_LENGTH    = 256,
+		MAX_VALUE_LENGTH   = 8192,
+		DFL_FIELD_LIMIT    = 100
+	};
+
+private:
+	HTTPHeaderTable(const HTTPHeaderTable&);
+	HTTPHeaderTable& operator = (const HTTPHeaderTable&);
+
+	std::size_t maxSize() const;
+
+	Poco::Buffer<char> _arena;
+	std::size_t        _lineStart;
+	bool               _complete;
+	Slice              _method;
+	Slice              _uri;
+	Slice              _version;
+	std::vector<Field> _fields;
+	int                _fieldLimit;
+};
+
+
+//
+// inlines
+//
+inline bool HTTPHeaderTable::complete() const
+{
+	return _complete;
+}
+
+
+inline bool HTTPHeaderTable::empty() const
+{
+	return _arena.size() == 0;
+}
+
+
+inline const HTTPHeaderTable::Slice& HTTPHeaderTable::method() const
+{
+	return _method;
+}
+
+
+inline const HTTPHeaderTable::Slice& HTTPHeaderTable::uri() const
+{
+	return _uri;
+}
+
+
+inline const HTTPHeaderTable::Slice& HTTPHeaderTable::version() const
+{
+	return _version;
+}
+
+
+inline int HTTPHeaderTable::count() const
+{
+	return static_cast<int>(_fields.size());
+}
+
+
+inline const HTTPHeaderTable::Field& HTTPHeaderTable::operator [] (int index) const
+{
+	return _fields[index];
+}
+
+
+inline const HTTPHeaderTable::Slice* HTTPHeaderTable::find(const std::string& name) const
+{
+	return find(name.data(), name.size());
+}
+
+
+inline bool HTTPHeaderTable::has(const std::string& name) const
+{
+	return find(name.data(), name.size()) != 0;
+}
+
+
+inline int HTTPHeaderTable::getFieldLimit() const
+{
+	return _fieldLimit;
+}
+
+
+inline std::string HTTPHeaderTable::toString(const Slice& slice)
+{
+	return std::string(slice.data, slice.length);
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPHeaderTable_INCLUDED
@@ -0,0 +1,143 @@
+//
+// HTTPReactorConnection.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorConnection
+//
+// Definition of the HTTPReactorConnection class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPReactorConnection_INCLUDED
+#define Net_HTTPReactorConnection_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Buffer.h"
+#include "Poco/Timestamp.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPReactorServer;
+class HTTPServerSession;
+class SocketReactor;
+class ReadableNotification;
+class ErrorNotification;
+class TimeoutNotification;
+class ShutdownNotification;
+
+
+class Net_API HTTPReactorConnection
+	/// This class handles a single HTTP connection for
+	/// HTTPReactorServer, and is used internally by it.
+	///
+	/// While waiting for a request, the connection is registered
+	/// with a SocketReactor, which notifies the connection whenever
+	/// data can be read. The connection reads the available data into
+	/// its buffer without blocking. Once the complete request (header
+	/// and body) has been received, the connection removes itself
+	/// from the reactor, and HTTPReactorServer passes it to a worker
+	/// thread, which handles the request with the HTTPRequestHandler
+	/// created by the HTTPRequestHandlerFactory.
+	///
+	/// A request is also passed to a worker thread if its header
+	/// has been received and
+	///   - the client expects a 100 Continue response before sending the body,
+	///   - the body is larger than MAX_BUFFERED_BODY, or
+	///   - the body is terminated by closing the connection.
+	/// In these cases, the worker thread reads the body from the socket.
+	///
+	/// The connection deletes itself when it is closed.
+{
+public:
+	enum
+	{
+		MAX_BUFFERED_BODY = 65536
+			/// Requests with a larger body are dispatched as soon
+			/// as their header has been received.
+	};
+
+	HTTPReactorConnection(HTTPReactorServer& server, const StreamSocket& socket, SocketReactor& reactor);
+		/// Creates the HTTPReactorConnection and registers it
+		/// with the given SocketReactor.
+
+	~HTTPReactorConnection();
+		/// Destroys the HTTPReactorConnection and closes the socket.
+
+	void handleRequests();
+		/// Handles the request(s) received so far, then either registers
+		/// the connection with its SocketReactor again, or closes the
+		/// connection and deletes it.
+		///
+		/// Called by HTTPReactorServer in a worker thread.
+
+	void close();
+		/// Closes the connection and deletes it.
+		///
+		/// Must only be called while the connection is not registered
+		/// with its SocketReactor, and not being handled by a
+		/// worker thread.
+
+	void onReadable(ReadableNotification* pNf);
+	void onError(ErrorNotification* pNf);
+	void onTimeout(TimeoutNotification* pNf);
+	void onShutdown(ShutdownNotification* pNf);
+
+protected:
+	bool handleRequest();
+		/// Handles a single request. Returns true if the
+		/// connection should be kept alive.
+
+	bool requestComplete();
+		/// Returns true if a complete request, or a request
+		/// that must be dispatched before its body has been
+		/// received, is in the buffer.
+
+	bool chunkedBodyComplete(const char* it, const char* end) const;
+		/// Returns true if the range contains a complete
+		/// chunked message body.
+
+	void sendErrorResponse(HTTPResponse::HTTPStatus status);
+	void registerHandlers();
+	void unregisterHandlers();
+	void resetRequest();
+
+private:
+	HTTPReactorConnection(const HTTPReactorConnection&);
+	HTTPReactorConnection& operator = (const HTTPReactorConnection&);
+
+	HTTPReactorServer&             _server;
+	SocketReactor&                 _reactor;
+	StreamSocket                   _socket;
+	HTTPServerParams::Ptr          _pParams;
+	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPServerSession*             _pSession;
+	Poco::Buffer<char>             _buffer;
+	std::size_t                    _headerLength;
+	std::size_t                    _requestLength;
+	bool                           _chunked;
+	Poco::Timestamp                _lastActivity;
+
+	friend class HTTPReactorServer;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPReactorConnection_INCLUDED
@@ -0,0 +1,201 @@
+//
+// HTTPReactorServer.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorServer
+//
+// Definition of the HTTPReactorServer class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPReactorServer_INCLUDED
+#define Net_HTTPReactorServer_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/ParallelSocketReactor.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/NotificationQueue.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "Poco/Mutex.h"
+#include "Poco/AtomicCounter.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+class HTTPReactorConnection;
+
+
+class Net_API HTTPReactorServer: public Poco::Runnable
+	/// HTTPReactorServer is an alternative to HTTPServer for
+	/// servers handling a large number of mostly idle persistent
+	/// connections.
+	///
+	/// HTTPServer dedicates a thread to every connection for as long
+	/// as the connection is open, including the time the connection
+	/// spends waiting for the next request. HTTPReactorServer instead
+	/// monitors idle connections with one or more SocketReactor
+	/// instances, each running in its own thread. Only once a complete
+	/// request has been received, the connection is handed over to one
+	/// of a fixed number of worker threads, which runs the
+	/// HTTPRequestHandler for the request. Afterwards, the connection
+	/// is returned to its SocketReactor. Thus, the number of threads
+	/// is independent of the number of open connections.
+	///
+	/// Request handlers written for HTTPServer can be used with
+	/// HTTPReactorServer without changes. Please see the
+	/// HTTPReactorConnection class for details on how requests
+	/// are received.
+	///
+	/// The following HTTPServerParams are supported:
+	///   - maxThreads: the number of worker threads (DEFAULT_WORKERS if 0),
+	///   - threadPriority: the priority of the worker threads,
+	///   - keepAlive, keepAliveTimeout and maxKeepAliveRequests,
+	///   - timeout (used when the worker thread has to read
+	///     the request body from the socket),
+	///   - pipelineDepth, fastHeaderParsing and softwareVersion.
+	/// The keep-alive timeout is enforced by the SocketReactor,
+	/// whenever it has been idle for its timeout (250 ms).
+	///
+	/// The ServerSocket must be bound and in listening state.
+{
+public:
+	enum
+	{
+		DEFAULT_WORKERS = 16
+	};
+
+	HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, Poco::UInt16 portNumber = 80, HTTPServerParams::Ptr pParams = new HTTPServerParams);
+		/// Creates HTTPReactorServer listening on the given port (default 80),
+		/// with one SocketReactor for every processor.
+
+	HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSocket& socket, HTTPServerParams::Ptr pParams, unsigned reactors = 0);
+		/// Creates the HTTPReactorServer, using the given ServerSocket and the
+		/// given number of SocketReactor threads for idle connections.
+		/// If reactors is 0, one SocketReactor for every processor is used.
+
+	~HTTPReactorServer();
+		/// Stops the server if it is still running, and destroys it.
+
+	void start();
+		/// Starts the server. The server starts accepting connections
+		/// and handling requests.
+
+	void stop();
+		/// Stops the server.
+		///
+		/// No new connections are accepted. Requests currently being
+		/// handled are allowed to complete, after which all client
+		/// connections are closed. Waits until all worker threads
+		/// have terminated.
+
+	int currentConnections() const;
+		/// Returns the number of currently open client connections.
+
+	const HTTPServerParams& params() const;
+		/// Returns a const reference to the HTTPServerParams
+		/// object used by the server.
+
+	HTTPRequestHandlerFactory::Ptr factory() const;
+		/// Returns the HTTPRequestHandlerFactory used by the server.
+
+	const ServerSocket& socket() const;
+		/// Returns the underlying server socket.
+
+	Poco::UInt16 port() const;
+		/// Returns the port the server socket listens on.
+
+protected:
+	void run();
+		/// The worker thread function.
+
+	void onAccept(ReadableNotification* pNf);
+		/// Accepts a new connection and assigns it to a SocketReactor.
+
+	void dispatch(HTTPReactorConnection* pConnection);
+		/// Passes a connection with a complete request to a worker thread.
+
+	bool resume(HTTPReactorConnection* pConnection);
+		/// Registers a connection with its SocketReactor again after
+		/// its requests have been handled, unless the server has been
+		/// stopped. Returns false if the server has been stopped.
+
+	void connectionOpened();
+	void connectionClosed();
+
+private:
+	typedef ParallelSocketReactor<SocketReactor> Reactor;
+	typedef std::vector<Reactor::Ptr> ReactorVec;
+	typedef std::vector<Poco::Thread*> ThreadVec;
+
+	HTTPReactorServer();
+	HTTPReactorServer(const HTTPReactorServer&);
+	HTTPReactorServer& operator = (const HTTPReactorServer&);
+
+	void init(unsigned reactors);
+
+	ServerSocket                   _socket;
+	HTTPRequestHandlerFactory::Ptr _pFactory;
+	HTTPServerParams::Ptr          _pParams;
+	SocketReactor                  _acceptReactor;
+	Poco::Thread                   _acceptThread;
+	unsigned                       _reactorCount;
+	ReactorVec                     _reactors;
+	std::size_t                    _nextReactor;
+	ThreadVec                      _workers;
+	Poco::NotificationQueue        _queue;
+	Poco::AtomicCounter            _connections;
+	bool                           _started;
+	bool                           _stopped;
+	Poco::FastMutex                _mutex;
+
+	friend class HTTPReactorConnection;
+};
+
+
+//
+// inlines
+//
+inline int HTTPReactorServer::currentConnections() const
+{
+	return _connections.value();
+}
+
+
+inline const HTTPServerParams& HTTPReactorServer::params() const
+{
+	return *_pParams;
+}
+
+
+inline HTTPRequestHandlerFactory::Ptr HTTPReactorServer::factory() const
+{
+	return _pFactory;
+}
+
+
+inline const ServerSocket& HTTPReactorServer::socket() const
+{
+	return _socket;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPReactorServer_INCLUDED
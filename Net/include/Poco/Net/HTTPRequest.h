@@ -28,6 +28,9 @@ namespace Poco {
 namespace Net {
 
 
+class HTTPHeaderTable;
+
+
 class Net_API HTTPRequest: public HTTPMessage
 	/// This class encapsulates an HTTP request
 	/// message.
@@ -135,6 +138,11 @@ public:
 	void read(std::istream& istr);
 		/// Reads the HTTP request from the
 		/// given input stream.
+
+	void read(const HTTPHeaderTable& table);
+		/// Sets the request line and header fields from
+		/// the given HTTPHeaderTable, which must have been
+		/// filled by HTTPHeaderTable::parseRequest().
 		
 	static const std::string HTTP_GET;
 	static const std::string HTTP_HEAD;
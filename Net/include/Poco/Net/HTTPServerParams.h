@@ -97,6 +97,41 @@ public:
 		/// during a persistent connection, or 0 if
 		/// unlimited connections are allowed.
 
+	void setFastHeaderParsing(bool fastHeaderParsing);
+		/// Enables or disables fast parsing of request headers.
+		///
+		/// If enabled, the request line and header of every request
+		/// are collected directly from the session's receive buffer
+		/// into an HTTPHeaderTable owned by the HTTPServerSession,
+		/// instead of being read character by character from a stream.
+		/// The header fields are still added to the HTTPServerRequest,
+		/// but can also be looked up without allocating memory
+		/// via HTTPServerSession::headerTable().
+		///
+		/// The default is false.
+
+	bool getFastHeaderParsing() const;
+		/// Returns true iff fast parsing of request headers
+		/// is enabled.
+
+	void setPipelineDepth(int pipelineDepth);
+		/// Sets the maximum number of pipelined requests whose
+		/// responses are collected and sent together.
+		///
+		/// If a client pipelines requests (sends a request before
+		/// it has received the response to the previous one), the
+		/// server handles the requests already received in order,
+		/// and sends their responses together once no further complete
+		/// request is waiting, or pipelineDepth responses have been
+		/// collected.
+		///
+		/// The default is 1, which sends every response
+		/// immediately.
+
+	int getPipelineDepth() const;
+		/// Returns the maximum number of pipelined requests whose
+		/// responses are collected and sent together.
+
 protected:
 	virtual ~HTTPServerParams();
 		/// Destroys the HTTPServerParams.
@@ -108,6 +143,8 @@ private:
 	bool           _keepAlive;
 	int            _maxKeepAliveRequests;
 	Poco::Timespan _keepAliveTimeout;
+	bool           _fastHeaderParsing;
+	int            _pipelineDepth;
 };
 
 
@@ -150,6 +187,18 @@ inline const Poco::Timespan& HTTPServerParams::getKeepAliveTimeout() const
 }
 
 
+inline bool HTTPServerParams::getFastHeaderParsing() const
+{
+	return _fastHeaderParsing;
+}
+
+
+inline int HTTPServerParams::getPipelineDepth() const
+{
+	return _pipelineDepth;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -22,6 +22,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/SocketDefs.h"
 #include <cstddef>
 #include <ostream>
 
@@ -77,6 +78,28 @@ public:
 		/// Throws a FileNotFoundException if the file
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
+
+	virtual void sendFile(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length);
+		/// Sends the response header to the client, followed
+		/// by length bytes of the given file, starting at offset,
+		/// e.g. to answer a request with a Range header.
+		///
+		/// The status is set to HTTP_PARTIAL_CONTENT (206) and a
+		/// Content-Range header is added. The range is truncated at
+		/// the end of the file. If offset is at or past the end of the
+		/// file, or if length is zero, the status is set to
+		/// HTTP_REQUESTED_RANGE_NOT_SATISFIABLE (416) and no content
+		/// is sent.
+		///
+		/// Must not be called after send(), sendBuffer() 
+		/// or redirect() has been called.
+		///
+		/// Throws a FileNotFoundException if the file
+		/// cannot be found, or an OpenFileException if
+		/// the file cannot be opened.
+		///
+		/// The default implementation writes the range to
+		/// the stream returned by send().
 		
 	virtual void sendBuffer(const void* pBuffer, std::size_t length) = 0;
 		/// Sends the response header to the client, followed
@@ -85,12 +108,31 @@ public:
 		/// The Content-Length header of the response is set
 		/// to length and chunked transfer encoding is disabled.
 		///
-		/// If both the HTTP message header and body (from the
-		/// given buffer) fit into one single network packet, the 
-		/// complete response can be sent in one network packet.
+		/// Header and body are sent with a single scatter/gather
+		/// write, without copying the body.
 		///
 		/// Must not be called after send(), sendFile()  
 		/// or redirect() has been called.
+
+	virtual void sendBuffers(const SocketBufVec& buffers);
+		/// Sends the response header to the client, followed
+		/// by the contents of the given buffers, which form
+		/// the message body.
+		///
+		/// The Content-Length header of the response is set
+		/// to the total length of the buffers and chunked
+		/// transfer encoding is disabled.
+		///
+		/// The buffers are owned by the caller and are not
+		/// referenced after the method returns.
+		///
+		/// Must not be called after send(), sendFile(), sendBuffer()
+		/// or redirect() has been called.
+		///
+		/// The default implementation writes the buffers to
+		/// the stream returned by send(). HTTPServerResponseImpl
+		/// sends header and body with a single scatter/gather
+		/// write, without copying the body.
 		
 	virtual void redirect(const std::string& uri, HTTPStatus status = HTTP_FOUND) = 0;
 		/// Sets the status code, which must be one of
@@ -109,6 +151,13 @@ public:
 		
 	virtual bool sent() const = 0;
 		/// Returns true if the response (header) has been sent.
+
+protected:
+	Poco::UInt64 prepareRange(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length);
+		/// Sets the status and the headers of a response to a
+		/// range request for the given file (see sendFile()),
+		/// and returns the number of bytes to send, which is
+		/// zero if the range cannot be satisfied.
 };
 
 
@@ -76,6 +76,12 @@ public:
 		/// cannot be found, or an OpenFileException if
 		/// the file cannot be opened.
 		
+	void sendFile(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length);
+		/// Sends the response header to the client, followed
+		/// by the given range of the file.
+		///
+		/// See HTTPServerResponse::sendFile() for details.
+
 	void sendBuffer(const void* pBuffer, std::size_t length);
 		/// Sends the response header to the client, followed
 		/// by the contents of the given buffer.
@@ -83,13 +89,18 @@ public:
 		/// The Content-Length header of the response is set
 		/// to length and chunked transfer encoding is disabled.
 		///
-		/// If both the HTTP message header and body (from the
-		/// given buffer) fit into one single network packet, the 
-		/// complete response can be sent in one network packet.
+		/// Header and body are sent with a single scatter/gather
+		/// write, without copying the body.
 		///
 		/// Must not be called after send(), sendFile()  
 		/// or redirect() has been called.
 		
+	void sendBuffers(const SocketBufVec& buffers);
+		/// Sends the response header to the client, followed
+		/// by the contents of the given buffers.
+		///
+		/// See HTTPServerResponse::sendBuffers() for details.
+
 	void redirect(const std::string& uri, HTTPStatus status = HTTP_FOUND);
 		/// Sets the status code, which must be one of
 		/// HTTP_MOVED_PERMANENTLY (301), HTTP_FOUND (302),
@@ -110,6 +121,10 @@ public:
 
 protected:
 	void attachRequest(HTTPServerRequestImpl* pRequest);
+
+	void sendFileContent(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length);
+		/// Sends the response header, followed by the given range
+		/// of the file, using StreamSocket::sendFile().
 	
 private:
 	HTTPServerSession& _session;
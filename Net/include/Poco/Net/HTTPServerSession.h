@@ -25,6 +25,7 @@
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/HTTPServerSession.h"
 #include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPHeaderTable.h"
 #include "Poco/Timespan.h"
 
 
@@ -49,17 +50,37 @@ public:
 	
 	bool canKeepAlive() const;
 		/// Returns true if the session can be kept alive.
+
+	bool hasPipelinedRequest() const;
+		/// Returns true if the complete header of another
+		/// request has already been received, meaning that
+		/// the client is pipelining requests.
 	
 	SocketAddress clientAddress();
 		/// Returns the client's address.
 		
 	SocketAddress serverAddress();
 		/// Returns the server's address.
-		
+
+	const HTTPHeaderTable& readRequestHeader();
+		/// Reads the request line and header of the next request
+		/// into the session's header table and parses them.
+		///
+		/// Throws a NoMessageException if the peer has closed
+		/// the connection, or a MessageException if the header
+		/// is malformed.
+
+	const HTTPHeaderTable& headerTable() const;
+		/// Returns the header table filled by the last call
+		/// to readRequestHeader().
+		///
+		/// The table is only valid until the next request is read.
+
 private:
-	bool           _firstRequest;
-	Poco::Timespan _keepAliveTimeout;
-	int            _maxKeepAliveRequests;
+	bool            _firstRequest;
+	Poco::Timespan  _keepAliveTimeout;
+	int             _maxKeepAliveRequests;
+	HTTPHeaderTable _headerTable;
 };
 
 
@@ -72,6 +93,18 @@ inline bool HTTPServerSession::canKeepAlive() const
 }
 
 
+inline bool HTTPServerSession::hasPipelinedRequest() const
+{
+	return bufferedHeader();
+}
+
+
+inline const HTTPHeaderTable& HTTPServerSession::headerTable() const
+{
+	return _headerTable;
+}
+
+
 } } // namespace Poco::Net
 
 
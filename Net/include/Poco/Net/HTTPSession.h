@@ -33,6 +33,9 @@ namespace Poco {
 namespace Net {
 
 
+class HTTPHeaderTable;
+
+
 class Net_API HTTPSession
 	/// HTTPSession implements basic HTTP session management
 	/// for both HTTP clients and HTTP servers.
@@ -113,6 +116,49 @@ public:
 		/// obtain any data already read from the socket, but not
 		/// yet processed.
 
+	void attachBuffer(char* pBuffer, std::size_t length);
+		/// Makes the session consume the given data before any
+		/// more data is read from the socket. Any data remaining
+		/// in the internal buffer is discarded.
+		///
+		/// This is the counterpart to drainBuffer(), and is used
+		/// to pass data that has already been received from the
+		/// socket, e.g. by a SocketReactor, to the session.
+		///
+		/// The session does not take ownership of the data, which
+		/// must remain valid until it has been consumed, or until
+		/// drainBuffer() has been called.
+
+	void setWriteBuffering(bool writeBuffering);
+		/// Enables or disables write buffering.
+		///
+		/// While write buffering is enabled, small writes are
+		/// collected in an internal buffer and sent together when
+		/// the buffer is full, when flush() is called, when data must
+		/// be received from the socket, or when write buffering is
+		/// disabled again. This is used to send the responses to
+		/// pipelined requests with as few system calls as possible.
+		///
+		/// Write buffering is disabled by default.
+
+	bool getWriteBuffering() const;
+		/// Returns true iff write buffering is enabled.
+
+	void flush();
+		/// Sends all data collected in the write buffer.
+		///
+		/// If the socket does not accept all data, the data
+		/// not sent remains in the write buffer and an
+		/// exception is thrown.
+
+	Poco::UInt64 bytesReceived() const;
+		/// Returns the number of bytes received over
+		/// the socket by this session.
+
+	Poco::UInt64 bytesSent() const;
+		/// Returns the number of bytes sent over
+		/// the socket by this session.
+
 protected:
 	HTTPSession();
 		/// Creates a HTTP session using an
@@ -154,6 +200,14 @@ protected:
 	virtual int write(const char* buffer, std::streamsize length);
 		/// Writes data to the socket.
 
+	int write(const SocketBufVec& buffers);
+		/// Writes the contents of the given buffers to the socket,
+		/// together with any data in the write buffer, using a
+		/// single scatter/gather send if possible. If write buffering
+		/// is enabled and the data fits, it is buffered instead.
+		///
+		/// Returns the number of bytes written from the given buffers.
+
 	int receive(char* buffer, int length);
 		/// Reads up to length bytes.
 		
@@ -162,6 +216,16 @@ protected:
 
 	void refill();
 		/// Refills the internal buffer.
+
+	bool bufferedHeader() const;
+		/// Returns true iff the internal buffer contains a
+		/// complete message header, terminated by an empty line.
+
+	void readHeader(HTTPHeaderTable& table);
+		/// Passes the data in the internal buffer to the given
+		/// HTTPHeaderTable, refilling the buffer as necessary, until
+		/// the table is complete or the peer has closed the connection.
+		/// Any data following the header remains in the buffer.
 		
 	virtual void connect(const SocketAddress& address);
 		/// Connects the underlying socket to the given address
@@ -184,16 +248,27 @@ private:
 	enum
 	{
 		HTTP_DEFAULT_TIMEOUT = 60000000,
-		HTTP_DEFAULT_CONNECTION_TIMEOUT = 30000000
+		HTTP_DEFAULT_CONNECTION_TIMEOUT = 30000000,
+		HTTP_WRITE_BUFFER_SIZE = 16384
 	};
 	
 	HTTPSession(const HTTPSession&);
 	HTTPSession& operator = (const HTTPSession&);
+
+	void consumeWriteBuffer(std::size_t length);
+		/// Removes the given number of bytes, which have
+		/// been sent, from the start of the write buffer.
 	
 	StreamSocket     _socket;
 	char*            _pBuffer;
 	char*            _pCurrent;
 	char*            _pEnd;
+	std::streamsize  _bufferSize;
+	Poco::UInt64     _bytesReceived;
+	Poco::UInt64     _bytesSent;
+	char*            _pWriteBuffer;
+	std::size_t      _writeBuffered;
+	bool             _writeBuffering;
 	bool             _keepAlive;
 	Poco::Timespan   _connectionTimeout;
 	Poco::Timespan   _receiveTimeout;
@@ -205,6 +280,7 @@ private:
 	friend class HTTPHeaderStreamBuf;
 	friend class HTTPFixedLengthStreamBuf;
 	friend class HTTPChunkedStreamBuf;
+	friend class HTTPServerResponseImpl;
 };
 
 
@@ -217,6 +293,24 @@ inline bool HTTPSession::getKeepAlive() const
 }
 
 
+inline bool HTTPSession::getWriteBuffering() const
+{
+	return _writeBuffering;
+}
+
+
+inline Poco::UInt64 HTTPSession::bytesReceived() const
+{
+	return _bytesReceived;
+}
+
+
+inline Poco::UInt64 HTTPSession::bytesSent() const
+{
+	return _bytesSent;
+}
+
+
 inline Poco::Timespan HTTPSession::getTimeout() const
 {
 	return _receiveTimeout;
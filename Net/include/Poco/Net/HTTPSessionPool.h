@@ -0,0 +1,281 @@
+//
+// HTTPSessionPool.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPSessionPool
+//
+// Definition of the HTTPSessionPool class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HTTPSessionPool_INCLUDED
+#define Net_HTTPSessionPool_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/URI.h"
+#include "Poco/ActiveMethod.h"
+#include "Poco/Timer.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+#include "Poco/Condition.h"
+#include <map>
+#include <list>
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API HTTPSessionPool
+	/// HTTPSessionPool maintains a pool of persistent HTTPClientSession
+	/// objects, so that connections to a server can be reused for
+	/// multiple requests, even by different threads.
+	///
+	/// Sessions are pooled by scheme, host and port. For every server,
+	/// at most maxSessionsPerHost sessions are in use at any time.
+	/// If all sessions for a server are in use, get() waits until
+	/// another thread returns a session to the pool, or until the
+	/// wait timeout expires.
+	///
+	/// Sessions are created with createSession(). For the "http" scheme,
+	/// a HTTPClientSession is created directly; all other schemes are
+	/// passed to HTTPSessionFactory::defaultFactory(), so the
+	/// corresponding HTTPSessionInstantiator (e.g., for "https") must
+	/// have been registered.
+	///
+	/// Before an idle session is reused, its socket is checked for
+	/// readability. A readable idle socket means that the server has
+	/// closed the connection (or sent unexpected data), so the session
+	/// is discarded. Sessions that have been idle for longer than the
+	/// idle time are discarded by a timer, as are stale ones.
+	///
+	/// Usage:
+	///     HTTPSessionPool pool;
+	///     HTTPSessionPool::ScopedSession session(pool, uri);
+	///     session->sendRequest(request);
+	///     std::istream& rs = session->receiveResponse(response);
+	///     StreamCopier::copyStream(rs, ostr);
+	///
+	/// A session must only be returned to the pool after the
+	/// response body has been read completely. Sessions
+	/// that have encountered a network error are not reused.
+	///
+	/// All sessions must have been returned to the pool before
+	/// the pool is destroyed.
+{
+public:
+	class Net_API ScopedSession
+		/// Obtains a session from a HTTPSessionPool,
+		/// and returns it to the pool when destroyed.
+	{
+	public:
+		ScopedSession(HTTPSessionPool& pool, const Poco::URI& uri);
+			/// Obtains a session for the given URI from the pool.
+
+		~ScopedSession();
+			/// Returns the session to the pool.
+
+		HTTPClientSession& operator * ();
+		HTTPClientSession* operator -> ();
+
+		HTTPClientSession* get();
+			/// Returns the session.
+
+	private:
+		ScopedSession();
+		ScopedSession(const ScopedSession&);
+		ScopedSession& operator = (const ScopedSession&);
+
+		HTTPSessionPool&   _pool;
+		HTTPClientSession* _pSession;
+	};
+
+	enum
+	{
+		DEFAULT_MAX_SESSIONS_PER_HOST = 8,
+		DEFAULT_IDLE_TIME = 60
+	};
+
+	HTTPSessionPool(int maxSessionsPerHost = DEFAULT_MAX_SESSIONS_PER_HOST, int idleTime = DEFAULT_IDLE_TIME);
+		/// Creates the HTTPSessionPool.
+		///
+		/// At most maxSessionsPerHost sessions are in use for a
+		/// single server at any time (0 means no limit). Sessions
+		/// that have been idle for more than idleTime seconds
+		/// are closed.
+
+	virtual ~HTTPSessionPool();
+		/// Closes all idle sessions and destroys the HTTPSessionPool.
+
+	HTTPClientSession* get(const Poco::URI& uri);
+		/// Returns a session for the server given by the scheme, host
+		/// and port of the URI. An idle session is reused if one is
+		/// available, otherwise a new session is created.
+		///
+		/// If the limit of sessions for the server has been reached,
+		/// waits until a session is returned to the pool. Throws a
+		/// Poco::TimeoutException if no session becomes available
+		/// within the wait timeout.
+		///
+		/// The session must be returned to the pool with release().
+
+	Poco::ActiveMethod<HTTPClientSession*, Poco::URI, HTTPSessionPool> getAsync;
+		/// Asynchronous version of get(), which does not block
+		/// the calling thread while waiting for a session.
+		///
+		/// The session obtained from the Poco::ActiveResult
+		/// must be returned to the pool with release().
+
+	void release(HTTPClientSession* pSession);
+		/// Returns a session obtained with get() to the pool.
+		///
+		/// The session is kept for reuse if it is connected, has
+		/// keep-alive enabled and has not encountered a network
+		/// error. Otherwise, the session is deleted.
+
+	void setWaitTimeout(const Poco::Timespan& timeout);
+		/// Sets the maximum time get() waits for a session.
+
+	Poco::Timespan getWaitTimeout() const;
+		/// Returns the maximum time get() waits for a session.
+
+	int maxSessionsPerHost() const;
+		/// Returns the maximum number of sessions per server.
+
+	int idleTime() const;
+		/// Returns the idle time in seconds.
+
+	int used() const;
+		/// Returns the number of sessions currently in use.
+
+	int idle() const;
+		/// Returns the number of idle sessions in the pool.
+
+	int allocated() const;
+		/// Returns the number of sessions in use or idle.
+
+	int hits() const;
+		/// Returns the number of times get() has
+		/// reused an idle session.
+
+	int misses() const;
+		/// Returns the number of times get() has
+		/// created a new session.
+
+	int waits() const;
+		/// Returns the number of times get() had to
+		/// wait for a session to become available.
+
+	static std::string key(const Poco::URI& uri);
+		/// Returns the key the sessions for the server
+		/// given by the URI are pooled under, in the form
+		/// "<scheme>://<host>:<port>".
+
+protected:
+	virtual HTTPClientSession* createSession(const Poco::URI& uri);
+		/// Creates a new session for the given URI,
+		/// with keep-alive enabled.
+		///
+		/// Can be overridden by subclasses to configure the session,
+		/// e.g. its timeouts or proxy settings.
+
+	HTTPClientSession* getImpl(const Poco::URI& uri);
+		/// Implementation of getAsync().
+
+	bool isStale(HTTPClientSession& session) const;
+		/// Returns true if the idle session's connection has
+		/// been closed by the server.
+
+	void onJanitorTimer(Poco::Timer& timer);
+		/// Closes sessions that have been idle for too long,
+		/// or have become stale.
+
+private:
+	struct IdleSession
+	{
+		HTTPClientSession* pSession;
+		Poco::Timestamp    lastUsed;
+	};
+
+	typedef std::list<IdleSession> IdleList;
+
+	struct Host
+	{
+		Host(): used(0)
+		{
+		}
+
+		IdleList idle;
+		int      used;
+	};
+
+	typedef std::map<std::string, Host> HostMap;
+	typedef std::map<HTTPClientSession*, std::string> SessionMap;
+
+	HTTPSessionPool(const HTTPSessionPool&);
+	HTTPSessionPool& operator = (const HTTPSessionPool&);
+
+	int             _maxSessionsPerHost;
+	int             _idleTime;
+	Poco::Timespan  _waitTimeout;
+	HostMap         _hosts;
+	SessionMap      _sessions;
+	int             _used;
+	int             _idle;
+	int             _hits;
+	int             _misses;
+	int             _waits;
+	Poco::Timer     _janitorTimer;
+	Poco::Condition _available;
+	mutable Poco::Mutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline HTTPClientSession& HTTPSessionPool::ScopedSession::operator * ()
+{
+	return *_pSession;
+}
+
+
+inline HTTPClientSession* HTTPSessionPool::ScopedSession::operator -> ()
+{
+	return _pSession;
+}
+
+
+inline HTTPClientSession* HTTPSessionPool::ScopedSession::get()
+{
+	return _pSession;
+}
+
+
+inline int HTTPSessionPool::maxSessionsPerHost() const
+{
+	return _maxSessionsPerHost;
+}
+
+
+inline int HTTPSessionPool::idleTime() const
+{
+	return _idleTime;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HTTPSessionPool_INCLUDED
@@ -0,0 +1,568 @@
+//
+// HappyEyeballsConnector.h
+//
+// $Id$
+//
+// Library: Net
+// Package: Reactor
+// Module:  HappyEyeballsConnector
+//
+// Definition of the HappyEyeballsConnector class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_HappyEyeballsConnector_INCLUDED
+#define Net_HappyEyeballsConnector_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/Net/DNSResolver.h"
+#include "Poco/Observer.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+#include <vector>
+
+
+namespace Poco {
+namespace Net {
+
+
+template <class ServiceHandler>
+class HappyEyeballsConnector: private DNSResolver::Callback
+	/// This class implements the Connector part of the
+	/// Acceptor-Connector design pattern for servers with more
+	/// than one address, using the "Happy Eyeballs" algorithm
+	/// described in RFC 8305.
+	///
+	/// Like SocketConnector, the HappyEyeballsConnector performs
+	/// non-blocking connect operations driven by a SocketReactor,
+	/// and creates a ServiceHandler for the connection once it has
+	/// been established. However, instead of connecting to a single
+	/// address, the HappyEyeballsConnector races connection attempts
+	/// to all addresses of the server:
+	///
+	///   - The addresses are reordered so that IPv6 and IPv4 addresses
+	///     alternate, starting with the family of the first address.
+	///   - The first connection attempt is started immediately. Further
+	///     attempts are started whenever the attempt delay (default 250
+	///     milliseconds) expires without any attempt having succeeded,
+	///     or immediately when an attempt fails.
+	///   - An attempt that has not succeeded within the attempt timeout
+	///     (default 10 seconds) fails.
+	///   - The first attempt that succeeds wins. All other attempts
+	///     are aborted, and the ServiceHandler is created for the
+	///     winning socket.
+	///
+	/// If all attempts fail, onError() is called with the error code
+	/// of the last failed attempt (POCO_ETIMEDOUT for an attempt that
+	/// timed out).
+	///
+	/// The attempt delay and the attempt timeout are checked whenever
+	/// one of the connector's sockets receives a notification, including
+	/// the reactor's TimeoutNotification, which the SocketReactor also
+	/// dispatches if it is busy. They are therefore enforced with the
+	/// granularity of the reactor's timeout. Once the connection
+	/// attempts have been started, all work is done by the reactor
+	/// thread.
+	///
+	/// The addresses can be given directly, or the HappyEyeballsConnector
+	/// can resolve a host name using a DNSResolver. In the latter case,
+	/// the lookup is started by start(), which must be called once the
+	/// HappyEyeballsConnector (including any subclass) has been fully
+	/// constructed. The connection attempts are started from the
+	/// DNSResolver's worker thread when the lookup has completed (or
+	/// from within start(), if the host name is cached). If the host
+	/// name cannot be resolved, onError() is called with POCO_EHOSTUNREACH.
+	///
+	/// The ServiceHandler class must provide a constructor that
+	/// takes a StreamSocket and a SocketReactor as arguments,
+	/// e.g.:
+	///     MyServiceHandler(const StreamSocket& socket, ServiceReactor& reactor)
+	///
+	/// When the ServiceHandler is done, it must destroy itself.
+	///
+	/// Subclasses can override the createServiceHandler() factory method
+	/// if special steps are necessary to create a ServiceHandler object.
+{
+public:
+	enum
+	{
+		DEFAULT_ATTEMPT_DELAY = 250,
+			/// The default delay in milliseconds before starting
+			/// the next connection attempt.
+		DEFAULT_ATTEMPT_TIMEOUT = 10000
+			/// The default timeout in milliseconds for a
+			/// single connection attempt.
+	};
+
+	HappyEyeballsConnector(const std::vector<SocketAddress>& addresses, SocketReactor& reactor):
+		_reactor(reactor),
+		_pResolver(0),
+		_port(0),
+		_attemptDelay(DEFAULT_ATTEMPT_DELAY*Poco::Timespan::MILLISECONDS),
+		_attemptTimeout(DEFAULT_ATTEMPT_TIMEOUT*Poco::Timespan::MILLISECONDS),
+		_next(0),
+		_starting(0),
+		_lastError(0),
+		_done(false)
+		/// Creates the HappyEyeballsConnector and starts connecting
+		/// to the given addresses.
+	{
+		connect(addresses);
+	}
+
+	HappyEyeballsConnector(const HostEntry& entry, Poco::UInt16 port, SocketReactor& reactor):
+		_reactor(reactor),
+		_pResolver(0),
+		_port(port),
+		_attemptDelay(DEFAULT_ATTEMPT_DELAY*Poco::Timespan::MILLISECONDS),
+		_attemptTimeout(DEFAULT_ATTEMPT_TIMEOUT*Poco::Timespan::MILLISECONDS),
+		_next(0),
+		_starting(0),
+		_lastError(0),
+		_done(false)
+		/// Creates the HappyEyeballsConnector and starts connecting
+		/// to the given port on the addresses of the given HostEntry.
+	{
+		connect(entry);
+	}
+
+	HappyEyeballsConnector(const std::string& host, Poco::UInt16 port, SocketReactor& reactor, DNSResolver& resolver):
+		_reactor(reactor),
+		_pResolver(&resolver),
+		_host(host),
+		_port(port),
+		_attemptDelay(DEFAULT_ATTEMPT_DELAY*Poco::Timespan::MILLISECONDS),
+		_attemptTimeout(DEFAULT_ATTEMPT_TIMEOUT*Poco::Timespan::MILLISECONDS),
+		_next(0),
+		_starting(0),
+		_lastError(0),
+		_done(false)
+		/// Creates the HappyEyeballsConnector, which resolves the given
+		/// host name with the given DNSResolver and then starts connecting
+		/// to the given port on the host's addresses.
+		///
+		/// The host name is not resolved until start() is called.
+	{
+	}
+
+	virtual ~HappyEyeballsConnector()
+		/// Aborts all pending connection attempts and
+		/// destroys the HappyEyeballsConnector.
+	{
+		try
+		{
+			if (_pResolver) _pResolver->cancel(*this);
+			std::vector<StreamSocket> aborted;
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_done = true;
+				abortAll(aborted);
+			}
+			abort(aborted);
+		}
+		catch (...)
+		{
+			poco_unexpected();
+		}
+	}
+
+	void start()
+		/// Starts resolving the host name given to the constructor.
+		/// Does nothing if the HappyEyeballsConnector has been given
+		/// the addresses.
+		///
+		/// Must be called after the HappyEyeballsConnector has been
+		/// constructed, and at most once. If the host name is cached,
+		/// the first connection attempt is started (or onError() is
+		/// called) before start() returns. Otherwise, this happens in
+		/// the DNSResolver's worker thread.
+	{
+		if (_pResolver) _pResolver->resolveAsync(_host, *this);
+	}
+
+	void setAttemptDelay(const Poco::Timespan& delay)
+		/// Sets the delay before the next connection attempt is
+		/// started, if no attempt has succeeded or failed.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_attemptDelay = delay;
+	}
+
+	Poco::Timespan getAttemptDelay() const
+		/// Returns the delay between connection attempts.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _attemptDelay;
+	}
+
+	void setAttemptTimeout(const Poco::Timespan& timeout)
+		/// Sets the timeout for a single connection attempt.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		_attemptTimeout = timeout;
+	}
+
+	Poco::Timespan getAttemptTimeout() const
+		/// Returns the timeout for a single connection attempt.
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _attemptTimeout;
+	}
+
+	void onWritable(WritableNotification* pNotification)
+	{
+		Socket socket(pNotification->socket());
+		pNotification->release();
+		complete(process(&socket, false));
+	}
+
+	void onError(ErrorNotification* pNotification)
+	{
+		Socket socket(pNotification->socket());
+		pNotification->release();
+		complete(process(&socket, true));
+	}
+
+	void onTimeout(TimeoutNotification* pNotification)
+	{
+		pNotification->release();
+		complete(process(0, false));
+	}
+
+protected:
+	virtual ServiceHandler* createServiceHandler()
+		/// Create and initialize a new ServiceHandler instance
+		/// for the connected socket.
+		///
+		/// Subclasses can override this method.
+	{
+		return new ServiceHandler(_socket, _reactor);
+	}
+
+	virtual void onError(int errorCode)
+		/// Called when the socket cannot be connected to any
+		/// of the addresses.
+		///
+		/// Subclasses can override this method.
+	{
+	}
+
+	SocketReactor& reactor()
+		/// Returns a reference to the SocketReactor where
+		/// this HappyEyeballsConnector is registered.
+	{
+		return _reactor;
+	}
+
+	StreamSocket& socket()
+		/// Returns a reference to the connected socket.
+		///
+		/// The socket is only valid once the connection
+		/// has been established.
+	{
+		return _socket;
+	}
+
+	static std::vector<SocketAddress> interleave(const std::vector<SocketAddress>& addresses)
+		/// Reorders the given addresses so that address families
+		/// alternate, starting with the family of the first address,
+		/// as described in RFC 8305, section 4.
+	{
+		std::vector<SocketAddress> first;
+		std::vector<SocketAddress> second;
+		for (std::vector<SocketAddress>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+		{
+			if (it->family() == addresses.front().family())
+				first.push_back(*it);
+			else
+				second.push_back(*it);
+		}
+		std::vector<SocketAddress> result;
+		result.reserve(addresses.size());
+		for (std::size_t i = 0; i < first.size() || i < second.size(); ++i)
+		{
+			if (i < first.size()) result.push_back(first[i]);
+			if (i < second.size()) result.push_back(second[i]);
+		}
+		return result;
+	}
+
+private:
+	struct Attempt
+	{
+		StreamSocket    socket;
+		Poco::Timestamp started;
+	};
+
+	HappyEyeballsConnector();
+	HappyEyeballsConnector(const HappyEyeballsConnector&);
+	HappyEyeballsConnector& operator = (const HappyEyeballsConnector&);
+
+	void connect(const HostEntry& entry)
+	{
+		std::vector<SocketAddress> addresses;
+		const HostEntry::AddressList& ipAddresses = entry.addresses();
+		for (HostEntry::AddressList::const_iterator it = ipAddresses.begin(); it != ipAddresses.end(); ++it)
+		{
+			addresses.push_back(SocketAddress(*it, _port));
+		}
+		connect(addresses);
+	}
+
+	void connect(const std::vector<SocketAddress>& addresses)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (!addresses.empty()) _addresses = interleave(addresses);
+			_lastError = POCO_EHOSTUNREACH;
+		}
+		complete(process(0, false));
+	}
+
+	void onResolved(const std::string&, const HostEntry& entry)
+	{
+		connect(entry);
+	}
+
+	void onResolveError(const std::string&, const Poco::Exception&)
+	{
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			_done = true;
+		}
+		onError(POCO_EHOSTUNREACH);
+	}
+
+	enum Result
+	{
+		RESULT_PENDING,
+		RESULT_CONNECTED,
+		RESULT_FAILED
+	};
+
+	Result process(const Socket* pSocket, bool error)
+		/// Handles a notification for the given socket (if not null),
+		/// fails attempts that have timed out and starts new attempts.
+		///
+		/// Sockets are registered with and removed from the reactor
+		/// without the mutex locked, as removing an event handler
+		/// waits for a running notification of that handler, which
+		/// in turn may wait for the mutex.
+	{
+		Result result = RESULT_PENDING;
+		std::vector<SocketAddress> addresses;
+		std::vector<StreamSocket> aborted;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			result = evaluate(pSocket, error, addresses, aborted);
+		}
+		if (result == RESULT_CONNECTED) unregister(_socket);
+		abort(aborted);
+		while (!addresses.empty())
+		{
+			std::vector<StreamSocket> started;
+			int lastError = 0;
+			for (std::vector<SocketAddress>::const_iterator it = addresses.begin(); it != addresses.end(); ++it)
+			{
+				try
+				{
+					StreamSocket socket;
+					socket.connectNB(*it);
+					registerSocket(socket);
+					started.push_back(socket);
+				}
+				catch (Poco::Exception& exc)
+				{
+					lastError = exc.code() ? exc.code() : POCO_EHOSTUNREACH;
+				}
+			}
+			addresses.clear();
+			{
+				Poco::FastMutex::ScopedLock lock(_mutex);
+				_starting = 0;
+				if (_done)
+				{
+					aborted.swap(started);
+				}
+				else
+				{
+					for (std::vector<StreamSocket>::const_iterator it = started.begin(); it != started.end(); ++it)
+					{
+						Attempt attempt;
+						attempt.socket = *it;
+						_attempts.push_back(attempt);
+					}
+					if (lastError)
+					{
+						_lastError = lastError;
+						// RFC 8305: start the next attempt as soon as one fails.
+						_lastStarted = 0;
+					}
+					result = evaluate(0, false, addresses, aborted);
+				}
+			}
+			abort(aborted);
+		}
+		return result;
+	}
+
+	Result evaluate(const Socket* pSocket, bool error, std::vector<SocketAddress>& addresses, std::vector<StreamSocket>& aborted)
+		/// Handles a notification for the given socket (if not null)
+		/// and fails attempts that have timed out. Returns the addresses
+		/// of the attempts to start in addresses, and the sockets to
+		/// close in aborted. Must be called with the mutex locked.
+	{
+		if (_done) return RESULT_PENDING;
+
+		if (pSocket)
+		{
+			std::size_t i = find(*pSocket);
+			if (i < _attempts.size())
+			{
+				int err = _attempts[i].socket.impl()->socketError();
+				if (!err && !error)
+				{
+					win(i, aborted);
+					return RESULT_CONNECTED;
+				}
+				fail(i, err ? err : POCO_ECONNREFUSED, aborted);
+			}
+		}
+		std::size_t i = 0;
+		while (i < _attempts.size())
+		{
+			if (_attempts[i].started.isElapsed(_attemptTimeout.totalMicroseconds()))
+				fail(i, POCO_ETIMEDOUT, aborted);
+			else
+				++i;
+		}
+		if (_starting > 0) return RESULT_PENDING;
+
+		if (_next < _addresses.size() && (_attempts.empty() || _lastStarted.isElapsed(_attemptDelay.totalMicroseconds())))
+		{
+			addresses.push_back(_addresses[_next++]);
+			_lastStarted.update();
+		}
+		_starting = addresses.size();
+		if (_attempts.empty() && _starting == 0 && _next == _addresses.size())
+		{
+			_done = true;
+			return RESULT_FAILED;
+		}
+		return RESULT_PENDING;
+	}
+
+	void complete(Result result)
+		/// Creates the ServiceHandler or reports the error.
+		/// Must be called without the mutex locked.
+	{
+		if (result == RESULT_CONNECTED)
+		{
+			_socket.setBlocking(true);
+			createServiceHandler();
+		}
+		else if (result == RESULT_FAILED)
+		{
+			onError(_lastError);
+		}
+	}
+
+	std::size_t find(const Socket& socket) const
+	{
+		std::size_t i = 0;
+		while (i < _attempts.size() && !(_attempts[i].socket == socket)) ++i;
+		return i;
+	}
+
+	void fail(std::size_t i, int errorCode, std::vector<StreamSocket>& aborted)
+	{
+		_lastError = errorCode;
+		aborted.push_back(_attempts[i].socket);
+		_attempts.erase(_attempts.begin() + i);
+		// RFC 8305: start the next attempt as soon as one fails.
+		_lastStarted = 0;
+	}
+
+	void win(std::size_t i, std::vector<StreamSocket>& aborted)
+	{
+		_done = true;
+		_socket = _attempts[i].socket;
+		_attempts.erase(_attempts.begin() + i);
+		abortAll(aborted);
+	}
+
+	void abortAll(std::vector<StreamSocket>& aborted)
+	{
+		for (typename std::vector<Attempt>::iterator it = _attempts.begin(); it != _attempts.end(); ++it)
+		{
+			aborted.push_back(it->socket);
+		}
+		_attempts.clear();
+	}
+
+	void registerSocket(StreamSocket& socket)
+	{
+		_reactor.addEventHandler(socket, Poco::Observer<HappyEyeballsConnector, WritableNotification>(*this, &HappyEyeballsConnector::onWritable));
+		_reactor.addEventHandler(socket, Poco::Observer<HappyEyeballsConnector, ErrorNotification>(*this, &HappyEyeballsConnector::onError));
+		_reactor.addEventHandler(socket, Poco::Observer<HappyEyeballsConnector, TimeoutNotification>(*this, &HappyEyeballsConnector::onTimeout));
+	}
+
+	void unregister(StreamSocket& socket)
+	{
+		_reactor.removeEventHandler(socket, Poco::Observer<HappyEyeballsConnector, WritableNotification>(*this, &HappyEyeballsConnector::onWritable));
+		_reactor.removeEventHandler(socket, Poco::Observer<HappyEyeballsConnector, ErrorNotification>(*this, &HappyEyeballsConnector::onError));
+		_reactor.removeEventHandler(socket, Poco::Observer<HappyEyeballsConnector, TimeoutNotification>(*this, &HappyEyeballsConnector::onTimeout));
+	}
+
+	void abort(std::vector<StreamSocket>& sockets)
+		/// Removes the given sockets from the reactor and closes them.
+		/// Must be called without the mutex locked.
+	{
+		for (std::vector<StreamSocket>::iterator it = sockets.begin(); it != sockets.end(); ++it)
+		{
+			unregister(*it);
+			try
+			{
+				it->close();
+			}
+			catch (Poco::Exception&)
+			{
+			}
+		}
+		sockets.clear();
+	}
+
+	SocketReactor&             _reactor;
+	DNSResolver*               _pResolver;
+	std::string                _host;
+	Poco::UInt16               _port;
+	Poco::Timespan             _attemptDelay;
+	Poco::Timespan             _attemptTimeout;
+	std::vector<SocketAddress> _addresses;
+	std::size_t                _next;
+	std::size_t                _starting;
+	std::vector<Attempt>       _attempts;
+	Poco::Timestamp            _lastStarted;
+	StreamSocket               _socket;
+	int                        _lastError;
+	bool                       _done;
+	mutable Poco::FastMutex    _mutex;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_HappyEyeballsConnector_INCLUDED
@@ -0,0 +1,133 @@
+//
+// PollSet.h
+//
+// $Id$
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Definition of the PollSet class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_PollSet_INCLUDED
+#define Net_PollSet_INCLUDED
+
+
+#include "Poco/Net/Socket.h"
+#include <map>
+
+
+namespace Poco {
+namespace Net {
+
+
+class PollSetImpl;
+
+
+class Net_API PollSet
+	/// A set of sockets that can be efficiently polled as a whole.
+	///
+	/// In contrast to Socket::select(), which sets up the
+	/// underlying polling mechanism from scratch on every call,
+	/// a PollSet keeps its sockets registered with the operating
+	/// system between calls to poll(). Registrations are only
+	/// changed when sockets are added, updated or removed.
+	///
+	/// If supported by the platform, PollSet is implemented using
+	/// epoll (Linux). Otherwise poll() or, as a last resort,
+	/// select() is used.
+	///
+	/// The sockets in a PollSet can be added, updated and removed
+	/// from another thread while poll() is waiting. With epoll,
+	/// changes take effect immediately. With the other implementations,
+	/// changes take effect with the next call to poll().
+{
+public:
+	enum Mode
+	{
+		POLL_READ  = 0x01,
+		POLL_WRITE = 0x02,
+		POLL_ERROR = 0x04
+	};
+
+	enum Trigger
+		/// The trigger mode used by the PollSet.
+	{
+		TRIGGER_LEVEL, /// A socket is reported as long as it is ready.
+		TRIGGER_EDGE   /// A socket is only reported when its state changes.
+		               /// Handlers must read or write until the operation
+		               /// would block, otherwise no further events will be
+		               /// reported for the socket. Only supported with
+		               /// epoll; other implementations are always level-triggered.
+	};
+
+	typedef std::map<Poco::Net::Socket, int> SocketModeMap;
+
+	PollSet();
+		/// Creates an empty, level-triggered PollSet.
+
+	explicit PollSet(Trigger trigger);
+		/// Creates an empty PollSet using the given trigger mode.
+
+	~PollSet();
+		/// Destroys the PollSet.
+
+	void add(const Poco::Net::Socket& socket, int mode);
+		/// Adds the given socket to the set, for polling with
+		/// the given mode, which can be an OR'd combination of
+		/// POLL_READ, POLL_WRITE and POLL_ERROR.
+		///
+		/// If the socket is already in the set, its mode is replaced
+		/// with the given mode.
+
+	void remove(const Poco::Net::Socket& socket);
+		/// Removes the given socket from the set.
+		/// Does nothing if the socket is not in the set.
+
+	void update(const Poco::Net::Socket& socket, int mode);
+		/// Updates the mode of the given socket.
+		/// Does nothing if the socket is not in the set.
+
+	bool has(const Poco::Net::Socket& socket) const;
+		/// Returns true if the given socket is in the set.
+
+	bool empty() const;
+		/// Returns true if the set does not contain any sockets.
+
+	std::size_t count() const;
+		/// Returns the number of sockets in the set.
+
+	void clear();
+		/// Removes all sockets from the set.
+
+	Trigger trigger() const;
+		/// Returns the trigger mode of the PollSet.
+
+	SocketModeMap poll(const Poco::Timespan& timeout);
+		/// Waits until the state of at least one of the set's
+		/// sockets changes accordingly to its mode, or the timeout
+		/// expires.
+		///
+		/// Returns a map containing the sockets that have had their
+		/// state changed, together with the ready modes.
+		/// The map is empty if the timeout expired.
+
+private:
+	PollSet(const PollSet&);
+	PollSet& operator = (const PollSet&);
+
+	PollSetImpl* _pImpl;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_PollSet_INCLUDED
@@ -0,0 +1,474 @@
+//
+// ServerStatistics.h
+//
+// $Id$
+//
+// Library: Net
+// Package: TCPServer
+// Module:  ServerStatistics
+//
+// Definition of the ServerStatistics class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_ServerStatistics_INCLUDED
+#define Net_ServerStatistics_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/AtomicCounter.h"
+#include "Poco/Mutex.h"
+#include "Poco/Clock.h"
+#include <ostream>
+#include <string>
+#if !defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS) && !defined(POCO_NO_LOCKFREE_SERVERSTATISTICS)
+	#if defined(POCO_HAVE_STD_ATOMICS) || __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+		#define POCO_HAVE_LOCKFREE_SERVERSTATISTICS
+	#endif
+#endif
+#if defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS)
+#include <atomic>
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API ServerStatistics: public Poco::RefCountedObject
+	/// ServerStatistics collects connection and request level
+	/// statistics of a TCPServer or HTTPServer.
+	///
+	/// To enable collecting statistics, pass a ServerStatistics
+	/// object to TCPServerParams::setStatistics() (or
+	/// HTTPServerParams::setStatistics()) before the server is
+	/// created. TCPServerDispatcher then records the time
+	/// connections spend in the accept queue and the time
+	/// they are served, and HTTPServerConnection records
+	/// request level statistics, so that no request handler
+	/// needs to be wrapped.
+	///
+	/// All times are recorded in microseconds. Counters and histograms
+	/// are updated with atomic operations if std::atomic is available
+	/// (C++11), otherwise they are protected by a mutex.
+	///
+	/// The statistics can be written in JSON format or in the
+	/// Prometheus text exposition format. See also
+	/// ServerStatisticsRequestHandler.
+{
+public:
+	typedef Poco::AutoPtr<ServerStatistics> Ptr;
+
+	class Net_API Counter
+		/// A monotonically increasing 64-bit counter.
+	{
+	public:
+		Counter();
+			/// Creates the Counter.
+
+		~Counter();
+			/// Destroys the Counter.
+
+		void add(Poco::UInt64 n = 1);
+			/// Adds n to the counter.
+
+		Poco::UInt64 value() const;
+			/// Returns the value of the counter.
+
+		void reset();
+			/// Resets the counter to zero.
+
+	private:
+		Counter(const Counter&);
+		Counter& operator = (const Counter&);
+
+#if defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS)
+		std::atomic<Poco::UInt64> _value;
+#else
+		Poco::UInt64 _value;
+		mutable Poco::FastMutex _mutex;
+#endif
+	};
+
+	class Net_API Histogram
+		/// A histogram for latencies or other non-negative values,
+		/// similar to an HDR histogram.
+		///
+		/// Values below 2^SUB_BUCKET_BITS are counted exactly.
+		/// Every larger power-of-two range is divided into
+		/// 2^SUB_BUCKET_BITS linear sub-buckets, so that the
+		/// relative error of percentiles is at most 1/16
+		/// over the full range of values. Values greater than
+		/// MAX_VALUE are counted as MAX_VALUE.
+		///
+		/// Recording a value does not allocate memory and,
+		/// with std::atomic, does not acquire a lock.
+	{
+	public:
+		enum
+		{
+			SUB_BUCKET_BITS  = 4,
+			SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS,
+			MAX_VALUE_BITS   = 36,
+			BUCKET_COUNT     = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1)*SUB_BUCKET_COUNT
+		};
+
+		static const Poco::UInt64 MAX_VALUE;
+			/// The largest value that can be recorded (2^36 - 1;
+			/// more than 19 hours if values are microseconds).
+
+		Histogram();
+			/// Creates an empty Histogram.
+
+		~Histogram();
+			/// Destroys the Histogram.
+
+		void record(Poco::UInt64 value);
+			/// Records the given value.
+
+		void recordElapsed(const Poco::Clock& since);
+			/// Records the time in microseconds that has
+			/// elapsed since the given Clock value.
+
+		Poco::UInt64 count() const;
+			/// Returns the number of recorded values.
+
+		Poco::UInt64 sum() const;
+			/// Returns the sum of all recorded values.
+
+		Poco::UInt64 minimum() const;
+			/// Returns the smallest recorded value,
+			/// or 0 if no values have been recorded.
+
+		Poco::UInt64 maximum() const;
+			/// Returns the largest recorded value.
+
+		double mean() const;
+			/// Returns the arithmetic mean of all recorded values,
+			/// or 0 if no values have been recorded.
+
+		Poco::UInt64 percentile(double percent) const;
+			/// Returns an upper bound for the value below which
+			/// the given percentage (0 - 100) of the recorded
+			/// values fall, or 0 if no values have been recorded.
+			///
+			/// The result is the largest value in the bucket
+			/// containing the percentile, limited to maximum().
+
+		void reset();
+			/// Removes all recorded values.
+
+		static int bucketIndex(Poco::UInt64 value);
+			/// Returns the index of the bucket for the given value.
+
+		static Poco::UInt64 bucketLowerBound(int index);
+			/// Returns the smallest value counted in the given bucket.
+
+		static Poco::UInt64 bucketUpperBound(int index);
+			/// Returns the largest value counted in the given bucket.
+
+	private:
+		Histogram(const Histogram&);
+		Histogram& operator = (const Histogram&);
+
+#if defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS)
+		std::atomic<Poco::UInt64> _buckets[BUCKET_COUNT];
+		std::atomic<Poco::UInt64> _count;
+		std::atomic<Poco::UInt64> _sum;
+		std::atomic<Poco::UInt64> _min;
+		std::atomic<Poco::UInt64> _max;
+#else
+		Poco::UInt64 _buckets[BUCKET_COUNT];
+		Poco::UInt64 _count;
+		Poco::UInt64 _sum;
+		Poco::UInt64 _min;
+		Poco::UInt64 _max;
+		mutable Poco::FastMutex _mutex;
+#endif
+	};
+
+	ServerStatistics();
+		/// Creates the ServerStatistics.
+
+	Counter& connections();
+		/// Returns the counter for the number of
+		/// connections that have been served.
+
+	const Counter& connections() const;
+		/// Returns the counter for the number of
+		/// connections that have been served.
+
+	Counter& requests();
+		/// Returns the counter for the number of HTTP requests.
+
+	const Counter& requests() const;
+		/// Returns the counter for the number of HTTP requests.
+
+	Counter& keepAliveRequests();
+		/// Returns the counter for the number of HTTP requests
+		/// received over a persistent connection that had
+		/// already served a previous request.
+
+	const Counter& keepAliveRequests() const;
+		/// Returns the counter for the number of HTTP requests
+		/// received over a persistent connection that had
+		/// already served a previous request.
+
+	Counter& badRequests();
+		/// Returns the counter for the number of HTTP requests
+		/// that could not be parsed.
+
+	const Counter& badRequests() const;
+		/// Returns the counter for the number of HTTP requests
+		/// that could not be parsed.
+
+	Counter& bytesReceived();
+		/// Returns the counter for the number of bytes
+		/// received over HTTP connections.
+
+	const Counter& bytesReceived() const;
+		/// Returns the counter for the number of bytes
+		/// received over HTTP connections.
+
+	Counter& bytesSent();
+		/// Returns the counter for the number of bytes
+		/// sent over HTTP connections.
+
+	const Counter& bytesSent() const;
+		/// Returns the counter for the number of bytes
+		/// sent over HTTP connections.
+
+	Histogram& queueWaitTime();
+		/// Returns the histogram of the times accepted connections
+		/// spent in the TCPServerDispatcher's queue.
+
+	const Histogram& queueWaitTime() const;
+		/// Returns the histogram of the times accepted connections
+		/// spent in the TCPServerDispatcher's queue.
+
+	Histogram& connectionTime();
+		/// Returns the histogram of the times
+		/// connections have been served.
+
+	const Histogram& connectionTime() const;
+		/// Returns the histogram of the times
+		/// connections have been served.
+
+	Histogram& requestParseTime();
+		/// Returns the histogram of the times spent receiving
+		/// and parsing HTTP request headers. For the first request
+		/// on a connection, this includes the time until the client
+		/// starts sending the request.
+
+	const Histogram& requestParseTime() const;
+		/// Returns the histogram of the times spent receiving
+		/// and parsing HTTP request headers. For the first request
+		/// on a connection, this includes the time until the client
+		/// starts sending the request.
+
+	Histogram& requestHandleTime();
+		/// Returns the histogram of the times spent in
+		/// HTTPRequestHandler::handleRequest().
+
+	const Histogram& requestHandleTime() const;
+		/// Returns the histogram of the times spent in
+		/// HTTPRequestHandler::handleRequest().
+
+	Histogram& responseWriteTime();
+		/// Returns the histogram of the times spent completing
+		/// and sending HTTP responses after the request handler
+		/// has returned.
+
+	const Histogram& responseWriteTime() const;
+		/// Returns the histogram of the times spent completing
+		/// and sending HTTP responses after the request handler
+		/// has returned.
+
+	void reset();
+		/// Resets all counters and histograms.
+
+	void writeJSON(std::ostream& ostr) const;
+		/// Writes the statistics as a JSON object to
+		/// the given stream. Times are given in microseconds.
+
+	void writePrometheus(std::ostream& ostr, const std::string& prefix = "poco_server") const;
+		/// Writes the statistics in the Prometheus text exposition
+		/// format to the given stream. Metric names start with
+		/// the given prefix. Histograms are written as summaries,
+		/// with times given in seconds.
+
+protected:
+	~ServerStatistics();
+		/// Destroys the ServerStatistics.
+
+private:
+	ServerStatistics(const ServerStatistics&);
+	ServerStatistics& operator = (const ServerStatistics&);
+
+	Counter _connections;
+	Counter _requests;
+	Counter _keepAliveRequests;
+	Counter _badRequests;
+	Counter _bytesReceived;
+	Counter _bytesSent;
+	Histogram _queueWaitTime;
+	Histogram _connectionTime;
+	Histogram _requestParseTime;
+	Histogram _requestHandleTime;
+	Histogram _responseWriteTime;
+};
+
+
+//
+// inlines
+//
+inline void ServerStatistics::Histogram::recordElapsed(const Poco::Clock& since)
+{
+	Poco::Clock::ClockDiff diff = since.elapsed();
+	record(diff > 0 ? static_cast<Poco::UInt64>(diff) : 0);
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::connections()
+{
+	return _connections;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::connections() const
+{
+	return _connections;
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::requests()
+{
+	return _requests;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::requests() const
+{
+	return _requests;
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::keepAliveRequests()
+{
+	return _keepAliveRequests;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::keepAliveRequests() const
+{
+	return _keepAliveRequests;
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::badRequests()
+{
+	return _badRequests;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::badRequests() const
+{
+	return _badRequests;
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::bytesReceived()
+{
+	return _bytesReceived;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::bytesReceived() const
+{
+	return _bytesReceived;
+}
+
+
+inline ServerStatistics::Counter& ServerStatistics::bytesSent()
+{
+	return _bytesSent;
+}
+
+
+inline const ServerStatistics::Counter& ServerStatistics::bytesSent() const
+{
+	return _bytesSent;
+}
+
+
+inline ServerStatistics::Histogram& ServerStatistics::queueWaitTime()
+{
+	return _queueWaitTime;
+}
+
+
+inline const ServerStatistics::Histogram& ServerStatistics::queueWaitTime() const
+{
+	return _queueWaitTime;
+}
+
+
+inline ServerStatistics::Histogram& ServerStatistics::connectionTime()
+{
+	return _connectionTime;
+}
+
+
+inline const ServerStatistics::Histogram& ServerStatistics::connectionTime() const
+{
+	return _connectionTime;
+}
+
+
+inline ServerStatistics::Histogram& ServerStatistics::requestParseTime()
+{
+	return _requestParseTime;
+}
+
+
+inline const ServerStatistics::Histogram& ServerStatistics::requestParseTime() const
+{
+	return _requestParseTime;
+}
+
+
+inline ServerStatistics::Histogram& ServerStatistics::requestHandleTime()
+{
+	return _requestHandleTime;
+}
+
+
+inline const ServerStatistics::Histogram& ServerStatistics::requestHandleTime() const
+{
+	return _requestHandleTime;
+}
+
+
+inline ServerStatistics::Histogram& ServerStatistics::responseWriteTime()
+{
+	return _responseWriteTime;
+}
+
+
+inline const ServerStatistics::Histogram& ServerStatistics::responseWriteTime() const
+{
+	return _responseWriteTime;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_ServerStatistics_INCLUDED
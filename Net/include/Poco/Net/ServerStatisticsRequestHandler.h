@@ -0,0 +1,64 @@
+//
+// ServerStatisticsRequestHandler.h
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  ServerStatisticsRequestHandler
+//
+// Definition of the ServerStatisticsRequestHandler class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_ServerStatisticsRequestHandler_INCLUDED
+#define Net_ServerStatisticsRequestHandler_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/ServerStatistics.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API ServerStatisticsRequestHandler: public HTTPRequestHandler
+	/// A HTTPRequestHandler that sends the contents of a
+	/// ServerStatistics object in the response.
+	///
+	/// By default, the statistics are sent in the Prometheus
+	/// text exposition format, so that the handler can be used
+	/// as a Prometheus scrape target. If the request has a
+	/// "format=json" query parameter or its Accept header
+	/// contains "application/json", the statistics are sent
+	/// in JSON format.
+{
+public:
+	ServerStatisticsRequestHandler(ServerStatistics::Ptr pStatistics, const std::string& prefix = "poco_server");
+		/// Creates the ServerStatisticsRequestHandler for the
+		/// given ServerStatistics. Prometheus metric names
+		/// start with the given prefix.
+
+	~ServerStatisticsRequestHandler();
+		/// Destroys the ServerStatisticsRequestHandler.
+
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response);
+		/// Sends the statistics.
+
+private:
+	ServerStatistics::Ptr _pStatistics;
+	std::string _prefix;
+};
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_ServerStatisticsRequestHandler_INCLUDED
@@ -286,6 +286,20 @@ public:
 	static bool supportsIPv6();
 		/// Returns true if the system supports IPv6.
 
+	static SocketBuf makeBuffer(const void* buffer, std::size_t length);
+		/// Returns a SocketBuf referring to the given buffer,
+		/// for use with StreamSocket::sendBytes(const SocketBufVec&).
+		/// The buffer is not copied.
+
+	static const char* bufferData(const SocketBuf& buffer);
+		/// Returns a pointer to the data of the given SocketBuf.
+
+	static std::size_t bufferLength(const SocketBuf& buffer);
+		/// Returns the length of the given SocketBuf.
+
+	static std::size_t bufferLength(const SocketBufVec& buffers);
+		/// Returns the total length of the given SocketBufs.
+
 	void init(int af);
 		/// Creates the underlying system socket for the given
 		/// address family.
@@ -621,6 +635,51 @@ inline bool Socket::supportsIPv6()
 }
 
 
+inline SocketBuf Socket::makeBuffer(const void* buffer, std::size_t length)
+{
+	SocketBuf buf;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	buf.buf = static_cast<char*>(const_cast<void*>(buffer));
+	buf.len = static_cast<ULONG>(length);
+#else
+	buf.iov_base = const_cast<void*>(buffer);
+	buf.iov_len  = length;
+#endif
+	return buf;
+}
+
+
+inline const char* Socket::bufferData(const SocketBuf& buffer)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buffer.buf;
+#else
+	return static_cast<const char*>(buffer.iov_base);
+#endif
+}
+
+
+inline std::size_t Socket::bufferLength(const SocketBuf& buffer)
+{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	return buffer.len;
+#else
+	return buffer.iov_len;
+#endif
+}
+
+
+inline std::size_t Socket::bufferLength(const SocketBufVec& buffers)
+{
+	std::size_t length = 0;
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		length += bufferLength(*it);
+	}
+	return length;
+}
+
+
 inline void Socket::init(int af)
 {
 	_pImpl->init(af);
@@ -0,0 +1,234 @@
+//
+// SocketCompletionReactor.h
+//
+// $Id$
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketCompletionReactor
+//
+// Definition of the SocketCompletionReactor class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_SocketCompletionReactor_INCLUDED
+#define Net_SocketCompletionReactor_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Runnable.h"
+#include "Poco/Timespan.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+class SocketCompletionReactorImpl;
+
+
+class Net_API SocketCompletionReactor: public Poco::Runnable
+	/// SocketCompletionReactor is a completion-based counterpart of
+	/// SocketReactor. Instead of notifying event handlers that a socket
+	/// has become readable or writable, it performs the I/O operations
+	/// itself and notifies the handler when an operation has completed:
+	///
+	///   - For a ServerSocket added with addAcceptor(), connections are
+	///     accepted continuously and passed to Handler::onAccept().
+	///   - For a StreamSocket added with addSocket(), data is received
+	///     continuously and passed to Handler::onReceive().
+	///   - Data given to send() is queued and sent in order, and
+	///     Handler::onSent() is called as data has been sent.
+	///
+	/// On Linux, if the Net library has been built with io_uring support
+	/// (POCO_HAVE_IO_URING, detected at build time) and the kernel supports
+	/// it, the operations are performed with io_uring: all operations
+	/// started while dispatching completions are submitted to the kernel
+	/// with a single system call, the sockets are registered as fixed
+	/// files, and data is received into buffers registered with the
+	/// kernel, one per socket. A single system call both submits the
+	/// pending operations and waits for completions, so receiving a
+	/// message does not require a separate recv() call.
+	///
+	/// Otherwise, the SocketCompletionReactor falls back to a PollSet
+	/// (epoll on Linux) and performs the operations when the sockets
+	/// become ready. The Handler interface is the same in both cases.
+	/// usesIOUring() tells which implementation is in use.
+	///
+	/// All methods except stop() must be called from the thread running
+	/// the SocketCompletionReactor (i.e., from a Handler), or before
+	/// run() has been called. The blocking mode of sockets added to the
+	/// SocketCompletionReactor is changed as required by the implementation
+	/// in use, so sockets should not be used outside of the
+	/// SocketCompletionReactor until they have been removed.
+{
+public:
+	class Net_API Handler
+		/// The interface for receiving completion notifications
+		/// from a SocketCompletionReactor.
+		///
+		/// The default implementations of all methods do nothing.
+	{
+	public:
+		virtual ~Handler();
+			/// Destroys the Handler.
+
+		virtual void onAccept(ServerSocket& serverSocket, StreamSocket& socket);
+			/// Called when a connection has been accepted on the given
+			/// server socket. To receive data from the new connection,
+			/// add the socket to the reactor with addSocket().
+
+		virtual void onReceive(StreamSocket& socket, const char* buffer, std::size_t length);
+			/// Called when data has been received from the given socket.
+			///
+			/// A length of zero means that the peer has shut down the
+			/// connection. In this case, the socket has already been
+			/// removed from the reactor.
+			///
+			/// The buffer is only valid until onReceive() returns.
+
+		virtual void onSent(StreamSocket& socket, std::size_t length);
+			/// Called when the given number of bytes from the
+			/// send queue has been sent over the given socket.
+
+		virtual void onError(Socket& socket, int errorCode);
+			/// Called when an operation on the given socket has failed
+			/// with the given (system-specific) error code. The socket
+			/// has already been removed from the reactor.
+	};
+
+	enum
+	{
+		DEFAULT_MAX_SOCKETS = 1024,
+			/// The default maximum number of sockets.
+		DEFAULT_BUFFER_SIZE = 4096
+			/// The default size of the receive buffer
+			/// of every socket.
+	};
+
+	SocketCompletionReactor(int maxSockets = DEFAULT_MAX_SOCKETS, int bufferSize = DEFAULT_BUFFER_SIZE);
+		/// Creates the SocketCompletionReactor for at most maxSockets
+		/// sockets (including server sockets), using a receive buffer
+		/// of bufferSize bytes for every socket.
+		///
+		/// io_uring is used if available, otherwise a PollSet.
+
+	SocketCompletionReactor(int maxSockets, int bufferSize, bool useIOUring);
+		/// Creates the SocketCompletionReactor. If useIOUring is false,
+		/// a PollSet is used even if io_uring is available.
+
+	~SocketCompletionReactor();
+		/// Destroys the SocketCompletionReactor.
+
+	void run();
+		/// Runs the SocketCompletionReactor, dispatching completions
+		/// until stop() is called.
+
+	void stop();
+		/// Stops the SocketCompletionReactor.
+		///
+		/// The SocketCompletionReactor will be stopped when the
+		/// currently pending operations have been processed,
+		/// or when the timeout expires.
+
+	void setTimeout(const Poco::Timespan& timeout);
+		/// Sets the maximum time run() waits for completions before
+		/// checking whether the reactor has been stopped.
+		///
+		/// The default timeout is 250 milliseconds.
+
+	const Poco::Timespan& getTimeout() const;
+		/// Returns the timeout.
+
+	void addAcceptor(const ServerSocket& socket, Handler& handler);
+		/// Starts accepting connections on the given server socket.
+		/// Accepted connections are passed to handler.onAccept().
+		///
+		/// Throws a Poco::IllegalStateException if the maximum
+		/// number of sockets has been reached.
+
+	void addSocket(const StreamSocket& socket, Handler& handler);
+		/// Starts receiving data from the given socket.
+		/// Received data is passed to handler.onReceive().
+		///
+		/// Throws a Poco::IllegalStateException if the maximum
+		/// number of sockets has been reached.
+
+	void removeSocket(const Socket& socket);
+		/// Stops all operations on the given socket and removes it
+		/// from the reactor. Data that has not been sent yet is
+		/// discarded. The socket's handler is not called anymore
+		/// for the socket.
+		///
+		/// Does nothing if the socket has not been added.
+		///
+		/// If io_uring is used, the pending operations on the socket
+		/// are cancelled asynchronously, and the socket only counts
+		/// towards the maximum number of sockets until they have
+		/// completed.
+
+	bool hasSocket(const Socket& socket) const;
+		/// Returns true if the socket has been added to the reactor.
+
+	void send(const StreamSocket& socket, const void* buffer, std::size_t length);
+		/// Queues the given data for sending over the given
+		/// socket, which must have been added with addSocket().
+		/// The data is copied.
+		///
+		/// Throws a Poco::NotFoundException if the socket has
+		/// not been added.
+
+	std::size_t pendingOutput(const StreamSocket& socket) const;
+		/// Returns the number of bytes queued for sending
+		/// over the given socket that have not been sent yet.
+
+	bool usesIOUring() const;
+		/// Returns true if io_uring is used, or false
+		/// if a PollSet is used.
+
+	static bool isIOUringAvailable();
+		/// Returns true if the Net library has been built with
+		/// io_uring support and the kernel supports io_uring.
+
+private:
+	SocketCompletionReactor(const SocketCompletionReactor&);
+	SocketCompletionReactor& operator = (const SocketCompletionReactor&);
+
+	enum
+	{
+		DEFAULT_TIMEOUT = 250000
+	};
+
+	SocketCompletionReactorImpl* _pImpl;
+	Poco::Timespan               _timeout;
+	volatile bool                _stop;
+};
+
+
+//
+// inlines
+//
+inline void SocketCompletionReactor::setTimeout(const Poco::Timespan& timeout)
+{
+	_timeout = timeout;
+}
+
+
+inline const Poco::Timespan& SocketCompletionReactor::getTimeout() const
+{
+	return _timeout;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_SocketCompletionReactor_INCLUDED
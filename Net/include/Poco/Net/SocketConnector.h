@@ -24,6 +24,7 @@
 #include "Poco/Net/SocketNotification.h"
 #include "Poco/Net/SocketAddress.h"
 #include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/DNSResolver.h"
 #include "Poco/Observer.h"
 
 
@@ -32,7 +33,7 @@ namespace Net {
 
 
 template <class ServiceHandler>
-class SocketConnector
+class SocketConnector: private DNSResolver::Callback
 	/// This class implements the Connector part of the
 	/// Acceptor-Connector design pattern.
 	///
@@ -71,17 +72,33 @@ class SocketConnector
 	///
 	/// Subclasses can override the createServiceHandler() factory method
 	/// if special steps are necessary to create a ServiceHandler object.
+	///
+	/// If the SocketConnector is given a host name and a DNSResolver,
+	/// the host name is resolved asynchronously, so the reactor thread
+	/// is never blocked by a DNS lookup. The lookup is started by start(),
+	/// which must be called once the SocketConnector (including any
+	/// subclass) has been fully constructed. The connect operation is
+	/// started, and the SocketConnector registered with the SocketReactor,
+	/// by the DNSResolver's worker thread when the lookup has completed
+	/// (or from within start(), if the host name is cached). If the host
+	/// name cannot be resolved, onError() is called with POCO_EHOSTUNREACH.
 {
 public:		
 	explicit SocketConnector(SocketAddress& address):
-		_pReactor(0)
+		_pReactor(0),
+		_pResolver(0),
+		_pResolveReactor(0),
+		_port(0)
 		/// Creates a SocketConnector, using the given Socket.
 	{
 		_socket.connectNB(address);
 	}
 
 	SocketConnector(SocketAddress& address, SocketReactor& reactor):
-		_pReactor(0)
+		_pReactor(0),
+		_pResolver(0),
+		_pResolveReactor(0),
+		_port(0)
 		/// Creates an acceptor, using the given ServerSocket.
 		/// The SocketConnector registers itself with the given SocketReactor.
 	{
@@ -89,11 +106,60 @@ public:
 		registerConnector(reactor);
 	}
 
+	SocketConnector(SocketAddress& address, SocketReactor& reactor, const StreamSocket& socket):
+		_socket(socket),
+		_pReactor(0),
+		_pResolver(0),
+		_pResolveReactor(0),
+		_port(0)
+		/// Creates a SocketConnector, using the given unconnected
+		/// StreamSocket, which can also be a SecureStreamSocket.
+		/// The SocketConnector registers itself with the given SocketReactor.
+	{
+		_socket.connectNB(address);
+		registerConnector(reactor);
+	}
+
+	SocketConnector(const std::string& host, Poco::UInt16 port, SocketReactor& reactor, DNSResolver& resolver):
+		_pReactor(0),
+		_pResolver(&resolver),
+		_pResolveReactor(&reactor),
+		_host(host),
+		_port(port)
+		/// Creates a SocketConnector that connects to the given host
+		/// and port, after the host name has been resolved by the
+		/// given DNSResolver.
+		/// The SocketConnector registers itself with the given SocketReactor
+		/// when the connect operation has been started.
+		///
+		/// The host name is not resolved until start() is called.
+	{
+	}
+
+	SocketConnector(const std::string& host, Poco::UInt16 port, SocketReactor& reactor, DNSResolver& resolver, const StreamSocket& socket):
+		_socket(socket),
+		_pReactor(0),
+		_pResolver(&resolver),
+		_pResolveReactor(&reactor),
+		_host(host),
+		_port(port)
+		/// Creates a SocketConnector that connects the given unconnected
+		/// StreamSocket, which can also be a SecureStreamSocket, to the
+		/// given host and port, after the host name has been resolved
+		/// by the given DNSResolver.
+		/// The SocketConnector registers itself with the given SocketReactor
+		/// when the connect operation has been started.
+		///
+		/// The host name is not resolved until start() is called.
+	{
+	}
+
 	virtual ~SocketConnector()
 		/// Destroys the SocketConnector.
 	{
 		try
 		{
+			if (_pResolver) _pResolver->cancel(*this);
 			unregisterConnector();
 		}
 		catch (...)
@@ -102,6 +168,19 @@ public:
 		}
 	}
 	
+	void start()
+		/// Starts resolving the host name given to the constructor.
+		/// Does nothing if the SocketConnector has been given an address.
+		///
+		/// Must be called after the SocketConnector has been constructed,
+		/// and at most once. If the host name is cached, the connect
+		/// operation is started (or onError() is called) before start()
+		/// returns. Otherwise, this happens in the DNSResolver's worker
+		/// thread.
+	{
+		if (_pResolver) _pResolver->resolveAsync(_host, *this);
+	}
+
 	virtual void registerConnector(SocketReactor& reactor)
 		/// Registers the SocketConnector with a SocketReactor.
 		///
@@ -202,9 +281,33 @@ private:
 	SocketConnector();
 	SocketConnector(const SocketConnector&);
 	SocketConnector& operator = (const SocketConnector&);
+
+	void onResolved(const std::string&, const HostEntry& entry)
+	{
+		try
+		{
+			SocketAddress address(entry.addresses()[0], _port);
+			_socket.connectNB(address);
+		}
+		catch (Poco::Exception&)
+		{
+			onError(POCO_EHOSTUNREACH);
+			return;
+		}
+		registerConnector(*_pResolveReactor);
+	}
+
+	void onResolveError(const std::string&, const Poco::Exception&)
+	{
+		onError(POCO_EHOSTUNREACH);
+	}
 	
 	StreamSocket   _socket;
 	SocketReactor* _pReactor;
+	DNSResolver*   _pResolver;
+	SocketReactor* _pResolveReactor;
+	std::string    _host;
+	Poco::UInt16   _port;
 };
 
 
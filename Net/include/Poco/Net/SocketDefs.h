@@ -140,6 +140,7 @@
 		#include <sys/select.h>
 	#endif
 	#include <sys/ioctl.h>
+	#include <sys/uio.h>
 	#if defined(POCO_OS_FAMILY_VMS)
 		#include <inet.h>
 	#else
@@ -353,6 +354,10 @@
 #endif
 
 
+#include <vector>
+#include <cstddef>
+
+
 namespace Poco {
 namespace Net {
 
@@ -378,6 +383,26 @@ struct AddressFamily
 };
 
 
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	typedef WSABUF SocketBuf;
+#elif defined(POCO_OS_FAMILY_UNIX) || defined(POCO_OS_FAMILY_VMS)
+	typedef struct iovec SocketBuf;
+#else
+	struct SocketBuf
+	{
+		void*       iov_base;
+		std::size_t iov_len;
+	};
+#endif
+	/// A buffer for scatter/gather I/O (WSABUF on Windows,
+	/// struct iovec on other platforms). Use Socket::makeBuffer()
+	/// to create a SocketBuf in a portable way.
+
+
+typedef std::vector<SocketBuf> SocketBufVec;
+	/// A list of buffers for scatter/gather I/O.
+
+
 } } // namespace Poco::Net
 
 
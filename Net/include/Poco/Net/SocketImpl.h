@@ -23,11 +23,17 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/SocketDefs.h"
 #include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/DatagramPacket.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
 
 
 namespace Poco {
+
+
+class FileInputStream;
+
+
 namespace Net {
 
 
@@ -47,6 +53,13 @@ public:
 		SELECT_ERROR = 4
 	};
 
+	enum
+	{
+		MAX_BATCH_SIZE = 64
+			/// The maximum number of datagrams transferred
+			/// by a single sendBatch() or receiveBatch() call.
+	};
+
 	virtual SocketImpl* acceptConnection(SocketAddress& clientAddr);
 		/// Get the next completed connection from the
 		/// socket's completed connection queue.
@@ -169,6 +182,40 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 	
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket, using a single system call (sendmsg()
+		/// or WSASend()) where possible.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
+	virtual int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in the
+		/// given buffers, filling each buffer before the next one,
+		/// using a single system call (recvmsg() or WSARecv())
+		/// where possible.
+		///
+		/// Returns the number of bytes received, which may be
+		/// less than the total size of the buffers.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
+	virtual Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends up to count bytes of the file opened by the given
+		/// stream, starting at the given offset. Stops at the
+		/// end of the file.
+		///
+		/// Returns the number of bytes sent.
+		///
+		/// The default implementation reads the file through the
+		/// stream and sends the data with sendBytes(). StreamSocketImpl
+		/// lets the kernel copy the data where possible.
+
 	virtual int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
@@ -191,6 +238,32 @@ public:
 		/// Stores the address of the sender in address.
 		///
 		/// Returns the number of bytes received.
+
+	virtual int sendBatch(const DatagramPacketVec& packets, int flags = 0);
+		/// Sends the given datagrams, each to the address
+		/// given in its DatagramPacket.
+		///
+		/// On Linux, up to MAX_BATCH_SIZE datagrams are sent
+		/// with a single sendmmsg() call. On other platforms,
+		/// the datagrams are sent one by one with sendTo().
+		///
+		/// Returns the number of datagrams sent, which may be
+		/// less than the number of packets given.
+
+	virtual int receiveBatch(DatagramPacketVec& packets, int flags = 0);
+		/// Receives up to packets.size() datagrams, waiting for
+		/// the first one, but not for any further datagrams.
+		/// Stores the size, the sender's address and, if enabled,
+		/// the receive timestamp of each datagram in its
+		/// DatagramPacket.
+		///
+		/// On Linux, up to MAX_BATCH_SIZE datagrams are received
+		/// with a single recvmmsg() call. On other platforms, the
+		/// datagrams are received one by one with receiveFrom().
+		///
+		/// Returns the number of datagrams received, or -1
+		/// if the socket is in non-blocking mode and no
+		/// datagram is available.
 	
 	virtual void sendUrgent(unsigned char data);
 		/// Sends one byte of urgent data through
@@ -359,6 +432,17 @@ public:
 	bool getBroadcast();
 		/// Returns the value of the SO_BROADCAST socket option.
 
+	void setReceiveTimestamps(bool flag);
+		/// Enables or disables kernel receive timestamps
+		/// for receiveBatch(), using the SO_TIMESTAMPNS
+		/// socket option.
+		///
+		/// Throws a Poco::NotImplementedException if the
+		/// platform does not support receive timestamps.
+
+	bool getReceiveTimestamps();
+		/// Returns true if kernel receive timestamps are enabled.
+
 	virtual void setBlocking(bool flag);
 		/// Sets the socket in blocking mode if flag is true,
 		/// disables blocking mode if flag is false.
@@ -434,6 +518,23 @@ protected:
 	void reset(poco_socket_t fd = POCO_INVALID_SOCKET);
 		/// Allows subclasses to set the socket manually, iff no valid socket is set yet.
 
+	int sendGathered(const SocketBufVec& buffers, int flags);
+		/// Copies the contents of the given buffers into a single
+		/// buffer and sends it with sendBytes(const void*, int, int).
+		///
+		/// Subclasses that transform the data written to the socket
+		/// (e.g., for encryption or framing) implement
+		/// sendBytes(const SocketBufVec&, int) by calling this method.
+
+	int receiveScattered(SocketBufVec& buffers, int flags);
+		/// Receives data into a single buffer with
+		/// receiveBytes(void*, int, int), and copies it
+		/// into the given buffers.
+		///
+		/// Subclasses that transform the data read from the socket
+		/// implement receiveBytes(SocketBufVec&, int) by calling
+		/// this method.
+
 	static int lastError();
 		/// Returns the last error code.
 
@@ -461,6 +562,7 @@ private:
 	
 	friend class Socket;
 	friend class SecureSocketImpl;
+	friend class PollSetImpl;
 };
 
 
@@ -22,6 +22,7 @@
 
 #include "Poco/Net/Net.h"
 #include "Poco/Net/Socket.h"
+#include "Poco/Net/PollSet.h"
 #include "Poco/Runnable.h"
 #include "Poco/Timespan.h"
 #include "Poco/Observer.h"
@@ -71,7 +72,10 @@ class Net_API SocketReactor: public Poco::Runnable
 	/// as argument.
 	///
 	/// Once started, the SocketReactor waits for events
-	/// on the registered sockets, using Socket::select().
+	/// on the registered sockets, using a PollSet. Sockets are
+	/// registered with the PollSet when event handlers are added
+	/// or removed, so the cost of waiting for events does not
+	/// depend on the number of idle sockets (if epoll is available).
 	/// If an event is detected, the corresponding event handler
 	/// is invoked. There are five event types (and corresponding
 	/// notification classes) defined: ReadableNotification, WritableNotification,
@@ -87,10 +91,17 @@ class Net_API SocketReactor: public Poco::Runnable
 	/// TimeoutNotification will be dispatched to all event handlers
 	/// registered for it. This is done in the onTimeout() method
 	/// which can be overridden by subclasses to perform custom
-	/// timeout processing.
+	/// timeout processing. If the SocketReactor is so busy that
+	/// the timeout never expires, the TimeoutNotification is
+	/// dispatched after the events of a poll, once the timeout has
+	/// elapsed since the last TimeoutNotification (unless stop()
+	/// has been called by one of the handlers). Handlers can
+	/// therefore use the TimeoutNotification to check their own
+	/// deadlines, but must not assume that a TimeoutNotification
+	/// means that none of their sockets had any events.
 	///
-	/// If there are no sockets for the SocketReactor to pass to
-	/// Socket::select(), an IdleNotification will be dispatched to
+	/// If there are no sockets for the SocketReactor to poll,
+	/// an IdleNotification will be dispatched to
 	/// all event handlers registered for it. This is done in the
 	/// onIdle() method which can be overridden by subclasses
 	/// to perform custom idle processing. Since onIdle() will be
@@ -144,7 +155,7 @@ public:
 		///
 		/// The default timeout is 250 milliseconds;
 		///
-		/// The timeout is passed to the Socket::select()
+		/// The timeout is passed to the PollSet::poll()
 		/// method.
 		
 	const Poco::Timespan& getTimeout() const;
@@ -169,14 +180,16 @@ public:
 
 protected:
 	virtual void onTimeout();
-		/// Called if the timeout expires and no other events are available.
+		/// Called if the timeout expires and no other events are available,
+		/// or if no timeout has been dispatched within the timeout
+		/// because the SocketReactor is busy.
 		///
 		/// Can be overridden by subclasses. The default implementation
 		/// dispatches the TimeoutNotification and thus should be called by overriding
 		/// implementations.
 
 	virtual void onIdle();
-		/// Called if no sockets are available to call select() on.
+		/// Called if no sockets are available to poll.
 		///
 		/// Can be overridden by subclasses. The default implementation
 		/// dispatches the IdleNotification and thus should be called by overriding
@@ -209,6 +222,9 @@ private:
 	typedef std::map<Socket, NotifierPtr>     EventHandlerMap;
 
 	void dispatch(NotifierPtr& pNotifier, SocketNotification* pNotification);
+	NotifierPtr getNotifier(const Socket& socket, bool makeNew = false);
+	int pollMode(NotifierPtr& pNotifier);
+	int pollMode(const Poco::AbstractObserver& observer);
 
 	enum
 	{
@@ -218,6 +234,7 @@ private:
 	bool            _stop;
 	Poco::Timespan  _timeout;
 	EventHandlerMap _handlers;
+	PollSet         _pollSet;
 	NotificationPtr _pReadableNotification;
 	NotificationPtr _pWritableNotification;
 	NotificationPtr _pErrorNotification;
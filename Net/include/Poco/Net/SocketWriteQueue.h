@@ -0,0 +1,254 @@
+//
+// SocketWriteQueue.h
+//
+// $Id$
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketWriteQueue
+//
+// Definition of the SocketWriteQueue class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_SocketWriteQueue_INCLUDED
+#define Net_SocketWriteQueue_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/BasicEvent.h"
+#include "Poco/SharedPtr.h"
+#include "Poco/Exception.h"
+#include "Poco/Mutex.h"
+#include <deque>
+#include <string>
+
+
+namespace Poco {
+namespace Net {
+
+
+class SocketReactor;
+class WritableNotification;
+
+
+class Net_API SocketWriteQueue
+	/// SocketWriteQueue buffers outgoing data for a StreamSocket
+	/// whose event handlers are registered with a SocketReactor.
+	///
+	/// Data passed to write() is sent immediately, as far as
+	/// the socket accepts it without blocking. Data that cannot
+	/// be sent immediately is queued, and the SocketWriteQueue
+	/// registers itself for WritableNotifications with the
+	/// SocketReactor, so that the queue is flushed as soon as the
+	/// socket becomes writable again. Once the queue is empty, the
+	/// SocketWriteQueue unregisters itself again, so that the
+	/// SocketReactor does not spin on an idle, writable socket.
+	///
+	/// Data can be queued without copying it, either by passing a
+	/// SharedBuffer (which can be queued for many sockets at once,
+	/// e.g. for broadcasting a message), or by handing over a
+	/// std::string with adopt(). Small blocks of data passed to
+	/// write(const void*, std::size_t) are copied and coalesced
+	/// into larger buffers. All queued buffers are sent with a
+	/// single scatter/gather send operation.
+	///
+	/// For backpressure, the SocketWriteQueue fires the
+	/// highWatermarkReached event when the amount of queued data
+	/// reaches the high watermark, and the lowWatermarkReached
+	/// event when it has subsequently been drained to the low
+	/// watermark. A typical handler stops reading from its source
+	/// (e.g., removes its ReadableNotification handler) in the first
+	/// case and resumes reading in the second one. The queue itself
+	/// does not limit the amount of queued data.
+	///
+	/// The socket is put into non-blocking mode.
+	///
+	/// All methods are thread-safe, so data can be written from
+	/// any thread. Events are fired without holding the internal
+	/// lock, so event handlers may call write(). The SocketWriteQueue
+	/// should be destroyed in the SocketReactor's thread, or after
+	/// the SocketReactor has been stopped.
+{
+public:
+	typedef Poco::SharedPtr<std::string> SharedBuffer;
+
+	enum
+	{
+		DEFAULT_HIGH_WATERMARK = 1024*1024,
+			/// The default high watermark.
+		DEFAULT_LOW_WATERMARK = 256*1024,
+			/// The default low watermark.
+		DEFAULT_COALESCE_SIZE = 4096
+			/// The default maximum size of a buffer into
+			/// which copied data is coalesced.
+	};
+
+	Poco::BasicEvent<const std::size_t> highWatermarkReached;
+		/// Fired when the amount of queued data has reached the
+		/// high watermark. The argument is the amount of queued data.
+
+	Poco::BasicEvent<const std::size_t> lowWatermarkReached;
+		/// Fired when the amount of queued data has been drained to
+		/// the low watermark, after the high watermark had been
+		/// reached. The argument is the amount of queued data.
+
+	Poco::BasicEvent<const Poco::Exception> writeFailed;
+		/// Fired when sending data has failed. All queued data
+		/// has been discarded, and all data written afterwards
+		/// will be discarded as well.
+
+	SocketWriteQueue(const StreamSocket& socket, SocketReactor& reactor);
+		/// Creates the SocketWriteQueue for the given socket and
+		/// SocketReactor, and puts the socket into non-blocking mode.
+
+	~SocketWriteQueue();
+		/// Destroys the SocketWriteQueue, unregistering it from
+		/// the SocketReactor. Data not sent yet is discarded.
+
+	void write(const void* buffer, std::size_t length);
+		/// Sends or queues the given data.
+		///
+		/// Data that cannot be sent immediately is copied. If
+		/// length does not exceed the coalesce size, the data is
+		/// appended to the last queued buffer, if possible.
+
+	void write(const SharedBuffer& pBuffer);
+		/// Sends or queues the given buffer, without copying it.
+		///
+		/// The buffer must not be modified until it has been sent
+		/// completely, i.e. until pending() no longer includes it.
+
+	void adopt(std::string& data);
+		/// Sends or queues the given data, taking over the contents
+		/// of the given string without copying it. The string is
+		/// left empty.
+
+	std::size_t pending() const;
+		/// Returns the number of bytes queued but not yet sent.
+
+	bool empty() const;
+		/// Returns true if all data has been sent.
+
+	bool full() const;
+		/// Returns true if the high watermark has been reached,
+		/// and the queued data has not yet been drained to the
+		/// low watermark.
+
+	bool failed() const;
+		/// Returns true if sending data has failed.
+
+	void setWatermarks(std::size_t low, std::size_t high);
+		/// Sets the low and high watermark.
+		///
+		/// Throws a Poco::InvalidArgumentException if low
+		/// is greater than high.
+
+	std::size_t getLowWatermark() const;
+		/// Returns the low watermark.
+
+	std::size_t getHighWatermark() const;
+		/// Returns the high watermark.
+
+	void setCoalesceSize(std::size_t size);
+		/// Sets the maximum size of a buffer into which
+		/// data copied by write() is coalesced. Zero
+		/// disables coalescing.
+
+	std::size_t getCoalesceSize() const;
+		/// Returns the coalesce size.
+
+	const StreamSocket& socket() const;
+		/// Returns the socket.
+
+	void onWritable(WritableNotification* pNf);
+		/// Flushes the queue. Called by the SocketReactor.
+
+protected:
+	enum Event
+	{
+		EVENT_NONE,
+		EVENT_HIGH_WATERMARK,
+		EVENT_LOW_WATERMARK,
+		EVENT_FAILED
+	};
+
+	void enqueue(const SharedBuffer& pBuffer, std::size_t offset, bool owned);
+		/// Appends the buffer, starting at the given offset, to
+		/// the queue. Must be called with the mutex locked.
+
+	std::size_t send(const char* data, std::size_t length);
+		/// Sends as much of the given data as possible without
+		/// blocking and returns the number of bytes sent.
+		/// Must be called with the mutex locked.
+
+	void fail(const Poco::Exception& exc);
+		/// Discards all queued data after a send error.
+		/// Must be called with the mutex locked.
+
+	Event flush();
+		/// Sends as much queued data as possible without blocking.
+		/// Must be called with the mutex locked.
+
+	Event update();
+		/// Registers or unregisters the WritableNotification handler
+		/// as required, and returns the event to be fired, if any.
+		/// Must be called with the mutex locked.
+
+	void fire(Event event);
+		/// Fires the event for the given condition.
+		/// Must be called with the mutex unlocked.
+
+private:
+	SocketWriteQueue();
+	SocketWriteQueue(const SocketWriteQueue&);
+	SocketWriteQueue& operator = (const SocketWriteQueue&);
+
+	struct Chunk
+	{
+		SharedBuffer pData;
+		std::size_t  offset;
+		bool         owned;
+	};
+
+	typedef std::deque<Chunk> ChunkQueue;
+
+	enum
+	{
+		MAX_GATHER = 64
+	};
+
+	StreamSocket       _socket;
+	SocketReactor&     _reactor;
+	ChunkQueue         _queue;
+	std::size_t        _pending;
+	std::size_t        _lowWatermark;
+	std::size_t        _highWatermark;
+	std::size_t        _coalesceSize;
+	bool               _full;
+	bool               _registered;
+	bool               _failed;
+	Poco::Exception*   _pException;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline const StreamSocket& SocketWriteQueue::socket() const
+{
+	return _socket;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_SocketWriteQueue_INCLUDED
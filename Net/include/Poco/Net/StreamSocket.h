@@ -109,6 +109,47 @@ public:
 		/// Certain socket implementations may also return a negative
 		/// value denoting a certain condition.
 
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket, in a single system call if possible
+		/// (scatter/gather I/O). The buffers are not copied.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+		///
+		/// Certain socket implementations may also return a negative
+		/// value denoting a certain condition.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in the
+		/// given buffers, filling each buffer before the next one.
+		/// Uses a single system call if possible (scatter/gather I/O).
+		///
+		/// Returns the number of bytes received.
+		/// A return value of 0 means a graceful shutdown
+		/// of the connection from the peer.
+		///
+		/// Throws a TimeoutException if a receive timeout has
+		/// been set and nothing is received within that interval.
+		/// Throws a NetException (or a subclass) in case of other errors.
+
+	Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends up to count bytes of the file opened by the given
+		/// FileInputStream, starting at the given offset in the file.
+		///
+		/// On Linux, plain TCP sockets send the file with sendfile(2),
+		/// so the data is not copied to user space. Otherwise, the
+		/// file is read through the stream and sent with sendBytes().
+		///
+		/// Returns the number of bytes sent, which is less than
+		/// count if the end of the file has been reached.
+
+	Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset = 0);
+		/// Sends the file opened by the given FileInputStream,
+		/// starting at the given offset, up to the end of the file.
+		///
+		/// Returns the number of bytes sent.
+
 	int sendBytes(Poco::FIFOBuffer& buffer);
 		/// Sends the contents of the given buffer through
 		/// the socket. FIFOBuffer has writable/readable transition
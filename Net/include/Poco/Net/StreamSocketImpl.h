@@ -50,6 +50,25 @@ public:
 		/// Returns the number of bytes sent. The return value may also be
 		/// negative to denote some special condition.
 
+	virtual int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Ensures that the contents of all buffers are sent if the
+		/// socket is blocking. In case of a non-blocking socket, sends as
+		/// many bytes as possible.
+		///
+		/// Returns the number of bytes sent. The return value may also be
+		/// negative to denote some special condition.
+
+	virtual Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends up to count bytes of the file opened by the given
+		/// stream, starting at the given offset.
+		///
+		/// On Linux, the data is sent with sendfile(2), without being
+		/// copied to user space. Elsewhere, or if the file does not
+		/// support sendfile(2), SocketImpl::sendFile() is used.
+		///
+		/// Ensures that all data is sent if the socket is blocking.
+		/// Returns the number of bytes sent.
+
 protected:
 	virtual ~StreamSocketImpl();
 };
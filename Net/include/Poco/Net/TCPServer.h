@@ -29,6 +29,7 @@
 #include "Poco/Runnable.h"
 #include "Poco/Thread.h"
 #include "Poco/ThreadPool.h"
+#include <vector>
 
 
 namespace Poco {
@@ -102,6 +103,13 @@ class Net_API TCPServer: public Poco::Runnable
 	/// Thus, the call to start() returns immediately, and the server
 	/// continues to run in the background.
 	///
+	/// On hosts with many cores, a single acceptor thread may become
+	/// a bottleneck. If TCPServerParams::setAcceptorCount() is used to
+	/// request more than one acceptor, the server opens additional
+	/// listening sockets on the same address using SO_REUSEPORT, each
+	/// with its own acceptor thread and worker group, and lets the
+	/// kernel distribute incoming connections among them.
+	///
 	/// To stop the server from accepting new connections, call stop().
 	///
 	/// After calling stop(), no new connections will be accepted and
@@ -221,14 +229,25 @@ protected:
 		/// Returns a thread name for the server thread.
 
 private:
+	struct Acceptor;
+
 	TCPServer();
 	TCPServer(const TCPServer&);
 	TCPServer& operator = (const TCPServer&);
-	
+
+	void acceptConnections(ServerSocket& socket, TCPServerDispatcher* pDispatcher);
+	void createAcceptors(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, TCPServerParams::Ptr pParams);
+	void destroyAcceptors();
+	static void runAcceptor(void* pAcceptor);
+	static ServerSocket createSocket(Poco::UInt16 portNumber, TCPServerParams::Ptr pParams);
+
+	typedef std::vector<Acceptor*> AcceptorVec;
+
 	ServerSocket _socket;
 	TCPServerDispatcher* _pDispatcher;
 	TCPServerConnectionFilter::Ptr _pConnectionFilter;
 	Poco::Thread _thread;
+	AcceptorVec _acceptors;
 	bool _stopped;
 };
 
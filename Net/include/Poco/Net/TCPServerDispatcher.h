@@ -26,6 +26,7 @@
 #include "Poco/Net/TCPServerParams.h"
 #include "Poco/Runnable.h"
 #include "Poco/NotificationQueue.h"
+#include "Poco/LockFreeNotificationQueue.h"
 #include "Poco/ThreadPool.h"
 #include "Poco/Mutex.h"
 
@@ -87,6 +88,10 @@ public:
 	const TCPServerParams& params() const;
 		/// Returns a const reference to the TCPServerParam object.
 
+	ServerStatistics::Ptr statistics() const;
+		/// Returns the ServerStatistics object given in the
+		/// TCPServerParams, or null if no statistics are collected.
+
 protected:
 	~TCPServerDispatcher();
 		/// Destroys the TCPServerDispatcher.
@@ -98,22 +103,27 @@ protected:
 		/// Updates the performance counters.
 
 private:
+	Poco::Notification* waitDequeue(long milliseconds);
+	bool queueEmpty() const;
+
 	TCPServerDispatcher();
 	TCPServerDispatcher(const TCPServerDispatcher&);
 	TCPServerDispatcher& operator = (const TCPServerDispatcher&);
 
 	int _rc;
 	TCPServerParams::Ptr _pParams;
+	ServerStatistics::Ptr _pStatistics;
 	int  _currentThreads;
 	int  _totalConnections;
 	int  _currentConnections;
 	int  _maxConcurrentConnections;
 	int  _refusedConnections;
 	bool _stopped;
-	Poco::NotificationQueue         _queue;
-	TCPServerConnectionFactory::Ptr _pConnectionFactory;
-	Poco::ThreadPool&               _threadPool;
-	mutable Poco::FastMutex         _mutex;
+	Poco::NotificationQueue          _queue;
+	Poco::LockFreeNotificationQueue* _pLockFreeQueue;
+	TCPServerConnectionFactory::Ptr  _pConnectionFactory;
+	Poco::ThreadPool&                _threadPool;
+	mutable Poco::FastMutex          _mutex;
 };
 
 
@@ -126,6 +136,12 @@ inline const TCPServerParams& TCPServerDispatcher::params() const
 }
 
 
+inline ServerStatistics::Ptr TCPServerDispatcher::statistics() const
+{
+	return _pStatistics;
+}
+
+
 } } // namespace Poco::Net
 
 
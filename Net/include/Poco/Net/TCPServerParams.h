@@ -21,6 +21,7 @@
 
 
 #include "Poco/Net/Net.h"
+#include "Poco/Net/ServerStatistics.h"
 #include "Poco/RefCountedObject.h"
 #include "Poco/Timespan.h"
 #include "Poco/Thread.h"
@@ -47,6 +48,9 @@ public:
 		///   - threadIdleTime:       10 seconds
 		///   - maxThreads:           0
 		///   - maxQueued:            64
+		///   - acceptorCount:        1
+		///   - lockFreeQueue:        false
+		///   - statistics:           none
 
 	void setThreadIdleTime(const Poco::Timespan& idleTime);
 		/// Sets the maximum idle time for a thread before
@@ -94,6 +98,59 @@ public:
 		/// Returns the priority of TCP server threads
 		/// created by TCPServer. 
 
+	void setAcceptorCount(int count);
+		/// Sets the number of listening sockets and acceptor
+		/// threads used by TCPServer. Must be greater than 0.
+		///
+		/// If count is greater than 1, the TCPServer opens count - 1
+		/// additional listening sockets bound to the same address
+		/// as the server socket, using the SO_REUSEPORT socket option.
+		/// The operating system then distributes incoming connections
+		/// among the listening sockets. Each listening socket has its
+		/// own acceptor thread and its own TCPServerDispatcher (worker
+		/// group) with a separate connection queue, so acceptor threads
+		/// never contend for a shared queue. The maxThreads and maxQueued
+		/// limits apply to each worker group.
+		///
+		/// If the TCPServer is given an already bound ServerSocket,
+		/// that socket must have been bound with the reusePort
+		/// flag set. The platform must support load balancing with
+		/// SO_REUSEPORT (e.g., Linux 3.9 or newer).
+		///
+		/// The default is 1 (a single acceptor thread).
+
+	int getAcceptorCount() const;
+		/// Returns the number of listening sockets and acceptor
+		/// threads used by TCPServer.
+
+	void setLockFreeQueue(bool flag);
+		/// Specifies whether the TCPServerDispatcher uses a
+		/// Poco::LockFreeNotificationQueue instead of a
+		/// Poco::NotificationQueue to hand over connections
+		/// to connection threads.
+		///
+		/// The lock-free queue reduces contention if connections
+		/// are accepted and served by many threads concurrently.
+		/// Its capacity is fixed, and determined by the maxQueued
+		/// parameter.
+		///
+		/// The default is false.
+
+	bool getLockFreeQueue() const;
+		/// Returns true if the TCPServerDispatcher uses a
+		/// lock-free queue.
+
+	void setStatistics(ServerStatistics::Ptr pStatistics);
+		/// Sets the ServerStatistics object that collects
+		/// connection and request level statistics.
+		///
+		/// Must be set before the TCPServer is created.
+		/// The default is none (no statistics are collected).
+
+	ServerStatistics::Ptr getStatistics() const;
+		/// Returns the ServerStatistics object,
+		/// or null if no statistics are collected.
+
 protected:
 	virtual ~TCPServerParams();
 		/// Destroys the TCPServerParams.
@@ -103,6 +160,9 @@ private:
 	int _maxThreads;
 	int _maxQueued;
 	Poco::Thread::Priority _threadPriority;
+	int _acceptorCount;
+	bool _lockFreeQueue;
+	ServerStatistics::Ptr _pStatistics;
 };
 
 
@@ -133,6 +193,24 @@ inline Poco::Thread::Priority TCPServerParams::getThreadPriority() const
 }
 
 
+inline int TCPServerParams::getAcceptorCount() const
+{
+	return _acceptorCount;
+}
+
+
+inline bool TCPServerParams::getLockFreeQueue() const
+{
+	return _lockFreeQueue;
+}
+
+
+inline ServerStatistics::Ptr TCPServerParams::getStatistics() const
+{
+	return _pStatistics;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -23,6 +23,7 @@
 #include "Poco/Net/Net.h"
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/HTTPCredentials.h"
+#include "Poco/Net/WebSocketDeflate.h"
 #include "Poco/Buffer.h"
 
 
@@ -34,6 +35,7 @@ class WebSocketImpl;
 class HTTPServerRequest;
 class HTTPServerResponse;
 class HTTPClientSession;
+class HTTPMessage;
 
 
 class Net_API WebSocket: public StreamSocket
@@ -124,10 +126,14 @@ public:
 			/// No Sec-WebSocket-Accept header or wrong value.
 		WS_ERR_UNAUTHORIZED                   = 6,
 			/// The server rejected the username or password for authentication.
+		WS_ERR_HANDSHAKE_EXTENSION            = 7,
+			/// Invalid Sec-WebSocket-Extensions header in handshake response.
 		WS_ERR_PAYLOAD_TOO_BIG                = 10,
 			/// Payload too big for supplied buffer.
-		WS_ERR_INCOMPLETE_FRAME               = 11
+		WS_ERR_INCOMPLETE_FRAME               = 11,
 			/// Incomplete frame received.
+		WS_ERR_COMPRESSION                    = 12
+			/// Compressed payload could not be decompressed.
 	};
 	
 	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response);
@@ -140,6 +146,20 @@ public:
 		///
 		/// Throws an exception if the request is not a proper WebSocket
 		/// upgrade request.
+
+	WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a server-side WebSocket from within a
+		/// HTTPRequestHandler, and enables the permessage-deflate
+		/// extension (RFC 7692) if it is offered by the client.
+		///
+		/// The given deflateParams specify the server's compression
+		/// level, and its limits for the parameters offered by the
+		/// client. A window size must be at least 9 bits for the
+		/// server and is reduced to the one offered by the client,
+		/// and context takeover is disabled for a side if either the
+		/// client or deflateParams request it.
+		///
+		/// Otherwise, works like the constructor without deflateParams.
 		
 	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response);
 		/// Creates a client-side WebSocket, using the given
@@ -167,6 +187,27 @@ public:
 		///
 		/// The result of the handshake can be obtained from the response
 		/// object.
+
+	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a client-side WebSocket, using the given
+		/// HTTPClientSession and HTTPRequest for the initial handshake
+		/// (HTTP Upgrade request), and offers the permessage-deflate
+		/// extension (RFC 7692) with the given parameters to the server.
+		///
+		/// The extension is used if the server accepts the offer,
+		/// which can be checked with perMessageDeflate(). The client
+		/// window size must be at least 9 bits.
+		///
+		/// Otherwise, works like the constructor without deflateParams.
+
+	WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params& deflateParams);
+		/// Creates a client-side WebSocket, using the given
+		/// HTTPClientSession and HTTPRequest for the initial handshake
+		/// (HTTP Upgrade request), and offers the permessage-deflate
+		/// extension (RFC 7692) with the given parameters to the server.
+		///
+		/// The given credentials are used for authentication
+		/// if requested by the server.
 	
 	WebSocket(const Socket& socket);
 		/// Creates a WebSocket from another Socket, which must be a WebSocket,
@@ -198,6 +239,9 @@ public:
 		/// Values from the FrameFlags, FrameOpcodes and SendFlags enumerations
 		/// can be specified in flags.
 		///
+		/// Concurrent calls from different threads are serialized,
+		/// so each frame is sent as a whole.
+		///
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
 		///
@@ -237,17 +281,74 @@ public:
 		/// The frame flags and opcode (FrameFlags and FrameOpcodes)
 		/// is stored in flags.
 
+	int receiveFrameInto(Poco::Buffer<char>& buffer, int& flags);
+		/// Receives a frame from the socket and replaces the
+		/// content of buffer with its payload. The buffer is only
+		/// reallocated if the payload is larger than its capacity,
+		/// so a buffer that is reused for all frames is rarely
+		/// reallocated.
+		///
+		/// Unless the socket is secure, the frame header is peeked
+		/// at (MSG_PEEK) and then received together with the payload,
+		/// directly into buffer, with a second system call (more calls
+		/// are only needed if the payload has not completely arrived yet).
+		/// A masked payload is unmasked in place.
+		///
+		/// Returns the number of bytes received.
+		/// A return value of 0 means that the peer has
+		/// shut down or closed the connection.
+		///
+		/// Throws a TimeoutException if a receive timeout has
+		/// been set and nothing is received within that interval.
+		/// Throws a NetException (or a subclass) in case of other errors.
+		///
+		/// The frame flags and opcode (FrameFlags and FrameOpcodes)
+		/// is stored in flags.
+
 	Mode mode() const;
 		/// Returns WS_SERVER if the WebSocket is a server-side
 		/// WebSocket, or WS_CLIENT otherwise.
 
+	bool perMessageDeflate() const;
+		/// Returns true if the permessage-deflate extension has been
+		/// negotiated in the handshake.
+		///
+		/// If so, the payload of text and binary messages sent with
+		/// sendFrame() is compressed, and compressed messages are
+		/// decompressed by receiveFrame() and receiveFrameInto().
+		/// Control frames are never compressed.
+		///
+		/// The negotiated parameters can be obtained from
+		/// WebSocketImpl::perMessageDeflate().
+
+	void setMaxPayloadSize(int maxPayloadSize);
+		/// Sets the maximum payload size of frames received with
+		/// receiveFrame() and receiveFrameInto().
+		///
+		/// A WebSocketException with the code WS_ERR_PAYLOAD_TOO_BIG
+		/// is thrown if a frame header announces a larger payload,
+		/// or if a compressed payload (see perMessageDeflate())
+		/// decompresses to more than maxPayloadSize bytes. In the
+		/// latter case, decompression stops as soon as the limit is
+		/// exceeded. The size of a decompressed payload received
+		/// with receiveFrame(void*, int, int&) is also limited by
+		/// the size of the given buffer.
+		///
+		/// The default is std::numeric_limits<int>::max(). Applications
+		/// receiving frames into a Poco::Buffer, especially with
+		/// permessage-deflate enabled, should set a lower limit.
+
+	int getMaxPayloadSize() const;
+		/// Returns the maximum payload size of received frames.
+
 	static const std::string WEBSOCKET_VERSION;
 		/// The WebSocket protocol version supported (13).
 	
 protected:
-	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response);
-	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials);
-	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key);
+	static WebSocketImpl* accept(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params* pDeflateParams = 0);
+	static WebSocketImpl* connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params* pDeflateParams = 0);
+	static WebSocketImpl* completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const WebSocketDeflate::Params* pDeflateParams = 0);
+	static std::string extensions(const HTTPMessage& message);
 	static std::string computeAccept(const std::string& key);
 	static std::string createKey();
 	
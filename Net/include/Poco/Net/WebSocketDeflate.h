@@ -0,0 +1,210 @@
+//
+// WebSocketDeflate.h
+//
+// $Id$
+//
+// Library: Net
+// Package: WebSocket
+// Module:  WebSocketDeflate
+//
+// Definition of the WebSocketDeflate class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef Net_WebSocketDeflate_INCLUDED
+#define Net_WebSocketDeflate_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/Buffer.h"
+#if defined(POCO_UNBUNDLED)
+#include <zlib.h>
+#else
+#include "Poco/zlib.h"
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+class Net_API WebSocketDeflate
+	/// This class implements the compression and decompression of
+	/// WebSocket messages according to the permessage-deflate
+	/// extension specified in RFC 7692, as well as the negotiation
+	/// of the extension parameters in the WebSocket handshake.
+	///
+	/// A WebSocketDeflate object holds the zlib compression and
+	/// decompression state of a single WebSocket connection. The
+	/// z_stream objects are created once, together with the
+	/// WebSocketDeflate object, and are reset (rather than
+	/// recreated) after a message if context takeover is
+	/// disabled. So, compressing or decompressing a message only
+	/// allocates memory if the output buffer must be enlarged.
+	///
+	/// This class is used internally by WebSocket and WebSocketImpl.
+	/// Applications enable the extension by passing a Params
+	/// object to the WebSocket constructor.
+{
+public:
+	struct Params
+		/// The permessage-deflate extension parameters.
+		///
+		/// When passed to a client-side WebSocket, the parameters
+		/// are offered to the server. When passed to a server-side
+		/// WebSocket, the parameters are the server's limits for
+		/// accepting an offer.
+		///
+		/// After the handshake, the parameters hold the negotiated
+		/// values.
+	{
+		Params();
+			/// Creates Params with context takeover enabled for
+			/// both sides, 15 bit windows, and the default
+			/// compression level.
+
+		bool serverNoContextTakeover;
+			/// If true, the server resets its compression state
+			/// after every message.
+
+		bool clientNoContextTakeover;
+			/// If true, the client resets its compression state
+			/// after every message.
+
+		int serverMaxWindowBits;
+			/// The base-2 logarithm of the server's LZ77 window size (8 - 15).
+
+		int clientMaxWindowBits;
+			/// The base-2 logarithm of the client's LZ77 window size (8 - 15).
+			///
+			/// Note that zlib does not support compressing with a
+			/// window size of 8 bits, so the window size used by
+			/// this end of a connection must be at least 9 bits.
+
+		int compressionLevel;
+			/// The zlib compression level (Z_DEFAULT_COMPRESSION,
+			/// or 0 - 9) used for compressing messages. Not negotiated.
+	};
+
+	enum
+	{
+		MIN_WINDOW_BITS = 8,
+		MAX_WINDOW_BITS = 15,
+		INFLATE_BUFFER_SIZE = 4096
+	};
+
+	WebSocketDeflate(const Params& params, bool client);
+		/// Creates the WebSocketDeflate with the negotiated
+		/// parameters, for the client or server side of
+		/// a WebSocket connection.
+
+	~WebSocketDeflate();
+		/// Destroys the WebSocketDeflate.
+
+	void deflate(const char* pData, std::size_t length, bool fin, Poco::Buffer<char>& out);
+		/// Compresses the given frame payload and replaces the
+		/// content of out with the compressed data.
+		///
+		/// fin must be true for the final frame of a message.
+		/// If so, the trailing empty block is removed from the
+		/// compressed data, and the compression state is reset if
+		/// context takeover is disabled.
+
+	void inflate(const char* pData, std::size_t length, bool fin, Poco::Buffer<char>& out, std::size_t maxSize);
+		/// Decompresses the given compressed frame payload
+		/// and appends the decompressed data to out.
+		///
+		/// fin must be true for the final frame of a message.
+		///
+		/// The size of out is limited to maxSize bytes. Decompression
+		/// stops as soon as the limit is exceeded (so that a small,
+		/// highly compressed payload cannot exhaust the available
+		/// memory), and a WebSocketException with the code
+		/// WebSocket::WS_ERR_PAYLOAD_TOO_BIG is thrown. The
+		/// decompression state is undefined afterwards, so the
+		/// WebSocket connection must be terminated.
+		///
+		/// Throws a WebSocketException if the data
+		/// cannot be decompressed.
+
+	const Params& params() const;
+		/// Returns the negotiated parameters.
+
+	bool client() const;
+		/// Returns true if the object is used by
+		/// the client side of a connection.
+
+	static std::string formatOffer(const Params& params);
+		/// Returns the extension offer for the Sec-WebSocket-Extensions
+		/// header of a client handshake request.
+
+	static std::string formatResponse(const Params& params);
+		/// Returns the Sec-WebSocket-Extensions header value for
+		/// the server handshake response, for the parameters
+		/// agreed on with negotiate().
+
+	static bool negotiate(const std::string& offers, const Params& params, Params& agreed);
+		/// Finds the first acceptable permessage-deflate offer in the
+		/// Sec-WebSocket-Extensions header value of a client handshake
+		/// request, and stores the resulting parameters in agreed.
+		///
+		/// Invalid offers, and offers requiring a server window size
+		/// that is not supported, are ignored.
+		///
+		/// Returns false if no acceptable offer was found.
+
+	static bool accept(const std::string& response, const Params& offered, Params& agreed);
+		/// Parses the Sec-WebSocket-Extensions header value of a server
+		/// handshake response to an offer made with formatOffer(), and
+		/// stores the resulting parameters in agreed.
+		///
+		/// Returns false if the server did not accept the offer. Throws
+		/// a WebSocketException if the response is not valid.
+
+	static const std::string EXTENSION;
+		/// The extension name, "permessage-deflate".
+
+	static const std::string EXTENSIONS_HEADER;
+		/// The name of the extension negotiation
+		/// header, "Sec-WebSocket-Extensions".
+
+protected:
+	void inflateImpl(const char* pData, std::size_t length, Poco::Buffer<char>& out, std::size_t maxSize);
+
+private:
+	WebSocketDeflate();
+	WebSocketDeflate(const WebSocketDeflate&);
+	WebSocketDeflate& operator = (const WebSocketDeflate&);
+
+	Params   _params;
+	bool     _client;
+	bool     _inflateEnd;
+	z_stream _deflateStream;
+	z_stream _inflateStream;
+};
+
+
+//
+// inlines
+//
+inline const WebSocketDeflate::Params& WebSocketDeflate::params() const
+{
+	return _params;
+}
+
+
+inline bool WebSocketDeflate::client() const
+{
+	return _client;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // Net_WebSocketDeflate_INCLUDED
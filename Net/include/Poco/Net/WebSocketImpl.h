@@ -21,9 +21,10 @@
 
 
 #include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/WebSocketDeflate.h"
 #include "Poco/Buffer.h"
 #include "Poco/Random.h"
-#include "Poco/Buffer.h"
+#include "Poco/Mutex.h"
 
 
 namespace Poco {
@@ -38,12 +39,23 @@ class Net_API WebSocketImpl: public StreamSocketImpl
 	/// to the WebSocket protocol described in RFC 6455.
 {
 public:
-	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload);
+	WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload, WebSocketDeflate* pDeflate = 0);
 		/// Creates a WebSocketImpl.
+		///
+		/// If pDeflate is given, messages are compressed according
+		/// to the permessage-deflate extension. The WebSocketImpl
+		/// takes ownership of the WebSocketDeflate object.
 	
 	// StreamSocketImpl
 	virtual int sendBytes(const void* buffer, int length, int flags);
 		/// Sends a WebSocket protocol frame.
+
+	virtual int sendBytes(const SocketBufVec& buffers, int flags);
+		/// Sends the contents of all buffers in a single
+		/// WebSocket protocol frame.
+
+	virtual Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends the file contents in WebSocket protocol frames.
 		
 	virtual int receiveBytes(void* buffer, int length, int flags);
 		/// Receives a WebSocket protocol frame.
@@ -51,6 +63,10 @@ public:
 	virtual int receiveBytes(Poco::Buffer<char>& buffer, int flags);
 		/// Receives a WebSocket protocol frame.
 
+	virtual int receiveBytes(SocketBufVec& buffers, int flags);
+		/// Receives a WebSocket protocol frame and stores
+		/// its payload in the given buffers.
+
 	virtual SocketImpl* acceptConnection(SocketAddress& clientAddr);
 	virtual void connect(const SocketAddress& address);
 	virtual void connect(const SocketAddress& address, const Poco::Timespan& timeout);
@@ -81,6 +97,34 @@ public:
 	bool mustMaskPayload() const;
 		/// Returns true if the payload must be masked.
 
+	const WebSocketDeflate* perMessageDeflate() const;
+		/// Returns the WebSocketDeflate holding the negotiated
+		/// permessage-deflate parameters, or null if the extension
+		/// is not used.
+
+	void setMaxPayloadSize(int maxPayloadSize);
+		/// Sets the maximum payload size of received frames.
+		///
+		/// See WebSocket::setMaxPayloadSize() for details.
+
+	int getMaxPayloadSize() const;
+		/// Returns the maximum payload size of received frames.
+
+	int receiveFrame(Poco::Buffer<char>& buffer);
+		/// Receives a WebSocket protocol frame and replaces the
+		/// content of buffer with its payload.
+		///
+		/// On sockets that are not secure, the header is peeked at,
+		/// and the header and the payload are received with a single
+		/// system call, the payload directly into buffer.
+
+	static void maskPayload(char* pDest, const char* pSrc, std::size_t length, const char mask[4]);
+		/// Stores the bytes from pSrc, XORed with the mask, in pDest.
+		/// pDest may be equal to pSrc.
+		///
+		/// Uses AVX2 or SSE2 instructions if the compiler targets them,
+		/// and processes 8 bytes at a time otherwise.
+
 protected:
 	enum
 	{
@@ -88,7 +132,11 @@ protected:
 		MAX_HEADER_LENGTH = 14
 	};
 	
+	int sendFrame(const void* buffer, int length, int flags);
+	bool inflateFrame();
+	void inflatePayload(int payloadLength, char mask[4], bool useMask, Poco::Buffer<char>& buffer, std::size_t maxSize);
 	int receiveHeader(char mask[4], bool& useMask);
+	int parseHeader(const char* pHeader, int length, int& payloadLength, char mask[4], bool& useMask);
 	int receivePayload(char *buffer, int payloadLength, char mask[4], bool useMask);
 	int receiveNBytes(void* buffer, int bytes);
 	int receiveSomeBytes(char* buffer, int bytes);
@@ -100,9 +148,20 @@ private:
 	StreamSocketImpl* _pStreamSocketImpl;
 	Poco::Buffer<char> _buffer;
 	int _bufferOffset;
+	Poco::FastMutex _sendMutex;
+	Poco::Buffer<char> _sendBuffer;
+	SocketBufVec _sendBuffers;
+	SocketBufVec _receiveBuffers;
 	int _frameFlags;
+	int _maxPayloadSize;
 	bool _mustMaskPayload;
 	Poco::Random _rnd;
+	WebSocketDeflate* _pDeflate;
+	Poco::Buffer<char> _deflateBuffer;
+	Poco::Buffer<char> _inflateBuffer;
+	Poco::Buffer<char> _inflatedBuffer;
+	bool _deflating;
+	bool _inflating;
 };
 
 
@@ -121,6 +180,18 @@ inline bool WebSocketImpl::mustMaskPayload() const
 }
 
 
+inline const WebSocketDeflate* WebSocketImpl::perMessageDeflate() const
+{
+	return _pDeflate;
+}
+
+
+inline int WebSocketImpl::getMaxPayloadSize() const
+{
+	return _maxPayloadSize;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -0,0 +1,119 @@
+//
+// DatagramBenchmark.cpp
+//
+// $Id$
+//
+// This sample measures the packet rate of a DatagramSocket over
+// the loopback interface, receiving datagrams one by one with
+// receiveFrom(), and in batches with receiveBatch().
+//
+// In every round, the sender sends a batch of datagrams, which
+// are then received before the next round begins, so that no
+// datagrams are lost due to full socket buffers.
+//
+// Usage: DatagramBenchmark [<datagrams> [<size> [<batch size>]]]
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/DatagramPacket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Net::DatagramSocket;
+using Poco::Net::DatagramPacket;
+using Poco::Net::DatagramPacketVec;
+using Poco::Net::SocketAddress;
+using Poco::Stopwatch;
+
+
+Poco::Timestamp::TimeDiff benchmarkSingle(DatagramSocket& sender, DatagramSocket& receiver, int datagrams, int size, int batchSize)
+{
+	std::vector<char> out(size, 'x');
+	std::vector<char> in(size);
+	SocketAddress destination = receiver.address();
+	SocketAddress source;
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < datagrams; i += batchSize)
+	{
+		for (int k = 0; k < batchSize; ++k)
+			sender.sendTo(&out[0], size, destination);
+		for (int k = 0; k < batchSize; ++k)
+			receiver.receiveFrom(&in[0], size, source);
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Timestamp::TimeDiff benchmarkBatch(DatagramSocket& sender, DatagramSocket& receiver, int datagrams, int size, int batchSize)
+{
+	std::vector<char> out(size, 'x');
+	std::vector<char> in(size*batchSize);
+	DatagramPacketVec outPackets(batchSize, DatagramPacket(&out[0], size, receiver.address()));
+	DatagramPacketVec inPackets;
+	for (int k = 0; k < batchSize; ++k)
+		inPackets.push_back(DatagramPacket(&in[k*size], size));
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < datagrams; i += batchSize)
+	{
+		int sent = sender.sendBatch(outPackets);
+		while (sent < batchSize)
+		{
+			DatagramPacketVec rest(outPackets.begin() + sent, outPackets.end());
+			sent += sender.sendBatch(rest);
+		}
+		int received = 0;
+		while (received < batchSize)
+		{
+			received += receiver.receiveBatch(inPackets);
+		}
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	int datagrams = argc > 1 ? Poco::NumberParser::parse(argv[1]) : 1000000;
+	int size      = argc > 2 ? Poco::NumberParser::parse(argv[2]) : 64;
+	int batchSize = argc > 3 ? Poco::NumberParser::parse(argv[3]) : 32;
+
+	try
+	{
+		DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+		DatagramSocket receiver(SocketAddress("127.0.0.1", 0));
+		receiver.setReceiveBufferSize(4*1024*1024);
+
+		Poco::Timestamp::TimeDiff singleTime = benchmarkSingle(sender, receiver, datagrams, size, batchSize);
+		Poco::Timestamp::TimeDiff batchTime = benchmarkBatch(sender, receiver, datagrams, size, batchSize);
+
+		std::cout << datagrams << " datagrams of " << size << " bytes, batch size " << batchSize << std::endl;
+		std::cout << std::left << std::setw(26) << "sendTo/receiveFrom:" << std::right
+		          << std::setw(12) << std::fixed << std::setprecision(0) << 1000000.0*datagrams/singleTime << " datagrams/s" << std::endl;
+		std::cout << std::left << std::setw(26) << "sendBatch/receiveBatch:" << std::right
+		          << std::setw(12) << std::fixed << std::setprecision(0) << 1000000.0*datagrams/batchTime << " datagrams/s" << std::endl;
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,120 @@
+//
+// HTTPParserBenchmark.cpp
+//
+// $Id$
+//
+// This sample compares the throughput of parsing HTTP request
+// headers with HTTPRequest::read(), which reads the header
+// character by character from a stream, and with HTTPHeaderTable.
+//
+// Three variants are measured:
+//   - stream: HTTPRequest::read(std::istream&)
+//   - table: HTTPHeaderTable::feed() and HTTPHeaderTable::parseRequest()
+//   - table+request: as above, followed by HTTPRequest::read(const HTTPHeaderTable&),
+//     which is what HTTPServer does if fast header parsing is enabled.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPHeaderTable.h"
+#include "Poco/MemoryStream.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPHeaderTable;
+using Poco::MemoryInputStream;
+using Poco::Stopwatch;
+
+
+const std::string REQUEST(
+	"GET /images/logo.png?size=large&format=png HTTP/1.1\r\n"
+	"Host: www.example.com\r\n"
+	"User-Agent: Mozilla/5.0 (X11; Linux x86_64; rv:50.0) Gecko/20100101 Firefox/50.0\r\n"
+	"Accept: image/png,image/*;q=0.8,*/*;q=0.5\r\n"
+	"Accept-Language: en-US,en;q=0.5\r\n"
+	"Accept-Encoding: gzip, deflate\r\n"
+	"Referer: http://www.example.com/index.html\r\n"
+	"Cookie: session=0123456789abcdef; theme=dark; lang=en\r\n"
+	"Connection: keep-alive\r\n"
+	"Cache-Control: max-age=0\r\n"
+	"\r\n");
+
+
+Poco::Clock::ClockDiff benchmarkStream(int iterations)
+{
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		MemoryInputStream istr(REQUEST.data(), REQUEST.size());
+		HTTPRequest request;
+		request.read(istr);
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Clock::ClockDiff benchmarkTable(int iterations)
+{
+	HTTPHeaderTable table;
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		table.reset();
+		table.feed(REQUEST.data(), REQUEST.size());
+		table.parseRequest();
+		poco_assert (table.find("Host", 4));
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Clock::ClockDiff benchmarkTableRequest(int iterations)
+{
+	HTTPHeaderTable table;
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		table.reset();
+		table.feed(REQUEST.data(), REQUEST.size());
+		table.parseRequest();
+		HTTPRequest request;
+		request.read(table);
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	int iterations = 200000;
+	if (argc > 1) iterations = Poco::NumberParser::parse(argv[1]);
+
+	Poco::Clock::ClockDiff streamTime = benchmarkStream(iterations);
+	Poco::Clock::ClockDiff tableTime = benchmarkTable(iterations);
+	Poco::Clock::ClockDiff tableRequestTime = benchmarkTableRequest(iterations);
+
+	std::cout << "Request header size: " << REQUEST.size() << " bytes, " << iterations << " iterations" << std::endl;
+	std::cout << std::setw(16) << "stream" << std::setw(12) << std::fixed << std::setprecision(0)
+	          << 1e6*iterations/streamTime << " requests/s" << std::endl;
+	std::cout << std::setw(16) << "table" << std::setw(12) << std::fixed << std::setprecision(0)
+	          << 1e6*iterations/tableTime << " requests/s" << std::endl;
+	std::cout << std::setw(16) << "table+request" << std::setw(12) << std::fixed << std::setprecision(0)
+	          << 1e6*iterations/tableRequestTime << " requests/s" << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,148 @@
+//
+// PollBenchmark.cpp
+//
+// $Id$
+//
+// This sample compares the cost of waiting for socket events
+// with Socket::select(), which sets up the polling mechanism
+// on every call (the way SocketReactor used to work), and
+// with a persistent PollSet.
+//
+// For each socket count, one datagram is sent to one of the
+// (otherwise idle) sockets per iteration, and the time needed
+// to detect and receive it is measured.
+//
+// Large socket counts may require raising the limit for open
+// files (ulimit -n).
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DatagramSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/PollSet.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Net::Socket;
+using Poco::Net::DatagramSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::PollSet;
+using Poco::Stopwatch;
+using Poco::Timespan;
+
+
+typedef std::vector<DatagramSocket> SocketVec;
+
+
+void receive(Socket& socket)
+{
+	char buffer[16];
+	DatagramSocket ds(socket);
+	ds.receiveBytes(buffer, sizeof(buffer));
+}
+
+
+Poco::Timestamp::TimeDiff benchmarkSelect(SocketVec& sockets, DatagramSocket& sender, int iterations)
+{
+	Timespan timeout(1, 0);
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		DatagramSocket& target = sockets[i % sockets.size()];
+		sender.sendTo("x", 1, target.address());
+
+		Socket::SocketList readList(sockets.begin(), sockets.end());
+		Socket::SocketList writeList;
+		Socket::SocketList exceptList;
+		Socket::select(readList, writeList, exceptList, timeout);
+		for (Socket::SocketList::iterator it = readList.begin(); it != readList.end(); ++it)
+			receive(*it);
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Timestamp::TimeDiff benchmarkPollSet(SocketVec& sockets, DatagramSocket& sender, int iterations)
+{
+	Timespan timeout(1, 0);
+	PollSet pollSet;
+	for (SocketVec::iterator it = sockets.begin(); it != sockets.end(); ++it)
+		pollSet.add(*it, PollSet::POLL_READ);
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < iterations; ++i)
+	{
+		DatagramSocket& target = sockets[i % sockets.size()];
+		sender.sendTo("x", 1, target.address());
+
+		PollSet::SocketModeMap sm = pollSet.poll(timeout);
+		for (PollSet::SocketModeMap::const_iterator it = sm.begin(); it != sm.end(); ++it)
+		{
+			Socket socket(it->first);
+			receive(socket);
+		}
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+int main(int argc, char** argv)
+{
+	std::vector<int> counts;
+	for (int i = 1; i < argc; ++i)
+		counts.push_back(Poco::NumberParser::parse(argv[i]));
+	if (counts.empty())
+	{
+		counts.push_back(1000);
+		counts.push_back(10000);
+		counts.push_back(50000);
+	}
+
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+
+	std::cout << std::setw(10) << "sockets" << std::setw(12) << "iterations"
+	          << std::setw(20) << "select [us/event]" << std::setw(20) << "PollSet [us/event]" << std::endl;
+
+	for (std::vector<int>::const_iterator it = counts.begin(); it != counts.end(); ++it)
+	{
+		int count = *it;
+		SocketVec sockets;
+		try
+		{
+			sockets.reserve(count);
+			for (int i = 0; i < count; ++i)
+				sockets.push_back(DatagramSocket(SocketAddress("127.0.0.1", 0)));
+		}
+		catch (Poco::Exception& exc)
+		{
+			std::cerr << "Cannot create " << count << " sockets (" << sockets.size() << " created): " << exc.displayText() << std::endl;
+			continue;
+		}
+
+		int iterations = count < 100000 ? 1000000/count : 10;
+		if (iterations > 1000) iterations = 1000;
+
+		Poco::Timestamp::TimeDiff selectTime = benchmarkSelect(sockets, sender, iterations);
+		Poco::Timestamp::TimeDiff pollSetTime = benchmarkPollSet(sockets, sender, iterations);
+
+		std::cout << std::setw(10) << count << std::setw(12) << iterations
+		          << std::setw(20) << std::fixed << std::setprecision(2) << double(selectTime)/iterations
+		          << std::setw(20) << std::fixed << std::setprecision(2) << double(pollSetTime)/iterations << std::endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,198 @@
+//
+// WebSocketBenchmark.cpp
+//
+// $Id$
+//
+// This sample measures
+//   - the throughput of WebSocket payload masking, byte by byte
+//     and with WebSocketImpl::maskPayload(), and
+//   - the rate at which a server receives masked client frames
+//     over the loopback interface with WebSocket::receiveFrame()
+//     and with WebSocket::receiveFrameInto().
+//
+// Usage: WebSocketBenchmark [<frames> [<frame size>]]
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/WebSocketImpl.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Buffer.h"
+#include "Poco/Stopwatch.h"
+#include "Poco/NumberParser.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <iostream>
+#include <iomanip>
+
+
+using Poco::Net::WebSocket;
+using Poco::Net::WebSocketImpl;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::ServerSocket;
+using Poco::Stopwatch;
+
+
+class ReceiveRequestHandler: public HTTPRequestHandler
+	/// Receives frames until a CLOSE frame arrives,
+	/// then sends a single frame back.
+{
+public:
+	void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+	{
+		WebSocket ws(request, response);
+		bool into = request.getURI() == "/into";
+		Poco::Buffer<char> buffer(0);
+		int flags;
+		do
+		{
+			if (into)
+			{
+				ws.receiveFrameInto(buffer, flags);
+			}
+			else
+			{
+				buffer.resize(0);
+				ws.receiveFrame(buffer, flags);
+			}
+		}
+		while ((flags & WebSocket::FRAME_OP_BITMASK) != WebSocket::FRAME_OP_CLOSE);
+		ws.sendFrame("done", 4);
+	}
+};
+
+
+class RequestHandlerFactory: public HTTPRequestHandlerFactory
+{
+public:
+	HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+	{
+		return new ReceiveRequestHandler;
+	}
+};
+
+
+Poco::Timestamp::TimeDiff benchmarkFrames(Poco::UInt16 port, const std::string& uri, int frames, int size)
+{
+	HTTPClientSession cs("127.0.0.1", port);
+	HTTPRequest request(HTTPRequest::HTTP_GET, uri, HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response);
+	std::vector<char> payload(size, 'x');
+
+	Stopwatch sw;
+	sw.start();
+	for (int i = 0; i < frames; ++i)
+	{
+		ws.sendFrame(&payload[0], size, WebSocket::FRAME_BINARY);
+	}
+	ws.shutdown();
+	char buffer[16];
+	int flags;
+	ws.receiveFrame(buffer, sizeof(buffer), flags);
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Timestamp::TimeDiff benchmarkMaskBytes(std::vector<char>& data, int rounds, const char mask[4])
+{
+	Stopwatch sw;
+	sw.start();
+	for (int r = 0; r < rounds; ++r)
+	{
+		char* p = &data[0];
+		for (std::size_t i = 0; i < data.size(); i++)
+		{
+			p[i] ^= mask[i % 4];
+		}
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+Poco::Timestamp::TimeDiff benchmarkMaskPayload(std::vector<char>& data, int rounds, const char mask[4])
+{
+	Stopwatch sw;
+	sw.start();
+	for (int r = 0; r < rounds; ++r)
+	{
+		WebSocketImpl::maskPayload(&data[0], &data[0], data.size(), mask);
+	}
+	sw.stop();
+	return sw.elapsed();
+}
+
+
+double gbps(double bytes, Poco::Timestamp::TimeDiff micros)
+{
+	return bytes/(1000.0*micros);
+}
+
+
+int main(int argc, char** argv)
+{
+	int frames = argc > 1 ? Poco::NumberParser::parse(argv[1]) : 100000;
+	int size   = argc > 2 ? Poco::NumberParser::parse(argv[2]) : 1024;
+
+	try
+	{
+		const char mask[4] = { 0x12, 0x34, 0x56, 0x78 };
+		std::vector<char> data(65536, 'x');
+		int rounds = 20000;
+		Poco::Timestamp::TimeDiff bytesTime = benchmarkMaskBytes(data, rounds, mask);
+		Poco::Timestamp::TimeDiff payloadTime = benchmarkMaskPayload(data, rounds, mask);
+		double total = double(data.size())*rounds;
+		std::cout << "Masking " << data.size() << " bytes:" << std::endl;
+		std::cout << std::left << std::setw(28) << "  byte by byte:" << std::right
+		          << std::setw(10) << std::fixed << std::setprecision(2) << gbps(total, bytesTime) << " GB/s" << std::endl;
+		std::cout << std::left << std::setw(28) << "  WebSocketImpl::maskPayload:" << std::right
+		          << std::setw(10) << std::fixed << std::setprecision(2) << gbps(total, payloadTime) << " GB/s" << std::endl;
+
+		ServerSocket svs(0);
+		HTTPServer server(new RequestHandlerFactory, svs, new HTTPServerParams);
+		server.start();
+
+		Poco::Timestamp::TimeDiff receiveTime = benchmarkFrames(svs.address().port(), "/receive", frames, size);
+		Poco::Timestamp::TimeDiff intoTime = benchmarkFrames(svs.address().port(), "/into", frames, size);
+		double frameBytes = double(frames)*size;
+		std::cout << frames << " masked frames of " << size << " bytes:" << std::endl;
+		std::cout << std::left << std::setw(28) << "  receiveFrame():" << std::right
+		          << std::setw(10) << std::fixed << std::setprecision(0) << 1000000.0*frames/receiveTime << " frames/s"
+		          << std::setw(10) << std::fixed << std::setprecision(2) << gbps(frameBytes, receiveTime) << " GB/s" << std::endl;
+		std::cout << std::left << std::setw(28) << "  receiveFrameInto():" << std::right
+		          << std::setw(10) << std::fixed << std::setprecision(0) << 1000000.0*frames/intoTime << " frames/s"
+		          << std::setw(10) << std::fixed << std::setprecision(2) << gbps(frameBytes, intoTime) << " GB/s" << std::endl;
+
+		server.stop();
+	}
+	catch (Poco::Exception& exc)
+	{
+		std::cerr << exc.displayText() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,421 @@
+//
+// DNSResolver.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: NetCore
+// Module:  DNSResolver
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DNSResolver.h"
+#include "Poco/Net/DNS.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Notification.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/SingletonHolder.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/String.h"
+
+
+using Poco::FastMutex;
+using Poco::Mutex;
+using Poco::Notification;
+using Poco::AutoPtr;
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	class ResolveNotification: public Notification
+	{
+	public:
+		ResolveNotification(const std::string& host):
+			_host(host)
+		{
+		}
+
+		const std::string& host() const
+		{
+			return _host;
+		}
+
+	private:
+		std::string _host;
+	};
+}
+
+
+DNSResolver::Callback::~Callback()
+{
+}
+
+
+DNSResolver::CacheEntry::CacheEntry(const HostEntry& entry, const Poco::Timespan& ttl):
+	_entry(entry)
+{
+	_expiration += ttl;
+}
+
+
+DNSResolver::CacheEntry::CacheEntry(const Poco::Exception& exc, const Poco::Timespan& ttl):
+	_pException(exc.clone())
+{
+	_expiration += ttl;
+}
+
+
+const HostEntry& DNSResolver::CacheEntry::entry() const
+{
+	return _entry;
+}
+
+
+const Poco::Exception* DNSResolver::CacheEntry::exception() const
+{
+	return _pException.get();
+}
+
+
+const Poco::Timestamp& DNSResolver::CacheEntry::getExpiration() const
+{
+	return _expiration;
+}
+
+
+DNSResolver::PendingLookup::PendingLookup():
+	result(new Poco::ActiveResultHolder<HostEntry>())
+{
+}
+
+
+DNSResolver::DNSResolver(int threads, long cacheSize):
+	_cache(cacheSize),
+	_threadPool("DNSResolver", threads, threads),
+	_positiveTTL(DEFAULT_POSITIVE_TTL, 0),
+	_negativeTTL(DEFAULT_NEGATIVE_TTL, 0),
+	_hits(0),
+	_misses(0),
+	_stopped(false)
+{
+	poco_assert (threads > 0);
+
+	for (int i = 0; i < threads; ++i)
+	{
+		_threadPool.start(*this);
+	}
+}
+
+
+DNSResolver::~DNSResolver()
+{
+	try
+	{
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			_stopped = true;
+		}
+		_queue.clear();
+		// Every worker thread terminates when it dequeues
+		// a notification other than a ResolveNotification.
+		for (int i = 0; i < _threadPool.capacity(); ++i)
+		{
+			_queue.enqueueNotification(new Notification);
+		}
+		_threadPool.joinAll();
+
+		CacheEntry entry(DNSException("DNS resolver has been destroyed"), Poco::Timespan());
+		Mutex::ScopedLock callbackLock(_callbackMutex);
+		for (PendingMap::iterator it = _pending.begin(); it != _pending.end(); ++it)
+		{
+			complete(it->second->result, entry);
+			for (std::vector<Callback*>::iterator itCb = it->second->callbacks.begin(); itCb != it->second->callbacks.end(); ++itCb)
+			{
+				notify(**itCb, it->first, entry);
+			}
+			delete it->second;
+		}
+		_pending.clear();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+HostEntry DNSResolver::resolve(const std::string& name)
+{
+	Result result = resolveAsync(name);
+	result.wait();
+	if (result.failed()) result.exception()->rethrow();
+	return result.data();
+}
+
+
+SocketAddress DNSResolver::resolveAddress(const std::string& host, Poco::UInt16 port)
+{
+	IPAddress ip;
+	if (IPAddress::tryParse(host, ip))
+		return SocketAddress(ip, port);
+
+	HostEntry entry = resolve(host);
+	return SocketAddress(entry.addresses()[0], port);
+}
+
+
+DNSResolver::Result DNSResolver::resolveAsync(const std::string& name)
+{
+	std::string k = key(name);
+	Poco::SharedPtr<CacheEntry> pEntry = _cache.get(k);
+	if (pEntry)
+	{
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_hits;
+		}
+		Result result(new Poco::ActiveResultHolder<HostEntry>());
+		complete(result, *pEntry);
+		return result;
+	}
+
+	FastMutex::ScopedLock lock(_mutex);
+	++_misses;
+	return startLookup(k)->result;
+}
+
+
+void DNSResolver::resolveAsync(const std::string& name, Callback& callback)
+{
+	std::string k = key(name);
+	Poco::SharedPtr<CacheEntry> pEntry = _cache.get(k);
+	if (pEntry)
+	{
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_hits;
+		}
+		notify(callback, k, *pEntry);
+		return;
+	}
+
+	FastMutex::ScopedLock lock(_mutex);
+	++_misses;
+	startLookup(k)->callbacks.push_back(&callback);
+}
+
+
+void DNSResolver::cancel(Callback& callback)
+{
+	// Callbacks are only called with _callbackMutex held,
+	// so no callback is running once we own it.
+	Mutex::ScopedLock callbackLock(_callbackMutex);
+	FastMutex::ScopedLock lock(_mutex);
+	for (PendingMap::iterator it = _pending.begin(); it != _pending.end(); ++it)
+	{
+		std::vector<Callback*>& callbacks = it->second->callbacks;
+		std::vector<Callback*>::iterator itCb = callbacks.begin();
+		while (itCb != callbacks.end())
+		{
+			if (*itCb == &callback)
+				itCb = callbacks.erase(itCb);
+			else
+				++itCb;
+		}
+	}
+}
+
+
+void DNSResolver::setPositiveTTL(const Poco::Timespan& ttl)
+{
+	FastMutex::ScopedLock lock(_mutex);
+	_positiveTTL = ttl;
+}
+
+
+Poco::Timespan DNSResolver::getPositiveTTL() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _positiveTTL;
+}
+
+
+void DNSResolver::setNegativeTTL(const Poco::Timespan& ttl)
+{
+	FastMutex::ScopedLock lock(_mutex);
+	_negativeTTL = ttl;
+}
+
+
+Poco::Timespan DNSResolver::getNegativeTTL() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _negativeTTL;
+}
+
+
+void DNSResolver::flushCache()
+{
+	_cache.clear();
+}
+
+
+Poco::UInt64 DNSResolver::cacheHits() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _hits;
+}
+
+
+Poco::UInt64 DNSResolver::cacheMisses() const
+{
+	FastMutex::ScopedLock lock(_mutex);
+	return _misses;
+}
+
+
+namespace
+{
+	static Poco::SingletonHolder<DNSResolver> sh;
+}
+
+
+DNSResolver& DNSResolver::defaultResolver()
+{
+	return *sh.get();
+}
+
+
+void DNSResolver::run()
+{
+	for (;;)
+	{
+		AutoPtr<Notification> pNf = _queue.waitDequeueNotification();
+		ResolveNotification* pResolveNf = dynamic_cast<ResolveNotification*>(pNf.get());
+		if (!pResolveNf) break;
+
+		try
+		{
+			lookup(pResolveNf->host());
+		}
+		catch (Poco::Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+}
+
+
+void DNSResolver::lookup(const std::string& key)
+{
+	Poco::SharedPtr<CacheEntry> pEntry;
+	Poco::Timespan ttl;
+	try
+	{
+		HostEntry entry = DNS::hostByName(key);
+		if (entry.addresses().empty()) throw NoAddressFoundException(key);
+		ttl = getPositiveTTL();
+		pEntry = new CacheEntry(entry, ttl);
+	}
+	catch (Poco::Exception& exc)
+	{
+		ttl = getNegativeTTL();
+		pEntry = new CacheEntry(exc, ttl);
+	}
+	if (ttl > 0) _cache.add(key, pEntry);
+
+	Mutex::ScopedLock callbackLock(_callbackMutex);
+	PendingLookup* pLookup = 0;
+	{
+		FastMutex::ScopedLock lock(_mutex);
+		PendingMap::iterator it = _pending.find(key);
+		if (it != _pending.end())
+		{
+			pLookup = it->second;
+			_pending.erase(it);
+		}
+	}
+	if (pLookup)
+	{
+		complete(pLookup->result, *pEntry);
+		for (std::vector<Callback*>::iterator it = pLookup->callbacks.begin(); it != pLookup->callbacks.end(); ++it)
+		{
+			notify(**it, key, *pEntry);
+		}
+		delete pLookup;
+	}
+}
+
+
+DNSResolver::PendingLookup* DNSResolver::startLookup(const std::string& key)
+{
+	if (_stopped) throw Poco::IllegalStateException("DNS resolver has been destroyed");
+
+	PendingMap::iterator it = _pending.find(key);
+	if (it != _pending.end()) return it->second;
+
+	PendingLookup* pLookup = new PendingLookup;
+	_pending[key] = pLookup;
+	_queue.enqueueNotification(new ResolveNotification(key));
+	return pLookup;
+}
+
+
+void DNSResolver::complete(Result& result, const CacheEntry& entry)
+{
+	if (entry.exception())
+		result.error(*entry.exception());
+	else
+		result.data(new HostEntry(entry.entry()));
+	result.notify();
+}
+
+
+void DNSResolver::notify(Callback& callback, const std::string& name, const CacheEntry& entry)
+{
+	try
+	{
+		if (entry.exception())
+			callback.onResolveError(name, *entry.exception());
+		else
+			callback.onResolved(name, entry.entry());
+	}
+	catch (Poco::Exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (std::exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (...)
+	{
+		ErrorHandler::handle();
+	}
+}
+
+
+std::string DNSResolver::key(const std::string& name)
+{
+	return Poco::toLower(name);
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,60 @@
+//
+// DatagramPacket.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: Sockets
+// Module:  DatagramPacket
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/DatagramPacket.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+DatagramPacket::DatagramPacket():
+	buffer(0),
+	length(0),
+	received(0),
+	truncated(false),
+	timestamp(0)
+{
+}
+
+
+DatagramPacket::DatagramPacket(void* pBuffer, int bufferLength):
+	buffer(pBuffer),
+	length(bufferLength),
+	received(0),
+	truncated(false),
+	timestamp(0)
+{
+}
+
+
+DatagramPacket::DatagramPacket(const void* pBuffer, int bufferLength, const SocketAddress& destination):
+	buffer(const_cast<void*>(pBuffer)),
+	length(bufferLength),
+	received(0),
+	truncated(false),
+	address(destination),
+	timestamp(0)
+{
+}
+
+
+DatagramPacket::~DatagramPacket()
+{
+}
+
+
+} } // namespace Poco::Net
@@ -113,4 +113,16 @@ int DatagramSocket::receiveFrom(void* buffer, int length, SocketAddress& address
 }
 
 
+int DatagramSocket::sendBatch(const DatagramPacketVec& packets, int flags)
+{
+	return impl()->sendBatch(packets, flags);
+}
+
+
+int DatagramSocket::receiveBatch(DatagramPacketVec& packets, int flags)
+{
+	return impl()->receiveBatch(packets, flags);
+}
+
+
 } } // namespace Poco::Net
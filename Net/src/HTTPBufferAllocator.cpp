@@ -15,31 +15,197 @@
 
 
 #include "Poco/Net/HTTPBufferAllocator.h"
+#include "Poco/MemoryPool.h"
+#include "Poco/Mutex.h"
+#include "Poco/Thread.h"
+#include <vector>
 
 
 using Poco::MemoryPool;
+using Poco::FastMutex;
+using Poco::Thread;
 
 
 namespace Poco {
 namespace Net {
 
 
-MemoryPool HTTPBufferAllocator::_pool(HTTPBufferAllocator::BUFFER_SIZE, 16);
+namespace
+{
+	struct BufferCache
+	{
+		BufferCache():
+			allocations(0),
+			deallocations(0),
+			cacheHits(0),
+			poolAllocations(0),
+			heapAllocations(0)
+		{
+			buffers.reserve(HTTPBufferAllocator::CACHE_SIZE);
+		}
+
+		FastMutex mutex;
+		std::vector<char*> buffers;
+		Poco::UInt64 allocations;
+		Poco::UInt64 deallocations;
+		Poco::UInt64 cacheHits;
+		Poco::UInt64 poolAllocations;
+		Poco::UInt64 heapAllocations;
+		char padding[64];
+			// keeps the mutexes of adjacent caches
+			// in different cache lines
+	};
+
+	// The buffer size and the pool are only changed with the
+	// mutexes of all caches locked, so holding the mutex
+	// of any cache is sufficient for accessing them.
+	BufferCache caches[HTTPBufferAllocator::CACHE_COUNT];
+	MemoryPool defaultPool(HTTPBufferAllocator::BUFFER_SIZE, 16);
+	MemoryPool* pPool = &defaultPool;
+	std::streamsize bufferSize = HTTPBufferAllocator::BUFFER_SIZE;
+
+
+	BufferCache& currentCache()
+	{
+		Thread::TID tid = Thread::currentTid();
+		const unsigned char* p = reinterpret_cast<const unsigned char*>(&tid);
+		std::size_t h = 0;
+		for (std::size_t i = 0; i < sizeof(tid); ++i)
+		{
+			h = h*31 + p[i];
+		}
+		return caches[(h ^ (h >> 7) ^ (h >> 13)) % HTTPBufferAllocator::CACHE_COUNT];
+	}
+
+
+	void flush(BufferCache& cache)
+	{
+		for (std::vector<char*>::iterator it = cache.buffers.begin(); it != cache.buffers.end(); ++it)
+		{
+			pPool->release(*it);
+		}
+		cache.buffers.clear();
+	}
+}
 
 
 char* HTTPBufferAllocator::allocate(std::streamsize size)
 {
-	poco_assert_dbg (size == BUFFER_SIZE);
-
-	return reinterpret_cast<char*>(_pool.get());
+	BufferCache& cache = currentCache();
+	FastMutex::ScopedLock lock(cache.mutex);
+
+	++cache.allocations;
+	if (size != bufferSize)
+	{
+		++cache.heapAllocations;
+		return new char[static_cast<std::size_t>(size)];
+	}
+	else if (!cache.buffers.empty())
+	{
+		++cache.cacheHits;
+		char* ptr = cache.buffers.back();
+		cache.buffers.pop_back();
+		return ptr;
+	}
+	else
+	{
+		++cache.poolAllocations;
+		return reinterpret_cast<char*>(pPool->get());
+	}
 }
 
 
 void HTTPBufferAllocator::deallocate(char* ptr, std::streamsize size)
 {
-	poco_assert_dbg (size == BUFFER_SIZE);
+	BufferCache& cache = currentCache();
+	FastMutex::ScopedLock lock(cache.mutex);
+
+	++cache.deallocations;
+	// MemoryPool allocates its blocks with new[], so buffers
+	// allocated from the heap and pool blocks of the same
+	// size are interchangeable.
+	if (size != bufferSize)
+		delete [] ptr;
+	else if (cache.buffers.size() < static_cast<std::size_t>(CACHE_SIZE))
+		cache.buffers.push_back(ptr);
+	else
+		pPool->release(ptr);
+}
+
+
+void HTTPBufferAllocator::setBufferSize(std::streamsize size)
+{
+	poco_assert (size > 0);
+
+	for (int i = 0; i < CACHE_COUNT; ++i) caches[i].mutex.lock();
+
+	for (int i = 0; i < CACHE_COUNT; ++i) flush(caches[i]);
+	if (size != bufferSize)
+	{
+		MemoryPool* pOldPool = pPool;
+		try
+		{
+			pPool = size == BUFFER_SIZE ? &defaultPool : new MemoryPool(static_cast<std::size_t>(size));
+			bufferSize = size;
+		}
+		catch (...)
+		{
+			for (int i = CACHE_COUNT - 1; i >= 0; --i) caches[i].mutex.unlock();
+			throw;
+		}
+		// Buffers of the previous size still in use will
+		// be deleted when they are deallocated.
+		if (pOldPool != &defaultPool)
+		{
+			delete pOldPool;
+		}
+		else
+		{
+			while (defaultPool.available() > 0)
+				delete [] reinterpret_cast<char*>(defaultPool.get());
+		}
+	}
+
+	for (int i = CACHE_COUNT - 1; i >= 0; --i) caches[i].mutex.unlock();
+}
 
-	_pool.release(ptr);
+
+std::streamsize HTTPBufferAllocator::getBufferSize()
+{
+	BufferCache& cache = currentCache();
+	FastMutex::ScopedLock lock(cache.mutex);
+
+	return bufferSize;
+}
+
+
+HTTPBufferAllocator::Statistics HTTPBufferAllocator::statistics()
+{
+	Statistics stats = {0, 0, 0, 0, 0};
+	for (int i = 0; i < CACHE_COUNT; ++i)
+	{
+		FastMutex::ScopedLock lock(caches[i].mutex);
+		stats.allocations     += caches[i].allocations;
+		stats.deallocations   += caches[i].deallocations;
+		stats.cacheHits       += caches[i].cacheHits;
+		stats.poolAllocations += caches[i].poolAllocations;
+		stats.heapAllocations += caches[i].heapAllocations;
+	}
+	return stats;
+}
+
+
+void HTTPBufferAllocator::resetStatistics()
+{
+	for (int i = 0; i < CACHE_COUNT; ++i)
+	{
+		FastMutex::ScopedLock lock(caches[i].mutex);
+		caches[i].allocations     = 0;
+		caches[i].deallocations   = 0;
+		caches[i].cacheHits       = 0;
+		caches[i].poolAllocations = 0;
+		caches[i].heapAllocations = 0;
+	}
 }
 
 
@@ -35,7 +35,7 @@ namespace Net {
 
 
 HTTPChunkedStreamBuf::HTTPChunkedStreamBuf(HTTPSession& session, openmode mode):
-	HTTPBasicStreamBuf(HTTPBufferAllocator::BUFFER_SIZE, mode),
+	HTTPBasicStreamBuf(HTTPBufferAllocator::getBufferSize(), mode),
 	_session(session),
 	_mode(mode),
 	_chunk(0)
@@ -22,6 +22,7 @@
 #include "Poco/Net/HTTPFixedLengthStream.h"
 #include "Poco/Net/HTTPChunkedStream.h"
 #include "Poco/Net/HTTPBasicCredentials.h"
+#include "Poco/Net/DNSResolver.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/CountingStream.h"
@@ -47,7 +48,8 @@ HTTPClientSession::HTTPClientSession():
 	_reconnect(false),
 	_mustReconnect(false),
 	_expectResponseBody(false),
-	_responseReceived(false)
+	_responseReceived(false),
+	_pResolver(0)
 {
 }
 
@@ -60,7 +62,8 @@ HTTPClientSession::HTTPClientSession(const StreamSocket& socket):
 	_reconnect(false),
 	_mustReconnect(false),
 	_expectResponseBody(false),
-	_responseReceived(false)
+	_responseReceived(false),
+	_pResolver(0)
 {
 }
 
@@ -73,7 +76,8 @@ HTTPClientSession::HTTPClientSession(const SocketAddress& address):
 	_reconnect(false),
 	_mustReconnect(false),
 	_expectResponseBody(false),
-	_responseReceived(false)
+	_responseReceived(false),
+	_pResolver(0)
 {
 }
 
@@ -86,7 +90,8 @@ HTTPClientSession::HTTPClientSession(const std::string& host, Poco::UInt16 port)
 	_reconnect(false),
 	_mustReconnect(false),
 	_expectResponseBody(false),
-	_responseReceived(false)
+	_responseReceived(false),
+	_pResolver(0)
 {
 }
 
@@ -99,7 +104,8 @@ HTTPClientSession::HTTPClientSession(const std::string& host, Poco::UInt16 port,
 	_reconnect(false),
 	_mustReconnect(false),
 	_expectResponseBody(false),
-	_responseReceived(false)
+	_responseReceived(false),
+	_pResolver(0)
 {
 }
 
@@ -193,6 +199,12 @@ void HTTPClientSession::setKeepAliveTimeout(const Poco::Timespan& timeout)
 }
 
 
+void HTTPClientSession::setResolver(DNSResolver* pResolver)
+{
+	_pResolver = pResolver;
+}
+
+
 std::ostream& HTTPClientSession::sendRequest(HTTPRequest& request)
 {
 	clearException();
@@ -375,12 +387,12 @@ void HTTPClientSession::reconnect()
 {
 	if (_proxyConfig.host.empty() || bypassProxy())
 	{
-		SocketAddress addr(_host, _port);
+		SocketAddress addr(_pResolver ? _pResolver->resolveAddress(_host, _port) : SocketAddress(_host, _port));
 		connect(addr);
 	}
 	else
 	{
-		SocketAddress addr(_proxyConfig.host, _proxyConfig.port);
+		SocketAddress addr(_pResolver ? _pResolver->resolveAddress(_proxyConfig.host, _proxyConfig.port) : SocketAddress(_proxyConfig.host, _proxyConfig.port));
 		connect(addr);
 	}
 }
@@ -28,7 +28,7 @@ namespace Net {
 
 
 HTTPHeaderStreamBuf::HTTPHeaderStreamBuf(HTTPSession& session, openmode mode):
-	HTTPBasicStreamBuf(HTTPBufferAllocator::BUFFER_SIZE, mode),
+	HTTPBasicStreamBuf(HTTPBufferAllocator::getBufferSize(), mode),
 	_session(session),
 	_end(false)
 {
@@ -0,0 +1,207 @@
+//
+// HTTPHeaderTable.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTP
+// Module:  HTTPHeaderTable
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPHeaderTable.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Ascii.h"
+#include <limits>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPHeaderTable::HTTPHeaderTable():
+	_arena(0),
+	_lineStart(0),
+	_complete(false),
+	_fieldLimit(DFL_FIELD_LIMIT)
+{
+	reset();
+}
+
+
+HTTPHeaderTable::~HTTPHeaderTable()
+{
+}
+
+
+void HTTPHeaderTable::reset()
+{
+	static const Slice empty = { "", 0 };
+
+	_arena.resize(0);
+	_lineStart = 0;
+	_complete  = false;
+	_method    = empty;
+	_uri       = empty;
+	_version   = empty;
+	_fields.clear();
+}
+
+
+std::size_t HTTPHeaderTable::feed(const char* buffer, std::size_t length)
+{
+	poco_assert (!_complete);
+
+	const char* it  = buffer;
+	const char* end = buffer + length;
+	if (_arena.size() == 0)
+	{
+		while (it != end && Poco::Ascii::isSpace(*it)) ++it;
+	}
+
+	std::size_t offset = _arena.size();
+	std::size_t available = maxSize() - offset;
+	std::size_t n = static_cast<std::size_t>(end - it);
+	if (n > available) n = available;
+	if (_arena.capacity() < offset + n)
+	{
+		std::size_t capacity = 2*_arena.capacity();
+		if (capacity < offset + n) capacity = offset + n;
+		_arena.setCapacity(capacity);
+	}
+	_arena.append(it, n);
+
+	char* pArena = _arena.begin();
+	char* pEnd   = _arena.end();
+	char* pScan  = pArena + offset;
+	while (pScan != pEnd)
+	{
+		char* pNL = static_cast<char*>(std::memchr(pScan, '\n', pEnd - pScan));
+		if (!pNL) break;
+		std::size_t lineLength = pNL - (pArena + _lineStart);
+		if (lineLength == 0 || (lineLength == 1 && pArena[_lineStart] == '\r'))
+		{
+			std::size_t size = pNL + 1 - pArena;
+			std::size_t excess = _arena.size() - size;
+			_arena.resize(size);
+			_complete = true;
+			return (it - buffer) + n - excess;
+		}
+		_lineStart = pNL + 1 - pArena;
+		pScan = pNL + 1;
+	}
+	if (n < static_cast<std::size_t>(end - it))
+		throw MessageException("HTTP request header too large");
+	return length;
+}
+
+
+void HTTPHeaderTable::parseRequest()
+{
+	char* p   = _arena.begin();
+	char* end = _arena.end();
+	if (p == end) throw NoMessageException();
+
+	_method.data = p;
+	while (p != end && !Poco::Ascii::isSpace(*p) && p - _method.data < MAX_METHOD_LENGTH) ++p;
+	if (p == end || !Poco::Ascii::isSpace(*p)) throw MessageException("HTTP request method invalid or too long");
+	_method.length = p - _method.data;
+	while (p != end && Poco::Ascii::isSpace(*p)) ++p;
+	_uri.data = p;
+	while (p != end && !Poco::Ascii::isSpace(*p) && p - _uri.data < MAX_URI_LENGTH) ++p;
+	if (p == end || !Poco::Ascii::isSpace(*p)) throw MessageException("HTTP request URI invalid or too long");
+	_uri.length = p - _uri.data;
+	while (p != end && Poco::Ascii::isSpace(*p)) ++p;
+	_version.data = p;
+	while (p != end && !Poco::Ascii::isSpace(*p) && p - _version.data < MAX_VERSION_LENGTH) ++p;
+	if (p == end || !Poco::Ascii::isSpace(*p)) throw MessageException("Invalid HTTP version string");
+	_version.length = p - _version.data;
+	while (p != end && *p != '\n') ++p;
+	if (p != end) ++p;
+
+	_fields.clear();
+	while (p != end && *p != '\r' && *p != '\n')
+	{
+		if (_fieldLimit > 0 && static_cast<int>(_fields.size()) == _fieldLimit)
+			throw MessageException("Too many header fields");
+		Field field;
+		field.name.data = p;
+		while (p != end && *p != ':' && *p != '\n' && p - field.name.data < MAX_NAME_LENGTH) ++p;
+		if (p != end && *p == '\n') { ++p; continue; } // ignore invalid header lines
+		if (p == end || *p != ':') throw MessageException("Field name too long/no colon found");
+		field.name.length = p - field.name.data;
+		++p; // ':'
+		while (p != end && Poco::Ascii::isSpace(*p) && *p != '\r' && *p != '\n') ++p;
+		// Folded lines are joined in place; out never passes p.
+		char* value = p;
+		char* out   = p;
+		while (p != end && *p != '\r' && *p != '\n' && out - value < MAX_VALUE_LENGTH) *out++ = *p++;
+		if (p != end && *p == '\r') ++p;
+		if (p != end && *p == '\n')
+			++p;
+		else if (p != end)
+			throw MessageException("Field value too long/no CRLF found");
+		while (p != end && (*p == ' ' || *p == '\t')) // folding
+		{
+			while (p != end && *p != '\r' && *p != '\n' && out - value < MAX_VALUE_LENGTH) *out++ = *p++;
+			if (p != end && *p == '\r') ++p;
+			if (p != end && *p == '\n')
+				++p;
+			else if (p != end)
+				throw MessageException("Folded field value too long/no CRLF found");
+		}
+		while (out != value && Poco::Ascii::isSpace(out[-1])) --out;
+		field.value.data   = value;
+		field.value.length = out - value;
+		_fields.push_back(field);
+	}
+}
+
+
+const HTTPHeaderTable::Slice* HTTPHeaderTable::find(const char* name, std::size_t length) const
+{
+	for (std::vector<Field>::const_iterator it = _fields.begin(); it != _fields.end(); ++it)
+	{
+		if (equals(it->name, name, length)) return &it->value;
+	}
+	return 0;
+}
+
+
+void HTTPHeaderTable::setFieldLimit(int limit)
+{
+	poco_assert (limit >= 0);
+
+	_fieldLimit = limit;
+}
+
+
+bool HTTPHeaderTable::equals(const Slice& slice, const char* str, std::size_t length)
+{
+	if (slice.length != length) return false;
+	for (std::size_t i = 0; i < length; ++i)
+	{
+		if (Poco::Ascii::toLower(slice.data[i]) != Poco::Ascii::toLower(str[i]))
+			return false;
+	}
+	return true;
+}
+
+
+std::size_t HTTPHeaderTable::maxSize() const
+{
+	if (_fieldLimit == 0) return std::numeric_limits<std::size_t>::max();
+
+	// request line and terminating empty line, plus "name: value\r\n" for every field
+	return MAX_METHOD_LENGTH + MAX_URI_LENGTH + MAX_VERSION_LENGTH + 6
+		+ static_cast<std::size_t>(_fieldLimit)*(MAX_NAME_LENGTH + MAX_VALUE_LENGTH + 4);
+}
+
+
+} } // namespace Poco::Net
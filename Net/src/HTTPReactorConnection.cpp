@@ -0,0 +1,382 @@
+//
+// HTTPReactorConnection.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorConnection
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPReactorConnection.h"
+#include "Poco/Net/HTTPReactorServer.h"
+#include "Poco/Net/HTTPServerSession.h"
+#include "Poco/Net/HTTPServerRequestImpl.h"
+#include "Poco/Net/HTTPServerResponseImpl.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPHeaderTable.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Observer.h"
+#include "Poco/NumberParser.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Ascii.h"
+#include <memory>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	const std::size_t READ_SIZE = 4096;
+}
+
+
+HTTPReactorConnection::HTTPReactorConnection(HTTPReactorServer& server, const StreamSocket& socket, SocketReactor& reactor):
+	_server(server),
+	_reactor(reactor),
+	_socket(socket),
+	_pParams(server._pParams),
+	_pFactory(server._pFactory),
+	_pSession(new HTTPServerSession(socket, server._pParams)),
+	_buffer(0),
+	_headerLength(0),
+	_requestLength(0),
+	_chunked(false)
+{
+	_server.connectionOpened();
+	registerHandlers();
+}
+
+
+HTTPReactorConnection::~HTTPReactorConnection()
+{
+	try
+	{
+		delete _pSession;
+		_socket.close();
+	}
+	catch (...)
+	{
+	}
+	_server.connectionClosed();
+}
+
+
+void HTTPReactorConnection::registerHandlers()
+{
+	_lastActivity.update();
+	_reactor.addEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ReadableNotification>(*this, &HTTPReactorConnection::onReadable));
+	_reactor.addEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ErrorNotification>(*this, &HTTPReactorConnection::onError));
+	_reactor.addEventHandler(_socket, Poco::Observer<HTTPReactorConnection, TimeoutNotification>(*this, &HTTPReactorConnection::onTimeout));
+	_reactor.addEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ShutdownNotification>(*this, &HTTPReactorConnection::onShutdown));
+}
+
+
+void HTTPReactorConnection::unregisterHandlers()
+{
+	_reactor.removeEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ReadableNotification>(*this, &HTTPReactorConnection::onReadable));
+	_reactor.removeEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ErrorNotification>(*this, &HTTPReactorConnection::onError));
+	_reactor.removeEventHandler(_socket, Poco::Observer<HTTPReactorConnection, TimeoutNotification>(*this, &HTTPReactorConnection::onTimeout));
+	_reactor.removeEventHandler(_socket, Poco::Observer<HTTPReactorConnection, ShutdownNotification>(*this, &HTTPReactorConnection::onShutdown));
+}
+
+
+void HTTPReactorConnection::close()
+{
+	delete this;
+}
+
+
+void HTTPReactorConnection::onReadable(ReadableNotification* pNf)
+{
+	pNf->release();
+
+	int n = 0;
+	try
+	{
+		std::size_t size = _buffer.size();
+		if (_buffer.capacity() < size + READ_SIZE)
+		{
+			std::size_t capacity = 2*_buffer.capacity();
+			if (capacity < size + READ_SIZE) capacity = size + READ_SIZE;
+			_buffer.setCapacity(capacity);
+		}
+		n = _socket.receiveBytes(_buffer.begin() + size, static_cast<int>(_buffer.capacity() - size));
+		if (n > 0) _buffer.resize(size + n);
+	}
+	catch (Poco::Exception&)
+	{
+		n = 0;
+	}
+	if (n <= 0)
+	{
+		unregisterHandlers();
+		close();
+	}
+	else if (requestComplete())
+	{
+		unregisterHandlers();
+		_server.dispatch(this);
+	}
+	else _lastActivity.update();
+}
+
+
+void HTTPReactorConnection::onError(ErrorNotification* pNf)
+{
+	pNf->release();
+	unregisterHandlers();
+	close();
+}
+
+
+void HTTPReactorConnection::onTimeout(TimeoutNotification* pNf)
+{
+	pNf->release();
+	if (_lastActivity.isElapsed(_pParams->getKeepAliveTimeout().totalMicroseconds()))
+	{
+		unregisterHandlers();
+		close();
+	}
+}
+
+
+void HTTPReactorConnection::onShutdown(ShutdownNotification* pNf)
+{
+	pNf->release();
+	unregisterHandlers();
+	close();
+}
+
+
+void HTTPReactorConnection::handleRequests()
+{
+	bool keepAlive = true;
+	try
+	{
+		int pipelineDepth = _pParams->getPipelineDepth();
+		int pipelined = 0;
+		do
+		{
+			_pSession->attachBuffer(_buffer.begin(), _buffer.size());
+			if (!_pSession->hasMoreRequests())
+			{
+				keepAlive = false;
+				break;
+			}
+			if (pipelineDepth > 1)
+				_pSession->setWriteBuffering(pipelined > 0 || _pSession->hasPipelinedRequest());
+			keepAlive = handleRequest();
+			if (_pSession->getWriteBuffering() && (!_pSession->hasPipelinedRequest() || ++pipelined >= pipelineDepth))
+			{
+				_pSession->flush();
+				pipelined = 0;
+			}
+
+			// The session may have read past the end of the request,
+			// either from our buffer, or from the socket.
+			Poco::Buffer<char> rest(0);
+			_pSession->drainBuffer(rest);
+			_buffer.swap(rest);
+			resetRequest();
+		}
+		while (keepAlive && _buffer.size() > 0 && requestComplete());
+		_pSession->flush();
+	}
+	catch (Poco::Exception& exc)
+	{
+		if (!_pSession->networkException()) ErrorHandler::handle(exc);
+		keepAlive = false;
+	}
+	catch (std::exception& exc)
+	{
+		ErrorHandler::handle(exc);
+		keepAlive = false;
+	}
+	catch (...)
+	{
+		ErrorHandler::handle();
+		keepAlive = false;
+	}
+
+	if (!keepAlive || !_server.resume(this))
+	{
+		close();
+	}
+}
+
+
+bool HTTPReactorConnection::handleRequest()
+{
+	try
+	{
+		HTTPServerResponseImpl response(*_pSession);
+		HTTPServerRequestImpl request(response, *_pSession, _pParams);
+
+		Poco::Timestamp now;
+		response.setDate(now);
+		response.setVersion(request.getVersion());
+		response.setKeepAlive(_pParams->getKeepAlive() && request.getKeepAlive() && _pSession->canKeepAlive());
+		const std::string& server = _pParams->getSoftwareVersion();
+		if (!server.empty())
+			response.set("Server", server);
+		try
+		{
+#if __cplusplus < 201103L
+			std::auto_ptr<HTTPRequestHandler> pHandler(_pFactory->createRequestHandler(request));
+#else
+			std::unique_ptr<HTTPRequestHandler> pHandler(_pFactory->createRequestHandler(request));
+#endif
+			if (pHandler.get())
+			{
+				if (request.getExpectContinue() && response.getStatus() == HTTPResponse::HTTP_OK)
+					response.sendContinue();
+
+				pHandler->handleRequest(request, response);
+				_pSession->setKeepAlive(_pParams->getKeepAlive() && response.getKeepAlive() && _pSession->canKeepAlive());
+			}
+			else sendErrorResponse(HTTPResponse::HTTP_NOT_IMPLEMENTED);
+		}
+		catch (Poco::Exception&)
+		{
+			if (!response.sent())
+			{
+				try
+				{
+					sendErrorResponse(HTTPResponse::HTTP_INTERNAL_SERVER_ERROR);
+				}
+				catch (...)
+				{
+				}
+			}
+			throw;
+		}
+	}
+	catch (NoMessageException&)
+	{
+		return false;
+	}
+	catch (MessageException&)
+	{
+		sendErrorResponse(HTTPResponse::HTTP_BAD_REQUEST);
+	}
+	return _pSession->getKeepAlive();
+}
+
+
+void HTTPReactorConnection::sendErrorResponse(HTTPResponse::HTTPStatus status)
+{
+	HTTPServerResponseImpl response(*_pSession);
+	response.setVersion(HTTPMessage::HTTP_1_1);
+	response.setStatusAndReason(status);
+	response.setKeepAlive(false);
+	response.send();
+	_pSession->setKeepAlive(false);
+}
+
+
+void HTTPReactorConnection::resetRequest()
+{
+	_headerLength  = 0;
+	_requestLength = 0;
+	_chunked       = false;
+}
+
+
+bool HTTPReactorConnection::requestComplete()
+{
+	const char* begin = _buffer.begin();
+	const char* end   = _buffer.end();
+
+	if (_headerLength == 0)
+	{
+		HTTPHeaderTable table;
+		try
+		{
+			std::size_t n = table.feed(begin, _buffer.size());
+			if (!table.complete()) return false;
+			_headerLength = n;
+			table.parseRequest();
+		}
+		catch (MessageException&)
+		{
+			// let the worker thread send the error response
+			return true;
+		}
+
+		const HTTPHeaderTable::Slice* pExpect = table.find("Expect", 6);
+		if (pExpect && HTTPHeaderTable::equals(*pExpect, "100-continue", 12))
+			return true;
+
+		const HTTPHeaderTable::Slice* pEncoding = table.find(HTTPMessage::TRANSFER_ENCODING);
+		const HTTPHeaderTable::Slice* pLength = table.find(HTTPMessage::CONTENT_LENGTH);
+		if (pEncoding && HTTPHeaderTable::equals(*pEncoding, HTTPMessage::CHUNKED_TRANSFER_ENCODING.data(), HTTPMessage::CHUNKED_TRANSFER_ENCODING.size()))
+		{
+			_chunked = true;
+		}
+		else if (pLength)
+		{
+			Poco::UInt64 length;
+			if (!Poco::NumberParser::tryParseUnsigned64(HTTPHeaderTable::toString(*pLength), length) || length > MAX_BUFFERED_BODY)
+				return true;
+			_requestLength = _headerLength + static_cast<std::size_t>(length);
+		}
+		else
+		{
+			std::string method = HTTPHeaderTable::toString(table.method());
+			if (method != HTTPRequest::HTTP_GET && method != HTTPRequest::HTTP_HEAD && method != HTTPRequest::HTTP_DELETE)
+				return true; // body is terminated by closing the connection
+			_requestLength = _headerLength;
+		}
+	}
+
+	if (_chunked)
+	{
+		if (static_cast<std::size_t>(end - begin) > _headerLength + MAX_BUFFERED_BODY) return true;
+		return chunkedBodyComplete(begin + _headerLength, end);
+	}
+	return static_cast<std::size_t>(end - begin) >= _requestLength;
+}
+
+
+bool HTTPReactorConnection::chunkedBodyComplete(const char* it, const char* end) const
+{
+	// Mirrors HTTPChunkedStreamBuf::readFromDevice().
+	for (;;)
+	{
+		while (it != end && Poco::Ascii::isSpace(*it)) ++it;
+		std::size_t chunk = 0;
+		int digits = 0;
+		while (it != end && Poco::Ascii::isHexDigit(*it) && digits < 8)
+		{
+			char c = *it++;
+			chunk = 16*chunk + (Poco::Ascii::isDigit(c) ? c - '0' : Poco::Ascii::toLower(c) - 'a' + 10);
+			++digits;
+		}
+		if (it == end) return false;
+		if (digits == 0 || !(Poco::Ascii::isSpace(*it) || *it == ';')) return true; // malformed, let the worker handle it
+		const char* pNL = static_cast<const char*>(std::memchr(it, '\n', end - it));
+		if (!pNL) return false;
+		it = pNL + 1;
+		if (chunk == 0)
+		{
+			return std::memchr(it, '\n', end - it) != 0;
+		}
+		if (static_cast<std::size_t>(end - it) < chunk) return false;
+		it += chunk;
+	}
+}
+
+
+} } // namespace Poco::Net
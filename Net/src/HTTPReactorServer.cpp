@@ -0,0 +1,215 @@
+//
+// HTTPReactorServer.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  HTTPReactorServer
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPReactorServer.h"
+#include "Poco/Net/HTTPReactorConnection.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Observer.h"
+#include "Poco/Environment.h"
+#include "Poco/ErrorHandler.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	class ConnectionNotification: public Poco::Notification
+	{
+	public:
+		ConnectionNotification(HTTPReactorConnection* pConnection):
+			_pConnection(pConnection)
+		{
+		}
+
+		HTTPReactorConnection* connection() const
+		{
+			return _pConnection;
+		}
+
+	private:
+		HTTPReactorConnection* _pConnection;
+	};
+
+
+	class StopNotification: public Poco::Notification
+	{
+	};
+}
+
+
+HTTPReactorServer::HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, Poco::UInt16 portNumber, HTTPServerParams::Ptr pParams):
+	_socket(portNumber),
+	_pFactory(pFactory),
+	_pParams(pParams),
+	_nextReactor(0),
+	_started(false),
+	_stopped(false)
+{
+	init(0);
+}
+
+
+HTTPReactorServer::HTTPReactorServer(HTTPRequestHandlerFactory::Ptr pFactory, const ServerSocket& socket, HTTPServerParams::Ptr pParams, unsigned reactors):
+	_socket(socket),
+	_pFactory(pFactory),
+	_pParams(pParams),
+	_nextReactor(0),
+	_started(false),
+	_stopped(false)
+{
+	init(reactors);
+}
+
+
+HTTPReactorServer::~HTTPReactorServer()
+{
+	try
+	{
+		stop();
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+void HTTPReactorServer::init(unsigned reactors)
+{
+	poco_check_ptr (_pFactory);
+	poco_check_ptr (_pParams);
+
+	_reactorCount = reactors > 0 ? reactors : Poco::Environment::processorCount();
+	if (_reactorCount == 0) _reactorCount = 1;
+}
+
+
+void HTTPReactorServer::start()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	poco_assert (!_started);
+
+	for (unsigned i = 0; i < _reactorCount; ++i)
+	{
+		_reactors.push_back(new Reactor);
+	}
+	int workers = _pParams->getMaxThreads();
+	if (workers == 0) workers = DEFAULT_WORKERS;
+	for (int i = 0; i < workers; ++i)
+	{
+		Poco::Thread* pThread = new Poco::Thread;
+		pThread->setPriority(_pParams->getThreadPriority());
+		_workers.push_back(pThread);
+		pThread->start(*this);
+	}
+	_acceptReactor.addEventHandler(_socket, Poco::Observer<HTTPReactorServer, ReadableNotification>(*this, &HTTPReactorServer::onAccept));
+	_acceptThread.start(_acceptReactor);
+	_started = true;
+}
+
+
+void HTTPReactorServer::stop()
+{
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (!_started || _stopped) return;
+		_stopped = true;
+	}
+
+	_acceptReactor.stop();
+	_acceptReactor.wakeUp();
+	_acceptThread.join();
+	_acceptReactor.removeEventHandler(_socket, Poco::Observer<HTTPReactorServer, ReadableNotification>(*this, &HTTPReactorServer::onAccept));
+
+	// Destroying a reactor closes all connections registered with it.
+	_reactors.clear();
+
+	// Workers finish the connections still in the queue before they
+	// dequeue their StopNotification. Since the server has been stopped,
+	// these connections are closed instead of being resumed.
+	for (std::size_t i = 0; i < _workers.size(); ++i)
+	{
+		_queue.enqueueNotification(new StopNotification);
+	}
+	for (ThreadVec::iterator it = _workers.begin(); it != _workers.end(); ++it)
+	{
+		(*it)->join();
+		delete *it;
+	}
+	_workers.clear();
+}
+
+
+Poco::UInt16 HTTPReactorServer::port() const
+{
+	return _socket.address().port();
+}
+
+
+void HTTPReactorServer::run()
+{
+	for (;;)
+	{
+		Poco::AutoPtr<Poco::Notification> pNf = _queue.waitDequeueNotification();
+		ConnectionNotification* pCNf = dynamic_cast<ConnectionNotification*>(pNf.get());
+		if (!pCNf) break;
+		pCNf->connection()->handleRequests();
+	}
+}
+
+
+void HTTPReactorServer::onAccept(ReadableNotification* pNf)
+{
+	pNf->release();
+	StreamSocket socket = _socket.acceptConnection();
+	SocketReactor& reactor = *_reactors[_nextReactor++ % _reactors.size()];
+	new HTTPReactorConnection(*this, socket, reactor);
+}
+
+
+void HTTPReactorServer::dispatch(HTTPReactorConnection* pConnection)
+{
+	_queue.enqueueNotification(new ConnectionNotification(pConnection));
+}
+
+
+bool HTTPReactorServer::resume(HTTPReactorConnection* pConnection)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (_stopped) return false;
+	pConnection->registerHandlers();
+	return true;
+}
+
+
+void HTTPReactorServer::connectionOpened()
+{
+	++_connections;
+}
+
+
+void HTTPReactorServer::connectionClosed()
+{
+	--_connections;
+}
+
+
+} } // namespace Poco::Net
@@ -15,6 +15,7 @@
 
 
 #include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPHeaderTable.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/NameValueCollection.h"
 #include "Poco/NumberFormatter.h"
@@ -233,6 +234,24 @@ void HTTPRequest::read(std::istream& istr)
 }
 
 
+void HTTPRequest::read(const HTTPHeaderTable& table)
+{
+	std::string value;
+	for (int i = 0; i < table.count(); ++i)
+	{
+		const HTTPHeaderTable::Field& field = table[i];
+		value.assign(field.value.data, field.value.length);
+		if (value.find("=?") == std::string::npos)
+			add(HTTPHeaderTable::toString(field.name), value);
+		else
+			add(HTTPHeaderTable::toString(field.name), decodeWord(value));
+	}
+	setMethod(HTTPHeaderTable::toString(table.method()));
+	setURI(HTTPHeaderTable::toString(table.uri()));
+	setVersion(HTTPHeaderTable::toString(table.version()));
+}
+
+
 void HTTPRequest::getCredentials(const std::string& header, std::string& scheme, std::string& authInfo) const
 {
 	scheme.clear();
@@ -21,8 +21,10 @@
 #include "Poco/Net/HTTPRequestHandler.h"
 #include "Poco/Net/HTTPRequestHandlerFactory.h"
 #include "Poco/Net/NetException.h"
+#include "Poco/Net/ServerStatistics.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Clock.h"
 #include "Poco/Delegate.h"
 #include <memory>
 
@@ -59,16 +61,37 @@ HTTPServerConnection::~HTTPServerConnection()
 void HTTPServerConnection::run()
 {
 	std::string server = _pParams->getSoftwareVersion();
+	int pipelineDepth = _pParams->getPipelineDepth();
+	int pipelined = 0;
+	ServerStatistics::Ptr pStatistics = _pParams->getStatistics();
+	int requests = 0;
 	HTTPServerSession session(socket(), _pParams);
 	while (!_stopped && session.hasMoreRequests())
 	{
+		Poco::UInt64 bytesReceived = session.bytesReceived();
+		Poco::UInt64 bytesSent = session.bytesSent();
+		Poco::Clock writeStart;
+		bool handled = false;
 		try
 		{
 			Poco::FastMutex::ScopedLock lock(_mutex);
 			if (!_stopped)
 			{
+				Poco::Clock parseStart;
 				HTTPServerResponseImpl response(session);
 				HTTPServerRequestImpl request(response, session, _pParams);
+
+				if (pStatistics)
+				{
+					pStatistics->requestParseTime().recordElapsed(parseStart);
+					pStatistics->requests().add();
+					if (requests++ > 0) pStatistics->keepAliveRequests().add();
+				}
+
+				// Collect the responses to pipelined requests, and send them
+				// together after the last request of a batch has been handled.
+				if (pipelineDepth > 1)
+					session.setWriteBuffering(pipelined > 0 || session.hasPipelinedRequest());
 			
 				Poco::Timestamp now;
 				response.setDate(now);
@@ -88,7 +111,14 @@ void HTTPServerConnection::run()
 						if (request.getExpectContinue() && response.getStatus() == HTTPResponse::HTTP_OK)
 							response.sendContinue();
 					
+						Poco::Clock handleStart;
 						pHandler->handleRequest(request, response);
+						if (pStatistics)
+						{
+							pStatistics->requestHandleTime().recordElapsed(handleStart);
+							writeStart.update();
+							handled = true;
+						}
 						session.setKeepAlive(_pParams->getKeepAlive() && response.getKeepAlive() && session.canKeepAlive());
 					}
 					else sendErrorResponse(session, HTTPResponse::HTTP_NOT_IMPLEMENTED);
@@ -108,6 +138,15 @@ void HTTPServerConnection::run()
 					throw;
 				}
 			}
+			if (session.getWriteBuffering() && (!session.hasPipelinedRequest() || ++pipelined >= pipelineDepth))
+			{
+				session.flush();
+				pipelined = 0;
+			}
+			if (handled)
+			{
+				pStatistics->responseWriteTime().recordElapsed(writeStart);
+			}
 		}
 		catch (NoMessageException&)
 		{
@@ -115,6 +154,7 @@ void HTTPServerConnection::run()
 		}
 		catch (MessageException&)
 		{
+			if (pStatistics) pStatistics->badRequests().add();
 			sendErrorResponse(session, HTTPResponse::HTTP_BAD_REQUEST);
 		}
 		catch (Poco::Exception&)
@@ -125,6 +165,11 @@ void HTTPServerConnection::run()
 			}
 			else throw;
 		}
+		if (pStatistics)
+		{
+			pStatistics->bytesReceived().add(session.bytesReceived() - bytesReceived);
+			pStatistics->bytesSent().add(session.bytesSent() - bytesSent);
+		}
 	}
 }
 
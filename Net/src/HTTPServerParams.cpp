@@ -25,7 +25,9 @@ HTTPServerParams::HTTPServerParams():
 	_timeout(60000000),
 	_keepAlive(true),
 	_maxKeepAliveRequests(0),
-	_keepAliveTimeout(15000000)
+	_keepAliveTimeout(15000000),
+	_fastHeaderParsing(false),
+	_pipelineDepth(1)
 {
 }
 
@@ -70,6 +72,19 @@ void HTTPServerParams::setMaxKeepAliveRequests(int maxKeepAliveRequests)
 	poco_assert (maxKeepAliveRequests >= 0);
 	_maxKeepAliveRequests = maxKeepAliveRequests;
 }
+
+
+void HTTPServerParams::setFastHeaderParsing(bool fastHeaderParsing)
+{
+	_fastHeaderParsing = fastHeaderParsing;
+}
+
+
+void HTTPServerParams::setPipelineDepth(int pipelineDepth)
+{
+	poco_assert (pipelineDepth > 0);
+	_pipelineDepth = pipelineDepth;
+}
 	
 
 } } // namespace Poco::Net
@@ -41,8 +41,15 @@ HTTPServerRequestImpl::HTTPServerRequestImpl(HTTPServerResponseImpl& response, H
 {
 	response.attachRequest(this);
 
-	HTTPHeaderInputStream hs(session);
-	read(hs);
+	if (pParams->getFastHeaderParsing())
+	{
+		read(session.readRequestHeader());
+	}
+	else
+	{
+		HTTPHeaderInputStream hs(session);
+		read(hs);
+	}
 	
 	// Now that we know socket is still connected, obtain addresses
 	_clientAddress = session.clientAddress();
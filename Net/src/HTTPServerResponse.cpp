@@ -15,6 +15,22 @@
 
 
 #include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/DateTimeFormatter.h"
+#include "Poco/DateTimeFormat.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/Exception.h"
+
+
+using Poco::File;
+using Poco::Timestamp;
+using Poco::DateTimeFormatter;
+using Poco::DateTimeFormat;
+using Poco::NumberFormatter;
+using Poco::OpenFileException;
+using Poco::ReadFileException;
 
 
 namespace Poco {
@@ -31,4 +47,80 @@ HTTPServerResponse::~HTTPServerResponse()
 }
 
 
+void HTTPServerResponse::sendFile(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length)
+{
+	length = prepareRange(path, mediaType, offset, length);
+
+	Poco::FileInputStream istr(path);
+	if (!istr.good()) throw OpenFileException(path);
+	std::ostream& ostr = send();
+	if (length > 0)
+	{
+		istr.seekg(static_cast<std::streamoff>(offset));
+		char buffer[8192];
+		while (length > 0 && istr.good())
+		{
+			std::streamsize n = static_cast<std::streamsize>(length < sizeof(buffer) ? length : sizeof(buffer));
+			istr.read(buffer, n);
+			n = istr.gcount();
+			ostr.write(buffer, n);
+			length -= static_cast<Poco::UInt64>(n);
+		}
+		// the file has been truncated since its size was determined
+		if (length > 0) throw ReadFileException(path);
+	}
+}
+
+
+void HTTPServerResponse::sendBuffers(const SocketBufVec& buffers)
+{
+#if defined(POCO_HAVE_INT64)
+	setContentLength64(static_cast<Poco::Int64>(Socket::bufferLength(buffers)));
+#else
+	setContentLength(static_cast<int>(Socket::bufferLength(buffers)));
+#endif
+	setChunkedTransferEncoding(false);
+
+	std::ostream& ostr = send();
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		ostr.write(Socket::bufferData(*it), static_cast<std::streamsize>(Socket::bufferLength(*it)));
+	}
+}
+
+
+Poco::UInt64 HTTPServerResponse::prepareRange(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length)
+{
+	File f(path);
+	Timestamp dateTime    = f.getLastModified();
+	File::FileSize size   = f.getSize();
+	set("Last-Modified", DateTimeFormatter::format(dateTime, DateTimeFormat::HTTP_FORMAT));
+	setChunkedTransferEncoding(false);
+	if (offset >= size || length == 0)
+	{
+		// an empty range cannot be expressed in a Content-Range header
+		setStatusAndReason(HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+		set("Content-Range", "bytes */" + NumberFormatter::format(size));
+		setContentLength(0);
+		return 0;
+	}
+	if (length > size - offset) length = size - offset;
+	setStatusAndReason(HTTP_PARTIAL_CONTENT);
+	std::string range("bytes ");
+	NumberFormatter::append(range, offset);
+	range += '-';
+	NumberFormatter::append(range, offset + length - 1);
+	range += '/';
+	NumberFormatter::append(range, size);
+	set("Content-Range", range);
+#if defined(POCO_HAVE_INT64)	
+	setContentLength64(length);
+#else
+	setContentLength(static_cast<int>(length));
+#endif
+	setContentType(mediaType);
+	return length;
+}
+
+
 } } // namespace Poco::Net
@@ -30,6 +30,7 @@
 #include "Poco/FileStream.h"
 #include "Poco/DateTimeFormatter.h"
 #include "Poco/DateTimeFormat.h"
+#include <sstream>
 
 
 using Poco::File;
@@ -123,33 +124,83 @@ void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string
 	setContentType(mediaType);
 	setChunkedTransferEncoding(false);
 
+	sendFileContent(path, 0, length);
+}
+
+
+void HTTPServerResponseImpl::sendFile(const std::string& path, const std::string& mediaType, Poco::UInt64 offset, Poco::UInt64 length)
+{
+	poco_assert (!_pStream);
+
+	Poco::UInt64 n = prepareRange(path, mediaType, offset, length);
+	sendFileContent(path, offset, n);
+}
+
+
+void HTTPServerResponseImpl::sendFileContent(const std::string& path, Poco::UInt64 offset, Poco::UInt64 length)
+{
 	Poco::FileInputStream istr(path);
-	if (istr.good())
+	if (!istr.good()) throw OpenFileException(path);
+
+	_pStream = new HTTPHeaderOutputStream(_session);
+	std::ostringstream hs;
+	write(hs);
+	std::string header(hs.str());
+	_session.write(SocketBufVec(1, Socket::makeBuffer(header.data(), header.size())));
+	if (length > 0 && _pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 	{
-		_pStream = new HTTPHeaderOutputStream(_session);
-		write(*_pStream);
-		if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
+		_session.flush();
+		Poco::Int64 sent;
+		try
 		{
-			StreamCopier::copyStream(istr, *_pStream);
+			sent = _session.socket().sendFile(istr, offset, length);
+			if (sent > 0) _session._bytesSent += sent;
+		}
+		catch (Poco::Exception& exc)
+		{
+			_session.setException(exc);
+			throw;
+		}
+		if (static_cast<Poco::UInt64>(sent) < length)
+		{
+			// The file has been truncated since its size was determined,
+			// so the response cannot be completed.
+			_session.setKeepAlive(false);
+			throw Poco::ReadFileException(path);
 		}
 	}
-	else throw OpenFileException(path);
 }
 
 
 void HTTPServerResponseImpl::sendBuffer(const void* pBuffer, std::size_t length)
+{
+	sendBuffers(SocketBufVec(1, Socket::makeBuffer(pBuffer, length)));
+}
+
+
+void HTTPServerResponseImpl::sendBuffers(const SocketBufVec& buffers)
 {
 	poco_assert (!_pStream);
 
-	setContentLength(static_cast<int>(length));
+#if defined(POCO_HAVE_INT64)
+	setContentLength64(static_cast<Poco::Int64>(Socket::bufferLength(buffers)));
+#else
+	setContentLength(static_cast<int>(Socket::bufferLength(buffers)));
+#endif
 	setChunkedTransferEncoding(false);
-	
+
 	_pStream = new HTTPHeaderOutputStream(_session);
-	write(*_pStream);
+	std::ostringstream hs;
+	write(hs);
+	std::string header(hs.str());
+	SocketBufVec all;
+	all.reserve(buffers.size() + 1);
+	all.push_back(Socket::makeBuffer(header.data(), header.size()));
 	if (_pRequest && _pRequest->getMethod() != HTTPRequest::HTTP_HEAD)
 	{
-		_pStream->write(static_cast<const char*>(pBuffer), static_cast<std::streamsize>(length));
+		all.insert(all.end(), buffers.begin(), buffers.end());
 	}
+	_session.write(all);
 }
 
 
@@ -45,13 +45,15 @@ bool HTTPServerSession::hasMoreRequests()
 	{
 		_firstRequest = false;
 		--_maxKeepAliveRequests;
-		return socket().poll(getTimeout(), Socket::SELECT_READ);
+		return buffered() > 0 || socket().poll(getTimeout(), Socket::SELECT_READ);
 	}
 	else if (_maxKeepAliveRequests != 0 && getKeepAlive())
 	{
 		if (_maxKeepAliveRequests > 0) 
 			--_maxKeepAliveRequests;
-		return buffered() > 0 || socket().poll(_keepAliveTimeout, Socket::SELECT_READ);
+		if (buffered() > 0) return true;
+		flush();
+		return socket().poll(_keepAliveTimeout, Socket::SELECT_READ);
 	}
 	else return false;
 }
@@ -69,4 +71,13 @@ SocketAddress HTTPServerSession::serverAddress()
 }
 
 
+const HTTPHeaderTable& HTTPServerSession::readRequestHeader()
+{
+	_headerTable.reset();
+	readHeader(_headerTable);
+	_headerTable.parseRequest();
+	return _headerTable;
+}
+
+
 } } // namespace Poco::Net
@@ -16,6 +16,7 @@
 
 #include "Poco/Net/HTTPSession.h"
 #include "Poco/Net/HTTPBufferAllocator.h"
+#include "Poco/Net/HTTPHeaderTable.h"
 #include "Poco/Net/NetException.h"
 #include <cstring>
 
@@ -31,6 +32,12 @@ HTTPSession::HTTPSession():
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(0),
+	_bytesReceived(0),
+	_bytesSent(0),
+	_pWriteBuffer(0),
+	_writeBuffered(0),
+	_writeBuffering(false),
 	_keepAlive(false),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
@@ -45,6 +52,12 @@ HTTPSession::HTTPSession(const StreamSocket& socket):
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(0),
+	_bytesReceived(0),
+	_bytesSent(0),
+	_pWriteBuffer(0),
+	_writeBuffered(0),
+	_writeBuffering(false),
 	_keepAlive(false),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
@@ -59,6 +72,12 @@ HTTPSession::HTTPSession(const StreamSocket& socket, bool keepAlive):
 	_pBuffer(0),
 	_pCurrent(0),
 	_pEnd(0),
+	_bufferSize(0),
+	_bytesReceived(0),
+	_bytesSent(0),
+	_pWriteBuffer(0),
+	_writeBuffered(0),
+	_writeBuffering(false),
 	_keepAlive(keepAlive),
 	_connectionTimeout(HTTP_DEFAULT_CONNECTION_TIMEOUT),
 	_receiveTimeout(HTTP_DEFAULT_TIMEOUT),
@@ -72,7 +91,15 @@ HTTPSession::~HTTPSession()
 {
 	try
 	{
-		if (_pBuffer) HTTPBufferAllocator::deallocate(_pBuffer, HTTPBufferAllocator::BUFFER_SIZE);
+		flush();
+	}
+	catch (...)
+	{
+	}
+	delete [] _pWriteBuffer;
+	try
+	{
+		if (_pBuffer) HTTPBufferAllocator::deallocate(_pBuffer, _bufferSize);
 	}
 	catch (...)
 	{
@@ -148,9 +175,80 @@ int HTTPSession::read(char* buffer, std::streamsize length)
 
 int HTTPSession::write(const char* buffer, std::streamsize length)
 {
+	if (_writeBuffering && length < HTTP_WRITE_BUFFER_SIZE)
+	{
+		if (_writeBuffered + length > HTTP_WRITE_BUFFER_SIZE) flush();
+		std::memcpy(_pWriteBuffer + _writeBuffered, buffer, static_cast<std::size_t>(length));
+		_writeBuffered += static_cast<std::size_t>(length);
+		return static_cast<int>(length);
+	}
+	flush();
 	try
 	{
-		return _socket.sendBytes(buffer, (int) length);
+		int n = _socket.sendBytes(buffer, (int) length);
+		if (n > 0) _bytesSent += n;
+		return n;
+	}
+	catch (Poco::Exception& exc)
+	{
+		setException(exc);
+		throw;
+	}
+}
+
+
+int HTTPSession::write(const SocketBufVec& buffers)
+{
+	std::size_t length = Socket::bufferLength(buffers);
+	if (_writeBuffering && length < HTTP_WRITE_BUFFER_SIZE)
+	{
+		if (_writeBuffered + length > HTTP_WRITE_BUFFER_SIZE) flush();
+		for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+		{
+			std::size_t n = Socket::bufferLength(*it);
+#if defined(POCO_OS_FAMILY_WINDOWS)
+			std::memcpy(_pWriteBuffer + _writeBuffered, it->buf, n);
+#else
+			std::memcpy(_pWriteBuffer + _writeBuffered, it->iov_base, n);
+#endif
+			_writeBuffered += n;
+		}
+		return static_cast<int>(length);
+	}
+	try
+	{
+		if (_writeBuffered > 0)
+		{
+			// Send the buffered data along with the given buffers.
+			SocketBufVec all;
+			all.reserve(buffers.size() + 1);
+			all.push_back(Socket::makeBuffer(_pWriteBuffer, _writeBuffered));
+			all.insert(all.end(), buffers.begin(), buffers.end());
+			int n = _socket.sendBytes(all);
+			if (n > 0) _bytesSent += n;
+			std::size_t sent = n > 0 ? static_cast<std::size_t>(n) : 0;
+			if (sent >= _writeBuffered)
+			{
+				sent -= _writeBuffered;
+				_writeBuffered = 0;
+				return static_cast<int>(sent);
+			}
+			// Not even the buffered data could be sent completely.
+			// The rest must be sent before any of the given buffers.
+			consumeWriteBuffer(sent);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		setException(exc);
+		throw;
+	}
+	flush();
+	try
+	{
+		int n = _socket.sendBytes(buffers);
+		if (n > 0) _bytesSent += n;
+		return n;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -162,9 +260,12 @@ int HTTPSession::write(const char* buffer, std::streamsize length)
 
 int HTTPSession::receive(char* buffer, int length)
 {
+	flush();
 	try
 	{
-		return _socket.receiveBytes(buffer, length);
+		int n = _socket.receiveBytes(buffer, length);
+		if (n > 0) _bytesReceived += n;
+		return n;
 	}
 	catch (Poco::Exception& exc)
 	{
@@ -178,14 +279,41 @@ void HTTPSession::refill()
 {
 	if (!_pBuffer)
 	{
-		_pBuffer = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+		_bufferSize = HTTPBufferAllocator::getBufferSize();
+		_pBuffer = HTTPBufferAllocator::allocate(_bufferSize);
 	}
 	_pCurrent = _pEnd = _pBuffer;
-	int n = receive(_pBuffer, HTTPBufferAllocator::BUFFER_SIZE);
+	int n = receive(_pBuffer, static_cast<int>(_bufferSize));
 	_pEnd += n;
 }
 
 
+bool HTTPSession::bufferedHeader() const
+{
+	const char* it = _pCurrent;
+	while (it != _pEnd)
+	{
+		const char* pNL = static_cast<const char*>(std::memchr(it, '\n', _pEnd - it));
+		if (!pNL || ++pNL == _pEnd) break;
+		if (*pNL == '\n' || (*pNL == '\r' && pNL + 1 != _pEnd && pNL[1] == '\n'))
+			return true;
+		it = pNL;
+	}
+	return false;
+}
+
+
+void HTTPSession::readHeader(HTTPHeaderTable& table)
+{
+	while (!table.complete())
+	{
+		if (_pCurrent == _pEnd) refill();
+		if (_pCurrent == _pEnd) break;
+		_pCurrent += table.feed(_pCurrent, static_cast<std::size_t>(_pEnd - _pCurrent));
+	}
+}
+
+
 bool HTTPSession::connected() const
 {
 	return _socket.impl()->initialized();
@@ -233,6 +361,7 @@ void HTTPSession::clearException()
 
 StreamSocket HTTPSession::detachSocket()
 {
+	flush();
 	StreamSocket oldSocket(_socket);
 	StreamSocket newSocket;
 	_socket = newSocket;
@@ -246,6 +375,57 @@ void HTTPSession::attachSocket(const StreamSocket& socket)
 }
 
 
+void HTTPSession::attachBuffer(char* pBuffer, std::size_t length)
+{
+	_pCurrent = pBuffer;
+	_pEnd = pBuffer + length;
+}
+
+
+void HTTPSession::setWriteBuffering(bool writeBuffering)
+{
+	if (writeBuffering)
+	{
+		if (!_pWriteBuffer) _pWriteBuffer = new char[HTTP_WRITE_BUFFER_SIZE];
+	}
+	else flush();
+	_writeBuffering = writeBuffering;
+}
+
+
+void HTTPSession::flush()
+{
+	std::size_t sent = 0;
+	try
+	{
+		while (sent < _writeBuffered)
+		{
+			int n = _socket.sendBytes(_pWriteBuffer + sent, static_cast<int>(_writeBuffered - sent));
+			if (n <= 0) throw NetException("Cannot send buffered HTTP data");
+			_bytesSent += n;
+			sent += static_cast<std::size_t>(n);
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		consumeWriteBuffer(sent);
+		setException(exc);
+		throw;
+	}
+	_writeBuffered = 0;
+}
+
+
+void HTTPSession::consumeWriteBuffer(std::size_t length)
+{
+	if (length > 0)
+	{
+		std::memmove(_pWriteBuffer, _pWriteBuffer + length, _writeBuffered - length);
+		_writeBuffered -= length;
+	}
+}
+
+
 void HTTPSession::attachSessionData(const Poco::Any& data)
 {
 	_data = data;
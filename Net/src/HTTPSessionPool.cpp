@@ -0,0 +1,320 @@
+//
+// HTTPSessionPool.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPClient
+// Module:  HTTPSessionPool
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/HTTPSessionPool.h"
+#include "Poco/Net/HTTPSessionFactory.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+HTTPSessionPool::ScopedSession::ScopedSession(HTTPSessionPool& pool, const Poco::URI& uri):
+	_pool(pool),
+	_pSession(pool.get(uri))
+{
+}
+
+
+HTTPSessionPool::ScopedSession::~ScopedSession()
+{
+	try
+	{
+		_pool.release(_pSession);
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+HTTPSessionPool::HTTPSessionPool(int maxSessionsPerHost, int idleTime):
+	getAsync(this, &HTTPSessionPool::getImpl),
+	_maxSessionsPerHost(maxSessionsPerHost),
+	_idleTime(idleTime),
+	_waitTimeout(30, 0),
+	_used(0),
+	_idle(0),
+	_hits(0),
+	_misses(0),
+	_waits(0),
+	_janitorTimer(1000*idleTime, 1000*idleTime/4)
+{
+	poco_assert (maxSessionsPerHost >= 0 && idleTime > 0);
+
+	_janitorTimer.start(Poco::TimerCallback<HTTPSessionPool>(*this, &HTTPSessionPool::onJanitorTimer));
+}
+
+
+HTTPSessionPool::~HTTPSessionPool()
+{
+	try
+	{
+		_janitorTimer.stop();
+		for (HostMap::iterator it = _hosts.begin(); it != _hosts.end(); ++it)
+		{
+			for (IdleList::iterator itIdle = it->second.idle.begin(); itIdle != it->second.idle.end(); ++itIdle)
+			{
+				delete itIdle->pSession;
+			}
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+}
+
+
+HTTPClientSession* HTTPSessionPool::get(const Poco::URI& uri)
+{
+	std::string k = key(uri);
+	Poco::Timestamp start;
+	bool waited = false;
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+
+		for (;;)
+		{
+			Host& host = _hosts[k];
+			// Prefer the most recently used session, which is
+			// the least likely to have been closed by the server.
+			while (!host.idle.empty())
+			{
+				HTTPClientSession* pSession = host.idle.back().pSession;
+				host.idle.pop_back();
+				--_idle;
+				if (isStale(*pSession))
+				{
+					delete pSession;
+				}
+				else
+				{
+					++host.used;
+					++_used;
+					++_hits;
+					_sessions[pSession] = k;
+					return pSession;
+				}
+			}
+			if (_maxSessionsPerHost == 0 || host.used < _maxSessionsPerHost)
+			{
+				++host.used;
+				++_used;
+				++_misses;
+				break;
+			}
+			if (!waited)
+			{
+				++_waits;
+				waited = true;
+			}
+			Poco::Timespan remaining = _waitTimeout - Poco::Timespan(start.elapsed());
+			if (remaining <= 0 || !_available.tryWait(_mutex, static_cast<long>(remaining.totalMilliseconds())))
+				throw Poco::TimeoutException("No HTTP session available for", k);
+		}
+	}
+
+	// The new session is created without holding the lock,
+	// as a HTTPSessionInstantiator may do arbitrary work.
+	HTTPClientSession* pSession = 0;
+	try
+	{
+		pSession = createSession(uri);
+	}
+	catch (...)
+	{
+		Poco::Mutex::ScopedLock lock(_mutex);
+		--_hosts[k].used;
+		--_used;
+		_available.broadcast();
+		throw;
+	}
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+	_sessions[pSession] = k;
+	return pSession;
+}
+
+
+HTTPClientSession* HTTPSessionPool::getImpl(const Poco::URI& uri)
+{
+	return get(uri);
+}
+
+
+void HTTPSessionPool::release(HTTPClientSession* pSession)
+{
+	poco_check_ptr (pSession);
+
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	SessionMap::iterator it = _sessions.find(pSession);
+	if (it == _sessions.end()) throw InvalidArgumentException("HTTPClientSession not obtained from this pool");
+
+	bool reuse = pSession->connected() && pSession->getKeepAlive() && !pSession->networkException();
+	Host& host = _hosts[it->second];
+	_sessions.erase(it);
+	--host.used;
+	--_used;
+	if (reuse)
+	{
+		IdleSession idleSession;
+		idleSession.pSession = pSession;
+		host.idle.push_back(idleSession);
+		++_idle;
+	}
+	else delete pSession;
+	_available.broadcast();
+}
+
+
+void HTTPSessionPool::setWaitTimeout(const Poco::Timespan& timeout)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	_waitTimeout = timeout;
+}
+
+
+Poco::Timespan HTTPSessionPool::getWaitTimeout() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _waitTimeout;
+}
+
+
+int HTTPSessionPool::used() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _used;
+}
+
+
+int HTTPSessionPool::idle() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _idle;
+}
+
+
+int HTTPSessionPool::allocated() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _used + _idle;
+}
+
+
+int HTTPSessionPool::hits() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _hits;
+}
+
+
+int HTTPSessionPool::misses() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _misses;
+}
+
+
+int HTTPSessionPool::waits() const
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	return _waits;
+}
+
+
+std::string HTTPSessionPool::key(const Poco::URI& uri)
+{
+	std::string k(Poco::toLower(uri.getScheme()));
+	k += "://";
+	k += Poco::toLower(uri.getHost());
+	k += ':';
+	Poco::NumberFormatter::append(k, uri.getPort());
+	return k;
+}
+
+
+HTTPClientSession* HTTPSessionPool::createSession(const Poco::URI& uri)
+{
+	HTTPClientSession* pSession;
+	if (Poco::icompare(uri.getScheme(), "http") == 0)
+		pSession = new HTTPClientSession(uri.getHost(), uri.getPort());
+	else
+		pSession = HTTPSessionFactory::defaultFactory().createClientSession(uri);
+	pSession->setKeepAlive(true);
+	return pSession;
+}
+
+
+bool HTTPSessionPool::isStale(HTTPClientSession& session) const
+{
+	if (!session.connected()) return false;
+	try
+	{
+		// An idle connection must not have anything to read.
+		return session.socket().poll(Poco::Timespan(0), Socket::SELECT_READ | Socket::SELECT_ERROR);
+	}
+	catch (Poco::Exception&)
+	{
+		return true;
+	}
+}
+
+
+void HTTPSessionPool::onJanitorTimer(Poco::Timer&)
+{
+	Poco::Mutex::ScopedLock lock(_mutex);
+
+	Poco::Timestamp::TimeDiff maxIdle = Poco::Timestamp::TimeDiff(_idleTime)*Poco::Timestamp::resolution();
+	HostMap::iterator it = _hosts.begin();
+	while (it != _hosts.end())
+	{
+		IdleList& idle = it->second.idle;
+		IdleList::iterator itIdle = idle.begin();
+		while (itIdle != idle.end())
+		{
+			if (itIdle->lastUsed.isElapsed(maxIdle) || isStale(*itIdle->pSession))
+			{
+				delete itIdle->pSession;
+				itIdle = idle.erase(itIdle);
+				--_idle;
+			}
+			else ++itIdle;
+		}
+		if (idle.empty() && it->second.used == 0)
+			_hosts.erase(it++);
+		else
+			++it;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,485 @@
+//
+// PollSet.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: Sockets
+// Module:  PollSet
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/PollSet.h"
+#include "Poco/Net/SocketImpl.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Mutex.h"
+#include "Poco/Timestamp.h"
+#include <vector>
+#if defined(POCO_HAVE_FD_EPOLL)
+#include <sys/epoll.h>
+#include <unistd.h>
+#elif defined(POCO_HAVE_FD_POLL)
+#include <poll.h>
+#endif
+
+
+namespace Poco {
+namespace Net {
+
+
+#if defined(POCO_HAVE_FD_EPOLL)
+
+
+//
+// Linux implementation using epoll
+//
+class PollSetImpl
+{
+public:
+	PollSetImpl(PollSet::Trigger trigger):
+		_trigger(trigger),
+		_epollfd(epoll_create(1))
+	{
+		if (_epollfd < 0) SocketImpl::error("Can't create epoll queue");
+	}
+
+	~PollSetImpl()
+	{
+		::close(_epollfd);
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		SocketMap::iterator it = _socketMap.find(socket.impl());
+		set(socket, mode, it == _socketMap.end());
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		SocketImpl* pImpl = socket.impl();
+		SocketMap::iterator it = _socketMap.find(pImpl);
+		if (it == _socketMap.end()) return;
+
+		removeImpl(pImpl);
+		_socketMap.erase(it);
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		// The lookup and the modification must be done under the
+		// same lock, otherwise a socket removed in between would
+		// be added again.
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_socketMap.find(socket.impl()) != _socketMap.end())
+			set(socket, mode, false);
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _socketMap.find(socket.impl()) != _socketMap.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _socketMap.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		// The epoll descriptor is kept, as poll() may be
+		// waiting for it in another thread.
+		for (SocketMap::iterator it = _socketMap.begin(); it != _socketMap.end(); ++it)
+		{
+			removeImpl(it->second.impl());
+		}
+		_socketMap.clear();
+	}
+
+	PollSet::Trigger trigger() const
+	{
+		return _trigger;
+	}
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		PollSet::SocketModeMap result;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_socketMap.empty()) return result;
+			_events.resize(_socketMap.size() < static_cast<std::size_t>(MAX_EVENTS) ? _socketMap.size() : static_cast<std::size_t>(MAX_EVENTS));
+		}
+
+		Poco::Timespan remainingTime(timeout);
+		int rc;
+		do
+		{
+			Poco::Timestamp start;
+			rc = epoll_wait(_epollfd, &_events[0], static_cast<int>(_events.size()), static_cast<int>(remainingTime.totalMilliseconds()));
+			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			{
+				Poco::Timestamp end;
+				Poco::Timespan waited = end - start;
+				if (waited < remainingTime)
+					remainingTime -= waited;
+				else
+					remainingTime = 0;
+			}
+		}
+		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
+		if (rc < 0) SocketImpl::error();
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		for (int i = 0; i < rc; i++)
+		{
+			SocketMap::iterator it = _socketMap.find(_events[i].data.ptr);
+			if (it != _socketMap.end())
+			{
+				int mode = 0;
+				if (_events[i].events & (EPOLLIN | EPOLLHUP)) mode |= PollSet::POLL_READ;
+				if (_events[i].events & EPOLLOUT)             mode |= PollSet::POLL_WRITE;
+				if (_events[i].events & EPOLLERR)             mode |= PollSet::POLL_ERROR;
+				result[it->second] |= mode;
+			}
+		}
+		return result;
+	}
+
+private:
+	typedef std::map<void*, Socket> SocketMap;
+
+	enum
+	{
+		MAX_EVENTS = 1024
+	};
+
+	void set(const Socket& socket, int mode, bool isNew)
+	{
+		// must be called with the mutex locked
+		SocketImpl* pImpl = socket.impl();
+		poco_socket_t fd = pImpl->sockfd();
+		if (fd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+
+		struct epoll_event ev;
+		ev.events = eventsFor(mode);
+		ev.data.ptr = pImpl;
+		int rc;
+		if (isNew)
+		{
+			rc = epoll_ctl(_epollfd, EPOLL_CTL_ADD, fd, &ev);
+			if (rc < 0 && SocketImpl::lastError() == EEXIST)
+				rc = epoll_ctl(_epollfd, EPOLL_CTL_MOD, fd, &ev);
+		}
+		else
+		{
+			rc = epoll_ctl(_epollfd, EPOLL_CTL_MOD, fd, &ev);
+			if (rc < 0 && SocketImpl::lastError() == ENOENT)
+				rc = epoll_ctl(_epollfd, EPOLL_CTL_ADD, fd, &ev);
+		}
+		if (rc < 0) SocketImpl::error("Can't insert socket to epoll queue");
+
+		if (isNew) _socketMap[pImpl] = socket;
+	}
+
+	void removeImpl(SocketImpl* pImpl)
+	{
+		// must be called with the mutex locked
+		// The descriptor may already have been closed, in which case
+		// the kernel has removed it from the epoll set already.
+		poco_socket_t fd = pImpl->sockfd();
+		if (fd != POCO_INVALID_SOCKET)
+		{
+			struct epoll_event ev;
+			ev.events = 0;
+			ev.data.ptr = 0;
+			epoll_ctl(_epollfd, EPOLL_CTL_DEL, fd, &ev);
+		}
+	}
+
+	uint32_t eventsFor(int mode) const
+	{
+		uint32_t events = 0;
+		if (mode & PollSet::POLL_READ)  events |= EPOLLIN;
+		if (mode & PollSet::POLL_WRITE) events |= EPOLLOUT;
+		if (mode & PollSet::POLL_ERROR) events |= EPOLLERR;
+		if (_trigger == PollSet::TRIGGER_EDGE) events |= EPOLLET;
+		return events;
+	}
+
+	PollSet::Trigger                _trigger;
+	int                             _epollfd;
+	SocketMap                       _socketMap;
+	std::vector<struct epoll_event> _events;
+	mutable Poco::FastMutex         _mutex;
+};
+
+
+#else
+
+
+//
+// Generic implementation using poll() or select()
+//
+class PollSetImpl
+{
+public:
+	PollSetImpl(PollSet::Trigger):
+		_dirty(true)
+	{
+	}
+
+	~PollSetImpl()
+	{
+	}
+
+	void add(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (socket.impl()->sockfd() == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		_socketMap[socket] = mode;
+		_dirty = true;
+	}
+
+	void remove(const Socket& socket)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_socketMap.erase(socket) > 0) _dirty = true;
+	}
+
+	void update(const Socket& socket, int mode)
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		PollSet::SocketModeMap::iterator it = _socketMap.find(socket);
+		if (it != _socketMap.end() && it->second != mode)
+		{
+			it->second = mode;
+			_dirty = true;
+		}
+	}
+
+	bool has(const Socket& socket) const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _socketMap.find(socket) != _socketMap.end();
+	}
+
+	std::size_t count() const
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		return _socketMap.size();
+	}
+
+	void clear()
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		_socketMap.clear();
+		_dirty = true;
+	}
+
+	PollSet::Trigger trigger() const
+	{
+		return PollSet::TRIGGER_LEVEL;
+	}
+
+#if defined(POCO_HAVE_FD_POLL)
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		PollSet::SocketModeMap result;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			if (_socketMap.empty()) return result;
+			if (_dirty)
+			{
+				_pollfds.clear();
+				_sockets.clear();
+				_pollfds.reserve(_socketMap.size());
+				_sockets.reserve(_socketMap.size());
+				for (PollSet::SocketModeMap::const_iterator it = _socketMap.begin(); it != _socketMap.end(); ++it)
+				{
+					poco_socket_t fd = it->first.impl()->sockfd();
+					if (fd == POCO_INVALID_SOCKET) continue;
+					pollfd pfd;
+					pfd.fd = fd;
+					pfd.events = 0;
+					pfd.revents = 0;
+					if (it->second & PollSet::POLL_READ)  pfd.events |= POLLIN;
+					if (it->second & PollSet::POLL_WRITE) pfd.events |= POLLOUT;
+					_pollfds.push_back(pfd);
+					_sockets.push_back(it->first);
+				}
+				_dirty = false;
+			}
+		}
+		if (_pollfds.empty()) return result;
+
+		Poco::Timespan remainingTime(timeout);
+		int rc;
+		do
+		{
+			Poco::Timestamp start;
+			rc = ::poll(&_pollfds[0], _pollfds.size(), remainingTime.totalMilliseconds());
+			if (rc < 0 && SocketImpl::lastError() == POCO_EINTR)
+			{
+				Poco::Timestamp end;
+				Poco::Timespan waited = end - start;
+				if (waited < remainingTime)
+					remainingTime -= waited;
+				else
+					remainingTime = 0;
+			}
+		}
+		while (rc < 0 && SocketImpl::lastError() == POCO_EINTR);
+		if (rc < 0) SocketImpl::error();
+
+		Poco::FastMutex::ScopedLock lock(_mutex);
+		for (std::size_t i = 0; i < _pollfds.size() && rc > 0; i++)
+		{
+			short revents = _pollfds[i].revents;
+			if (revents == 0) continue;
+			--rc;
+			if (_socketMap.find(_sockets[i]) == _socketMap.end()) continue;
+			int mode = 0;
+			if (revents & (POLLIN | POLLHUP)) mode |= PollSet::POLL_READ;
+			if (revents & POLLOUT)            mode |= PollSet::POLL_WRITE;
+			if (revents & POLLERR)            mode |= PollSet::POLL_ERROR;
+			result[_sockets[i]] |= mode;
+		}
+		return result;
+	}
+
+#else
+
+	PollSet::SocketModeMap poll(const Poco::Timespan& timeout)
+	{
+		PollSet::SocketModeMap result;
+		Socket::SocketList readList;
+		Socket::SocketList writeList;
+		Socket::SocketList exceptList;
+		{
+			Poco::FastMutex::ScopedLock lock(_mutex);
+			for (PollSet::SocketModeMap::const_iterator it = _socketMap.begin(); it != _socketMap.end(); ++it)
+			{
+				if (it->second & PollSet::POLL_READ)  readList.push_back(it->first);
+				if (it->second & PollSet::POLL_WRITE) writeList.push_back(it->first);
+				if (it->second & PollSet::POLL_ERROR) exceptList.push_back(it->first);
+			}
+		}
+		if (Socket::select(readList, writeList, exceptList, timeout) > 0)
+		{
+			for (Socket::SocketList::iterator it = readList.begin(); it != readList.end(); ++it)
+				result[*it] |= PollSet::POLL_READ;
+			for (Socket::SocketList::iterator it = writeList.begin(); it != writeList.end(); ++it)
+				result[*it] |= PollSet::POLL_WRITE;
+			for (Socket::SocketList::iterator it = exceptList.begin(); it != exceptList.end(); ++it)
+				result[*it] |= PollSet::POLL_ERROR;
+		}
+		return result;
+	}
+
+#endif // POCO_HAVE_FD_POLL
+
+private:
+	PollSet::SocketModeMap  _socketMap;
+	bool                    _dirty;
+#if defined(POCO_HAVE_FD_POLL)
+	std::vector<pollfd>     _pollfds;
+	std::vector<Socket>     _sockets;
+#endif
+	mutable Poco::FastMutex _mutex;
+};
+
+
+#endif // POCO_HAVE_FD_EPOLL
+
+
+PollSet::PollSet():
+	_pImpl(new PollSetImpl(TRIGGER_LEVEL))
+{
+}
+
+
+PollSet::PollSet(Trigger trigger):
+	_pImpl(new PollSetImpl(trigger))
+{
+}
+
+
+PollSet::~PollSet()
+{
+	delete _pImpl;
+}
+
+
+void PollSet::add(const Socket& socket, int mode)
+{
+	_pImpl->add(socket, mode);
+}
+
+
+void PollSet::remove(const Socket& socket)
+{
+	_pImpl->remove(socket);
+}
+
+
+void PollSet::update(const Socket& socket, int mode)
+{
+	_pImpl->update(socket, mode);
+}
+
+
+bool PollSet::has(const Socket& socket) const
+{
+	return _pImpl->has(socket);
+}
+
+
+bool PollSet::empty() const
+{
+	return _pImpl->count() == 0;
+}
+
+
+std::size_t PollSet::count() const
+{
+	return _pImpl->count();
+}
+
+
+void PollSet::clear()
+{
+	_pImpl->clear();
+}
+
+
+PollSet::Trigger PollSet::trigger() const
+{
+	return _pImpl->trigger();
+}
+
+
+PollSet::SocketModeMap PollSet::poll(const Poco::Timespan& timeout)
+{
+	return _pImpl->poll(timeout);
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,458 @@
+//
+// ServerStatistics.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: TCPServer
+// Module:  ServerStatistics
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/ServerStatistics.h"
+#include "Poco/NumberFormatter.h"
+
+
+using Poco::NumberFormatter;
+
+
+namespace Poco {
+namespace Net {
+
+
+//
+// ServerStatistics::Counter
+//
+
+
+ServerStatistics::Counter::Counter():
+	_value(0)
+{
+}
+
+
+ServerStatistics::Counter::~Counter()
+{
+}
+
+
+#if defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS)
+
+
+void ServerStatistics::Counter::add(Poco::UInt64 n)
+{
+	_value.fetch_add(n, std::memory_order_relaxed);
+}
+
+
+Poco::UInt64 ServerStatistics::Counter::value() const
+{
+	return _value.load(std::memory_order_relaxed);
+}
+
+
+void ServerStatistics::Counter::reset()
+{
+	_value.store(0, std::memory_order_relaxed);
+}
+
+
+#else
+
+
+void ServerStatistics::Counter::add(Poco::UInt64 n)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_value += n;
+}
+
+
+Poco::UInt64 ServerStatistics::Counter::value() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _value;
+}
+
+
+void ServerStatistics::Counter::reset()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	_value = 0;
+}
+
+
+#endif // POCO_HAVE_LOCKFREE_SERVERSTATISTICS
+
+
+//
+// ServerStatistics::Histogram
+//
+
+
+const Poco::UInt64 ServerStatistics::Histogram::MAX_VALUE = (static_cast<Poco::UInt64>(1) << MAX_VALUE_BITS) - 1;
+
+
+ServerStatistics::Histogram::Histogram()
+{
+	reset();
+}
+
+
+ServerStatistics::Histogram::~Histogram()
+{
+}
+
+
+int ServerStatistics::Histogram::bucketIndex(Poco::UInt64 value)
+{
+	if (value > MAX_VALUE) value = MAX_VALUE;
+	if (value < SUB_BUCKET_COUNT) return static_cast<int>(value);
+
+	int msb = 0;
+	while ((value >> msb) > 1) ++msb;
+	int shift = msb - SUB_BUCKET_BITS;
+	return (shift + 1)*SUB_BUCKET_COUNT + static_cast<int>((value >> shift) & (SUB_BUCKET_COUNT - 1));
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::bucketLowerBound(int index)
+{
+	poco_assert (index >= 0 && index < BUCKET_COUNT);
+
+	if (index < SUB_BUCKET_COUNT) return index;
+	int shift = index/SUB_BUCKET_COUNT - 1;
+	return static_cast<Poco::UInt64>(SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << shift;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::bucketUpperBound(int index)
+{
+	poco_assert (index >= 0 && index < BUCKET_COUNT);
+
+	if (index < SUB_BUCKET_COUNT) return index;
+	int shift = index/SUB_BUCKET_COUNT - 1;
+	return bucketLowerBound(index) + (static_cast<Poco::UInt64>(1) << shift) - 1;
+}
+
+
+double ServerStatistics::Histogram::mean() const
+{
+	Poco::UInt64 n = count();
+	return n > 0 ? static_cast<double>(sum())/n : 0.0;
+}
+
+
+#if defined(POCO_HAVE_LOCKFREE_SERVERSTATISTICS)
+
+
+void ServerStatistics::Histogram::record(Poco::UInt64 value)
+{
+	if (value > MAX_VALUE) value = MAX_VALUE;
+
+	_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+	_sum.fetch_add(value, std::memory_order_relaxed);
+	Poco::UInt64 min = _min.load(std::memory_order_relaxed);
+	while (value < min && !_min.compare_exchange_weak(min, value, std::memory_order_relaxed))
+	{
+	}
+	Poco::UInt64 max = _max.load(std::memory_order_relaxed);
+	while (value > max && !_max.compare_exchange_weak(max, value, std::memory_order_relaxed))
+	{
+	}
+	_count.fetch_add(1, std::memory_order_release);
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::count() const
+{
+	return _count.load(std::memory_order_acquire);
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::sum() const
+{
+	return _sum.load(std::memory_order_relaxed);
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::minimum() const
+{
+	return count() > 0 ? _min.load(std::memory_order_relaxed) : 0;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::maximum() const
+{
+	return _max.load(std::memory_order_relaxed);
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::percentile(double percent) const
+{
+	// The buckets may be updated concurrently, so the
+	// total is taken from the buckets themselves.
+	Poco::UInt64 counts[BUCKET_COUNT];
+	Poco::UInt64 total = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		counts[i] = _buckets[i].load(std::memory_order_relaxed);
+		total += counts[i];
+	}
+	if (total == 0) return 0;
+
+	if (percent < 0) percent = 0;
+	else if (percent > 100) percent = 100;
+	Poco::UInt64 rank = static_cast<Poco::UInt64>(percent*total/100 + 0.5);
+	if (rank == 0) rank = 1;
+	Poco::UInt64 max = maximum();
+	Poco::UInt64 n = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		n += counts[i];
+		if (n >= rank)
+		{
+			Poco::UInt64 upper = bucketUpperBound(i);
+			return upper < max ? upper : max;
+		}
+	}
+	return max;
+}
+
+
+void ServerStatistics::Histogram::reset()
+{
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		_buckets[i].store(0, std::memory_order_relaxed);
+	}
+	_sum.store(0, std::memory_order_relaxed);
+	_min.store(MAX_VALUE, std::memory_order_relaxed);
+	_max.store(0, std::memory_order_relaxed);
+	_count.store(0, std::memory_order_release);
+}
+
+
+#else
+
+
+void ServerStatistics::Histogram::record(Poco::UInt64 value)
+{
+	if (value > MAX_VALUE) value = MAX_VALUE;
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	++_buckets[bucketIndex(value)];
+	_sum += value;
+	if (value < _min) _min = value;
+	if (value > _max) _max = value;
+	++_count;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::count() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _count;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::sum() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _sum;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::minimum() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _count > 0 ? _min : 0;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::maximum() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	return _max;
+}
+
+
+Poco::UInt64 ServerStatistics::Histogram::percentile(double percent) const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	if (_count == 0) return 0;
+
+	if (percent < 0) percent = 0;
+	else if (percent > 100) percent = 100;
+	Poco::UInt64 rank = static_cast<Poco::UInt64>(percent*_count/100 + 0.5);
+	if (rank == 0) rank = 1;
+	Poco::UInt64 n = 0;
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		n += _buckets[i];
+		if (n >= rank)
+		{
+			Poco::UInt64 upper = bucketUpperBound(i);
+			return upper < _max ? upper : _max;
+		}
+	}
+	return _max;
+}
+
+
+void ServerStatistics::Histogram::reset()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+	for (int i = 0; i < BUCKET_COUNT; ++i)
+	{
+		_buckets[i] = 0;
+	}
+	_count = 0;
+	_sum = 0;
+	_min = MAX_VALUE;
+	_max = 0;
+}
+
+
+#endif // POCO_HAVE_LOCKFREE_SERVERSTATISTICS
+
+
+//
+// ServerStatistics
+//
+
+
+namespace
+{
+	struct MetricInfo
+	{
+		const char* jsonName;
+		const char* metricName;
+		const char* help;
+	};
+
+	const MetricInfo COUNTERS[] =
+	{
+		{"connections", "connections_total", "Number of connections served."},
+		{"requests", "http_requests_total", "Number of HTTP requests."},
+		{"keepAliveRequests", "http_keepalive_requests_total", "Number of HTTP requests received over a reused persistent connection."},
+		{"badRequests", "http_bad_requests_total", "Number of malformed HTTP requests."},
+		{"bytesReceived", "received_bytes_total", "Number of bytes received over HTTP connections."},
+		{"bytesSent", "sent_bytes_total", "Number of bytes sent over HTTP connections."}
+	};
+
+	const MetricInfo HISTOGRAMS[] =
+	{
+		{"queueWaitTime", "queue_wait_seconds", "Time accepted connections spent in the connection queue."},
+		{"connectionTime", "connection_seconds", "Time connections have been served."},
+		{"requestParseTime", "http_request_parse_seconds", "Time spent receiving and parsing HTTP request headers."},
+		{"requestHandleTime", "http_request_handle_seconds", "Time spent in HTTP request handlers."},
+		{"responseWriteTime", "http_response_write_seconds", "Time spent completing HTTP responses after the request handler returned."}
+	};
+
+	const double QUANTILES[] = {0.5, 0.9, 0.99, 0.999};
+
+	const char* const QUANTILE_NAMES[] = {"p50", "p90", "p99", "p999"};
+
+	const int QUANTILE_COUNT = sizeof(QUANTILES)/sizeof(QUANTILES[0]);
+
+	std::string seconds(Poco::UInt64 microseconds)
+	{
+		return NumberFormatter::format(microseconds/1000000.0, 6);
+	}
+}
+
+
+ServerStatistics::ServerStatistics()
+{
+}
+
+
+ServerStatistics::~ServerStatistics()
+{
+}
+
+
+void ServerStatistics::reset()
+{
+	_connections.reset();
+	_requests.reset();
+	_keepAliveRequests.reset();
+	_badRequests.reset();
+	_bytesReceived.reset();
+	_bytesSent.reset();
+	_queueWaitTime.reset();
+	_connectionTime.reset();
+	_requestParseTime.reset();
+	_requestHandleTime.reset();
+	_responseWriteTime.reset();
+}
+
+
+void ServerStatistics::writeJSON(std::ostream& ostr) const
+{
+	const Counter* counters[] = {&_connections, &_requests, &_keepAliveRequests, &_badRequests, &_bytesReceived, &_bytesSent};
+	const Histogram* histograms[] = {&_queueWaitTime, &_connectionTime, &_requestParseTime, &_requestHandleTime, &_responseWriteTime};
+
+	ostr << '{';
+	for (std::size_t i = 0; i < sizeof(counters)/sizeof(counters[0]); ++i)
+	{
+		ostr << '"' << COUNTERS[i].jsonName << "\":" << counters[i]->value() << ',';
+	}
+	for (std::size_t i = 0; i < sizeof(histograms)/sizeof(histograms[0]); ++i)
+	{
+		const Histogram& h = *histograms[i];
+		if (i > 0) ostr << ',';
+		ostr << '"' << HISTOGRAMS[i].jsonName << "\":{"
+		     << "\"count\":" << h.count()
+		     << ",\"sum\":" << h.sum()
+		     << ",\"min\":" << h.minimum()
+		     << ",\"max\":" << h.maximum()
+		     << ",\"mean\":" << NumberFormatter::format(h.mean(), 1);
+		for (int q = 0; q < QUANTILE_COUNT; ++q)
+		{
+			ostr << ",\"" << QUANTILE_NAMES[q] << "\":" << h.percentile(QUANTILES[q]*100);
+		}
+		ostr << '}';
+	}
+	ostr << '}';
+}
+
+
+void ServerStatistics::writePrometheus(std::ostream& ostr, const std::string& prefix) const
+{
+	const Counter* counters[] = {&_connections, &_requests, &_keepAliveRequests, &_badRequests, &_bytesReceived, &_bytesSent};
+	const Histogram* histograms[] = {&_queueWaitTime, &_connectionTime, &_requestParseTime, &_requestHandleTime, &_responseWriteTime};
+
+	for (std::size_t i = 0; i < sizeof(counters)/sizeof(counters[0]); ++i)
+	{
+		std::string name(prefix);
+		name += '_';
+		name += COUNTERS[i].metricName;
+		ostr << "# HELP " << name << ' ' << COUNTERS[i].help << '\n'
+		     << "# TYPE " << name << " counter\n"
+		     << name << ' ' << counters[i]->value() << '\n';
+	}
+	for (std::size_t i = 0; i < sizeof(histograms)/sizeof(histograms[0]); ++i)
+	{
+		const Histogram& h = *histograms[i];
+		std::string name(prefix);
+		name += '_';
+		name += HISTOGRAMS[i].metricName;
+		ostr << "# HELP " << name << ' ' << HISTOGRAMS[i].help << '\n'
+		     << "# TYPE " << name << " summary\n";
+		for (int q = 0; q < QUANTILE_COUNT; ++q)
+		{
+			ostr << name << "{quantile=\"" << QUANTILES[q] << "\"} " << seconds(h.percentile(QUANTILES[q]*100)) << '\n';
+		}
+		ostr << name << "_sum " << seconds(h.sum()) << '\n'
+		     << name << "_count " << h.count() << '\n';
+	}
+}
+
+
+} } // namespace Poco::Net
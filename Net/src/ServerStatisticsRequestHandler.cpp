@@ -0,0 +1,67 @@
+//
+// ServerStatisticsRequestHandler.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: HTTPServer
+// Module:  ServerStatisticsRequestHandler
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/ServerStatisticsRequestHandler.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/URI.h"
+#include <sstream>
+
+
+namespace Poco {
+namespace Net {
+
+
+ServerStatisticsRequestHandler::ServerStatisticsRequestHandler(ServerStatistics::Ptr pStatistics, const std::string& prefix):
+	_pStatistics(pStatistics),
+	_prefix(prefix)
+{
+	poco_check_ptr (pStatistics);
+}
+
+
+ServerStatisticsRequestHandler::~ServerStatisticsRequestHandler()
+{
+}
+
+
+void ServerStatisticsRequestHandler::handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+{
+	bool json = request.get("Accept", "").find("application/json") != std::string::npos;
+	Poco::URI::QueryParameters params = Poco::URI(request.getURI()).getQueryParameters();
+	for (Poco::URI::QueryParameters::const_iterator it = params.begin(); it != params.end(); ++it)
+	{
+		if (it->first == "format") json = it->second == "json";
+	}
+
+	std::ostringstream ostr;
+	if (json)
+	{
+		_pStatistics->writeJSON(ostr);
+		response.setContentType("application/json");
+	}
+	else
+	{
+		_pStatistics->writePrometheus(ostr, _prefix);
+		response.setContentType("text/plain; version=0.0.4");
+	}
+	response.set("Cache-Control", "no-cache");
+	std::string body = ostr.str();
+	response.sendBuffer(body.data(), body.size());
+}
+
+
+} } // namespace Poco::Net
@@ -0,0 +1,1261 @@
+//
+// SocketCompletionReactor.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketCompletionReactor
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SocketCompletionReactor.h"
+#include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/PollSet.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/ErrorHandler.h"
+#include "Poco/Exception.h"
+#include "Poco/Thread.h"
+#include <vector>
+#include <deque>
+#include <map>
+#if defined(POCO_HAVE_IO_URING)
+#include "Poco/Error.h"
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+
+using Poco::ErrorHandler;
+
+
+namespace Poco {
+namespace Net {
+
+
+class SocketCompletionReactorImpl
+	/// The base class for the implementations of SocketCompletionReactor.
+	/// Keeps track of the sockets and their send queues, and dispatches
+	/// completions to the handlers.
+{
+public:
+	typedef SocketCompletionReactor::Handler Handler;
+
+	SocketCompletionReactorImpl(int maxSockets);
+	virtual ~SocketCompletionReactorImpl();
+
+	virtual void addAcceptor(const ServerSocket& socket, Handler& handler) = 0;
+	virtual void addSocket(const StreamSocket& socket, Handler& handler) = 0;
+	virtual void removeSocket(const Socket& socket) = 0;
+	virtual void send(const StreamSocket& socket, const void* buffer, std::size_t length) = 0;
+	virtual void poll(const Poco::Timespan& timeout) = 0;
+	virtual bool usesIOUring() const = 0;
+
+	bool hasSocket(const Socket& socket) const;
+	std::size_t pendingOutput(const StreamSocket& socket) const;
+
+protected:
+	typedef std::vector<char> Buffer;
+
+	struct Slot
+	{
+		Slot();
+
+		Socket socket;
+		Handler* pHandler;
+		bool acceptor;
+		bool active;
+		Poco::UInt32 generation;
+		int pending;
+		bool receiving;
+		bool sending;
+		std::deque<Buffer> queue;
+		std::size_t offset;
+		std::size_t queued;
+	};
+
+	int find(const Socket& socket) const;
+		/// Returns the index of the slot for the given socket,
+		/// or -1 if the socket has not been added.
+
+	int allocate(const Socket& socket, Handler& handler, bool acceptor);
+		/// Allocates a slot for the given socket and returns its index.
+
+	void release(int index);
+		/// Releases the slot with the given index, which must
+		/// have been detached from its socket, and discards its
+		/// send queue.
+
+	void detach(int index);
+		/// Removes the slot's socket from the index. The slot
+		/// is no longer active, but its send queue is kept until
+		/// the slot is released, as pending operations may still
+		/// refer to it.
+
+	Slot& slot(int index);
+
+	int slotCount() const;
+		/// Returns the number of slots allocated so far.
+
+	void enqueue(Slot& slot, const void* buffer, std::size_t length);
+	std::size_t consume(Slot& slot, std::size_t length);
+		/// Removes length sent bytes from the slot's send queue
+		/// and returns the number of bytes still queued.
+
+	void fail(int index, int errorCode);
+		/// Removes the socket and notifies the handler about the error.
+
+	void shutdown(int index);
+		/// Removes the socket and notifies the handler that
+		/// the peer has shut down the connection.
+
+	static void notifyAccept(Handler& handler, const Socket& serverSocket, const StreamSocket& socket);
+	static void notifyReceive(Handler& handler, const Socket& socket, const char* buffer, std::size_t length);
+	static void notifySent(Handler& handler, const Socket& socket, std::size_t length);
+	static void notifyError(Handler& handler, const Socket& socket, int errorCode);
+	static void handleException();
+
+	int _maxSockets;
+
+private:
+	typedef std::map<poco_socket_t, int> IndexMap;
+
+	std::vector<Slot*> _slots;
+	std::vector<int> _free;
+	IndexMap _index;
+};
+
+
+namespace
+{
+#if defined(MSG_NOSIGNAL)
+	const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+	const int SEND_FLAGS = 0;
+#endif
+}
+
+
+//
+// SocketCompletionReactorImpl
+//
+
+
+SocketCompletionReactorImpl::Slot::Slot():
+	pHandler(0),
+	acceptor(false),
+	active(false),
+	generation(0),
+	pending(0),
+	receiving(false),
+	sending(false),
+	offset(0),
+	queued(0)
+{
+}
+
+
+SocketCompletionReactorImpl::SocketCompletionReactorImpl(int maxSockets):
+	_maxSockets(maxSockets)
+{
+	poco_assert (maxSockets > 0);
+}
+
+
+SocketCompletionReactorImpl::~SocketCompletionReactorImpl()
+{
+	for (std::vector<Slot*>::iterator it = _slots.begin(); it != _slots.end(); ++it)
+	{
+		delete *it;
+	}
+}
+
+
+bool SocketCompletionReactorImpl::hasSocket(const Socket& socket) const
+{
+	return find(socket) >= 0;
+}
+
+
+std::size_t SocketCompletionReactorImpl::pendingOutput(const StreamSocket& socket) const
+{
+	int index = find(socket);
+	return index >= 0 ? _slots[index]->queued : 0;
+}
+
+
+int SocketCompletionReactorImpl::find(const Socket& socket) const
+{
+	IndexMap::const_iterator it = _index.find(socket.impl()->sockfd());
+	if (it != _index.end() && _slots[it->second]->socket == socket)
+		return it->second;
+	else
+		return -1;
+}
+
+
+int SocketCompletionReactorImpl::allocate(const Socket& socket, Handler& handler, bool acceptor)
+{
+	poco_socket_t sockfd = socket.impl()->sockfd();
+	if (sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+	if (_index.find(sockfd) != _index.end()) throw Poco::ExistsException("Socket has already been added to SocketCompletionReactor");
+
+	int index;
+	if (!_free.empty())
+	{
+		index = _free.back();
+		_free.pop_back();
+	}
+	else if (static_cast<int>(_slots.size()) < _maxSockets)
+	{
+		index = static_cast<int>(_slots.size());
+		_slots.push_back(new Slot);
+	}
+	else throw Poco::IllegalStateException("Maximum number of sockets in SocketCompletionReactor reached");
+
+	Slot& s = *_slots[index];
+	s.socket    = socket;
+	s.pHandler  = &handler;
+	s.acceptor  = acceptor;
+	s.active    = true;
+	s.receiving = false;
+	s.sending   = false;
+	_index[sockfd] = index;
+	return index;
+}
+
+
+void SocketCompletionReactorImpl::release(int index)
+{
+	Slot& s = *_slots[index];
+	poco_assert_dbg (!s.active && s.pending == 0);
+
+	s.socket   = Socket();
+	s.pHandler = 0;
+	s.queue.clear();
+	s.offset   = 0;
+	s.queued   = 0;
+	++s.generation;
+	_free.push_back(index);
+}
+
+
+void SocketCompletionReactorImpl::detach(int index)
+{
+	Slot& s = *_slots[index];
+	_index.erase(s.socket.impl()->sockfd());
+	s.active = false;
+}
+
+
+SocketCompletionReactorImpl::Slot& SocketCompletionReactorImpl::slot(int index)
+{
+	return *_slots[index];
+}
+
+
+int SocketCompletionReactorImpl::slotCount() const
+{
+	return static_cast<int>(_slots.size());
+}
+
+
+void SocketCompletionReactorImpl::enqueue(Slot& slot, const void* buffer, std::size_t length)
+{
+	const char* p = reinterpret_cast<const char*>(buffer);
+	slot.queue.push_back(Buffer(p, p + length));
+	slot.queued += length;
+}
+
+
+std::size_t SocketCompletionReactorImpl::consume(Slot& slot, std::size_t length)
+{
+	slot.offset += length;
+	slot.queued -= length;
+	while (!slot.queue.empty() && slot.offset >= slot.queue.front().size())
+	{
+		slot.offset -= slot.queue.front().size();
+		slot.queue.pop_front();
+	}
+	return slot.queued;
+}
+
+
+void SocketCompletionReactorImpl::fail(int index, int errorCode)
+{
+	Slot& s = *_slots[index];
+	Socket socket = s.socket;
+	Handler& handler = *s.pHandler;
+	removeSocket(socket);
+	notifyError(handler, socket, errorCode);
+}
+
+
+void SocketCompletionReactorImpl::shutdown(int index)
+{
+	Slot& s = *_slots[index];
+	Socket socket = s.socket;
+	Handler& handler = *s.pHandler;
+	removeSocket(socket);
+	notifyReceive(handler, socket, 0, 0);
+}
+
+
+void SocketCompletionReactorImpl::notifyAccept(Handler& handler, const Socket& serverSocket, const StreamSocket& socket)
+{
+	try
+	{
+		ServerSocket ss(serverSocket);
+		StreamSocket s(socket);
+		handler.onAccept(ss, s);
+	}
+	catch (...)
+	{
+		handleException();
+	}
+}
+
+
+void SocketCompletionReactorImpl::notifyReceive(Handler& handler, const Socket& socket, const char* buffer, std::size_t length)
+{
+	try
+	{
+		StreamSocket s(socket);
+		handler.onReceive(s, buffer, length);
+	}
+	catch (...)
+	{
+		handleException();
+	}
+}
+
+
+void SocketCompletionReactorImpl::notifySent(Handler& handler, const Socket& socket, std::size_t length)
+{
+	try
+	{
+		StreamSocket s(socket);
+		handler.onSent(s, length);
+	}
+	catch (...)
+	{
+		handleException();
+	}
+}
+
+
+void SocketCompletionReactorImpl::notifyError(Handler& handler, const Socket& socket, int errorCode)
+{
+	try
+	{
+		Socket s(socket);
+		handler.onError(s, errorCode);
+	}
+	catch (...)
+	{
+		handleException();
+	}
+}
+
+
+void SocketCompletionReactorImpl::handleException()
+{
+	try
+	{
+		throw;
+	}
+	catch (Poco::Exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (std::exception& exc)
+	{
+		ErrorHandler::handle(exc);
+	}
+	catch (...)
+	{
+		ErrorHandler::handle();
+	}
+}
+
+
+namespace
+{
+	class PollSetCompletionImpl: public SocketCompletionReactorImpl
+		/// The portable implementation of SocketCompletionReactor,
+		/// based on a PollSet. Performs the operations when the
+		/// non-blocking sockets become ready.
+	{
+	public:
+		enum
+		{
+			MAX_ACCEPT = 16
+				/// The maximum number of connections accepted
+				/// per readiness notification.
+		};
+
+		PollSetCompletionImpl(int maxSockets, int bufferSize):
+			SocketCompletionReactorImpl(maxSockets),
+			_buffer(bufferSize)
+		{
+		}
+
+		void addAcceptor(const ServerSocket& socket, Handler& handler)
+		{
+			add(socket, handler, true);
+		}
+
+		void addSocket(const StreamSocket& socket, Handler& handler)
+		{
+			add(socket, handler, false);
+		}
+
+		void removeSocket(const Socket& socket)
+		{
+			int index = find(socket);
+			if (index < 0) return;
+
+			_pollSet.remove(socket);
+			detach(index);
+			release(index);
+		}
+
+		void send(const StreamSocket& socket, const void* buffer, std::size_t length)
+		{
+			int index = find(socket);
+			if (index < 0) throw Poco::NotFoundException("Socket has not been added to SocketCompletionReactor");
+			if (length == 0) return;
+
+			Slot& s = slot(index);
+			enqueue(s, buffer, length);
+			if (!s.sending)
+			{
+				s.sending = true;
+				_pollSet.update(socket, PollSet::POLL_READ | PollSet::POLL_WRITE);
+			}
+		}
+
+		void poll(const Poco::Timespan& timeout)
+		{
+			if (_pollSet.empty())
+			{
+				Poco::Thread::sleep(timeout.totalMilliseconds());
+				return;
+			}
+
+			PollSet::SocketModeMap sm = _pollSet.poll(timeout);
+			for (PollSet::SocketModeMap::iterator it = sm.begin(); it != sm.end(); ++it)
+			{
+				int index = find(it->first);
+				if (index >= 0 && (it->second & PollSet::POLL_WRITE))
+				{
+					writable(index);
+					index = find(it->first);
+				}
+				if (index >= 0 && (it->second & (PollSet::POLL_READ | PollSet::POLL_ERROR)))
+				{
+					if (slot(index).acceptor)
+						accept(index);
+					else
+						readable(index);
+				}
+			}
+		}
+
+		bool usesIOUring() const
+		{
+			return false;
+		}
+
+	private:
+		void add(const Socket& socket, Handler& handler, bool acceptor)
+		{
+			int index = allocate(socket, handler, acceptor);
+			try
+			{
+				Socket(socket).setBlocking(false);
+				_pollSet.add(socket, PollSet::POLL_READ);
+			}
+			catch (...)
+			{
+				detach(index);
+				release(index);
+				throw;
+			}
+		}
+
+		void accept(int index)
+		{
+			Slot& s = slot(index);
+			Socket socket = s.socket;
+			Handler& handler = *s.pHandler;
+			ServerSocket serverSocket(socket);
+			for (int i = 0; i < MAX_ACCEPT; ++i)
+			{
+				StreamSocket ss;
+				try
+				{
+					ss = serverSocket.acceptConnection();
+				}
+				catch (Poco::Exception& exc)
+				{
+					int err = exc.code();
+					if (err == POCO_EWOULDBLOCK || err == POCO_EAGAIN) return;
+					if (err == POCO_EINTR || err == POCO_ECONNABORTED) continue;
+					fail(index, err);
+					return;
+				}
+				notifyAccept(handler, socket, ss);
+				if (find(socket) != index) return;
+			}
+		}
+
+		void readable(int index)
+		{
+			Slot& s = slot(index);
+			Socket socket = s.socket;
+			int n;
+			try
+			{
+				n = socket.impl()->receiveBytes(&_buffer[0], static_cast<int>(_buffer.size()));
+			}
+			catch (Poco::Exception& exc)
+			{
+				fail(index, exc.code());
+				return;
+			}
+			if (n > 0)
+				notifyReceive(*s.pHandler, socket, &_buffer[0], n);
+			else if (n == 0)
+				shutdown(index);
+		}
+
+		void writable(int index)
+		{
+			Slot& s = slot(index);
+			Socket socket = s.socket;
+			std::size_t sent = 0;
+			while (!s.queue.empty())
+			{
+				const Buffer& buffer = s.queue.front();
+				int n;
+				try
+				{
+					n = socket.impl()->sendBytes(&buffer[s.offset], static_cast<int>(buffer.size() - s.offset), SEND_FLAGS);
+				}
+				catch (Poco::Exception& exc)
+				{
+					int err = exc.code();
+					if (err == POCO_EWOULDBLOCK || err == POCO_EAGAIN) break;
+					fail(index, err);
+					return;
+				}
+				consume(s, n);
+				sent += n;
+			}
+			if (s.queue.empty())
+			{
+				s.sending = false;
+				_pollSet.update(socket, PollSet::POLL_READ);
+			}
+			if (sent > 0) notifySent(*s.pHandler, socket, sent);
+		}
+
+		PollSet _pollSet;
+		Buffer _buffer;
+	};
+
+
+#if defined(POCO_HAVE_IO_URING)
+
+
+	int ioUringSetup(unsigned entries, io_uring_params& params)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+	}
+
+
+	int ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags, void* pArg, std::size_t argSize)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, pArg, argSize));
+	}
+
+
+	int ioUringRegister(int fd, unsigned opcode, const void* pArg, unsigned nrArgs)
+	{
+		return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, pArg, nrArgs));
+	}
+
+
+	class IOUringCompletionImpl: public SocketCompletionReactorImpl
+		/// The io_uring based implementation of SocketCompletionReactor.
+		///
+		/// Sockets are registered in a sparse fixed file table, using the
+		/// slot index as file index. Every slot has its own receive buffer,
+		/// and all receive buffers are registered with the kernel if possible.
+		/// Submission queue entries are collected while completions are
+		/// dispatched and submitted with the next io_uring_enter() call,
+		/// which also waits for the next completions.
+		///
+		/// The user data of every operation contains the slot index, the
+		/// slot's generation and the operation. A slot (including its send
+		/// queue, which pending send operations refer to) is only released
+		/// and reused after all its operations have completed. Before the
+		/// rings are unmapped and the receive buffers are freed, all pending
+		/// operations are cancelled and their completions are awaited.
+	{
+	public:
+		enum Operation
+		{
+			OP_ACCEPT = 1,
+			OP_RECEIVE,
+			OP_SEND,
+			OP_CANCEL
+		};
+
+		enum
+		{
+			MIN_ENTRIES = 64,
+			MAX_ENTRIES = 4096,
+			MAX_REGISTERED_BUFFERS = 16384
+		};
+
+		IOUringCompletionImpl(int maxSockets, int bufferSize):
+			SocketCompletionReactorImpl(maxSockets),
+			_fd(-1),
+			_pSQRing(MAP_FAILED),
+			_sqRingSize(0),
+			_pCQRing(MAP_FAILED),
+			_cqRingSize(0),
+			_pSQEs(static_cast<io_uring_sqe*>(MAP_FAILED)),
+			_sqesSize(0),
+			_sqeTail(0),
+			_buffers(static_cast<std::size_t>(maxSockets)*bufferSize),
+			_bufferSize(bufferSize),
+			_fixedBuffers(false)
+		{
+			try
+			{
+				setup();
+			}
+			catch (...)
+			{
+				close();
+				throw;
+			}
+		}
+
+		~IOUringCompletionImpl()
+		{
+			close();
+		}
+
+		void addAcceptor(const ServerSocket& socket, Handler& handler)
+		{
+			int index = add(socket, handler, true);
+			startAccept(index);
+		}
+
+		void addSocket(const StreamSocket& socket, Handler& handler)
+		{
+			int index = add(socket, handler, false);
+			startReceive(index);
+		}
+
+		void removeSocket(const Socket& socket)
+		{
+			int index = find(socket);
+			if (index < 0) return;
+
+			Slot& s = slot(index);
+			detach(index);
+			updateFile(index, -1);
+			if (s.receiving) cancel(index, s.acceptor ? OP_ACCEPT : OP_RECEIVE);
+			if (s.sending) cancel(index, OP_SEND);
+			if (s.pending == 0) release(index);
+		}
+
+		void send(const StreamSocket& socket, const void* buffer, std::size_t length)
+		{
+			int index = find(socket);
+			if (index < 0) throw Poco::NotFoundException("Socket has not been added to SocketCompletionReactor");
+			if (length == 0) return;
+
+			Slot& s = slot(index);
+			enqueue(s, buffer, length);
+			if (!s.sending) startSend(index);
+		}
+
+		void poll(const Poco::Timespan& timeout)
+		{
+			unsigned head = *_pCQHead;
+			unsigned tail = __atomic_load_n(_pCQTail, __ATOMIC_ACQUIRE);
+			enter(head == tail ? 1 : 0, timeout);
+
+			tail = __atomic_load_n(_pCQTail, __ATOMIC_ACQUIRE);
+			while (head != tail)
+			{
+				io_uring_cqe cqe = _pCQEs[head & _cqMask];
+				++head;
+				__atomic_store_n(_pCQHead, head, __ATOMIC_RELEASE);
+				complete(cqe);
+			}
+		}
+
+		bool usesIOUring() const
+		{
+			return true;
+		}
+
+		static bool isAvailable()
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			int fd = ioUringSetup(1, params);
+			if (fd < 0) return false;
+			::close(fd);
+			return (params.features & IORING_FEAT_EXT_ARG) != 0;
+		}
+
+	private:
+		void setup()
+		{
+			unsigned entries = 2*_maxSockets;
+			if (entries < MIN_ENTRIES) entries = MIN_ENTRIES;
+			else if (entries > MAX_ENTRIES) entries = MAX_ENTRIES;
+
+			io_uring_params params;
+			std::memset(&params, 0, sizeof(params));
+			_fd = ioUringSetup(entries, params);
+			if (_fd < 0) throw Poco::IOException("Cannot set up io_uring", Poco::Error::getMessage(errno), errno);
+			if (!(params.features & IORING_FEAT_EXT_ARG)) throw Poco::NotImplementedException("io_uring does not support IORING_FEAT_EXT_ARG");
+
+			_sqRingSize = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+			_cqRingSize = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+			bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMap)
+			{
+				if (_cqRingSize > _sqRingSize) _sqRingSize = _cqRingSize;
+				_cqRingSize = 0;
+			}
+			_pSQRing = mmap(0, _sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQ_RING);
+			if (_pSQRing == MAP_FAILED) throw Poco::IOException("Cannot map io_uring submission queue", Poco::Error::getMessage(errno), errno);
+			if (!singleMap)
+			{
+				_pCQRing = mmap(0, _cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_CQ_RING);
+				if (_pCQRing == MAP_FAILED) throw Poco::IOException("Cannot map io_uring completion queue", Poco::Error::getMessage(errno), errno);
+			}
+			_sqesSize = params.sq_entries*sizeof(io_uring_sqe);
+			_pSQEs = static_cast<io_uring_sqe*>(mmap(0, _sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _fd, IORING_OFF_SQES));
+			if (_pSQEs == MAP_FAILED) throw Poco::IOException("Cannot map io_uring submission queue entries", Poco::Error::getMessage(errno), errno);
+
+			char* pSQ = static_cast<char*>(_pSQRing);
+			char* pCQ = singleMap ? pSQ : static_cast<char*>(_pCQRing);
+			_pSQHead   = reinterpret_cast<unsigned*>(pSQ + params.sq_off.head);
+			_pSQTail   = reinterpret_cast<unsigned*>(pSQ + params.sq_off.tail);
+			_pSQArray  = reinterpret_cast<unsigned*>(pSQ + params.sq_off.array);
+			_sqMask    = *reinterpret_cast<unsigned*>(pSQ + params.sq_off.ring_mask);
+			_sqEntries = params.sq_entries;
+			_pCQHead   = reinterpret_cast<unsigned*>(pCQ + params.cq_off.head);
+			_pCQTail   = reinterpret_cast<unsigned*>(pCQ + params.cq_off.tail);
+			_pCQEs     = reinterpret_cast<io_uring_cqe*>(pCQ + params.cq_off.cqes);
+			_cqMask    = *reinterpret_cast<unsigned*>(pCQ + params.cq_off.ring_mask);
+			_sqeTail   = *_pSQTail;
+
+			std::vector<int> files(_maxSockets, -1);
+			if (ioUringRegister(_fd, IORING_REGISTER_FILES, &files[0], _maxSockets) < 0)
+				throw Poco::IOException("Cannot register io_uring file table", Poco::Error::getMessage(errno), errno);
+
+			// Registering the receive buffers may fail due to
+			// resource limits (RLIMIT_MEMLOCK); in this case,
+			// data is received into unregistered buffers.
+			if (_maxSockets <= MAX_REGISTERED_BUFFERS)
+			{
+				std::vector<iovec> iovecs(_maxSockets);
+				for (int i = 0; i < _maxSockets; ++i)
+				{
+					iovecs[i].iov_base = buffer(i);
+					iovecs[i].iov_len  = _bufferSize;
+				}
+				_fixedBuffers = ioUringRegister(_fd, IORING_REGISTER_BUFFERS, &iovecs[0], _maxSockets) == 0;
+			}
+		}
+
+		void close()
+		{
+			if (_fd >= 0 && _pSQEs != MAP_FAILED)
+			{
+				try
+				{
+					cancelAll();
+				}
+				catch (...)
+				{
+					poco_unexpected();
+				}
+			}
+			if (_pSQEs != MAP_FAILED) munmap(_pSQEs, _sqesSize);
+			if (_pCQRing != MAP_FAILED) munmap(_pCQRing, _cqRingSize);
+			if (_pSQRing != MAP_FAILED) munmap(_pSQRing, _sqRingSize);
+			if (_fd >= 0) ::close(_fd);
+			_fd = -1;
+		}
+
+		int add(const Socket& socket, Handler& handler, bool acceptor)
+		{
+			int index = allocate(socket, handler, acceptor);
+			try
+			{
+				// io_uring performs operations on non-blocking
+				// sockets synchronously, failing with EAGAIN.
+				Socket(socket).setBlocking(true);
+				updateFile(index, socket.impl()->sockfd());
+			}
+			catch (...)
+			{
+				detach(index);
+				release(index);
+				throw;
+			}
+			return index;
+		}
+
+		char* buffer(int index)
+		{
+			return &_buffers[static_cast<std::size_t>(index)*_bufferSize];
+		}
+
+		Poco::UInt64 userData(int index, Operation op)
+		{
+			return (static_cast<Poco::UInt64>(slot(index).generation) << 32) | (static_cast<Poco::UInt64>(index) << 8) | op;
+		}
+
+		void updateFile(int index, int fd)
+		{
+			io_uring_files_update update;
+			std::memset(&update, 0, sizeof(update));
+			update.offset = index;
+			update.fds    = reinterpret_cast<Poco::UInt64>(&fd);
+			if (ioUringRegister(_fd, IORING_REGISTER_FILES_UPDATE, &update, 1) < 0)
+				throw Poco::IOException("Cannot update io_uring file table", Poco::Error::getMessage(errno), errno);
+		}
+
+		io_uring_sqe* nextSQE()
+		{
+			if (_sqeTail - __atomic_load_n(_pSQHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+			{
+				enter(0, Poco::Timespan());
+				if (_sqeTail - __atomic_load_n(_pSQHead, __ATOMIC_ACQUIRE) >= _sqEntries)
+					throw Poco::IOException("io_uring submission queue is full");
+			}
+			unsigned i = _sqeTail & _sqMask;
+			io_uring_sqe* pSQE = &_pSQEs[i];
+			std::memset(pSQE, 0, sizeof(io_uring_sqe));
+			_pSQArray[i] = i;
+			++_sqeTail;
+			return pSQE;
+		}
+
+		void startAccept(int index)
+		{
+			io_uring_sqe* pSQE = nextSQE();
+			pSQE->opcode       = IORING_OP_ACCEPT;
+			pSQE->flags        = IOSQE_FIXED_FILE;
+			pSQE->fd           = index;
+			pSQE->accept_flags = SOCK_CLOEXEC;
+			pSQE->user_data    = userData(index, OP_ACCEPT);
+			Slot& s = slot(index);
+			s.receiving = true;
+			++s.pending;
+		}
+
+		void startReceive(int index)
+		{
+			io_uring_sqe* pSQE = nextSQE();
+			pSQE->opcode    = _fixedBuffers ? IORING_OP_READ_FIXED : IORING_OP_RECV;
+			pSQE->flags     = IOSQE_FIXED_FILE;
+			pSQE->fd        = index;
+			pSQE->addr      = reinterpret_cast<Poco::UInt64>(buffer(index));
+			pSQE->len       = _bufferSize;
+			pSQE->user_data = userData(index, OP_RECEIVE);
+			if (_fixedBuffers) pSQE->buf_index = index;
+			Slot& s = slot(index);
+			s.receiving = true;
+			++s.pending;
+		}
+
+		void startSend(int index)
+		{
+			Slot& s = slot(index);
+			const Buffer& data = s.queue.front();
+			io_uring_sqe* pSQE = nextSQE();
+			pSQE->opcode    = IORING_OP_SEND;
+			pSQE->flags     = IOSQE_FIXED_FILE;
+			pSQE->fd        = index;
+			pSQE->addr      = reinterpret_cast<Poco::UInt64>(&data[s.offset]);
+			pSQE->len       = static_cast<Poco::UInt32>(data.size() - s.offset);
+			pSQE->msg_flags = MSG_NOSIGNAL;
+			pSQE->user_data = userData(index, OP_SEND);
+			s.sending = true;
+			++s.pending;
+		}
+
+		void cancel(int index, Operation op)
+		{
+			io_uring_sqe* pSQE = nextSQE();
+			pSQE->opcode    = IORING_OP_ASYNC_CANCEL;
+			pSQE->fd        = -1;
+			pSQE->addr      = userData(index, op);
+			pSQE->user_data = userData(index, OP_CANCEL);
+		}
+
+		void cancelAll()
+			/// Cancels all pending operations and waits until
+			/// they have completed, so that the kernel no longer
+			/// accesses any send queue or receive buffer.
+		{
+			int pending = 0;
+			for (int index = 0; index < slotCount(); ++index)
+			{
+				Slot& s = slot(index);
+				if (s.receiving) cancel(index, s.acceptor ? OP_ACCEPT : OP_RECEIVE);
+				if (s.sending) cancel(index, OP_SEND);
+				pending += s.pending;
+			}
+			unsigned head = *_pCQHead;
+			while (pending > 0)
+			{
+				unsigned tail = __atomic_load_n(_pCQTail, __ATOMIC_ACQUIRE);
+				if (head == tail)
+				{
+					enter(1, Poco::Timespan(1, 0));
+					tail = __atomic_load_n(_pCQTail, __ATOMIC_ACQUIRE);
+				}
+				while (head != tail)
+				{
+					const io_uring_cqe& cqe = _pCQEs[head & _cqMask];
+					Operation op = static_cast<Operation>(cqe.user_data & 0xFF);
+					if (op != OP_CANCEL)
+					{
+						int index = static_cast<int>((cqe.user_data >> 8) & 0xFFFFFF);
+						--slot(index).pending;
+						--pending;
+					}
+					++head;
+					__atomic_store_n(_pCQHead, head, __ATOMIC_RELEASE);
+				}
+			}
+		}
+
+		void enter(unsigned minComplete, const Poco::Timespan& timeout)
+		{
+			__atomic_store_n(_pSQTail, _sqeTail, __ATOMIC_RELEASE);
+			unsigned toSubmit = _sqeTail - __atomic_load_n(_pSQHead, __ATOMIC_ACQUIRE);
+			if (toSubmit == 0 && minComplete == 0) return;
+
+			unsigned flags = 0;
+			__kernel_timespec ts;
+			io_uring_getevents_arg arg;
+			std::memset(&arg, 0, sizeof(arg));
+			if (minComplete > 0)
+			{
+				flags   = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+				ts.tv_sec  = timeout.totalSeconds();
+				ts.tv_nsec = timeout.useconds()*1000;
+				arg.sigmask_sz = _NSIG/8;
+				arg.ts  = reinterpret_cast<Poco::UInt64>(&ts);
+			}
+			int rc = ioUringEnter(_fd, toSubmit, minComplete, flags, minComplete > 0 ? &arg : 0, minComplete > 0 ? sizeof(arg) : 0);
+			if (rc < 0 && errno != ETIME && errno != EINTR && errno != EAGAIN && errno != EBUSY)
+				throw Poco::IOException("io_uring_enter failed", Poco::Error::getMessage(errno), errno);
+		}
+
+		void complete(const io_uring_cqe& cqe)
+		{
+			Operation op = static_cast<Operation>(cqe.user_data & 0xFF);
+			if (op == OP_CANCEL) return;
+
+			int index = static_cast<int>((cqe.user_data >> 8) & 0xFFFFFF);
+			Slot& s = slot(index);
+			--s.pending;
+			if (op == OP_SEND)
+				s.sending = false;
+			else
+				s.receiving = false;
+			if (!s.active)
+			{
+				if (s.pending == 0) release(index);
+				return;
+			}
+
+			switch (op)
+			{
+			case OP_ACCEPT:
+				accepted(index, cqe.res);
+				break;
+			case OP_RECEIVE:
+				received(index, cqe.res);
+				break;
+			case OP_SEND:
+				sent(index, cqe.res);
+				break;
+			default:
+				break;
+			}
+		}
+
+		void accepted(int index, int res)
+		{
+			if (res >= 0)
+			{
+				Slot& s = slot(index);
+				Socket socket = s.socket;
+				StreamSocket ss(new StreamSocketImpl(res));
+				startAccept(index);
+				notifyAccept(*s.pHandler, socket, ss);
+			}
+			else if (res == -EINTR || res == -EAGAIN || res == -ECONNABORTED)
+			{
+				startAccept(index);
+			}
+			else fail(index, -res);
+		}
+
+		void received(int index, int res)
+		{
+			if (res > 0)
+			{
+				Slot& s = slot(index);
+				Poco::UInt32 generation = s.generation;
+				Socket socket = s.socket;
+				notifyReceive(*s.pHandler, socket, buffer(index), res);
+				if (s.active && s.generation == generation && !s.receiving)
+					startReceive(index);
+			}
+			else if (res == 0)
+			{
+				shutdown(index);
+			}
+			else if (res == -EINTR || res == -EAGAIN)
+			{
+				startReceive(index);
+			}
+			else fail(index, -res);
+		}
+
+		void sent(int index, int res)
+		{
+			if (res >= 0)
+			{
+				Slot& s = slot(index);
+				Socket socket = s.socket;
+				if (consume(s, res) > 0) startSend(index);
+				if (res > 0) notifySent(*s.pHandler, socket, res);
+			}
+			else if (res == -EINTR || res == -EAGAIN)
+			{
+				startSend(index);
+			}
+			else fail(index, -res);
+		}
+
+		int _fd;
+		void* _pSQRing;
+		std::size_t _sqRingSize;
+		void* _pCQRing;
+		std::size_t _cqRingSize;
+		io_uring_sqe* _pSQEs;
+		std::size_t _sqesSize;
+		unsigned* _pSQHead;
+		unsigned* _pSQTail;
+		unsigned* _pSQArray;
+		unsigned _sqMask;
+		unsigned _sqEntries;
+		unsigned _sqeTail;
+		unsigned* _pCQHead;
+		unsigned* _pCQTail;
+		io_uring_cqe* _pCQEs;
+		unsigned _cqMask;
+		Buffer _buffers;
+		int _bufferSize;
+		bool _fixedBuffers;
+	};
+
+
+#endif // POCO_HAVE_IO_URING
+
+
+	SocketCompletionReactorImpl* createImpl(int maxSockets, int bufferSize, bool useIOUring)
+	{
+		poco_assert (bufferSize > 0);
+
+#if defined(POCO_HAVE_IO_URING)
+		if (useIOUring)
+		{
+			try
+			{
+				return new IOUringCompletionImpl(maxSockets, bufferSize);
+			}
+			catch (Poco::Exception&)
+			{
+				// fall back to PollSet
+			}
+		}
+#endif
+		return new PollSetCompletionImpl(maxSockets, bufferSize);
+	}
+}
+
+
+//
+// SocketCompletionReactor::Handler
+//
+
+
+SocketCompletionReactor::Handler::~Handler()
+{
+}
+
+
+void SocketCompletionReactor::Handler::onAccept(ServerSocket&, StreamSocket&)
+{
+}
+
+
+void SocketCompletionReactor::Handler::onReceive(StreamSocket&, const char*, std::size_t)
+{
+}
+
+
+void SocketCompletionReactor::Handler::onSent(StreamSocket&, std::size_t)
+{
+}
+
+
+void SocketCompletionReactor::Handler::onError(Socket&, int)
+{
+}
+
+
+//
+// SocketCompletionReactor
+//
+
+
+SocketCompletionReactor::SocketCompletionReactor(int maxSockets, int bufferSize):
+	_pImpl(createImpl(maxSockets, bufferSize, true)),
+	_timeout(DEFAULT_TIMEOUT),
+	_stop(false)
+{
+}
+
+
+SocketCompletionReactor::SocketCompletionReactor(int maxSockets, int bufferSize, bool useIOUring):
+	_pImpl(createImpl(maxSockets, bufferSize, useIOUring)),
+	_timeout(DEFAULT_TIMEOUT),
+	_stop(false)
+{
+}
+
+
+SocketCompletionReactor::~SocketCompletionReactor()
+{
+	delete _pImpl;
+}
+
+
+void SocketCompletionReactor::run()
+{
+	while (!_stop)
+	{
+		try
+		{
+			_pImpl->poll(_timeout);
+		}
+		catch (Exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (std::exception& exc)
+		{
+			ErrorHandler::handle(exc);
+		}
+		catch (...)
+		{
+			ErrorHandler::handle();
+		}
+	}
+}
+
+
+void SocketCompletionReactor::stop()
+{
+	_stop = true;
+}
+
+
+void SocketCompletionReactor::addAcceptor(const ServerSocket& socket, Handler& handler)
+{
+	_pImpl->addAcceptor(socket, handler);
+}
+
+
+void SocketCompletionReactor::addSocket(const StreamSocket& socket, Handler& handler)
+{
+	_pImpl->addSocket(socket, handler);
+}
+
+
+void SocketCompletionReactor::removeSocket(const Socket& socket)
+{
+	_pImpl->removeSocket(socket);
+}
+
+
+bool SocketCompletionReactor::hasSocket(const Socket& socket) const
+{
+	return _pImpl->hasSocket(socket);
+}
+
+
+void SocketCompletionReactor::send(const StreamSocket& socket, const void* buffer, std::size_t length)
+{
+	_pImpl->send(socket, buffer, length);
+}
+
+
+std::size_t SocketCompletionReactor::pendingOutput(const StreamSocket& socket) const
+{
+	return _pImpl->pendingOutput(socket);
+}
+
+
+bool SocketCompletionReactor::usesIOUring() const
+{
+	return _pImpl->usesIOUring();
+}
+
+
+bool SocketCompletionReactor::isIOUringAvailable()
+{
+#if defined(POCO_HAVE_IO_URING)
+	return IOUringCompletionImpl::isAvailable();
+#else
+	return false;
+#endif
+}
+
+
+} } // namespace Poco::Net
@@ -15,10 +15,13 @@
 
 
 #include "Poco/Net/SocketImpl.h"
+#include "Poco/Net/Socket.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Net/StreamSocketImpl.h"
 #include "Poco/NumberFormatter.h"
 #include "Poco/Timestamp.h"
+#include "Poco/Buffer.h"
+#include "Poco/FileStream.h"
 #include <string.h> // FD_SET needs memset on some platforms, so we can't use <cstring>
 #if defined(POCO_HAVE_FD_EPOLL)
 #include <sys/epoll.h>
@@ -35,6 +38,18 @@
 
 #ifdef POCO_OS_FAMILY_WINDOWS
 #include <Windows.h>
+#else
+#include <limits.h>
+#endif
+
+
+#if !defined(POCO_OS_FAMILY_WINDOWS) && !defined(IOV_MAX)
+#define IOV_MAX 16
+#endif
+
+
+#if POCO_OS == POCO_OS_LINUX && defined(MSG_WAITFORONE)
+#define POCO_HAVE_MMSG
 #endif
 
 
@@ -316,6 +331,92 @@ int SocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int SocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	if (buffers.empty()) return 0;
+
+	if (_isBrokenTimeout)
+	{
+		if (_sndTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_sndTimeout, SELECT_WRITE))
+				throw TimeoutException();
+		}
+	}
+
+	int rc;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+	DWORD sent = 0;
+	rc = WSASend(_sockfd, const_cast<LPWSABUF>(&buffers[0]), static_cast<DWORD>(buffers.size()), &sent, static_cast<DWORD>(flags), 0, 0);
+	if (rc == SOCKET_ERROR) error();
+	rc = static_cast<int>(sent);
+#elif defined(POCO_OS_FAMILY_UNIX) || defined(POCO_OS_FAMILY_VMS)
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = const_cast<struct iovec*>(&buffers[0]);
+	msg.msg_iovlen = buffers.size() < IOV_MAX ? buffers.size() : IOV_MAX;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		rc = ::sendmsg(_sockfd, &msg, flags);
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0) error();
+#else
+	rc = 0;
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+		int n = sendBytes(it->iov_base, static_cast<int>(it->iov_len), flags);
+		rc += n;
+		if (n < static_cast<int>(it->iov_len)) break;
+	}
+#endif
+	return rc;
+}
+
+
+int SocketImpl::sendGathered(const SocketBufVec& buffers, int flags)
+{
+	std::size_t length = Socket::bufferLength(buffers);
+	Poco::Buffer<char> buffer(length);
+	char* p = buffer.begin();
+	for (SocketBufVec::const_iterator it = buffers.begin(); it != buffers.end(); ++it)
+	{
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		memcpy(p, it->buf, it->len);
+#else
+		memcpy(p, it->iov_base, it->iov_len);
+#endif
+		p += Socket::bufferLength(*it);
+	}
+	return sendBytes(buffer.begin(), static_cast<int>(length), flags);
+}
+
+
+Poco::Int64 SocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	const std::size_t BUFFER_SIZE = 8192;
+
+	istr.clear();
+	istr.seekg(static_cast<std::streamoff>(offset), std::ios::beg);
+	Poco::Buffer<char> buffer(BUFFER_SIZE);
+	Poco::Int64 sent = 0;
+	while (static_cast<Poco::UInt64>(sent) < count && istr.good())
+	{
+		std::streamsize n = BUFFER_SIZE;
+		if (static_cast<Poco::UInt64>(n) > count - sent) n = static_cast<std::streamsize>(count - sent);
+		istr.read(buffer.begin(), n);
+		n = istr.gcount();
+		if (n == 0) break;
+		int rc = sendBytes(buffer.begin(), static_cast<int>(n));
+		if (rc > 0) sent += rc;
+		if (rc < n) break;
+	}
+	return sent;
+}
+
+
 int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 	if (_isBrokenTimeout)
@@ -348,6 +449,87 @@ int SocketImpl::receiveBytes(void* buffer, int length, int flags)
 }
 
 
+int SocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	if (buffers.empty()) return 0;
+
+	if (_isBrokenTimeout)
+	{
+		if (_recvTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_recvTimeout, SELECT_READ))
+				throw TimeoutException();
+		}
+	}
+
+	int rc;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+	DWORD received = 0;
+	DWORD recvFlags = static_cast<DWORD>(flags);
+	rc = WSARecv(_sockfd, &buffers[0], static_cast<DWORD>(buffers.size()), &received, &recvFlags, 0, 0);
+	if (rc == SOCKET_ERROR)
+	{
+		int err = lastError();
+		if (err == POCO_EAGAIN && !_blocking)
+			return -1;
+		else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+			throw TimeoutException(err);
+		else
+			error(err);
+	}
+	rc = static_cast<int>(received);
+#elif defined(POCO_OS_FAMILY_UNIX) || defined(POCO_OS_FAMILY_VMS)
+	struct msghdr msg;
+	memset(&msg, 0, sizeof(msg));
+	msg.msg_iov    = &buffers[0];
+	msg.msg_iovlen = buffers.size() < IOV_MAX ? buffers.size() : IOV_MAX;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		rc = ::recvmsg(_sockfd, &msg, flags);
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0)
+	{
+		int err = lastError();
+		if (err == POCO_EAGAIN && !_blocking)
+			;
+		else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+			throw TimeoutException(err);
+		else
+			error(err);
+	}
+#else
+	rc = receiveScattered(buffers, flags);
+#endif
+	return rc;
+}
+
+
+int SocketImpl::receiveScattered(SocketBufVec& buffers, int flags)
+{
+	std::size_t length = Socket::bufferLength(buffers);
+	Poco::Buffer<char> buffer(length);
+	int rc = receiveBytes(buffer.begin(), static_cast<int>(length), flags);
+	const char* p = buffer.begin();
+	std::size_t rest = rc > 0 ? static_cast<std::size_t>(rc) : 0;
+	for (SocketBufVec::iterator it = buffers.begin(); it != buffers.end() && rest > 0; ++it)
+	{
+		std::size_t n = Socket::bufferLength(*it);
+		if (n > rest) n = rest;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		memcpy(it->buf, p, n);
+#else
+		memcpy(it->iov_base, p, n);
+#endif
+		p += n;
+		rest -= n;
+	}
+	return rc;
+}
+
+
 int SocketImpl::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
 {
 	int rc;
@@ -405,6 +587,139 @@ int SocketImpl::receiveFrom(void* buffer, int length, SocketAddress& address, in
 }
 
 
+int SocketImpl::sendBatch(const DatagramPacketVec& packets, int flags)
+{
+	if (packets.empty()) return 0;
+#if defined(POCO_HAVE_MMSG)
+	std::size_t count = packets.size() < static_cast<std::size_t>(MAX_BATCH_SIZE) ? packets.size() : static_cast<std::size_t>(MAX_BATCH_SIZE);
+	struct mmsghdr msgs[MAX_BATCH_SIZE];
+	struct iovec iovs[MAX_BATCH_SIZE];
+	memset(msgs, 0, count*sizeof(struct mmsghdr));
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const DatagramPacket& packet = packets[i];
+		iovs[i].iov_base = packet.buffer;
+		iovs[i].iov_len  = packet.length;
+		msgs[i].msg_hdr.msg_name    = const_cast<struct sockaddr*>(packet.address.addr());
+		msgs[i].msg_hdr.msg_namelen = packet.address.length();
+		msgs[i].msg_hdr.msg_iov     = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen  = 1;
+	}
+	int rc;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		rc = ::sendmmsg(_sockfd, msgs, static_cast<unsigned>(count), flags);
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0) error();
+	return rc;
+#else
+	int n = 0;
+	for (DatagramPacketVec::const_iterator it = packets.begin(); it != packets.end(); ++it)
+	{
+		sendTo(it->buffer, it->length, it->address, flags);
+		++n;
+	}
+	return n;
+#endif
+}
+
+
+int SocketImpl::receiveBatch(DatagramPacketVec& packets, int flags)
+{
+	if (packets.empty()) return 0;
+#if defined(POCO_HAVE_MMSG)
+	if (_isBrokenTimeout)
+	{
+		if (_recvTimeout.totalMicroseconds() != 0)
+		{
+			if (!poll(_recvTimeout, SELECT_READ))
+				throw TimeoutException();
+		}
+	}
+
+	union ControlBuffer
+	{
+		struct cmsghdr header;
+		char buffer[CMSG_SPACE(sizeof(struct timespec))];
+	};
+
+	std::size_t count = packets.size() < static_cast<std::size_t>(MAX_BATCH_SIZE) ? packets.size() : static_cast<std::size_t>(MAX_BATCH_SIZE);
+	struct mmsghdr msgs[MAX_BATCH_SIZE];
+	struct iovec iovs[MAX_BATCH_SIZE];
+	struct sockaddr_storage addrs[MAX_BATCH_SIZE];
+	ControlBuffer controls[MAX_BATCH_SIZE];
+	memset(msgs, 0, count*sizeof(struct mmsghdr));
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		iovs[i].iov_base = packets[i].buffer;
+		iovs[i].iov_len  = packets[i].length;
+		msgs[i].msg_hdr.msg_name       = &addrs[i];
+		msgs[i].msg_hdr.msg_namelen    = sizeof(addrs[i]);
+		msgs[i].msg_hdr.msg_iov        = &iovs[i];
+		msgs[i].msg_hdr.msg_iovlen     = 1;
+		msgs[i].msg_hdr.msg_control    = controls[i].buffer;
+		msgs[i].msg_hdr.msg_controllen = sizeof(controls[i].buffer);
+	}
+	int rc;
+	do
+	{
+		if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
+		rc = ::recvmmsg(_sockfd, msgs, static_cast<unsigned>(count), flags | MSG_WAITFORONE, 0);
+	}
+	while (_blocking && rc < 0 && lastError() == POCO_EINTR);
+	if (rc < 0)
+	{
+		int err = lastError();
+		if (err == POCO_EAGAIN && !_blocking)
+			;
+		else if (err == POCO_EAGAIN || err == POCO_ETIMEDOUT)
+			throw TimeoutException(err);
+		else
+			error(err);
+		return rc;
+	}
+	for (int i = 0; i < rc; ++i)
+	{
+		DatagramPacket& packet = packets[i];
+		struct msghdr& hdr = msgs[i].msg_hdr;
+		packet.received  = static_cast<int>(msgs[i].msg_len);
+		packet.truncated = (hdr.msg_flags & MSG_TRUNC) != 0;
+		const struct sockaddr* pSA = reinterpret_cast<const struct sockaddr*>(&addrs[i]);
+		// Datagrams usually come from a few senders only, so the
+		// SocketAddress is only replaced if the sender has changed.
+		if (hdr.msg_namelen > 0 && (packet.address.length() != hdr.msg_namelen || memcmp(packet.address.addr(), pSA, hdr.msg_namelen) != 0))
+			packet.address = SocketAddress(pSA, hdr.msg_namelen);
+		packet.timestamp = 0;
+		for (struct cmsghdr* pCmsg = CMSG_FIRSTHDR(&hdr); pCmsg; pCmsg = CMSG_NXTHDR(&hdr, pCmsg))
+		{
+			if (pCmsg->cmsg_level == SOL_SOCKET && pCmsg->cmsg_type == SCM_TIMESTAMPNS)
+			{
+				struct timespec ts;
+				memcpy(&ts, CMSG_DATA(pCmsg), sizeof(ts));
+				packet.timestamp = Poco::Timestamp::TimeVal(ts.tv_sec)*Poco::Timestamp::resolution() + ts.tv_nsec/1000;
+			}
+		}
+	}
+	return rc;
+#else
+	int n = 0;
+	for (DatagramPacketVec::iterator it = packets.begin(); it != packets.end(); ++it)
+	{
+		if (n > 0 && !poll(Poco::Timespan(0), SELECT_READ)) break;
+		int rc = receiveFrom(it->buffer, it->length, it->address, flags);
+		if (rc < 0) return n > 0 ? n : rc;
+		it->received  = rc;
+		it->truncated = false;
+		it->timestamp = 0;
+		++n;
+	}
+	return n;
+#endif
+}
+
+
 void SocketImpl::sendUrgent(unsigned char data)
 {
 	if (_sockfd == POCO_INVALID_SOCKET) throw InvalidSocketException();
@@ -899,6 +1214,29 @@ bool SocketImpl::getBroadcast()
 }
 
 
+void SocketImpl::setReceiveTimestamps(bool flag)
+{
+#if defined(POCO_HAVE_MMSG) && defined(SO_TIMESTAMPNS)
+	int value = flag ? 1 : 0;
+	setOption(SOL_SOCKET, SO_TIMESTAMPNS, value);
+#else
+	throw Poco::NotImplementedException("receive timestamps not supported on this platform");
+#endif
+}
+
+
+bool SocketImpl::getReceiveTimestamps()
+{
+#if defined(POCO_HAVE_MMSG) && defined(SO_TIMESTAMPNS)
+	int value(0);
+	getOption(SOL_SOCKET, SO_TIMESTAMPNS, value);
+	return value != 0;
+#else
+	return false;
+#endif
+}
+
+
 void SocketImpl::setBlocking(bool flag)
 {
 #if !defined(POCO_OS_FAMILY_UNIX)
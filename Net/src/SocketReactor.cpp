@@ -18,6 +18,7 @@
 #include "Poco/Net/SocketNotification.h"
 #include "Poco/Net/SocketNotifier.h"
 #include "Poco/ErrorHandler.h"
+#include "Poco/Timestamp.h"
 #include "Poco/Thread.h"
 #include "Poco/Exception.h"
 
@@ -68,56 +69,49 @@ void SocketReactor::run()
 {
 	_pThread = Thread::current();
 
-	Socket::SocketList readable;
-	Socket::SocketList writable;
-	Socket::SocketList except;
-	
+	Poco::Timestamp lastTimeout;
 	while (!_stop)
 	{
 		try
 		{
-			readable.clear();
-			writable.clear();
-			except.clear();
-			int nSockets = 0;
+			if (_pollSet.empty())
 			{
-				FastMutex::ScopedLock lock(_mutex);
-				for (EventHandlerMap::iterator it = _handlers.begin(); it != _handlers.end(); ++it)
+				onIdle();
+				Thread::trySleep(_timeout.totalMilliseconds());
+			}
+			else
+			{
+				PollSet::SocketModeMap sm = _pollSet.poll(_timeout);
+				if (!sm.empty())
 				{
-					if (it->second->accepts(_pReadableNotification))
-					{
-						readable.push_back(it->first);
-						nSockets++;
-					}
-					if (it->second->accepts(_pWritableNotification))
+					onBusy();
+
+					for (PollSet::SocketModeMap::iterator it = sm.begin(); it != sm.end(); ++it)
 					{
-						writable.push_back(it->first);
-						nSockets++;
+						if (it->second & PollSet::POLL_READ)
+							dispatch(it->first, _pReadableNotification);
+						if (it->second & PollSet::POLL_WRITE)
+							dispatch(it->first, _pWritableNotification);
+						if (it->second & PollSet::POLL_ERROR)
+							dispatch(it->first, _pErrorNotification);
 					}
-					if (it->second->accepts(_pErrorNotification))
+					// Make sure that handlers checking deadlines in
+					// their timeout handler also get a chance to do
+					// so if the reactor is always busy. Handlers may
+					// have stopped the reactor and destroyed themselves
+					// in the meantime, so nothing is dispatched then.
+					if (!_stop && lastTimeout.isElapsed(_timeout.totalMicroseconds()))
 					{
-						except.push_back(it->first);
-						nSockets++;
+						lastTimeout.update();
+						onTimeout();
 					}
 				}
+				else
+				{
+					lastTimeout.update();
+					onTimeout();
+				}
 			}
-			if (nSockets == 0)
-			{
-				onIdle();
-				Thread::trySleep(_timeout.totalMilliseconds());
-			}
-			else if (Socket::select(readable, writable, except, _timeout))
-			{
-				onBusy();
-
-				for (Socket::SocketList::iterator it = readable.begin(); it != readable.end(); ++it)
-					dispatch(*it, _pReadableNotification);
-				for (Socket::SocketList::iterator it = writable.begin(); it != writable.end(); ++it)
-					dispatch(*it, _pWritableNotification);
-				for (Socket::SocketList::iterator it = except.begin(); it != except.end(); ++it)
-					dispatch(*it, _pErrorNotification);
-			}
-			else onTimeout();
 		}
 		catch (Exception& exc)
 		{
@@ -162,17 +156,24 @@ const Poco::Timespan& SocketReactor::getTimeout() const
 
 void SocketReactor::addEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
 {
+	// The handler map and the poll set are updated under the same
+	// lock, so that concurrent add/remove calls for the same socket
+	// cannot leave a registered handler without a poll set entry.
+	// The observer is added after releasing the lock, as adding or
+	// removing an observer may have to wait for a running handler,
+	// which in turn may call addEventHandler() or removeEventHandler().
 	NotifierPtr pNotifier;
 	{
 		FastMutex::ScopedLock lock(_mutex);
-		
+
 		EventHandlerMap::iterator it = _handlers.find(socket);
 		if (it == _handlers.end())
-		{
-			pNotifier = new SocketNotifier(socket);
-			_handlers[socket] = pNotifier;
-		}
-		else pNotifier = it->second;
+			pNotifier = _handlers[socket] = new SocketNotifier(socket);
+		else
+			pNotifier = it->second;
+
+		int mode = pollMode(pNotifier) | pollMode(observer);
+		if (mode) _pollSet.add(socket, mode);
 	}
 	if (!pNotifier->hasObserver(observer))
 		pNotifier->addObserver(this, observer);
@@ -181,43 +182,37 @@ void SocketReactor::addEventHandler(const Socket& socket, const Poco::AbstractOb
 
 bool SocketReactor::hasEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
 {
-	NotifierPtr pNotifier;
-	{
-		FastMutex::ScopedLock lock(_mutex);
-	
-		EventHandlerMap::iterator it = _handlers.find(socket);
-		if (it != _handlers.end())
-		{
-			if (it->second->hasObserver(observer))
-				return true;
-		}
-	}
-
-	return false;
+	NotifierPtr pNotifier = getNotifier(socket);
+	return pNotifier && pNotifier->hasObserver(observer);
 }
 
 
 void SocketReactor::removeEventHandler(const Socket& socket, const Poco::AbstractObserver& observer)
 {
-	NotifierPtr pNotifier;
+	NotifierPtr pNotifier = getNotifier(socket);
+	if (!pNotifier || !pNotifier->hasObserver(observer)) return;
+
+	bool last = pNotifier->countObservers() == 1;
 	{
 		FastMutex::ScopedLock lock(_mutex);
-	
-		EventHandlerMap::iterator it = _handlers.find(socket);
-		if (it != _handlers.end())
+
+		int mode = last ? 0 : pollMode(pNotifier) & ~pollMode(observer);
+		if (mode)
 		{
-			pNotifier = it->second;
-			if (pNotifier->hasObserver(observer) && pNotifier->countObservers() == 1)
+			_pollSet.update(socket, mode);
+		}
+		else
+		{
+			if (last)
 			{
-				_handlers.erase(it);
+				EventHandlerMap::iterator it = _handlers.find(socket);
+				if (it != _handlers.end() && it->second == pNotifier) _handlers.erase(it);
 			}
+			_pollSet.remove(socket);
 		}
 	}
-	if (pNotifier && pNotifier->hasObserver(observer))
-	{
-		pNotifier->removeObserver(this, observer);
-	}
-
+	// see addEventHandler()
+	pNotifier->removeObserver(this, observer);
 }
 
 
@@ -246,16 +241,8 @@ void SocketReactor::onBusy()
 
 void SocketReactor::dispatch(const Socket& socket, SocketNotification* pNotification)
 {
-	NotifierPtr pNotifier;
-	{
-		FastMutex::ScopedLock lock(_mutex);
-		EventHandlerMap::iterator it = _handlers.find(socket);
-		if (it != _handlers.end())
-			pNotifier = it->second;
-		else
-			return;
-	}
-	dispatch(pNotifier, pNotification);
+	NotifierPtr pNotifier = getNotifier(socket);
+	if (pNotifier) dispatch(pNotifier, pNotification);
 }
 
 
@@ -296,4 +283,42 @@ void SocketReactor::dispatch(NotifierPtr& pNotifier, SocketNotification* pNotifi
 }
 
 
+SocketReactor::NotifierPtr SocketReactor::getNotifier(const Socket& socket, bool makeNew)
+{
+	FastMutex::ScopedLock lock(_mutex);
+
+	EventHandlerMap::iterator it = _handlers.find(socket);
+	if (it != _handlers.end())
+		return it->second;
+	else if (makeNew)
+		return (_handlers[socket] = new SocketNotifier(socket));
+
+	return 0;
+}
+
+
+int SocketReactor::pollMode(NotifierPtr& pNotifier)
+{
+	int mode = 0;
+	if (pNotifier->accepts(_pReadableNotification)) mode |= PollSet::POLL_READ;
+	if (pNotifier->accepts(_pWritableNotification)) mode |= PollSet::POLL_WRITE;
+	if (pNotifier->accepts(_pErrorNotification))    mode |= PollSet::POLL_ERROR;
+	return mode;
+}
+
+
+int SocketReactor::pollMode(const Poco::AbstractObserver& observer)
+{
+	// must match the notification types recognized by SocketNotifier::addObserver()
+	if (observer.accepts(_pReadableNotification))
+		return PollSet::POLL_READ;
+	else if (observer.accepts(_pWritableNotification))
+		return PollSet::POLL_WRITE;
+	else if (observer.accepts(_pErrorNotification))
+		return PollSet::POLL_ERROR;
+	else
+		return 0;
+}
+
+
 } } // namespace Poco::Net
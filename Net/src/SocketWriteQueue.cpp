@@ -0,0 +1,360 @@
+//
+// SocketWriteQueue.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: Reactor
+// Module:  SocketWriteQueue
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SocketWriteQueue.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Net/SocketImpl.h"
+#include "Poco/Observer.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+#if defined(MSG_NOSIGNAL)
+	const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+	const int SEND_FLAGS = 0;
+#endif
+}
+
+
+SocketWriteQueue::SocketWriteQueue(const StreamSocket& socket, SocketReactor& reactor):
+	_socket(socket),
+	_reactor(reactor),
+	_pending(0),
+	_lowWatermark(DEFAULT_LOW_WATERMARK),
+	_highWatermark(DEFAULT_HIGH_WATERMARK),
+	_coalesceSize(DEFAULT_COALESCE_SIZE),
+	_full(false),
+	_registered(false),
+	_failed(false),
+	_pException(0)
+{
+	_socket.setBlocking(false);
+}
+
+
+SocketWriteQueue::~SocketWriteQueue()
+{
+	try
+	{
+		if (_registered)
+		{
+			_reactor.removeEventHandler(_socket, Poco::Observer<SocketWriteQueue, WritableNotification>(*this, &SocketWriteQueue::onWritable));
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+	delete _pException;
+}
+
+
+void SocketWriteQueue::write(const void* buffer, std::size_t length)
+{
+	if (length == 0) return;
+
+	Event event = EVENT_NONE;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_failed) return;
+		const char* data = static_cast<const char*>(buffer);
+		std::size_t offset = _queue.empty() ? send(data, length) : 0;
+		if (offset < length && !_failed)
+		{
+			data += offset;
+			length -= offset;
+			if (length <= _coalesceSize && !_queue.empty() && _queue.back().owned && _queue.back().pData->size() + length <= _coalesceSize)
+			{
+				_queue.back().pData->append(data, length);
+				_pending += length;
+			}
+			else
+			{
+				SharedBuffer pBuffer(new std::string);
+				if (length < _coalesceSize) pBuffer->reserve(_coalesceSize);
+				pBuffer->assign(data, length);
+				enqueue(pBuffer, 0, true);
+			}
+		}
+		event = update();
+	}
+	fire(event);
+}
+
+
+void SocketWriteQueue::write(const SharedBuffer& pBuffer)
+{
+	poco_check_ptr (pBuffer);
+
+	Event event = EVENT_NONE;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		if (_failed || pBuffer->empty()) return;
+		std::size_t offset = _queue.empty() ? send(pBuffer->data(), pBuffer->size()) : 0;
+		if (offset < pBuffer->size() && !_failed)
+		{
+			enqueue(pBuffer, offset, false);
+		}
+		event = update();
+	}
+	fire(event);
+}
+
+
+void SocketWriteQueue::adopt(std::string& data)
+{
+	SharedBuffer pBuffer(new std::string);
+	pBuffer->swap(data);
+	write(pBuffer);
+}
+
+
+std::size_t SocketWriteQueue::pending() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pending;
+}
+
+
+bool SocketWriteQueue::empty() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _pending == 0;
+}
+
+
+bool SocketWriteQueue::full() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _full;
+}
+
+
+bool SocketWriteQueue::failed() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _failed;
+}
+
+
+void SocketWriteQueue::setWatermarks(std::size_t low, std::size_t high)
+{
+	if (low > high) throw Poco::InvalidArgumentException("low watermark must not be greater than high watermark");
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_lowWatermark = low;
+	_highWatermark = high;
+}
+
+
+std::size_t SocketWriteQueue::getLowWatermark() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _lowWatermark;
+}
+
+
+std::size_t SocketWriteQueue::getHighWatermark() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _highWatermark;
+}
+
+
+void SocketWriteQueue::setCoalesceSize(std::size_t size)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_coalesceSize = size;
+}
+
+
+std::size_t SocketWriteQueue::getCoalesceSize() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _coalesceSize;
+}
+
+
+void SocketWriteQueue::onWritable(WritableNotification* pNf)
+{
+	pNf->release();
+
+	Event event = EVENT_NONE;
+	{
+		Poco::FastMutex::ScopedLock lock(_mutex);
+
+		event = flush();
+	}
+	fire(event);
+}
+
+
+void SocketWriteQueue::enqueue(const SharedBuffer& pBuffer, std::size_t offset, bool owned)
+{
+	Chunk chunk;
+	chunk.pData  = pBuffer;
+	chunk.offset = offset;
+	chunk.owned  = owned;
+	_queue.push_back(chunk);
+	_pending += pBuffer->size() - offset;
+}
+
+
+std::size_t SocketWriteQueue::send(const char* data, std::size_t length)
+{
+	try
+	{
+		int n = _socket.impl()->sendBytes(data, static_cast<int>(length), SEND_FLAGS);
+		return n > 0 ? static_cast<std::size_t>(n) : 0;
+	}
+	catch (Poco::Exception& exc)
+	{
+		int err = exc.code();
+		if (err != POCO_EWOULDBLOCK && err != POCO_EAGAIN) fail(exc);
+		return 0;
+	}
+}
+
+
+void SocketWriteQueue::fail(const Poco::Exception& exc)
+{
+	_failed = true;
+	_pException = exc.clone();
+	_queue.clear();
+	_pending = 0;
+}
+
+
+SocketWriteQueue::Event SocketWriteQueue::flush()
+{
+	SocketBufVec buffers;
+	buffers.reserve(MAX_GATHER);
+	while (!_queue.empty())
+	{
+		buffers.clear();
+		std::size_t total = 0;
+		for (ChunkQueue::const_iterator it = _queue.begin(); it != _queue.end() && buffers.size() < MAX_GATHER; ++it)
+		{
+			std::size_t length = it->pData->size() - it->offset;
+			buffers.push_back(Socket::makeBuffer(it->pData->data() + it->offset, length));
+			total += length;
+		}
+		int n;
+		try
+		{
+			n = _socket.impl()->sendBytes(buffers, SEND_FLAGS);
+		}
+		catch (Poco::Exception& exc)
+		{
+			int err = exc.code();
+			if (err != POCO_EWOULDBLOCK && err != POCO_EAGAIN) fail(exc);
+			break;
+		}
+		std::size_t sent = static_cast<std::size_t>(n);
+		_pending -= sent;
+		while (sent > 0)
+		{
+			Chunk& front = _queue.front();
+			std::size_t length = front.pData->size() - front.offset;
+			if (sent < length)
+			{
+				front.offset += sent;
+				break;
+			}
+			sent -= length;
+			_queue.pop_front();
+		}
+		if (static_cast<std::size_t>(n) < total) break;
+	}
+
+	return update();
+}
+
+
+SocketWriteQueue::Event SocketWriteQueue::update()
+{
+	bool wantWritable = !_queue.empty();
+	if (wantWritable != _registered)
+	{
+		Poco::Observer<SocketWriteQueue, WritableNotification> observer(*this, &SocketWriteQueue::onWritable);
+		if (wantWritable)
+			_reactor.addEventHandler(_socket, observer);
+		else
+			_reactor.removeEventHandler(_socket, observer);
+		_registered = wantWritable;
+	}
+
+	if (_failed)
+	{
+		return EVENT_FAILED;
+	}
+	else if (!_full && _pending >= _highWatermark)
+	{
+		_full = true;
+		return EVENT_HIGH_WATERMARK;
+	}
+	else if (_full && _pending <= _lowWatermark)
+	{
+		_full = false;
+		return EVENT_LOW_WATERMARK;
+	}
+	else return EVENT_NONE;
+}
+
+
+void SocketWriteQueue::fire(Event event)
+{
+	switch (event)
+	{
+	case EVENT_HIGH_WATERMARK:
+		{
+			std::size_t n = pending();
+			highWatermarkReached.notify(this, n);
+		}
+		break;
+	case EVENT_LOW_WATERMARK:
+		{
+			std::size_t n = pending();
+			lowWatermarkReached.notify(this, n);
+		}
+		break;
+	case EVENT_FAILED:
+		writeFailed.notify(this, *_pException);
+		break;
+	default:
+		break;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -19,6 +19,7 @@
 #include "Poco/FIFOBuffer.h"
 #include "Poco/Mutex.h"
 #include "Poco/Exception.h"
+#include <limits>
 
 
 using Poco::InvalidArgumentException;
@@ -117,6 +118,30 @@ int StreamSocket::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int StreamSocket::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return impl()->sendBytes(buffers, flags);
+}
+
+
+int StreamSocket::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return impl()->receiveBytes(buffers, flags);
+}
+
+
+Poco::Int64 StreamSocket::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return impl()->sendFile(istr, offset, count);
+}
+
+
+Poco::Int64 StreamSocket::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset)
+{
+	return impl()->sendFile(istr, offset, std::numeric_limits<Poco::UInt64>::max());
+}
+
+
 int StreamSocket::sendBytes(FIFOBuffer& fifoBuf)
 {
 	ScopedLock<Mutex> l(fifoBuf.mutex());
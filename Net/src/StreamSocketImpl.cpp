@@ -15,8 +15,14 @@
 
 
 #include "Poco/Net/StreamSocketImpl.h"
+#include "Poco/Net/Socket.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/FileStream.h"
 #include "Poco/Exception.h"
 #include "Poco/Thread.h"
+#if POCO_OS == POCO_OS_LINUX
+#include <sys/sendfile.h>
+#endif
 
 
 namespace Poco {
@@ -76,4 +82,76 @@ int StreamSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int StreamSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	SocketBufVec pending(buffers);
+	int sent = 0;
+	bool blocking = getBlocking();
+	for (;;)
+	{
+		int n = SocketImpl::sendBytes(pending, flags);
+		poco_assert_dbg (n >= 0);
+		sent += n;
+		std::size_t rest = static_cast<std::size_t>(n);
+		SocketBufVec::iterator it = pending.begin();
+		while (it != pending.end() && Socket::bufferLength(*it) <= rest)
+		{
+			rest -= Socket::bufferLength(*it);
+			++it;
+		}
+		pending.erase(pending.begin(), it);
+		if (pending.empty()) break;
+#if defined(POCO_OS_FAMILY_WINDOWS)
+		pending.front().buf += rest;
+		pending.front().len -= static_cast<ULONG>(rest);
+#else
+		pending.front().iov_base = static_cast<char*>(pending.front().iov_base) + rest;
+		pending.front().iov_len -= rest;
+#endif
+		if (blocking)
+			Poco::Thread::yield();
+		else
+			break;
+	}
+	return sent;
+}
+
+
+Poco::Int64 StreamSocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+#if POCO_OS == POCO_OS_LINUX
+	const Poco::UInt64 MAX_CHUNK = 0x7ffff000; // maximum transferred by one sendfile() call
+
+	off_t pos = static_cast<off_t>(offset);
+	Poco::Int64 sent = 0;
+	while (static_cast<Poco::UInt64>(sent) < count)
+	{
+		Poco::UInt64 chunk = count - sent;
+		if (chunk > MAX_CHUNK) chunk = MAX_CHUNK;
+		ssize_t rc;
+		do
+		{
+			if (sockfd() == POCO_INVALID_SOCKET) throw InvalidSocketException();
+			rc = ::sendfile(sockfd(), istr.nativeHandle(), &pos, static_cast<std::size_t>(chunk));
+		}
+		while (rc < 0 && lastError() == POCO_EINTR);
+		if (rc < 0)
+		{
+			int err = lastError();
+			if (sent == 0 && (err == EINVAL || err == ENOSYS))
+				return SocketImpl::sendFile(istr, offset, count);
+			else if (sent > 0 && err == POCO_EAGAIN && !getBlocking())
+				break;
+			error(err);
+		}
+		if (rc == 0) break; // end of file
+		sent += rc;
+	}
+	return sent;
+#else
+	return SocketImpl::sendFile(istr, offset, count);
+#endif
+}
+
+
 } } // namespace Poco::Net
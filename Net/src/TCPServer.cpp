@@ -40,24 +40,53 @@ TCPServerConnectionFilter::~TCPServerConnectionFilter()
 }
 
 
+//
+// TCPServer::Acceptor
+//
+
+
+struct TCPServer::Acceptor
+	/// An additional listening socket (bound using SO_REUSEPORT)
+	/// together with its acceptor thread and worker group.
+{
+	Acceptor(TCPServer* pSrv, const ServerSocket& sock, TCPServerDispatcher* pDisp):
+		pServer(pSrv),
+		socket(sock),
+		pDispatcher(pDisp),
+		thread(TCPServer::threadName(sock))
+	{
+	}
+
+	~Acceptor()
+	{
+		pDispatcher->release();
+	}
+
+	TCPServer* pServer;
+	ServerSocket socket;
+	TCPServerDispatcher* pDispatcher;
+	Poco::Thread thread;
+};
+
+
 //
 // TCPServer
 //
 
 
 TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::UInt16 portNumber, TCPServerParams::Ptr pParams):
-	_socket(ServerSocket(portNumber)),
+	_socket(createSocket(portNumber, pParams)),
 	_thread(threadName(_socket)),
 	_stopped(true)
 {	
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
 	if (pParams)
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*pParams->getAcceptorCount() - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
 	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
-	
+	createAcceptors(pFactory, pool, pParams);
 }
 
 
@@ -69,10 +98,11 @@ TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, const ServerSocke
 	Poco::ThreadPool& pool = Poco::ThreadPool::defaultPool();
 	if (pParams)
 	{
-		int toAdd = pParams->getMaxThreads() - pool.capacity();
+		int toAdd = pParams->getMaxThreads()*pParams->getAcceptorCount() - pool.capacity();
 		if (toAdd > 0) pool.addCapacity(toAdd);
 	}
 	_pDispatcher = new TCPServerDispatcher(pFactory, pool, pParams);
+	createAcceptors(pFactory, pool, pParams);
 }
 
 
@@ -82,6 +112,7 @@ TCPServer::TCPServer(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool&
 	_thread(threadName(socket)),
 	_stopped(true)
 {
+	createAcceptors(pFactory, threadPool, pParams);
 }
 
 
@@ -90,6 +121,7 @@ TCPServer::~TCPServer()
 	try
 	{
 		stop();
+		destroyAcceptors();
 		_pDispatcher->release();
 	}
 	catch (...)
@@ -111,6 +143,10 @@ void TCPServer::start()
 
 	_stopped = false;
 	_thread.start(*this);
+	for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		(*it)->thread.start(runAcceptor, *it);
+	}
 }
 
 	
@@ -120,23 +156,44 @@ void TCPServer::stop()
 	{
 		_stopped = true;
 		_thread.join();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->thread.join();
+		}
 		_pDispatcher->stop();
+		for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+		{
+			(*it)->pDispatcher->stop();
+		}
 	}
 }
 
 
 void TCPServer::run()
+{
+	acceptConnections(_socket, _pDispatcher);
+}
+
+
+void TCPServer::runAcceptor(void* pData)
+{
+	Acceptor* pAcceptor = reinterpret_cast<Acceptor*>(pData);
+	pAcceptor->pServer->acceptConnections(pAcceptor->socket, pAcceptor->pDispatcher);
+}
+
+
+void TCPServer::acceptConnections(ServerSocket& socket, TCPServerDispatcher* pDispatcher)
 {
 	while (!_stopped)
 	{
 		Poco::Timespan timeout(250000);
 		try
 		{
-			if (_socket.poll(timeout, Socket::SELECT_READ))
+			if (socket.poll(timeout, Socket::SELECT_READ))
 			{
 				try
 				{
-					StreamSocket ss = _socket.acceptConnection();
+					StreamSocket ss = socket.acceptConnection();
 					
 					if (!_pConnectionFilter || _pConnectionFilter->accept(ss))
 					{
@@ -147,7 +204,7 @@ void TCPServer::run()
 						{
 							ss.setNoDelay(true);
 						}
-						_pDispatcher->enqueue(ss);
+						pDispatcher->enqueue(ss);
 					}
 				}
 				catch (Poco::Exception& exc)
@@ -177,43 +234,78 @@ void TCPServer::run()
 
 int TCPServer::currentThreads() const
 {
-	return _pDispatcher->currentThreads();
+	int result = _pDispatcher->currentThreads();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->currentThreads();
+	}
+	return result;
 }
 
 
 int TCPServer::maxThreads() const
 {
-	return _pDispatcher->maxThreads();
+	int result = _pDispatcher->maxThreads();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->maxThreads();
+	}
+	return result;
 }
 
 	
 int TCPServer::totalConnections() const
 {
-	return _pDispatcher->totalConnections();
+	int result = _pDispatcher->totalConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->totalConnections();
+	}
+	return result;
 }
 
 
 int TCPServer::currentConnections() const
 {
-	return _pDispatcher->currentConnections();
+	int result = _pDispatcher->currentConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->currentConnections();
+	}
+	return result;
 }
 
 
 int TCPServer::maxConcurrentConnections() const
 {
-	return _pDispatcher->maxConcurrentConnections();
+	int result = _pDispatcher->maxConcurrentConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->maxConcurrentConnections();
+	}
+	return result;
 }
 
 	
 int TCPServer::queuedConnections() const
 {
-	return _pDispatcher->queuedConnections();
+	int result = _pDispatcher->queuedConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->queuedConnections();
+	}
+	return result;
 }
 
 
 int TCPServer::refusedConnections() const
 {
-	return _pDispatcher->refusedConnections();
+	int result = _pDispatcher->refusedConnections();
+	for (AcceptorVec::const_iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		result += (*it)->pDispatcher->refusedConnections();
+	}
+	return result;
 }
 
 
@@ -225,6 +317,59 @@ void TCPServer::setConnectionFilter(const TCPServerConnectionFilter::Ptr& pConne
 }
 
 
+void TCPServer::createAcceptors(TCPServerConnectionFactory::Ptr pFactory, Poco::ThreadPool& threadPool, TCPServerParams::Ptr pParams)
+{
+	int count = _pDispatcher->params().getAcceptorCount();
+	if (count <= 1) return;
+
+	try
+	{
+		SocketAddress address = _socket.address();
+		for (int i = 1; i < count; i++)
+		{
+			ServerSocket socket;
+#if defined(POCO_HAVE_IPv6)
+			if (address.family() == SocketAddress::IPv6)
+				socket.bind6(address, true, true, false);
+			else
+#endif
+				socket.bind(address, true, true);
+			socket.listen();
+			_acceptors.push_back(new Acceptor(this, socket, new TCPServerDispatcher(pFactory, threadPool, pParams)));
+		}
+	}
+	catch (...)
+	{
+		destroyAcceptors();
+		_pDispatcher->release();
+		throw;
+	}
+}
+
+
+void TCPServer::destroyAcceptors()
+{
+	for (AcceptorVec::iterator it = _acceptors.begin(); it != _acceptors.end(); ++it)
+	{
+		delete *it;
+	}
+	_acceptors.clear();
+}
+
+
+ServerSocket TCPServer::createSocket(Poco::UInt16 portNumber, TCPServerParams::Ptr pParams)
+{
+	if (pParams && pParams->getAcceptorCount() > 1)
+	{
+		ServerSocket socket;
+		socket.bind(portNumber, true, true);
+		socket.listen();
+		return socket;
+	}
+	else return ServerSocket(portNumber);
+}
+
+
 std::string TCPServer::threadName(const ServerSocket& socket)
 {
 #if _WIN32_WCE == 0x0800
@@ -18,6 +18,7 @@
 #include "Poco/Net/TCPServerConnectionFactory.h"
 #include "Poco/Notification.h"
 #include "Poco/AutoPtr.h"
+#include "Poco/Clock.h"
 #include <memory>
 
 
@@ -47,8 +48,14 @@ public:
 		return _socket;
 	}
 
+	const Poco::Clock& enqueued() const
+	{
+		return _enqueued;
+	}
+
 private:
 	StreamSocket _socket;
+	Poco::Clock _enqueued;
 };
 
 
@@ -61,6 +68,7 @@ TCPServerDispatcher::TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactor
 	_maxConcurrentConnections(0),
 	_refusedConnections(0),
 	_stopped(false),
+	_pLockFreeQueue(0),
 	_pConnectionFactory(pFactory),
 	_threadPool(threadPool)
 {
@@ -68,14 +76,20 @@ TCPServerDispatcher::TCPServerDispatcher(TCPServerConnectionFactory::Ptr pFactor
 
 	if (!_pParams)
 		_pParams = new TCPServerParams;
+
+	_pStatistics = _pParams->getStatistics();
 	
 	if (_pParams->getMaxThreads() == 0)
 		_pParams->setMaxThreads(threadPool.capacity());
+
+	if (_pParams->getLockFreeQueue())
+		_pLockFreeQueue = new Poco::LockFreeNotificationQueue(_pParams->getMaxQueued());
 }
 
 
 TCPServerDispatcher::~TCPServerDispatcher()
 {
+	delete _pLockFreeQueue;
 }
 
 
@@ -104,7 +118,7 @@ void TCPServerDispatcher::run()
 
 	for (;;)
 	{
-		AutoPtr<Notification> pNf = _queue.waitDequeueNotification(idleTime);
+		AutoPtr<Notification> pNf = waitDequeue(idleTime);
 		if (pNf)
 		{
 			TCPConnectionNotification* pCNf = dynamic_cast<TCPConnectionNotification*>(pNf.get());
@@ -117,13 +131,21 @@ void TCPServerDispatcher::run()
 #endif
 				poco_check_ptr(pConnection.get());
 				beginConnection();
-				pConnection->start();
+				if (_pStatistics)
+				{
+					_pStatistics->queueWaitTime().recordElapsed(pCNf->enqueued());
+					Poco::Clock start;
+					pConnection->start();
+					_pStatistics->connections().add();
+					_pStatistics->connectionTime().recordElapsed(start);
+				}
+				else pConnection->start();
 				endConnection();
 			}
 		}
 	
 		FastMutex::ScopedLock lock(_mutex);
-		if (_stopped || (_currentThreads > 1 && _queue.empty()))
+		if (_stopped || (_currentThreads > 1 && queueEmpty()))
 		{
 			--_currentThreads;
 			break;
@@ -140,6 +162,38 @@ namespace
 	
 void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 {
+	if (_pLockFreeQueue)
+	{
+		if (_pLockFreeQueue->size() < _pParams->getMaxQueued() && _pLockFreeQueue->tryEnqueueNotification(new TCPConnectionNotification(socket)))
+		{
+			// the dispatcher's mutex is only needed if
+			// a new connection thread must be started
+			if (!_pLockFreeQueue->hasIdleThreads())
+			{
+				FastMutex::ScopedLock lock(_mutex);
+				if (_currentThreads < _pParams->getMaxThreads())
+				{
+					try
+					{
+						_threadPool.startWithPriority(_pParams->getThreadPriority(), *this, threadName);
+						++_currentThreads;
+					}
+					catch (Poco::Exception&)
+					{
+						// no problem here, connection is already queued
+						// and a new thread might be available later.
+					}
+				}
+			}
+		}
+		else
+		{
+			FastMutex::ScopedLock lock(_mutex);
+			++_refusedConnections;
+		}
+		return;
+	}
+
 	FastMutex::ScopedLock lock(_mutex);
 
 	if (_queue.size() < _pParams->getMaxQueued())
@@ -169,8 +223,16 @@ void TCPServerDispatcher::enqueue(const StreamSocket& socket)
 void TCPServerDispatcher::stop()
 {
 	_stopped = true;
-	_queue.clear();
-	_queue.wakeUpAll();
+	if (_pLockFreeQueue)
+	{
+		_pLockFreeQueue->clear();
+		_pLockFreeQueue->wakeUpAll();
+	}
+	else
+	{
+		_queue.clear();
+		_queue.wakeUpAll();
+	}
 }
 
 
@@ -215,7 +277,7 @@ int TCPServerDispatcher::maxConcurrentConnections() const
 
 int TCPServerDispatcher::queuedConnections() const
 {
-	return _queue.size();
+	return _pLockFreeQueue ? _pLockFreeQueue->size() : _queue.size();
 }
 
 
@@ -246,4 +308,19 @@ void TCPServerDispatcher::endConnection()
 }
 
 
+Poco::Notification* TCPServerDispatcher::waitDequeue(long milliseconds)
+{
+	if (_pLockFreeQueue)
+		return _pLockFreeQueue->waitDequeueNotification(milliseconds);
+	else
+		return _queue.waitDequeueNotification(milliseconds);
+}
+
+
+bool TCPServerDispatcher::queueEmpty() const
+{
+	return _pLockFreeQueue ? _pLockFreeQueue->empty() : _queue.empty();
+}
+
+
 } } // namespace Poco::Net
@@ -25,7 +25,9 @@ TCPServerParams::TCPServerParams():
 	_threadIdleTime(10000000),
 	_maxThreads(0),
 	_maxQueued(64),
-	_threadPriority(Poco::Thread::PRIO_NORMAL)
+	_threadPriority(Poco::Thread::PRIO_NORMAL),
+	_acceptorCount(1),
+	_lockFreeQueue(false)
 {
 }
 
@@ -63,4 +65,24 @@ void TCPServerParams::setThreadPriority(Poco::Thread::Priority prio)
 }
 
 
+void TCPServerParams::setAcceptorCount(int count)
+{
+	poco_assert (count > 0);
+
+	_acceptorCount = count;
+}
+
+
+void TCPServerParams::setLockFreeQueue(bool flag)
+{
+	_lockFreeQueue = flag;
+}
+
+
+void TCPServerParams::setStatistics(ServerStatistics::Ptr pStatistics)
+{
+	_pStatistics = pStatistics;
+}
+
+
 } } // namespace Poco::Net
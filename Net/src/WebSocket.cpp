@@ -59,6 +59,24 @@ WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse&
 }
 
 
+WebSocket::WebSocket(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(accept(request, response, &deflateParams))
+{
+}
+
+
+WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(connect(cs, request, response, _defaultCreds, &deflateParams))
+{
+}
+
+
+WebSocket::WebSocket(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params& deflateParams):
+	StreamSocket(connect(cs, request, response, credentials, &deflateParams))
+{
+}
+
+
 WebSocket::WebSocket(const Socket& socket): 
 	StreamSocket(socket)
 {
@@ -122,13 +140,39 @@ int WebSocket::receiveFrame(Poco::Buffer<char>& buffer, int& flags)
 }
 
 
+int WebSocket::receiveFrameInto(Poco::Buffer<char>& buffer, int& flags)
+{
+	int n = static_cast<WebSocketImpl*>(impl())->receiveFrame(buffer);
+	flags = static_cast<WebSocketImpl*>(impl())->frameFlags();
+	return n;
+}
+
+
+void WebSocket::setMaxPayloadSize(int maxPayloadSize)
+{
+	static_cast<WebSocketImpl*>(impl())->setMaxPayloadSize(maxPayloadSize);
+}
+
+
+int WebSocket::getMaxPayloadSize() const
+{
+	return static_cast<WebSocketImpl*>(impl())->getMaxPayloadSize();
+}
+
+
 WebSocket::Mode WebSocket::mode() const
 {
 	return static_cast<WebSocketImpl*>(impl())->mustMaskPayload() ? WS_CLIENT : WS_SERVER;
 }
 
 
-WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response)
+bool WebSocket::perMessageDeflate() const
+{
+	return static_cast<WebSocketImpl*>(impl())->perMessageDeflate() != 0;
+}
+
+
+WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse& response, const WebSocketDeflate::Params* pDeflateParams)
 {
 	if (request.hasToken("Connection", "upgrade") && icompare(request.get("Upgrade", ""), "websocket") == 0)
 	{
@@ -143,17 +187,22 @@ WebSocketImpl* WebSocket::accept(HTTPServerRequest& request, HTTPServerResponse&
 		response.set("Upgrade", "websocket");
 		response.set("Connection", "Upgrade");
 		response.set("Sec-WebSocket-Accept", computeAccept(key));
+		WebSocketDeflate::Params agreed;
+		bool deflate = pDeflateParams && WebSocketDeflate::negotiate(extensions(request), *pDeflateParams, agreed);
+		if (deflate)
+			response.set(WebSocketDeflate::EXTENSIONS_HEADER, WebSocketDeflate::formatResponse(agreed));
 		response.setContentLength(0);
 		response.send().flush();
 		
 		HTTPServerRequestImpl& requestImpl = static_cast<HTTPServerRequestImpl&>(request);
-		return new WebSocketImpl(static_cast<StreamSocketImpl*>(requestImpl.detachSocket().impl()), requestImpl.session(), false);
+		WebSocketDeflate* pDeflate = deflate ? new WebSocketDeflate(agreed, false) : 0;
+		return new WebSocketImpl(static_cast<StreamSocketImpl*>(requestImpl.detachSocket().impl()), requestImpl.session(), false, pDeflate);
 	}
 	else throw WebSocketException("No WebSocket handshake", WS_ERR_NO_HANDSHAKE);
 }
 
 
-WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials)
+WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, HTTPResponse& response, HTTPCredentials& credentials, const WebSocketDeflate::Params* pDeflateParams)
 {
 	if (!cs.getProxyHost().empty() && !cs.secure())
 	{
@@ -164,13 +213,15 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 	request.set("Upgrade", "websocket");
 	request.set("Sec-WebSocket-Version", WEBSOCKET_VERSION);
 	request.set("Sec-WebSocket-Key", key);
+	if (pDeflateParams)
+		request.set(WebSocketDeflate::EXTENSIONS_HEADER, WebSocketDeflate::formatOffer(*pDeflateParams));
 	request.setChunkedTransferEncoding(false);
 	cs.setKeepAlive(true);
 	cs.sendRequest(request);
 	std::istream& istr = cs.receiveResponse(response);
 	if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 	{
-		return completeHandshake(cs, response, key);
+		return completeHandshake(cs, response, key, pDeflateParams);
 	}
 	else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 	{
@@ -186,7 +237,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 		cs.receiveResponse(response);
 		if (response.getStatus() == HTTPResponse::HTTP_SWITCHING_PROTOCOLS)
 		{
-			return completeHandshake(cs, response, key);
+			return completeHandshake(cs, response, key, pDeflateParams);
 		}
 		else if (response.getStatus() == HTTPResponse::HTTP_UNAUTHORIZED)
 		{
@@ -204,7 +255,7 @@ WebSocketImpl* WebSocket::connect(HTTPClientSession& cs, HTTPRequest& request, H
 }
 
 
-WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key)
+WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse& response, const std::string& key, const WebSocketDeflate::Params* pDeflateParams)
 {
 	std::string connection = response.get("Connection", "");
 	if (Poco::icompare(connection, "Upgrade") != 0) 
@@ -215,7 +266,25 @@ WebSocketImpl* WebSocket::completeHandshake(HTTPClientSession& cs, HTTPResponse&
 	std::string accept = response.get("Sec-WebSocket-Accept", "");
 	if (accept != computeAccept(key))
 		throw WebSocketException("Invalid or missing Sec-WebSocket-Accept header in handshake response", WS_ERR_HANDSHAKE_ACCEPT);
-	return new WebSocketImpl(static_cast<StreamSocketImpl*>(cs.detachSocket().impl()), cs, true);
+	WebSocketDeflate::Params agreed;
+	WebSocketDeflate* pDeflate = 0;
+	if (pDeflateParams && WebSocketDeflate::accept(extensions(response), *pDeflateParams, agreed))
+		pDeflate = new WebSocketDeflate(agreed, true);
+	return new WebSocketImpl(static_cast<StreamSocketImpl*>(cs.detachSocket().impl()), cs, true, pDeflate);
+}
+
+
+std::string WebSocket::extensions(const HTTPMessage& message)
+{
+	std::string result;
+	NameValueCollection::ConstIterator it = message.find(WebSocketDeflate::EXTENSIONS_HEADER);
+	while (it != message.end() && Poco::icompare(it->first, WebSocketDeflate::EXTENSIONS_HEADER) == 0)
+	{
+		if (!result.empty()) result += ", ";
+		result += it->second;
+		++it;
+	}
+	return result;
 }
 
 
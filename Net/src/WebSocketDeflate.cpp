@@ -0,0 +1,369 @@
+//
+// WebSocketDeflate.cpp
+//
+// $Id$
+//
+// Library: Net
+// Package: WebSocket
+// Module:  WebSocketDeflate
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/WebSocketDeflate.h"
+#include "Poco/Net/WebSocket.h"
+#include "Poco/Net/MessageHeader.h"
+#include "Poco/Net/NameValueCollection.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/NumberParser.h"
+#include "Poco/String.h"
+#include "Poco/Exception.h"
+#include <vector>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+namespace
+{
+	enum Parameter
+	{
+		PARAM_SERVER_NO_CONTEXT_TAKEOVER = 0x01,
+		PARAM_CLIENT_NO_CONTEXT_TAKEOVER = 0x02,
+		PARAM_SERVER_MAX_WINDOW_BITS     = 0x04,
+		PARAM_CLIENT_MAX_WINDOW_BITS     = 0x08
+	};
+
+	int parameter(const std::string& name)
+	{
+		if (Poco::icompare(name, "server_no_context_takeover") == 0)
+			return PARAM_SERVER_NO_CONTEXT_TAKEOVER;
+		else if (Poco::icompare(name, "client_no_context_takeover") == 0)
+			return PARAM_CLIENT_NO_CONTEXT_TAKEOVER;
+		else if (Poco::icompare(name, "server_max_window_bits") == 0)
+			return PARAM_SERVER_MAX_WINDOW_BITS;
+		else if (Poco::icompare(name, "client_max_window_bits") == 0)
+			return PARAM_CLIENT_MAX_WINDOW_BITS;
+		else
+			return 0;
+	}
+
+	bool parseWindowBits(const std::string& value, int& bits)
+	{
+		return Poco::NumberParser::tryParse(value, bits) && bits >= WebSocketDeflate::MIN_WINDOW_BITS && bits <= WebSocketDeflate::MAX_WINDOW_BITS;
+	}
+
+	int rawWindowBits(int bits)
+	{
+		// zlib does not support a window size of 256 bytes for raw deflate.
+		return bits < 9 ? -9 : -bits;
+	}
+
+	const char EMPTY_BLOCK_TAIL[] = { '\x00', '\x00', '\xff', '\xff' };
+}
+
+
+const std::string WebSocketDeflate::EXTENSION("permessage-deflate");
+const std::string WebSocketDeflate::EXTENSIONS_HEADER("Sec-WebSocket-Extensions");
+
+
+WebSocketDeflate::Params::Params():
+	serverNoContextTakeover(false),
+	clientNoContextTakeover(false),
+	serverMaxWindowBits(MAX_WINDOW_BITS),
+	clientMaxWindowBits(MAX_WINDOW_BITS),
+	compressionLevel(Z_DEFAULT_COMPRESSION)
+{
+}
+
+
+WebSocketDeflate::WebSocketDeflate(const Params& params, bool client):
+	_params(params),
+	_client(client),
+	_inflateEnd(false)
+{
+	std::memset(&_deflateStream, 0, sizeof(_deflateStream));
+	std::memset(&_inflateStream, 0, sizeof(_inflateStream));
+	_deflateStream.zalloc = Z_NULL;
+	_deflateStream.zfree  = Z_NULL;
+	_deflateStream.opaque = Z_NULL;
+	_inflateStream.zalloc = Z_NULL;
+	_inflateStream.zfree  = Z_NULL;
+	_inflateStream.opaque = Z_NULL;
+
+	int deflateBits = client ? params.clientMaxWindowBits : params.serverMaxWindowBits;
+	int inflateBits = client ? params.serverMaxWindowBits : params.clientMaxWindowBits;
+	int rc = deflateInit2(&_deflateStream, params.compressionLevel, Z_DEFLATED, rawWindowBits(deflateBits), 8, Z_DEFAULT_STRATEGY);
+	if (rc != Z_OK) throw IOException(zError(rc));
+	// A larger window than the peer's one is always safe for inflating.
+	rc = inflateInit2(&_inflateStream, rawWindowBits(inflateBits));
+	if (rc != Z_OK)
+	{
+		deflateEnd(&_deflateStream);
+		throw IOException(zError(rc));
+	}
+}
+
+
+WebSocketDeflate::~WebSocketDeflate()
+{
+	deflateEnd(&_deflateStream);
+	inflateEnd(&_inflateStream);
+}
+
+
+void WebSocketDeflate::deflate(const char* pData, std::size_t length, bool fin, Poco::Buffer<char>& out)
+{
+	// The bound does not include the empty block appended by Z_SYNC_FLUSH.
+	out.resize(::deflateBound(&_deflateStream, static_cast<uLong>(length)) + 16, false);
+	_deflateStream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(pData));
+	_deflateStream.avail_in = static_cast<uInt>(length);
+	std::size_t n = 0;
+	for (;;)
+	{
+		_deflateStream.next_out  = reinterpret_cast<Bytef*>(out.begin() + n);
+		_deflateStream.avail_out = static_cast<uInt>(out.size() - n);
+		int rc = ::deflate(&_deflateStream, Z_SYNC_FLUSH);
+		if (rc != Z_OK && rc != Z_BUF_ERROR) throw IOException(zError(rc));
+		n = out.size() - _deflateStream.avail_out;
+		if (_deflateStream.avail_out > 0) break;
+		out.resize(2*out.size());
+	}
+
+	if (fin)
+	{
+		if (n >= sizeof(EMPTY_BLOCK_TAIL) && std::memcmp(out.begin() + n - sizeof(EMPTY_BLOCK_TAIL), EMPTY_BLOCK_TAIL, sizeof(EMPTY_BLOCK_TAIL)) == 0)
+			n -= sizeof(EMPTY_BLOCK_TAIL);
+		// zlib produces no output for an empty message following
+		// a flush, but the payload must be a valid DEFLATE block.
+		if (n == 0) out[n++] = 0;
+		if (_client ? _params.clientNoContextTakeover : _params.serverNoContextTakeover)
+			::deflateReset(&_deflateStream);
+	}
+	out.resize(n);
+}
+
+
+void WebSocketDeflate::inflate(const char* pData, std::size_t length, bool fin, Poco::Buffer<char>& out, std::size_t maxSize)
+{
+	inflateImpl(pData, length, out, maxSize);
+	if (fin)
+	{
+		inflateImpl(EMPTY_BLOCK_TAIL, sizeof(EMPTY_BLOCK_TAIL), out, maxSize);
+		if (_inflateEnd || (_client ? _params.serverNoContextTakeover : _params.clientNoContextTakeover))
+			::inflateReset(&_inflateStream);
+		_inflateEnd = false;
+	}
+}
+
+
+void WebSocketDeflate::inflateImpl(const char* pData, std::size_t length, Poco::Buffer<char>& out, std::size_t maxSize)
+{
+	// Data following a final block is ignored.
+	if (_inflateEnd) return;
+
+	_inflateStream.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(pData));
+	_inflateStream.avail_in = static_cast<uInt>(length);
+	std::size_t n = out.size();
+	for (;;)
+	{
+		if (n > maxSize)
+			throw WebSocketException("Decompressed payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+
+		// At most one byte more than allowed is decompressed,
+		// which is sufficient to detect an oversized payload.
+		std::size_t room = maxSize - n + 1;
+		std::size_t minRoom = room < INFLATE_BUFFER_SIZE ? room : INFLATE_BUFFER_SIZE;
+		if (out.capacity() - n < minRoom)
+		{
+			std::size_t capacity = 2*out.capacity();
+			if (capacity < n + INFLATE_BUFFER_SIZE) capacity = n + INFLATE_BUFFER_SIZE;
+			if (capacity - n > room) capacity = n + room;
+			out.setCapacity(capacity);
+		}
+		std::size_t avail = out.capacity() - n;
+		if (avail > room) avail = room;
+		out.resize(n + avail);
+		_inflateStream.next_out  = reinterpret_cast<Bytef*>(out.begin() + n);
+		_inflateStream.avail_out = static_cast<uInt>(avail);
+		int rc = ::inflate(&_inflateStream, Z_SYNC_FLUSH);
+		n = out.size() - _inflateStream.avail_out;
+		out.resize(n);
+		if (n > maxSize)
+			throw WebSocketException("Decompressed payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+		if (rc == Z_STREAM_END)
+		{
+			_inflateEnd = true;
+			break;
+		}
+		if (rc != Z_OK && rc != Z_BUF_ERROR)
+			throw WebSocketException("Invalid compressed payload", WebSocket::WS_ERR_COMPRESSION);
+		if (_inflateStream.avail_out > 0) break;
+	}
+}
+
+
+std::string WebSocketDeflate::formatOffer(const Params& params)
+{
+	std::string offer(EXTENSION);
+	if (params.serverNoContextTakeover)
+		offer += "; server_no_context_takeover";
+	if (params.clientNoContextTakeover)
+		offer += "; client_no_context_takeover";
+	if (params.serverMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		offer += "; server_max_window_bits=";
+		Poco::NumberFormatter::append(offer, params.serverMaxWindowBits);
+	}
+	// The server may limit our window size in any case.
+	offer += "; client_max_window_bits";
+	if (params.clientMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		offer += "=";
+		Poco::NumberFormatter::append(offer, params.clientMaxWindowBits);
+	}
+	return offer;
+}
+
+
+std::string WebSocketDeflate::formatResponse(const Params& params)
+{
+	std::string response(EXTENSION);
+	if (params.serverNoContextTakeover)
+		response += "; server_no_context_takeover";
+	if (params.clientNoContextTakeover)
+		response += "; client_no_context_takeover";
+	if (params.serverMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		response += "; server_max_window_bits=";
+		Poco::NumberFormatter::append(response, params.serverMaxWindowBits);
+	}
+	if (params.clientMaxWindowBits < MAX_WINDOW_BITS)
+	{
+		response += "; client_max_window_bits=";
+		Poco::NumberFormatter::append(response, params.clientMaxWindowBits);
+	}
+	return response;
+}
+
+
+bool WebSocketDeflate::negotiate(const std::string& offers, const Params& params, Params& agreed)
+{
+	std::vector<std::string> elements;
+	MessageHeader::splitElements(offers, elements);
+	for (std::vector<std::string>::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		std::string extension;
+		NameValueCollection parameters;
+		MessageHeader::splitParameters(*it, extension, parameters);
+		if (Poco::icompare(extension, EXTENSION) != 0) continue;
+
+		Params result(params);
+		int clientMaxWindowBits = MAX_WINDOW_BITS;
+		int seen = 0;
+		bool valid = true;
+		for (NameValueCollection::ConstIterator itParam = parameters.begin(); valid && itParam != parameters.end(); ++itParam)
+		{
+			int param = parameter(itParam->first);
+			valid = param != 0 && (seen & param) == 0;
+			seen |= param;
+			switch (param)
+			{
+			case PARAM_SERVER_NO_CONTEXT_TAKEOVER:
+				valid = valid && itParam->second.empty();
+				result.serverNoContextTakeover = true;
+				break;
+			case PARAM_CLIENT_NO_CONTEXT_TAKEOVER:
+				valid = valid && itParam->second.empty();
+				result.clientNoContextTakeover = true;
+				break;
+			case PARAM_SERVER_MAX_WINDOW_BITS:
+				{
+					int bits;
+					valid = valid && parseWindowBits(itParam->second, bits);
+					if (valid && bits < result.serverMaxWindowBits) result.serverMaxWindowBits = bits;
+				}
+				break;
+			case PARAM_CLIENT_MAX_WINDOW_BITS:
+				valid = valid && (itParam->second.empty() || parseWindowBits(itParam->second, clientMaxWindowBits));
+				break;
+			}
+		}
+		if (!valid || result.serverMaxWindowBits < 9) continue;
+
+		// The client's window size can only be limited
+		// if the client has offered to accept a limit.
+		if (!(seen & PARAM_CLIENT_MAX_WINDOW_BITS))
+			result.clientMaxWindowBits = MAX_WINDOW_BITS;
+		else if (clientMaxWindowBits < result.clientMaxWindowBits)
+			result.clientMaxWindowBits = clientMaxWindowBits;
+
+		agreed = result;
+		return true;
+	}
+	return false;
+}
+
+
+bool WebSocketDeflate::accept(const std::string& response, const Params& offered, Params& agreed)
+{
+	std::vector<std::string> elements;
+	MessageHeader::splitElements(response, elements);
+	bool found = false;
+	for (std::vector<std::string>::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		std::string extension;
+		NameValueCollection parameters;
+		MessageHeader::splitParameters(*it, extension, parameters);
+		if (Poco::icompare(extension, EXTENSION) != 0) continue;
+		if (found) throw WebSocketException("Duplicate permessage-deflate extension in handshake response", WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+		found = true;
+
+		Params result(offered);
+		result.serverNoContextTakeover = false;
+		result.serverMaxWindowBits = MAX_WINDOW_BITS;
+		int seen = 0;
+		for (NameValueCollection::ConstIterator itParam = parameters.begin(); itParam != parameters.end(); ++itParam)
+		{
+			int param = parameter(itParam->first);
+			if (param == 0 || (seen & param) != 0)
+				throw WebSocketException("Invalid permessage-deflate parameter in handshake response", itParam->first, WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+			seen |= param;
+			bool valid = true;
+			int bits = MAX_WINDOW_BITS;
+			switch (param)
+			{
+			case PARAM_SERVER_NO_CONTEXT_TAKEOVER:
+				valid = itParam->second.empty();
+				result.serverNoContextTakeover = true;
+				break;
+			case PARAM_CLIENT_NO_CONTEXT_TAKEOVER:
+				valid = itParam->second.empty();
+				result.clientNoContextTakeover = true;
+				break;
+			case PARAM_SERVER_MAX_WINDOW_BITS:
+				valid = parseWindowBits(itParam->second, bits) && bits <= offered.serverMaxWindowBits;
+				result.serverMaxWindowBits = bits;
+				break;
+			case PARAM_CLIENT_MAX_WINDOW_BITS:
+				valid = parseWindowBits(itParam->second, bits) && bits >= 9;
+				if (bits < result.clientMaxWindowBits) result.clientMaxWindowBits = bits;
+				break;
+			}
+			if (!valid)
+				throw WebSocketException("Invalid permessage-deflate parameter in handshake response", itParam->first, WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+		}
+		agreed = result;
+	}
+	return found;
+}
+
+
+} } // namespace Poco::Net
@@ -19,24 +19,43 @@
 #include "Poco/Net/WebSocket.h"
 #include "Poco/Net/HTTPSession.h"
 #include "Poco/Buffer.h"
-#include "Poco/BinaryWriter.h"
 #include "Poco/BinaryReader.h"
 #include "Poco/MemoryStream.h"
 #include "Poco/Format.h"
+#include "Poco/ByteOrder.h"
 #include <cstring>
+#include <limits>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define POCO_WEBSOCKET_AVX2
+#define POCO_WEBSOCKET_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define POCO_WEBSOCKET_SSE2
+#endif
 
 
 namespace Poco {
 namespace Net {
 
 
-WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload):
+WebSocketImpl::WebSocketImpl(StreamSocketImpl* pStreamSocketImpl, HTTPSession& session, bool mustMaskPayload, WebSocketDeflate* pDeflate):
 	StreamSocketImpl(pStreamSocketImpl->sockfd()),
 	_pStreamSocketImpl(pStreamSocketImpl),
 	_buffer(0),
 	_bufferOffset(0),
+	_sendBuffer(0),
+	_sendBuffers(2),
+	_receiveBuffers(2),
 	_frameFlags(0),
-	_mustMaskPayload(mustMaskPayload)
+	_maxPayloadSize(std::numeric_limits<int>::max()),
+	_mustMaskPayload(mustMaskPayload),
+	_pDeflate(pDeflate),
+	_deflateBuffer(0),
+	_inflateBuffer(0),
+	_inflatedBuffer(0),
+	_deflating(false),
+	_inflating(false)
 {
 	poco_check_ptr(pStreamSocketImpl);
 	_pStreamSocketImpl->duplicate();
@@ -50,6 +69,7 @@ WebSocketImpl::~WebSocketImpl()
 	{
 		_pStreamSocketImpl->release();
 		reset();
+		delete _pDeflate;
 	}
 	catch (...)
 	{
@@ -60,13 +80,38 @@ WebSocketImpl::~WebSocketImpl()
 	
 int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 {
-	Poco::Buffer<char> frame(length + MAX_HEADER_LENGTH);
-	Poco::MemoryOutputStream ostr(frame.begin(), frame.size());
-	Poco::BinaryWriter writer(ostr, Poco::BinaryWriter::NETWORK_BYTE_ORDER);
-	
 	if (flags == 0) flags = WebSocket::FRAME_BINARY;
 	flags &= 0xff;
-	writer << static_cast<Poco::UInt8>(flags);
+
+	// The send buffers, the mask generator and the compression state are
+	// shared by all senders, so frames are sent one at a time. This also
+	// keeps frames sent concurrently from different threads intact.
+	Poco::FastMutex::ScopedLock lock(_sendMutex);
+
+	if (_pDeflate && !(flags & WebSocket::FRAME_FLAG_RSV1))
+	{
+		int opcode = flags & WebSocket::FRAME_OP_BITMASK;
+		if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY || (opcode == WebSocket::FRAME_OP_CONT && _deflating))
+		{
+			bool fin = (flags & WebSocket::FRAME_FLAG_FIN) != 0;
+			_pDeflate->deflate(reinterpret_cast<const char*>(buffer), length, fin, _deflateBuffer);
+			// Only the first frame of a compressed message has the RSV1 bit set.
+			if (opcode != WebSocket::FRAME_OP_CONT) flags |= WebSocket::FRAME_FLAG_RSV1;
+			_deflating = !fin;
+			sendFrame(_deflateBuffer.begin(), static_cast<int>(_deflateBuffer.size()), flags);
+			return length;
+		}
+	}
+	return sendFrame(buffer, length, flags);
+}
+
+
+int WebSocketImpl::sendFrame(const void* buffer, int length, int flags)
+{
+	char header[MAX_HEADER_LENGTH];
+	int headerLength = 2;
+	
+	header[0] = static_cast<char>(flags);
 	Poco::UInt8 lengthByte(0);
 	if (_mustMaskPayload)
 	{
@@ -75,39 +120,101 @@ int WebSocketImpl::sendBytes(const void* buffer, int length, int flags)
 	if (length < 126)
 	{
 		lengthByte |= static_cast<Poco::UInt8>(length);
-		writer << lengthByte;
 	}
 	else if (length < 65536)
 	{
 		lengthByte |= 126;
-		writer << lengthByte << static_cast<Poco::UInt16>(length);
+		Poco::UInt16 l = Poco::ByteOrder::toNetwork(static_cast<Poco::UInt16>(length));
+		std::memcpy(header + headerLength, &l, sizeof(l));
+		headerLength += sizeof(l);
 	}
 	else
 	{
 		lengthByte |= 127;
-		writer << lengthByte << static_cast<Poco::UInt64>(length);
+		Poco::UInt64 l = Poco::ByteOrder::toNetwork(static_cast<Poco::UInt64>(length));
+		std::memcpy(header + headerLength, &l, sizeof(l));
+		headerLength += sizeof(l);
 	}
+	header[1] = static_cast<char>(lengthByte);
 	if (_mustMaskPayload)
 	{
 		const Poco::UInt32 mask = _rnd.next();
 		const char* m = reinterpret_cast<const char*>(&mask);
-		const char* b = reinterpret_cast<const char*>(buffer);
-		writer.writeRaw(m, 4);
-		char* p = frame.begin() + ostr.charsWritten();
-		for (int i = 0; i < length; i++)
-		{
-			p[i] = b[i] ^ m[i % 4];
-		}
+		std::memcpy(header + headerLength, m, 4);
+		headerLength += 4;
+		_sendBuffer.resize(headerLength + length, false);
+		std::memcpy(_sendBuffer.begin(), header, headerLength);
+		maskPayload(_sendBuffer.begin() + headerLength, reinterpret_cast<const char*>(buffer), length, m);
+		_pStreamSocketImpl->sendBytes(_sendBuffer.begin(), headerLength + length);
 	}
 	else
 	{
-		std::memcpy(frame.begin() + ostr.charsWritten(), buffer, length);
+		// The payload is sent along with the header, without copying it.
+		_sendBuffers[0] = Socket::makeBuffer(header, headerLength);
+		_sendBuffers[1] = Socket::makeBuffer(buffer, length);
+		_pStreamSocketImpl->sendBytes(_sendBuffers);
 	}
-	_pStreamSocketImpl->sendBytes(frame.begin(), length + static_cast<int>(ostr.charsWritten()));
 	return length;
 }
 
+
+int WebSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return sendGathered(buffers, flags);
+}
+
+
+Poco::Int64 WebSocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return SocketImpl::sendFile(istr, offset, count);
+}
+
 	
+int WebSocketImpl::parseHeader(const char* pHeader, int length, int& payloadLength, char mask[4], bool& useMask)
+{
+	if (length < 2) return 0;
+	Poco::UInt8 flags = static_cast<Poco::UInt8>(pHeader[0]);
+	Poco::UInt8 lengthByte = static_cast<Poco::UInt8>(pHeader[1]);
+	bool masked = ((lengthByte & FRAME_FLAG_MASK) != 0);
+	int headerLength = 2;
+	Poco::UInt64 l;
+	lengthByte &= 0x7f;
+	if (lengthByte == 127)
+	{
+		if (length < 10) return 0;
+		Poco::UInt64 l64;
+		std::memcpy(&l64, pHeader + 2, sizeof(l64));
+		l = Poco::ByteOrder::fromNetwork(l64);
+		headerLength = 10;
+	}
+	else if (lengthByte == 126)
+	{
+		if (length < 4) return 0;
+		Poco::UInt16 l16;
+		std::memcpy(&l16, pHeader + 2, sizeof(l16));
+		l = Poco::ByteOrder::fromNetwork(l16);
+		headerLength = 4;
+	}
+	else
+	{
+		l = lengthByte;
+	}
+	if (masked)
+	{
+		if (length < headerLength + 4) return 0;
+		std::memcpy(mask, pHeader + headerLength, 4);
+		headerLength += 4;
+	}
+	if (l > static_cast<Poco::UInt64>(_maxPayloadSize))
+		throw WebSocketException("Frame payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+
+	_frameFlags = flags;
+	useMask = masked;
+	payloadLength = static_cast<int>(l);
+	return headerLength;
+}
+
+
 int WebSocketImpl::receiveHeader(char mask[4], bool& useMask)
 {
 	char header[MAX_HEADER_LENGTH];
@@ -136,6 +243,8 @@ int WebSocketImpl::receiveHeader(char mask[4], bool& useMask)
 		Poco::BinaryReader reader(istr, Poco::BinaryReader::NETWORK_BYTE_ORDER);
 		Poco::UInt64 l;
 		reader >> l;
+		if (l > static_cast<Poco::UInt64>(_maxPayloadSize))
+			throw WebSocketException("Frame payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 		payloadLength = static_cast<int>(l);
 	} 
 	else if (lengthByte == 126)
@@ -156,6 +265,8 @@ int WebSocketImpl::receiveHeader(char mask[4], bool& useMask)
 	{
 		payloadLength = lengthByte;
 	}
+	if (payloadLength > _maxPayloadSize)
+		throw WebSocketException("Frame payload too big", WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
 
 	if (useMask)
 	{
@@ -178,20 +289,52 @@ int WebSocketImpl::receivePayload(char *buffer, int payloadLength, char mask[4],
 
 	if (useMask)
 	{
-		for (int i = 0; i < received; i++)
-		{
-			buffer[i] ^= mask[i % 4];
-		}
+		maskPayload(buffer, buffer, received, mask);
 	}
 	return received;
 }
 
 
+bool WebSocketImpl::inflateFrame()
+{
+	if (!_pDeflate) return false;
+
+	int opcode = _frameFlags & WebSocket::FRAME_OP_BITMASK;
+	if (opcode == WebSocket::FRAME_OP_TEXT || opcode == WebSocket::FRAME_OP_BINARY)
+		_inflating = (_frameFlags & WebSocket::FRAME_FLAG_RSV1) != 0;
+	else if (opcode != WebSocket::FRAME_OP_CONT)
+		return false;
+	bool inflate = _inflating;
+	if (_frameFlags & WebSocket::FRAME_FLAG_FIN) _inflating = false;
+	_frameFlags &= ~WebSocket::FRAME_FLAG_RSV1;
+	return inflate;
+}
+
+
+void WebSocketImpl::inflatePayload(int payloadLength, char mask[4], bool useMask, Poco::Buffer<char>& buffer, std::size_t maxSize)
+{
+	_inflateBuffer.resize(payloadLength, false);
+	if (payloadLength > 0) receivePayload(_inflateBuffer.begin(), payloadLength, mask, useMask);
+	_pDeflate->inflate(_inflateBuffer.begin(), payloadLength, (_frameFlags & WebSocket::FRAME_FLAG_FIN) != 0, buffer, maxSize);
+}
+
+
 int WebSocketImpl::receiveBytes(void* buffer, int length, int)
 {
 	char mask[4];
 	bool useMask;
 	int payloadLength = receiveHeader(mask, useMask);
+	if (payloadLength >= 0 && inflateFrame())
+	{
+		// Decompression stops as soon as the payload exceeds the buffer.
+		_inflatedBuffer.resize(0, false);
+		int maxSize = length < _maxPayloadSize ? length : _maxPayloadSize;
+		if (maxSize < 0) maxSize = 0;
+		inflatePayload(payloadLength, mask, useMask, _inflatedBuffer, maxSize);
+		int n = static_cast<int>(_inflatedBuffer.size());
+		std::memcpy(buffer, _inflatedBuffer.begin(), n);
+		return n;
+	}
 	if (payloadLength <= 0)
 		return payloadLength;
 	if (payloadLength > length)
@@ -205,6 +348,12 @@ int WebSocketImpl::receiveBytes(Poco::Buffer<char>& buffer, int)
 	char mask[4];
 	bool useMask;
 	int payloadLength = receiveHeader(mask, useMask);
+	if (payloadLength >= 0 && inflateFrame())
+	{
+		std::size_t oldSize = buffer.size();
+		inflatePayload(payloadLength, mask, useMask, buffer, oldSize + _maxPayloadSize);
+		return static_cast<int>(buffer.size() - oldSize);
+	}
 	if (payloadLength <= 0)
 		return payloadLength;
 	int oldSize = buffer.size();
@@ -213,6 +362,123 @@ int WebSocketImpl::receiveBytes(Poco::Buffer<char>& buffer, int)
 }
 
 
+int WebSocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return receiveScattered(buffers, flags);
+}
+
+
+int WebSocketImpl::receiveFrame(Poco::Buffer<char>& buffer)
+{
+	char header[MAX_HEADER_LENGTH];
+	char mask[4];
+	bool useMask = false;
+	int payloadLength = 0;
+	int headerLength = 0;
+	if (_bufferOffset == static_cast<int>(_buffer.size()) && !_pStreamSocketImpl->secure())
+	{
+		int n = _pStreamSocketImpl->receiveBytes(header, MAX_HEADER_LENGTH, MSG_PEEK);
+		if (n <= 0)
+		{
+			_frameFlags = 0;
+			return n;
+		}
+		headerLength = parseHeader(header, n, payloadLength, mask, useMask);
+	}
+	if (headerLength == 0)
+	{
+		// Data left over from the handshake, a secure socket, or
+		// a partially received header: receive the frame piecewise.
+		payloadLength = receiveHeader(mask, useMask);
+		if (payloadLength >= 0 && inflateFrame())
+		{
+			buffer.resize(0, false);
+			inflatePayload(payloadLength, mask, useMask, buffer, _maxPayloadSize);
+			return static_cast<int>(buffer.size());
+		}
+		if (payloadLength <= 0)
+		{
+			buffer.resize(0, false);
+			return payloadLength;
+		}
+		buffer.resize(payloadLength, false);
+		return receivePayload(buffer.begin(), payloadLength, mask, useMask);
+	}
+
+	// A compressed payload is received into a separate buffer and
+	// decompressed into the given one.
+	bool inflate = inflateFrame();
+	Poco::Buffer<char>& payload = inflate ? _inflateBuffer : buffer;
+	payload.resize(payloadLength, false);
+	_receiveBuffers[0] = Socket::makeBuffer(header, headerLength);
+	_receiveBuffers[1] = Socket::makeBuffer(payload.begin(), payloadLength);
+	int n = _pStreamSocketImpl->receiveBytes(_receiveBuffers);
+	if (n < headerLength) throw WebSocketException("Incomplete frame received", WebSocket::WS_ERR_INCOMPLETE_FRAME);
+	int received = n - headerLength;
+	if (received < payloadLength)
+	{
+		if (receiveNBytes(payload.begin() + received, payloadLength - received) <= 0)
+			throw WebSocketException("Incomplete frame received", WebSocket::WS_ERR_INCOMPLETE_FRAME);
+	}
+	if (useMask)
+	{
+		maskPayload(payload.begin(), payload.begin(), payloadLength, mask);
+	}
+	if (inflate)
+	{
+		buffer.resize(0, false);
+		_pDeflate->inflate(payload.begin(), payloadLength, (_frameFlags & WebSocket::FRAME_FLAG_FIN) != 0, buffer, _maxPayloadSize);
+		return static_cast<int>(buffer.size());
+	}
+	return payloadLength;
+}
+
+
+void WebSocketImpl::setMaxPayloadSize(int maxPayloadSize)
+{
+	poco_assert (maxPayloadSize > 0);
+
+	_maxPayloadSize = maxPayloadSize;
+}
+
+
+void WebSocketImpl::maskPayload(char* pDest, const char* pSrc, std::size_t length, const char mask[4])
+{
+	Poco::UInt32 mask32;
+	std::memcpy(&mask32, mask, 4);
+	std::size_t i = 0;
+#if defined(POCO_WEBSOCKET_AVX2)
+	const __m256i mask256 = _mm256_set1_epi32(static_cast<int>(mask32));
+	for (; i + 32 <= length; i += 32)
+	{
+		__m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pSrc + i));
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(pDest + i), _mm256_xor_si256(data, mask256));
+	}
+#endif
+#if defined(POCO_WEBSOCKET_SSE2)
+	const __m128i mask128 = _mm_set1_epi32(static_cast<int>(mask32));
+	for (; i + 16 <= length; i += 16)
+	{
+		__m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pSrc + i));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDest + i), _mm_xor_si128(data, mask128));
+	}
+#endif
+	const Poco::UInt64 mask64 = (static_cast<Poco::UInt64>(mask32) << 32) | mask32;
+	for (; i + 8 <= length; i += 8)
+	{
+		Poco::UInt64 data;
+		std::memcpy(&data, pSrc + i, 8);
+		data ^= mask64;
+		std::memcpy(pDest + i, &data, 8);
+	}
+	// i is a multiple of 4 here, so the mask is still aligned.
+	for (; i < length; ++i)
+	{
+		pDest[i] = pSrc[i] ^ mask[i % 4];
+	}
+}
+
+
 int WebSocketImpl::receiveNBytes(void* buffer, int bytes)
 {
 	int received = receiveSomeBytes(reinterpret_cast<char*>(buffer), bytes);
@@ -0,0 +1,230 @@
+//
+// DNSResolverTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "DNSResolverTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/DNSResolver.h"
+#include "Poco/Net/HostEntry.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Event.h"
+
+
+using Poco::Net::DNSResolver;
+using Poco::Net::HostEntry;
+using Poco::Net::IPAddress;
+using Poco::Net::SocketAddress;
+using Poco::Net::DNSException;
+
+
+namespace
+{
+	class TestCallback: public DNSResolver::Callback
+	{
+	public:
+		TestCallback():
+			_failed(false)
+		{
+		}
+
+		void onResolved(const std::string& name, const HostEntry& entry)
+		{
+			_name = name;
+			_entry = entry;
+			_done.set();
+		}
+
+		void onResolveError(const std::string& name, const Poco::Exception& exc)
+		{
+			_name = name;
+			_failed = true;
+			_done.set();
+		}
+
+		void wait()
+		{
+			_done.wait(10000);
+		}
+
+		const std::string& name() const
+		{
+			return _name;
+		}
+
+		const HostEntry& entry() const
+		{
+			return _entry;
+		}
+
+		bool failed() const
+		{
+			return _failed;
+		}
+
+	private:
+		Poco::Event _done;
+		std::string _name;
+		HostEntry _entry;
+		bool _failed;
+	};
+}
+
+
+DNSResolverTest::DNSResolverTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+DNSResolverTest::~DNSResolverTest()
+{
+}
+
+
+void DNSResolverTest::testResolve()
+{
+	DNSResolver resolver;
+	HostEntry he1 = resolver.resolve("localhost");
+	assert (!he1.addresses().empty());
+	assert (he1.addresses()[0].isLoopback());
+	assert (resolver.cacheHits() == 0);
+	assert (resolver.cacheMisses() == 1);
+
+	HostEntry he2 = resolver.resolve("LocalHost");
+	assert (he2.addresses() == he1.addresses());
+	assert (resolver.cacheHits() == 1);
+	assert (resolver.cacheMisses() == 1);
+
+	resolver.flushCache();
+	resolver.resolve("localhost");
+	assert (resolver.cacheHits() == 1);
+	assert (resolver.cacheMisses() == 2);
+}
+
+
+void DNSResolverTest::testResolveAsync()
+{
+	DNSResolver resolver;
+	DNSResolver::Result result1 = resolver.resolveAsync("localhost");
+	DNSResolver::Result result2 = resolver.resolveAsync("localhost");
+	result1.wait(10000);
+	result2.wait(10000);
+	assert (!result1.failed());
+	assert (!result2.failed());
+	assert (!result1.data().addresses().empty());
+	assert (result1.data().addresses() == result2.data().addresses());
+
+	DNSResolver::Result result3 = resolver.resolveAsync("localhost");
+	assert (result3.available());
+	assert (!result3.failed());
+	assert (resolver.cacheHits() >= 1);
+}
+
+
+void DNSResolverTest::testCallback()
+{
+	DNSResolver resolver;
+	TestCallback callback1;
+	resolver.resolveAsync("localhost", callback1);
+	callback1.wait();
+	assert (!callback1.failed());
+	assert (callback1.name() == "localhost");
+	assert (!callback1.entry().addresses().empty());
+
+	// cached, so the callback is called immediately
+	TestCallback callback2;
+	resolver.resolveAsync("localhost", callback2);
+	assert (!callback2.failed());
+	assert (!callback2.entry().addresses().empty());
+	assert (resolver.cacheHits() == 1);
+
+	TestCallback callback3;
+	resolver.resolveAsync("nohost.invalid", callback3);
+	callback3.wait();
+	assert (callback3.failed());
+}
+
+
+void DNSResolverTest::testNegativeCache()
+{
+	DNSResolver resolver;
+	try
+	{
+		resolver.resolve("nohost.invalid");
+		fail("host not found - must throw");
+	}
+	catch (DNSException&)
+	{
+	}
+	assert (resolver.cacheMisses() == 1);
+
+	try
+	{
+		resolver.resolve("nohost.invalid");
+		fail("host not found - must throw");
+	}
+	catch (DNSException&)
+	{
+	}
+	assert (resolver.cacheHits() == 1);
+	assert (resolver.cacheMisses() == 1);
+}
+
+
+void DNSResolverTest::testNoCache()
+{
+	DNSResolver resolver;
+	resolver.setPositiveTTL(0);
+	resolver.setNegativeTTL(0);
+	resolver.resolve("localhost");
+	resolver.resolve("localhost");
+	assert (resolver.cacheHits() == 0);
+	assert (resolver.cacheMisses() == 2);
+}
+
+
+void DNSResolverTest::testResolveAddress()
+{
+	DNSResolver resolver;
+	SocketAddress sa1 = resolver.resolveAddress("127.0.0.1", 80);
+	assert (sa1.toString() == "127.0.0.1:80");
+	assert (resolver.cacheMisses() == 0);
+
+	SocketAddress sa2 = resolver.resolveAddress("localhost", 8080);
+	assert (sa2.host().isLoopback());
+	assert (sa2.port() == 8080);
+}
+
+
+void DNSResolverTest::setUp()
+{
+}
+
+
+void DNSResolverTest::tearDown()
+{
+}
+
+
+CppUnit::Test* DNSResolverTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("DNSResolverTest");
+
+	CppUnit_addTest(pSuite, DNSResolverTest, testResolve);
+	CppUnit_addTest(pSuite, DNSResolverTest, testResolveAsync);
+	CppUnit_addTest(pSuite, DNSResolverTest, testCallback);
+	CppUnit_addTest(pSuite, DNSResolverTest, testNegativeCache);
+	CppUnit_addTest(pSuite, DNSResolverTest, testNoCache);
+	CppUnit_addTest(pSuite, DNSResolverTest, testResolveAddress);
+
+	return pSuite;
+}
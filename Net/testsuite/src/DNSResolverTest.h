@@ -0,0 +1,45 @@
+//
+// DNSResolverTest.h
+//
+// $Id$
+//
+// Definition of the DNSResolverTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef DNSResolverTest_INCLUDED
+#define DNSResolverTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class DNSResolverTest: public CppUnit::TestCase
+{
+public:
+	DNSResolverTest(const std::string& name);
+	~DNSResolverTest();
+
+	void testResolve();
+	void testResolveAsync();
+	void testCallback();
+	void testNegativeCache();
+	void testNoCache();
+	void testResolveAddress();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // DNSResolverTest_INCLUDED
@@ -20,11 +20,15 @@
 #include "Poco/Net/NetException.h"
 #include "Poco/Timespan.h"
 #include "Poco/Stopwatch.h"
+#include "Poco/Timestamp.h"
+#include <vector>
 
 
 using Poco::Net::Socket;
 using Poco::Net::DatagramSocket;
 using Poco::Net::SocketAddress;
+using Poco::Net::DatagramPacket;
+using Poco::Net::DatagramPacketVec;
 using Poco::Net::IPAddress;
 #ifdef POCO_NET_HAS_INTERFACE
 	using Poco::Net::NetworkInterface;
@@ -135,6 +139,89 @@ void DatagramSocketTest::testBroadcast()
 }
 
 
+void DatagramSocketTest::testBatch()
+{
+	DatagramSocket receiver(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+	receiver.setReceiveTimeout(Timespan(5, 0));
+
+	std::vector<std::string> messages;
+	for (int i = 0; i < 10; ++i)
+		messages.push_back(std::string(i + 1, 'a' + i));
+
+	DatagramPacketVec out;
+	for (std::vector<std::string>::const_iterator it = messages.begin(); it != messages.end(); ++it)
+		out.push_back(DatagramPacket(it->data(), (int) it->size(), receiver.address()));
+	assert (sender.sendBatch(out) == 10);
+
+	char buffers[16][32];
+	DatagramPacketVec in;
+	for (int i = 0; i < 16; ++i)
+		in.push_back(DatagramPacket(buffers[i], sizeof(buffers[i])));
+
+	std::vector<std::string> received;
+	while (received.size() < messages.size())
+	{
+		int n = receiver.receiveBatch(in);
+		assert (n > 0);
+		for (int i = 0; i < n; ++i)
+		{
+			assert (in[i].address == sender.address());
+			assert (!in[i].truncated);
+			received.push_back(std::string(buffers[i], in[i].received));
+		}
+	}
+	assert (received == messages);
+
+	// truncated datagram
+	std::string large(64, 'x');
+	out.clear();
+	out.push_back(DatagramPacket(large.data(), (int) large.size(), receiver.address()));
+	assert (sender.sendBatch(out) == 1);
+	in.resize(1);
+	assert (receiver.receiveBatch(in) == 1);
+#if POCO_OS == POCO_OS_LINUX
+	assert (in[0].truncated);
+#endif
+
+	// non-blocking receive without datagrams
+	receiver.setBlocking(false);
+	assert (receiver.receiveBatch(in) < 0);
+}
+
+
+void DatagramSocketTest::testReceiveTimestamps()
+{
+	DatagramSocket receiver(SocketAddress("127.0.0.1", 0));
+	DatagramSocket sender(SocketAddress("127.0.0.1", 0));
+	receiver.setReceiveTimeout(Timespan(5, 0));
+	try
+	{
+		receiver.setReceiveTimestamps(true);
+	}
+	catch (Poco::NotImplementedException&)
+	{
+		return;
+	}
+	assert (receiver.getReceiveTimestamps());
+
+	Poco::Timestamp before;
+	sender.sendTo("hello", 5, receiver.address());
+	char buffer[16];
+	DatagramPacketVec in(1, DatagramPacket(buffer, sizeof(buffer)));
+	assert (receiver.receiveBatch(in) == 1);
+	Poco::Timestamp after;
+	assert (in[0].received == 5);
+	assert (in[0].timestamp >= before - 1000 && in[0].timestamp <= after);
+
+	receiver.setReceiveTimestamps(false);
+	assert (!receiver.getReceiveTimestamps());
+	sender.sendTo("hello", 5, receiver.address());
+	assert (receiver.receiveBatch(in) == 1);
+	assert (in[0].timestamp == 0);
+}
+
+
 void DatagramSocketTest::setUp()
 {
 }
@@ -155,6 +242,8 @@ CppUnit::Test* DatagramSocketTest::suite()
 #if (POCO_OS != POCO_OS_FREE_BSD) // works only with local net bcast and very randomly
 	CppUnit_addTest(pSuite, DatagramSocketTest, testBroadcast);
 #endif
+	CppUnit_addTest(pSuite, DatagramSocketTest, testBatch);
+	CppUnit_addTest(pSuite, DatagramSocketTest, testReceiveTimestamps);
 
 	return pSuite;
 }
@@ -30,6 +30,8 @@ public:
 	void testSendToReceiveFrom();
 	void testUnbound();
 	void testBroadcast();
+	void testBatch();
+	void testReceiveTimestamps();
 
 	void setUp();
 	void tearDown();
@@ -0,0 +1,176 @@
+//
+// HTTPBufferAllocatorTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPBufferAllocatorTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPBufferAllocator.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Runnable.h"
+#include "Poco/Thread.h"
+#include "HTTPTestServer.h"
+#include <sstream>
+
+
+using Poco::Net::HTTPBufferAllocator;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPResponse;
+using Poco::StreamCopier;
+using Poco::Thread;
+
+
+namespace
+{
+	class AllocatorRunnable: public Poco::Runnable
+	{
+	public:
+		void run()
+		{
+			for (int i = 0; i < 10000; ++i)
+			{
+				char* p1 = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+				char* p2 = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+				p1[0] = 'x';
+				p2[HTTPBufferAllocator::BUFFER_SIZE - 1] = 'y';
+				HTTPBufferAllocator::deallocate(p1, HTTPBufferAllocator::BUFFER_SIZE);
+				HTTPBufferAllocator::deallocate(p2, HTTPBufferAllocator::BUFFER_SIZE);
+			}
+		}
+	};
+}
+
+
+HTTPBufferAllocatorTest::HTTPBufferAllocatorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPBufferAllocatorTest::~HTTPBufferAllocatorTest()
+{
+}
+
+
+void HTTPBufferAllocatorTest::testAllocate()
+{
+	HTTPBufferAllocator::resetStatistics();
+	char* p1 = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+	HTTPBufferAllocator::deallocate(p1, HTTPBufferAllocator::BUFFER_SIZE);
+	char* p2 = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+	assert (p2 == p1);
+	HTTPBufferAllocator::deallocate(p2, HTTPBufferAllocator::BUFFER_SIZE);
+
+	HTTPBufferAllocator::Statistics stats = HTTPBufferAllocator::statistics();
+	assert (stats.allocations == 2);
+	assert (stats.deallocations == 2);
+	assert (stats.cacheHits >= 1);
+	assert (stats.cacheHits + stats.poolAllocations == 2);
+	assert (stats.heapAllocations == 0);
+
+	HTTPBufferAllocator::resetStatistics();
+	stats = HTTPBufferAllocator::statistics();
+	assert (stats.allocations == 0);
+	assert (stats.cacheHits == 0);
+}
+
+
+void HTTPBufferAllocatorTest::testBufferSize()
+{
+	assert (HTTPBufferAllocator::getBufferSize() == HTTPBufferAllocator::BUFFER_SIZE);
+	char* pOld = HTTPBufferAllocator::allocate(HTTPBufferAllocator::BUFFER_SIZE);
+
+	HTTPBufferAllocator::setBufferSize(16384);
+	assert (HTTPBufferAllocator::getBufferSize() == 16384);
+	HTTPBufferAllocator::resetStatistics();
+	char* p1 = HTTPBufferAllocator::allocate(16384);
+	char* p2 = HTTPBufferAllocator::allocate(1000);
+	p1[16383] = 0;
+	p2[999] = 0;
+	HTTPBufferAllocator::deallocate(p1, 16384);
+	HTTPBufferAllocator::deallocate(p2, 1000);
+	// allocated with the previous buffer size
+	HTTPBufferAllocator::deallocate(pOld, HTTPBufferAllocator::BUFFER_SIZE);
+
+	HTTPBufferAllocator::Statistics stats = HTTPBufferAllocator::statistics();
+	assert (stats.allocations == 2);
+	assert (stats.deallocations == 3);
+	assert (stats.poolAllocations == 1);
+	assert (stats.heapAllocations == 1);
+
+	HTTPBufferAllocator::setBufferSize(HTTPBufferAllocator::BUFFER_SIZE);
+	assert (HTTPBufferAllocator::getBufferSize() == HTTPBufferAllocator::BUFFER_SIZE);
+}
+
+
+void HTTPBufferAllocatorTest::testLargeBuffers()
+{
+	HTTPBufferAllocator::setBufferSize(16384);
+	HTTPBufferAllocator::resetStatistics();
+	{
+		HTTPTestServer srv;
+		HTTPClientSession s("127.0.0.1", srv.port());
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/large");
+		s.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = s.receiveResponse(response);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		assert (ostr.str() == HTTPTestServer::LARGE_BODY);
+	}
+	HTTPBufferAllocator::Statistics stats = HTTPBufferAllocator::statistics();
+	assert (stats.allocations > 0);
+	assert (stats.allocations == stats.deallocations);
+	assert (stats.heapAllocations == 0);
+}
+
+
+void HTTPBufferAllocatorTest::testConcurrentAllocate()
+{
+	HTTPBufferAllocator::resetStatistics();
+	AllocatorRunnable r;
+	Thread threads[8];
+	for (int i = 0; i < 8; ++i) threads[i].start(r);
+	for (int i = 0; i < 8; ++i) threads[i].join();
+
+	HTTPBufferAllocator::Statistics stats = HTTPBufferAllocator::statistics();
+	assert (stats.allocations == 8*20000);
+	assert (stats.deallocations == 8*20000);
+	assert (stats.cacheHits + stats.poolAllocations == 8*20000);
+	assert (stats.cacheHits > stats.poolAllocations);
+}
+
+
+void HTTPBufferAllocatorTest::setUp()
+{
+}
+
+
+void HTTPBufferAllocatorTest::tearDown()
+{
+	HTTPBufferAllocator::setBufferSize(HTTPBufferAllocator::BUFFER_SIZE);
+}
+
+
+CppUnit::Test* HTTPBufferAllocatorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPBufferAllocatorTest");
+
+	CppUnit_addTest(pSuite, HTTPBufferAllocatorTest, testAllocate);
+	CppUnit_addTest(pSuite, HTTPBufferAllocatorTest, testBufferSize);
+	CppUnit_addTest(pSuite, HTTPBufferAllocatorTest, testLargeBuffers);
+	CppUnit_addTest(pSuite, HTTPBufferAllocatorTest, testConcurrentAllocate);
+
+	return pSuite;
+}
@@ -0,0 +1,43 @@
+//
+// HTTPBufferAllocatorTest.h
+//
+// $Id$
+//
+// Definition of the HTTPBufferAllocatorTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPBufferAllocatorTest_INCLUDED
+#define HTTPBufferAllocatorTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTPBufferAllocatorTest: public CppUnit::TestCase
+{
+public:
+	HTTPBufferAllocatorTest(const std::string& name);
+	~HTTPBufferAllocatorTest();
+
+	void testAllocate();
+	void testBufferSize();
+	void testLargeBuffers();
+	void testConcurrentAllocate();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPBufferAllocatorTest_INCLUDED
@@ -16,6 +16,7 @@
 #include "Poco/Net/HTTPClientSession.h"
 #include "Poco/Net/HTTPRequest.h"
 #include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/DNSResolver.h"
 #include "Poco/StreamCopier.h"
 #include "HTTPTestServer.h"
 #include <istream>
@@ -27,6 +28,7 @@ using Poco::Net::HTTPClientSession;
 using Poco::Net::HTTPRequest;
 using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPMessage;
+using Poco::Net::DNSResolver;
 using Poco::StreamCopier;
 
 
@@ -341,6 +343,35 @@ void HTTPClientSessionTest::testExpectContinueFail()
 }
 
 
+void HTTPClientSessionTest::testResolver()
+{
+	HTTPTestServer srv;
+	DNSResolver resolver;
+	HTTPClientSession s1("localhost", srv.port());
+	s1.setResolver(&resolver);
+	assert (s1.getResolver() == &resolver);
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/small");
+	s1.sendRequest(request);
+	HTTPResponse response;
+	std::istream& rs1 = s1.receiveResponse(response);
+	std::ostringstream ostr1;
+	StreamCopier::copyStream(rs1, ostr1);
+	assert (ostr1.str() == HTTPTestServer::SMALL_BODY);
+	assert (resolver.cacheMisses() == 1);
+	s1.reset();
+
+	HTTPClientSession s2("localhost", srv.port());
+	s2.setResolver(&resolver);
+	s2.sendRequest(request);
+	std::istream& rs2 = s2.receiveResponse(response);
+	std::ostringstream ostr2;
+	StreamCopier::copyStream(rs2, ostr2);
+	assert (ostr2.str() == HTTPTestServer::SMALL_BODY);
+	assert (resolver.cacheHits() == 1);
+	assert (resolver.cacheMisses() == 1);
+}
+
+
 void HTTPClientSessionTest::setUp()
 {
 }
@@ -370,6 +401,7 @@ CppUnit::Test* HTTPClientSessionTest::suite()
 	CppUnit_addTest(pSuite, HTTPClientSessionTest, testBypassProxy);
 	CppUnit_addTest(pSuite, HTTPClientSessionTest, testExpectContinue);
 	CppUnit_addTest(pSuite, HTTPClientSessionTest, testExpectContinueFail);
+	CppUnit_addTest(pSuite, HTTPClientSessionTest, testResolver);
 
 	return pSuite;
 }
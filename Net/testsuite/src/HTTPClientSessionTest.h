@@ -41,6 +41,7 @@ public:
 	void testBypassProxy();
 	void testExpectContinue();
 	void testExpectContinueFail();
+	void testResolver();
 
 	void setUp();
 	void tearDown();
@@ -13,6 +13,7 @@
 #include "HTTPClientTestSuite.h"
 #include "HTTPClientSessionTest.h"
 #include "HTTPStreamFactoryTest.h"
+#include "HTTPSessionPoolTest.h"
 
 
 CppUnit::Test* HTTPClientTestSuite::suite()
@@ -21,6 +22,7 @@ CppUnit::Test* HTTPClientTestSuite::suite()
 
 	pSuite->addTest(HTTPClientSessionTest::suite());
 	pSuite->addTest(HTTPStreamFactoryTest::suite());
+	pSuite->addTest(HTTPSessionPoolTest::suite());
 
 	return pSuite;
 }
@@ -0,0 +1,414 @@
+//
+// HTTPHeaderTableTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPHeaderTableTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPHeaderTable.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/NetException.h"
+#include <sstream>
+
+
+using Poco::Net::HTTPHeaderTable;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPMessage;
+using Poco::Net::MessageException;
+using Poco::Net::NoMessageException;
+
+
+namespace
+{
+	std::string str(const HTTPHeaderTable::Slice& slice)
+	{
+		return HTTPHeaderTable::toString(slice);
+	}
+
+	std::string get(const HTTPHeaderTable& table, const std::string& name)
+	{
+		const HTTPHeaderTable::Slice* pValue = table.find(name);
+		return pValue ? HTTPHeaderTable::toString(*pValue) : std::string("<none>");
+	}
+
+	void parse(HTTPHeaderTable& table, const std::string& s)
+	{
+		table.feed(s.data(), s.size());
+		table.parseRequest();
+	}
+}
+
+
+HTTPHeaderTableTest::HTTPHeaderTableTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPHeaderTableTest::~HTTPHeaderTableTest()
+{
+}
+
+
+void HTTPHeaderTableTest::testParse()
+{
+	std::string s("POST /test.cgi HTTP/1.1\r\nConnection: Close\r\nContent-Length:   100  \r\nContent-Type: text/plain\r\nHost: localhost:8000\r\nUser-Agent: Poco\r\n\r\n");
+	HTTPHeaderTable table;
+	assert (table.empty());
+	assert (!table.complete());
+	assert (table.feed(s.data(), s.size()) == s.size());
+	assert (table.complete());
+	table.parseRequest();
+	assert (str(table.method()) == "POST");
+	assert (str(table.uri()) == "/test.cgi");
+	assert (str(table.version()) == "HTTP/1.1");
+	assert (table.count() == 5);
+	assert (str(table[0].name) == "Connection");
+	assert (str(table[0].value) == "Close");
+	assert (str(table[1].name) == "Content-Length");
+	assert (str(table[1].value) == "100");
+	assert (str(table[2].name) == "Content-Type");
+	assert (str(table[2].value) == "text/plain");
+	assert (str(table[3].name) == "Host");
+	assert (str(table[3].value) == "localhost:8000");
+	assert (str(table[4].name) == "User-Agent");
+	assert (str(table[4].value) == "Poco");
+}
+
+
+void HTTPHeaderTableTest::testFeed()
+{
+	std::string s("\r\nGET /index.html HTTP/1.1\nHost: localhost\n\nbody");
+	HTTPHeaderTable table;
+	std::size_t consumed = 0;
+	for (std::size_t i = 0; i < s.size() && !table.complete(); ++i)
+	{
+		consumed += table.feed(s.data() + i, 1);
+	}
+	assert (table.complete());
+	assert (consumed == s.size() - 4);
+	table.parseRequest();
+	assert (str(table.method()) == "GET");
+	assert (str(table.uri()) == "/index.html");
+	assert (str(table.version()) == "HTTP/1.1");
+	assert (table.count() == 1);
+	assert (get(table, "Host") == "localhost");
+
+	table.reset();
+	assert (table.feed(s.data(), 10) == 10);
+	assert (table.feed(s.data() + 10, s.size() - 10) == s.size() - 14);
+	assert (table.complete());
+	table.parseRequest();
+	assert (str(table.uri()) == "/index.html");
+	assert (get(table, "Host") == "localhost");
+}
+
+
+void HTTPHeaderTableTest::testFolding()
+{
+	std::string s("GET / HTTP/1.1\r\nX-Folded: first\r\n second\r\n\tthird  \r\nHost: localhost\r\n\r\n");
+	HTTPHeaderTable table;
+	parse(table, s);
+	assert (table.count() == 2);
+	assert (get(table, "X-Folded") == "first second\tthird");
+	assert (get(table, "Host") == "localhost");
+
+	std::istringstream istr(s);
+	HTTPRequest request;
+	request.read(istr);
+	assert (request.get("X-Folded") == get(table, "X-Folded"));
+}
+
+
+void HTTPHeaderTableTest::testFind()
+{
+	std::string s("GET / HTTP/1.1\r\nHost: localhost\r\nAccept: text/html\r\naccept: text/plain\r\n\r\n");
+	HTTPHeaderTable table;
+	parse(table, s);
+	assert (table.has("host"));
+	assert (table.has("HOST"));
+	assert (!table.has("Hos"));
+	assert (!table.has("Hosts"));
+	assert (get(table, "ACCEPT") == "text/html");
+	assert (table.find("Host", 4) != 0);
+	assert (table.find("Cookie") == 0);
+	assert (HTTPHeaderTable::equals(table[0].name, "hOsT", 4));
+	assert (!HTTPHeaderTable::equals(table[0].name, "Hose", 4));
+}
+
+
+void HTTPHeaderTableTest::testInvalidLines()
+{
+	std::string s("GET / HTTP/1.1\r\nHost: localhost\r\ninvalid\r\nUser-Agent: Poco\r\n\r\n");
+	HTTPHeaderTable table;
+	parse(table, s);
+	assert (table.count() == 2);
+	assert (get(table, "Host") == "localhost");
+	assert (get(table, "User-Agent") == "Poco");
+}
+
+
+void HTTPHeaderTableTest::testIncomplete()
+{
+	HTTPHeaderTable table;
+	try
+	{
+		table.parseRequest();
+		fail("no data - must throw");
+	}
+	catch (NoMessageException&)
+	{
+	}
+
+	std::string s("GET / HTTP/1.1\r\nHost: localhost\r\nUser-Agent: Po");
+	table.feed(s.data(), s.size());
+	assert (!table.complete());
+	table.parseRequest();
+	assert (table.count() == 2);
+	assert (get(table, "Host") == "localhost");
+	assert (get(table, "User-Agent") == "Po");
+
+	table.reset();
+	s = "GET / HTTP/1.1\r\nHost: localhost\r\nUser-Ag";
+	table.feed(s.data(), s.size());
+	try
+	{
+		table.parseRequest();
+		fail("incomplete field name - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	table.reset();
+	s = "GET / HTTP/1.1";
+	table.feed(s.data(), s.size());
+	try
+	{
+		table.parseRequest();
+		fail("incomplete request line - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testReset()
+{
+	HTTPHeaderTable table;
+	parse(table, "GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+	assert (table.count() == 1);
+	table.reset();
+	assert (table.empty());
+	assert (!table.complete());
+	assert (table.count() == 0);
+	assert (table.method().length == 0);
+	parse(table, "HEAD /index.html HTTP/1.0\r\nUser-Agent: Poco\r\nConnection: Close\r\n\r\n");
+	assert (str(table.method()) == "HEAD");
+	assert (table.count() == 2);
+	assert (!table.has("Host"));
+}
+
+
+void HTTPHeaderTableTest::testFieldLimit()
+{
+	std::string s("GET / HTTP/1.1\r\n");
+	for (int i = 0; i < 10; ++i) s.append("X-Field: value\r\n");
+	s.append("\r\n");
+
+	HTTPHeaderTable table;
+	table.setFieldLimit(10);
+	assert (table.getFieldLimit() == 10);
+	parse(table, s);
+	assert (table.count() == 10);
+
+	table.reset();
+	table.setFieldLimit(9);
+	try
+	{
+		parse(table, s);
+		fail("too many fields - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testNameTooLong()
+{
+	std::string s("GET / HTTP/1.1\r\n");
+	s.append(HTTPHeaderTable::MAX_NAME_LENGTH + 1, 'x');
+	s.append(": value\r\n\r\n");
+	HTTPHeaderTable table;
+	try
+	{
+		parse(table, s);
+		fail("name too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testValueTooLong()
+{
+	std::string s("GET / HTTP/1.1\r\nX-Value: ");
+	s.append(HTTPHeaderTable::MAX_VALUE_LENGTH, 'x');
+	s.append("\r\n\r\n");
+	HTTPHeaderTable table;
+	parse(table, s);
+	assert (table[0].value.length == HTTPHeaderTable::MAX_VALUE_LENGTH);
+
+	s = "GET / HTTP/1.1\r\nX-Value: ";
+	s.append(HTTPHeaderTable::MAX_VALUE_LENGTH + 1, 'x');
+	s.append("\r\n\r\n");
+	table.reset();
+	try
+	{
+		parse(table, s);
+		fail("value too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	s = "GET / HTTP/1.1\r\nX-Value: ";
+	s.append(HTTPHeaderTable::MAX_VALUE_LENGTH - 2, 'x');
+	s.append("\r\n yy\r\n\r\n");
+	table.reset();
+	try
+	{
+		parse(table, s);
+		fail("folded value too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testHeaderTooLarge()
+{
+	std::string s("GET / HTTP/1.1\r\n");
+	for (int i = 0; i < 5; ++i)
+	{
+		s.append("X-Value: ");
+		s.append(HTTPHeaderTable::MAX_VALUE_LENGTH, 'x');
+		s.append("\r\n");
+	}
+	HTTPHeaderTable table;
+	table.setFieldLimit(1);
+	try
+	{
+		table.feed(s.data(), s.size());
+		fail("header too large - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testInvalidRequestLine()
+{
+	HTTPHeaderTable table;
+	std::string s(256, 'x');
+	s.append("\r\n\r\n");
+	try
+	{
+		parse(table, s);
+		fail("invalid method - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	s = "GET ";
+	s.append(HTTPHeaderTable::MAX_URI_LENGTH + 1, 'x');
+	s.append(" HTTP/1.0\r\n\r\n");
+	table.reset();
+	try
+	{
+		parse(table, s);
+		fail("URI too long - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+
+	table.reset();
+	try
+	{
+		parse(table, "GET / HTTP/1.10\r\n\r\n");
+		fail("invalid version - must throw");
+	}
+	catch (MessageException&)
+	{
+	}
+}
+
+
+void HTTPHeaderTableTest::testReadRequest()
+{
+	std::string s("POST /test.cgi HTTP/1.1\r\nConnection: Close\r\nContent-Length: 100\r\nContent-Type: text/plain\r\nHost: localhost:8000\r\nX-Encoded: =?ISO-8859-1?Q?Andr=E9?=\r\n\r\n");
+	HTTPHeaderTable table;
+	parse(table, s);
+	HTTPRequest request;
+	request.read(table);
+	assert (request.getMethod() == HTTPRequest::HTTP_POST);
+	assert (request.getURI() == "/test.cgi");
+	assert (request.getVersion() == HTTPMessage::HTTP_1_1);
+	assert (request.size() == 5);
+	assert (request["Connection"] == "Close");
+	assert (request["Host"] == "localhost:8000");
+	assert (request.getContentType() == "text/plain");
+	assert (request.getContentLength() == 100);
+
+	std::istringstream istr(s);
+	HTTPRequest streamRequest;
+	streamRequest.read(istr);
+	assert (request["X-Encoded"] == streamRequest["X-Encoded"]);
+	assert (request["X-Encoded"] != "=?ISO-8859-1?Q?Andr=E9?=");
+}
+
+
+void HTTPHeaderTableTest::setUp()
+{
+}
+
+
+void HTTPHeaderTableTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPHeaderTableTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPHeaderTableTest");
+
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testParse);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testFeed);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testFolding);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testFind);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testInvalidLines);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testIncomplete);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testReset);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testFieldLimit);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testNameTooLong);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testValueTooLong);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testHeaderTooLarge);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testInvalidRequestLine);
+	CppUnit_addTest(pSuite, HTTPHeaderTableTest, testReadRequest);
+
+	return pSuite;
+}
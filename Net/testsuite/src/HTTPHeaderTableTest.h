@@ -0,0 +1,52 @@
+//
+// HTTPHeaderTableTest.h
+//
+// $Id$
+//
+// Definition of the HTTPHeaderTableTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPHeaderTableTest_INCLUDED
+#define HTTPHeaderTableTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTPHeaderTableTest: public CppUnit::TestCase
+{
+public:
+	HTTPHeaderTableTest(const std::string& name);
+	~HTTPHeaderTableTest();
+
+	void testParse();
+	void testFeed();
+	void testFolding();
+	void testFind();
+	void testInvalidLines();
+	void testIncomplete();
+	void testReset();
+	void testFieldLimit();
+	void testNameTooLong();
+	void testValueTooLong();
+	void testHeaderTooLarge();
+	void testInvalidRequestLine();
+	void testReadRequest();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPHeaderTableTest_INCLUDED
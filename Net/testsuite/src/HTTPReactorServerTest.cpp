@@ -0,0 +1,430 @@
+//
+// HTTPReactorServerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPReactorServerTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPReactorServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Thread.h"
+#include <sstream>
+
+
+using Poco::Net::HTTPReactorServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::StreamCopier;
+using Poco::Thread;
+
+
+namespace
+{
+	class EchoBodyRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (request.getChunkedTransferEncoding())
+				response.setChunkedTransferEncoding(true);
+			else if (request.getContentLength() != HTTPMessage::UNKNOWN_CONTENT_LENGTH)
+				response.setContentLength(request.getContentLength());
+			
+			response.setContentType(request.getContentType());
+			
+			std::istream& istr = request.stream();
+			std::ostream& ostr = response.send();
+			StreamCopier::copyStream(istr, ostr);
+		}
+	};
+	
+	class EchoHeaderRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			std::ostringstream osstr;
+			request.write(osstr);
+			int n = (int) osstr.str().length();
+			response.setContentLength(n);
+			std::ostream& ostr = response.send();
+			if (request.getMethod() != HTTPRequest::HTTP_HEAD)
+				request.write(ostr);
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			if (request.getURI() == "/echoBody")
+				return new EchoBodyRequestHandler;
+			else if (request.getURI() == "/echoHeader")
+				return new EchoHeaderRequestHandler;
+			else
+				return 0;
+		}
+	};
+}
+
+
+HTTPReactorServerTest::HTTPReactorServerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPReactorServerTest::~HTTPReactorServerTest()
+{
+}
+
+
+void HTTPReactorServerTest::testIdentityRequest()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	std::string body(5000, 'x');
+	HTTPRequest request("POST", "/echoBody");
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getContentLength() == body.size());
+	assert (response.getContentType() == "text/plain");
+	assert (rbody == body);
+}
+
+
+void HTTPReactorServerTest::testChunkedRequest()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	std::string body(5000, 'x');
+	HTTPRequest request("POST", "/echoBody");
+	request.setContentType("text/plain");
+	request.setChunkedTransferEncoding(true);
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getContentLength() == HTTPMessage::UNKNOWN_CONTENT_LENGTH);
+	assert (response.getContentType() == "text/plain");
+	assert (response.getChunkedTransferEncoding());
+	assert (rbody == body);
+}
+
+
+void HTTPReactorServerTest::testLargeRequest()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	// The body is larger than HTTPReactorConnection::MAX_BUFFERED_BODY,
+	// so the worker thread reads it from the socket.
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	cs.setKeepAlive(true);
+	std::string body(200000, 'x');
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getContentLength() == body.size());
+	assert (response.getKeepAlive());
+	assert (rbody == body);
+
+	request.setChunkedTransferEncoding(true);
+	cs.sendRequest(request) << body;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getChunkedTransferEncoding());
+	assert (response.getKeepAlive());
+	assert (rbody == body);
+}
+
+
+void HTTPReactorServerTest::testKeepAlive()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 10; ++i)
+	{
+		std::string body(1000*(i + 1), 'x');
+		HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+		request.setContentLength((int) body.length());
+		request.setContentType("text/plain");
+		cs.sendRequest(request) << body;
+		HTTPResponse response;
+		std::string rbody;
+		cs.receiveResponse(response) >> rbody;
+		assert (response.getContentLength() == body.size());
+		assert (response.getKeepAlive());
+		assert (rbody == body);
+		assert (srv.currentConnections() == 1);
+	}
+
+	HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	request.setKeepAlive(false);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (!response.getKeepAlive());
+	assert (rbody.find("GET /echoHeader HTTP/1.1") != std::string::npos);
+
+	for (int i = 0; i < 20 && srv.currentConnections() > 0; ++i) Thread::sleep(100);
+	assert (srv.currentConnections() == 0);
+}
+
+
+void HTTPReactorServerTest::testKeepAliveTimeout()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setKeepAliveTimeout(Poco::Timespan(1, 0));
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getKeepAlive());
+	assert (srv.currentConnections() == 1);
+
+	for (int i = 0; i < 30 && srv.currentConnections() > 0; ++i) Thread::sleep(100);
+	assert (srv.currentConnections() == 0);
+}
+
+
+void HTTPReactorServerTest::test100Continue()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	std::string body(5000, 'x');
+	HTTPRequest request("POST", "/echoBody");
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	request.set("Expect", "100-Continue");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getContentLength() == body.size());
+	assert (response.getContentType() == "text/plain");
+	assert (rbody == body);
+}
+
+
+void HTTPReactorServerTest::testNotImpl()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(false);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", srv.port());
+	HTTPRequest request("GET", "/notImpl");
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getStatus() == HTTPResponse::HTTP_NOT_IMPLEMENTED);
+	assert (rbody.empty());
+}
+
+
+void HTTPReactorServerTest::testPipelining()
+{
+	for (int depth = 1; depth <= 4; depth *= 4)
+	{
+		ServerSocket svs(0);
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setKeepAlive(true);
+		pParams->setPipelineDepth(depth);
+		HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+		srv.start();
+
+		std::string requests;
+		for (int i = 1; i <= 4; ++i)
+		{
+			requests += "GET /echoHeader HTTP/1.1\r\nHost: localhost\r\nX-Seq: ";
+			requests += char('0' + i);
+			requests += "\r\n\r\n";
+		}
+		requests += "POST /echoBody HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\nTransfer-Encoding: chunked\r\n\r\n";
+		requests += "5\r\nhello\r\n0\r\n\r\n";
+		requests += "POST /echoBody HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\nContent-Length: 5\r\nConnection: close\r\n\r\nworld";
+
+		StreamSocket ss(SocketAddress("127.0.0.1", srv.port()));
+		ss.sendBytes(requests.data(), (int) requests.size());
+		std::string responses;
+		char buffer[1024];
+		int n;
+		while ((n = ss.receiveBytes(buffer, sizeof(buffer))) > 0)
+		{
+			responses.append(buffer, n);
+		}
+
+		std::istringstream istr(responses);
+		for (int i = 1; i <= 4; ++i)
+		{
+			HTTPResponse response;
+			response.read(istr);
+			assert (response.getStatus() == HTTPResponse::HTTP_OK);
+			assert (response.getKeepAlive());
+			std::string body(static_cast<std::size_t>(response.getContentLength()), 0);
+			istr.read(&body[0], body.size());
+			std::string seq("X-Seq: ");
+			seq += char('0' + i);
+			assert (body.find(seq) != std::string::npos);
+		}
+		HTTPResponse response;
+		response.read(istr);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (response.getChunkedTransferEncoding());
+		std::string line;
+		std::getline(istr, line);
+		assert (line == "5\r");
+		std::getline(istr, line);
+		assert (line == "hello\r");
+		std::getline(istr, line);
+		assert (line == "0\r");
+		std::getline(istr, line);
+		HTTPResponse lastResponse;
+		lastResponse.read(istr);
+		assert (lastResponse.getStatus() == HTTPResponse::HTTP_OK);
+		assert (!lastResponse.getKeepAlive());
+		std::string rbody;
+		StreamCopier::copyToString(istr, rbody);
+		assert (rbody == "world");
+	}
+}
+
+
+void HTTPReactorServerTest::testSplitRequest()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPReactorServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	StreamSocket ss(SocketAddress("127.0.0.1", srv.port()));
+	const std::string parts[] =
+	{
+		"POST /echoBody HTTP/1.1\r\nHost: local",
+		"host\r\nContent-Type: text/plain\r\nContent-Length: 10\r\nConnection: close\r\n",
+		"\r\nhello",
+		"world"
+	};
+	for (int i = 0; i < 4; ++i)
+	{
+		ss.sendBytes(parts[i].data(), (int) parts[i].size());
+		Thread::sleep(100);
+	}
+	std::string responses;
+	char buffer[1024];
+	int n;
+	while ((n = ss.receiveBytes(buffer, sizeof(buffer))) > 0)
+	{
+		responses.append(buffer, n);
+	}
+	std::istringstream istr(responses);
+	HTTPResponse response;
+	response.read(istr);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	std::string rbody;
+	StreamCopier::copyToString(istr, rbody);
+	assert (rbody == "helloworld");
+}
+
+
+void HTTPReactorServerTest::setUp()
+{
+}
+
+
+void HTTPReactorServerTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPReactorServerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPReactorServerTest");
+
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testIdentityRequest);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testChunkedRequest);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testLargeRequest);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testKeepAlive);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testKeepAliveTimeout);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, test100Continue);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testNotImpl);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testPipelining);
+	CppUnit_addTest(pSuite, HTTPReactorServerTest, testSplitRequest);
+
+	return pSuite;
+}
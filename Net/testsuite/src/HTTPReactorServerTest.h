@@ -0,0 +1,48 @@
+//
+// HTTPReactorServerTest.h
+//
+// $Id$
+//
+// Definition of the HTTPReactorServerTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPReactorServerTest_INCLUDED
+#define HTTPReactorServerTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTPReactorServerTest: public CppUnit::TestCase
+{
+public:
+	HTTPReactorServerTest(const std::string& name);
+	~HTTPReactorServerTest();
+
+	void testIdentityRequest();
+	void testChunkedRequest();
+	void testLargeRequest();
+	void testKeepAlive();
+	void testKeepAliveTimeout();
+	void test100Continue();
+	void testNotImpl();
+	void testPipelining();
+	void testSplitRequest();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPReactorServerTest_INCLUDED
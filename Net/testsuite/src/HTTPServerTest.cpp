@@ -23,7 +23,12 @@
 #include "Poco/Net/HTTPResponse.h"
 #include "Poco/Net/HTTPServerResponse.h"
 #include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
 #include "Poco/StreamCopier.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/FileStream.h"
+#include "Poco/NumberParser.h"
 #include <sstream>
 
 
@@ -39,6 +44,8 @@ using Poco::Net::HTTPResponse;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::HTTPMessage;
 using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
 using Poco::StreamCopier;
 
 
@@ -106,6 +113,98 @@ namespace
 		}
 	};
 	
+	class BuffersRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			static const std::string head("<html>");
+			static const std::string body(10000, 'x');
+			static const std::string tail("</html>");
+			Poco::Net::SocketBufVec buffers;
+			buffers.push_back(Poco::Net::Socket::makeBuffer(head.data(), head.size()));
+			buffers.push_back(Poco::Net::Socket::makeBuffer(body.data(), body.size()));
+			buffers.push_back(Poco::Net::Socket::makeBuffer(tail.data(), tail.size()));
+			response.setContentType("text/html");
+			response.sendBuffers(buffers);
+		}
+	};
+	
+	std::string filePath;
+
+	class FileRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			if (request.has("Range"))
+			{
+				// only "bytes=first-last" is supported here
+				const std::string& range = request.get("Range");
+				std::string::size_type dash = range.find('-');
+				Poco::UInt64 first = Poco::NumberParser::parseUnsigned64(range.substr(6, dash - 6));
+				Poco::UInt64 last  = Poco::NumberParser::parseUnsigned64(range.substr(dash + 1));
+				response.sendFile(filePath, "text/plain", first, last - first + 1);
+			}
+			else response.sendFile(filePath, "text/plain");
+		}
+	};
+	
+	class StringServerResponse: public HTTPServerResponse
+		/// An HTTPServerResponse that only implements the
+		/// pure virtual methods, writing to a string.
+	{
+	public:
+		using HTTPServerResponse::sendFile;
+
+		StringServerResponse():
+			_sent(false)
+		{
+		}
+
+		void sendContinue()
+		{
+		}
+
+		std::ostream& send()
+		{
+			write(_ostr);
+			_sent = true;
+			return _ostr;
+		}
+
+		void sendFile(const std::string&, const std::string&)
+		{
+		}
+
+		void sendBuffer(const void* pBuffer, std::size_t length)
+		{
+			send().write(static_cast<const char*>(pBuffer), static_cast<std::streamsize>(length));
+		}
+
+		void redirect(const std::string&, HTTPStatus)
+		{
+		}
+
+		void requireAuthentication(const std::string&)
+		{
+		}
+
+		bool sent() const
+		{
+			return _sent;
+		}
+
+		std::string str() const
+		{
+			return _ostr.str();
+		}
+
+	private:
+		std::ostringstream _ostr;
+		bool _sent;
+	};
+
 	class RequestHandlerFactory: public HTTPRequestHandlerFactory
 	{
 	public:
@@ -121,6 +220,10 @@ namespace
 				return new AuthRequestHandler();
 			else if (request.getURI() == "/buffer")
 				return new BufferRequestHandler();
+			else if (request.getURI() == "/buffers")
+				return new BuffersRequestHandler();
+			else if (request.getURI() == "/file")
+				return new FileRequestHandler();
 			else
 				return 0;
 		}
@@ -262,6 +365,51 @@ void HTTPServerTest::testIdentityRequestKeepAlive()
 	assert (rbody == body);}
 
 
+void HTTPServerTest::testFastHeaderParsing()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setFastHeaderParsing(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	std::string body(5000, 'x');
+	HTTPRequest request("POST", "/echoBody", HTTPMessage::HTTP_1_1);
+	request.setContentLength((int) body.length());
+	request.setContentType("text/plain");
+	cs.sendRequest(request) << body;
+	HTTPResponse response;
+	std::string rbody;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getContentLength() == body.size());
+	assert (response.getContentType() == "text/plain");
+	assert (response.getKeepAlive());
+	assert (rbody == body);
+
+	HTTPRequest headerRequest("GET", "/echoHeader", HTTPMessage::HTTP_1_1);
+	headerRequest.set("X-Test", "fast header parsing");
+	cs.sendRequest(headerRequest);
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getKeepAlive());
+	assert (rbody.find("GET /echoHeader HTTP/1.1") == 0);
+	assert (rbody.find("X-Test: fast header parsing\r\n") != std::string::npos);
+
+	body.assign(1000, 'y');
+	request.setContentLength((int) body.length());
+	request.setChunkedTransferEncoding(true);
+	request.setKeepAlive(false);
+	cs.sendRequest(request) << body;
+	cs.receiveResponse(response) >> rbody;
+	assert (response.getChunkedTransferEncoding());
+	assert (!response.getKeepAlive());
+	assert (rbody == body);
+}
+
+
 void HTTPServerTest::testChunkedRequestKeepAlive()
 {
 	HTTPServer srv(new RequestHandlerFactory, 8009);
@@ -518,6 +666,230 @@ void HTTPServerTest::testBuffer()
 }
 
 
+void HTTPServerTest::testBuffers()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/buffers", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response.getContentType() == "text/html");
+	assert (response.getContentLength() == 10013);
+	assert (rbody == "<html>" + std::string(10000, 'x') + "</html>");
+
+	request.setMethod(HTTPRequest::HTTP_HEAD);
+	cs.sendRequest(request);
+	HTTPResponse headResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(headResponse), rbody);
+	assert (headResponse.getContentLength() == 10013);
+	assert (rbody.empty());
+
+	// pipelined requests are collected in the write buffer
+	srv.stop();
+	ServerSocket svs2(0);
+	HTTPServerParams* pParams2 = new HTTPServerParams;
+	pParams2->setPipelineDepth(4);
+	HTTPServer srv2(new RequestHandlerFactory, svs2, pParams2);
+	srv2.start();
+	std::string requests("GET /buffers HTTP/1.1\r\nHost: localhost\r\n\r\nGET /buffers HTTP/1.1\r\nHost: localhost\r\nConnection: close\r\n\r\n");
+	StreamSocket ss(SocketAddress("127.0.0.1", svs2.address().port()));
+	ss.sendBytes(requests.data(), (int) requests.size());
+	std::string responses;
+	char buffer[1024];
+	int n;
+	while ((n = ss.receiveBytes(buffer, sizeof(buffer))) > 0)
+	{
+		responses.append(buffer, n);
+	}
+	std::istringstream istr(responses);
+	for (int i = 0; i < 2; ++i)
+	{
+		HTTPResponse pipelinedResponse;
+		pipelinedResponse.read(istr);
+		assert (pipelinedResponse.getStatus() == HTTPResponse::HTTP_OK);
+		std::string body(static_cast<std::size_t>(pipelinedResponse.getContentLength()), 0);
+		istr.read(&body[0], body.size());
+		assert (body == "<html>" + std::string(10000, 'x') + "</html>");
+	}
+}
+
+
+void HTTPServerTest::testFile()
+{
+	Poco::TemporaryFile file;
+	std::string content;
+	for (int i = 0; i < 20000; ++i) content += char('a' + i % 26);
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << content;
+	}
+	filePath = file.path();
+
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+	
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	HTTPRequest request("GET", "/file", HTTPMessage::HTTP_1_1);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getStatus() == HTTPResponse::HTTP_OK);
+	assert (response.getContentLength() == content.size());
+	assert (response.has("Last-Modified"));
+	assert (rbody == content);
+
+	request.set("Range", "bytes=100-199");
+	cs.sendRequest(request);
+	HTTPResponse rangeResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(rangeResponse), rbody);
+	assert (rangeResponse.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assert (rangeResponse.get("Content-Range") == "bytes 100-199/20000");
+	assert (rbody == content.substr(100, 100));
+
+	request.set("Range", "bytes=19990-29999");
+	cs.sendRequest(request);
+	HTTPResponse tailResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(tailResponse), rbody);
+	assert (tailResponse.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assert (tailResponse.get("Content-Range") == "bytes 19990-19999/20000");
+	assert (rbody == content.substr(19990));
+
+	request.set("Range", "bytes=20000-20099");
+	cs.sendRequest(request);
+	HTTPResponse invalidResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(invalidResponse), rbody);
+	assert (invalidResponse.getStatus() == HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+	assert (invalidResponse.get("Content-Range") == "bytes */20000");
+	assert (rbody.empty());
+
+	// empty range (length 0)
+	request.set("Range", "bytes=100-99");
+	cs.sendRequest(request);
+	HTTPResponse emptyResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(emptyResponse), rbody);
+	assert (emptyResponse.getStatus() == HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+	assert (emptyResponse.get("Content-Range") == "bytes */20000");
+	assert (emptyResponse.getContentLength() == 0);
+	assert (rbody.empty());
+
+	request.erase("Range");
+	request.setMethod(HTTPRequest::HTTP_HEAD);
+	cs.sendRequest(request);
+	HTTPResponse headResponse;
+	rbody.clear();
+	StreamCopier::copyToString(cs.receiveResponse(headResponse), rbody);
+	assert (headResponse.getContentLength() == content.size());
+	assert (rbody.empty());
+}
+
+
+void HTTPServerTest::testPipelining()
+{
+	for (int depth = 1; depth <= 8; depth *= 2)
+	{
+		ServerSocket svs(0);
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setKeepAlive(true);
+		pParams->setPipelineDepth(depth);
+		HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+		srv.start();
+
+		std::string requests;
+		for (int i = 1; i <= 4; ++i)
+		{
+			requests += "GET /echoHeader HTTP/1.1\r\nHost: localhost\r\nX-Seq: ";
+			requests += char('0' + i);
+			requests += "\r\n\r\n";
+		}
+		requests += "POST /echoBody HTTP/1.1\r\nHost: localhost\r\nContent-Type: text/plain\r\nContent-Length: 5\r\nConnection: close\r\n\r\nhello";
+
+		StreamSocket ss(SocketAddress("127.0.0.1", svs.address().port()));
+		ss.sendBytes(requests.data(), (int) requests.size());
+		std::string responses;
+		char buffer[1024];
+		int n;
+		while ((n = ss.receiveBytes(buffer, sizeof(buffer))) > 0)
+		{
+			responses.append(buffer, n);
+		}
+
+		std::istringstream istr(responses);
+		for (int i = 1; i <= 4; ++i)
+		{
+			HTTPResponse response;
+			response.read(istr);
+			assert (response.getStatus() == HTTPResponse::HTTP_OK);
+			assert (response.getKeepAlive());
+			std::string body(static_cast<std::size_t>(response.getContentLength()), 0);
+			istr.read(&body[0], body.size());
+			std::string seq("X-Seq: ");
+			seq += char('0' + i);
+			assert (body.find(seq) != std::string::npos);
+		}
+		HTTPResponse response;
+		response.read(istr);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (!response.getKeepAlive());
+		std::string rbody;
+		StreamCopier::copyToString(istr, rbody);
+		assert (rbody == "hello");
+	}
+}
+
+
+void HTTPServerTest::testDefaultResponse()
+{
+	StringServerResponse response1;
+	std::string head("<html>");
+	std::string tail("</html>");
+	Poco::Net::SocketBufVec buffers;
+	buffers.push_back(Poco::Net::Socket::makeBuffer(head.data(), head.size()));
+	buffers.push_back(Poco::Net::Socket::makeBuffer(tail.data(), tail.size()));
+	response1.sendBuffers(buffers);
+	assert (response1.sent());
+	assert (response1.str() == "HTTP/1.0 200 OK\r\nContent-Length: 13\r\n\r\n<html></html>");
+
+	Poco::TemporaryFile file;
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << "0123456789";
+	}
+	StringServerResponse response2;
+	response2.sendFile(file.path(), "text/plain", 2, 3);
+	assert (response2.getStatus() == HTTPResponse::HTTP_PARTIAL_CONTENT);
+	assert (response2.get("Content-Range") == "bytes 2-4/10");
+	assert (response2.getContentLength() == 3);
+	std::string str(response2.str());
+	assert (str.substr(str.size() - 7) == "\r\n\r\n234");
+
+	StringServerResponse response3;
+	response3.sendFile(file.path(), "text/plain", 10, 3);
+	assert (response3.getStatus() == HTTPResponse::HTTP_REQUESTED_RANGE_NOT_SATISFIABLE);
+	assert (response3.get("Content-Range") == "bytes */10");
+	str = response3.str();
+	assert (str.substr(str.size() - 4) == "\r\n\r\n");
+}
+
+
 void HTTPServerTest::setUp()
 {
 }
@@ -537,6 +909,7 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testChunkedRequest);
 	CppUnit_addTest(pSuite, HTTPServerTest, testClosedRequest);
 	CppUnit_addTest(pSuite, HTTPServerTest, testIdentityRequestKeepAlive);
+	CppUnit_addTest(pSuite, HTTPServerTest, testFastHeaderParsing);
 	CppUnit_addTest(pSuite, HTTPServerTest, testChunkedRequestKeepAlive);
 	CppUnit_addTest(pSuite, HTTPServerTest, testClosedRequestKeepAlive);
 	CppUnit_addTest(pSuite, HTTPServerTest, testMaxKeepAlive);
@@ -546,6 +919,10 @@ CppUnit::Test* HTTPServerTest::suite()
 	CppUnit_addTest(pSuite, HTTPServerTest, testAuth);
 	CppUnit_addTest(pSuite, HTTPServerTest, testNotImpl);
 	CppUnit_addTest(pSuite, HTTPServerTest, testBuffer);
+	CppUnit_addTest(pSuite, HTTPServerTest, testBuffers);
+	CppUnit_addTest(pSuite, HTTPServerTest, testFile);
+	CppUnit_addTest(pSuite, HTTPServerTest, testDefaultResponse);
+	CppUnit_addTest(pSuite, HTTPServerTest, testPipelining);
 
 	return pSuite;
 }
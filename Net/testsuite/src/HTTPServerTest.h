@@ -31,6 +31,7 @@ public:
 	void testChunkedRequest();
 	void testClosedRequest();
 	void testIdentityRequestKeepAlive();
+	void testFastHeaderParsing();
 	void testChunkedRequestKeepAlive();
 	void testClosedRequestKeepAlive();
 	void testMaxKeepAlive();
@@ -40,6 +41,10 @@ public:
 	void testAuth();
 	void testNotImpl();
 	void testBuffer();
+	void testBuffers();
+	void testFile();
+	void testDefaultResponse();
+	void testPipelining();
 
 	void setUp();
 	void tearDown();
@@ -12,6 +12,8 @@
 
 #include "HTTPServerTestSuite.h"
 #include "HTTPServerTest.h"
+#include "HTTPReactorServerTest.h"
+#include "ServerStatisticsTest.h"
 
 
 CppUnit::Test* HTTPServerTestSuite::suite()
@@ -19,6 +21,8 @@ CppUnit::Test* HTTPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPServerTestSuite");
 
 	pSuite->addTest(HTTPServerTest::suite());
+	pSuite->addTest(HTTPReactorServerTest::suite());
+	pSuite->addTest(ServerStatisticsTest::suite());
 
 	return pSuite;
 }
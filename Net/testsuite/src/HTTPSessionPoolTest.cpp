@@ -0,0 +1,320 @@
+//
+// HTTPSessionPoolTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "HTTPSessionPoolTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/HTTPSessionPool.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandler.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/URI.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/NumberFormatter.h"
+#include "Poco/ActiveResult.h"
+#include "Poco/Exception.h"
+#include "Poco/Thread.h"
+#include <sstream>
+
+
+using Poco::Net::HTTPSessionPool;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::ServerSocket;
+using Poco::URI;
+using Poco::StreamCopier;
+using Poco::ActiveResult;
+using Poco::Thread;
+
+
+namespace
+{
+	class HelloRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.setContentType("text/plain");
+			response.sendBuffer("Hello", 5);
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			return new HelloRequestHandler;
+		}
+	};
+
+	HTTPServerParams* createParams(int keepAliveTimeout = 10)
+	{
+		HTTPServerParams* pParams = new HTTPServerParams;
+		pParams->setKeepAlive(true);
+		pParams->setKeepAliveTimeout(Poco::Timespan(keepAliveTimeout, 0));
+		return pParams;
+	}
+
+	std::string hello(HTTPClientSession& session)
+	{
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/hello", HTTPMessage::HTTP_1_1);
+		session.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = session.receiveResponse(response);
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		return ostr.str();
+	}
+}
+
+
+HTTPSessionPoolTest::HTTPSessionPoolTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+HTTPSessionPoolTest::~HTTPSessionPoolTest()
+{
+}
+
+
+void HTTPSessionPoolTest::testReuse()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool;
+	HTTPClientSession* pSession = pool.get(uri);
+	assert (pool.used() == 1);
+	assert (pool.idle() == 0);
+	assert (hello(*pSession) == "Hello");
+	pool.release(pSession);
+	assert (pool.used() == 0);
+	assert (pool.idle() == 1);
+	assert (pool.allocated() == 1);
+
+	for (int i = 0; i < 5; ++i)
+	{
+		HTTPSessionPool::ScopedSession session(pool, uri);
+		assert (session.get() == pSession);
+		assert (hello(*session) == "Hello");
+	}
+	assert (pool.hits() == 5);
+	assert (pool.misses() == 1);
+	assert (pool.waits() == 0);
+	assert (pool.idle() == 1);
+	assert (srv.totalConnections() == 1);
+}
+
+
+void HTTPSessionPoolTest::testKey()
+{
+	assert (HTTPSessionPool::key(URI("http://www.appinf.com/index.html")) == "http://www.appinf.com:80");
+	assert (HTTPSessionPool::key(URI("HTTP://WWW.AppInf.com:8080/")) == "http://www.appinf.com:8080");
+	assert (HTTPSessionPool::key(URI("https://www.appinf.com/")) == "https://www.appinf.com:443");
+}
+
+
+void HTTPSessionPoolTest::testMaxSessionsPerHost()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool(2);
+	pool.setWaitTimeout(Poco::Timespan(0, 200000));
+	HTTPClientSession* pSession1 = pool.get(uri);
+	HTTPClientSession* pSession2 = pool.get(uri);
+	assert (pSession1 != pSession2);
+	try
+	{
+		pool.get(uri);
+		fail("limit reached - must throw");
+	}
+	catch (Poco::TimeoutException&)
+	{
+	}
+	assert (pool.waits() == 1);
+	assert (pool.used() == 2);
+
+	// a different server has its own limit
+	HTTPClientSession* pSession3 = pool.get(URI("http://localhost:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello"));
+	assert (pool.used() == 3);
+
+	pool.release(pSession1);
+	pool.release(pSession2);
+	pool.release(pSession3);
+	assert (pool.used() == 0);
+}
+
+
+void HTTPSessionPoolTest::testWait()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool(1);
+	HTTPClientSession* pSession = pool.get(uri);
+	assert (hello(*pSession) == "Hello");
+
+	ActiveResult<HTTPClientSession*> result = pool.getAsync(uri);
+	assert (!result.tryWait(200));
+	pool.release(pSession);
+	result.wait();
+	assert (result.data() == pSession);
+	assert (pool.waits() == 1);
+	assert (pool.hits() == 1);
+	pool.release(result.data());
+}
+
+
+void HTTPSessionPoolTest::testStale()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams(1));
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool;
+	HTTPClientSession* pSession = pool.get(uri);
+	assert (hello(*pSession) == "Hello");
+	pool.release(pSession);
+	assert (pool.idle() == 1);
+
+	// wait for the server to close the idle connection
+	Thread::sleep(2000);
+
+	pSession = pool.get(uri);
+	assert (pool.hits() == 0);
+	assert (pool.misses() == 2);
+	assert (hello(*pSession) == "Hello");
+	pool.release(pSession);
+	assert (srv.totalConnections() == 2);
+}
+
+
+void HTTPSessionPoolTest::testIdle()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool(8, 1);
+	HTTPClientSession* pSession = pool.get(uri);
+	assert (hello(*pSession) == "Hello");
+	pool.release(pSession);
+	assert (pool.idle() == 1);
+
+	Thread::sleep(2000);
+	assert (pool.idle() == 0);
+	assert (pool.allocated() == 0);
+}
+
+
+void HTTPSessionPoolTest::testAsync()
+{
+	ServerSocket svs(0);
+	HTTPServer srv(new RequestHandlerFactory, svs, createParams());
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool;
+	ActiveResult<HTTPClientSession*> result1 = pool.getAsync(uri);
+	ActiveResult<HTTPClientSession*> result2 = pool.getAsync(uri);
+	result1.wait();
+	result2.wait();
+	assert (result1.data() != result2.data());
+	assert (hello(*result1.data()) == "Hello");
+	assert (hello(*result2.data()) == "Hello");
+	pool.release(result1.data());
+	pool.release(result2.data());
+	assert (pool.idle() == 2);
+	assert (pool.misses() == 2);
+}
+
+
+void HTTPSessionPoolTest::testNoKeepAlive()
+{
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = createParams();
+	pParams->setKeepAlive(false);
+	HTTPServer srv(new RequestHandlerFactory, svs, pParams);
+	srv.start();
+
+	URI uri("http://127.0.0.1:" + Poco::NumberFormatter::format(svs.address().port()) + "/hello");
+	HTTPSessionPool pool;
+	HTTPClientSession* pSession = pool.get(uri);
+	assert (hello(*pSession) == "Hello");
+	pSession->setKeepAlive(false);
+	pool.release(pSession);
+	assert (pool.idle() == 0);
+	assert (pool.allocated() == 0);
+
+	HTTPClientSession other;
+	try
+	{
+		pool.release(&other);
+		fail("not from this pool - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+}
+
+
+void HTTPSessionPoolTest::setUp()
+{
+}
+
+
+void HTTPSessionPoolTest::tearDown()
+{
+}
+
+
+CppUnit::Test* HTTPSessionPoolTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPSessionPoolTest");
+
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testReuse);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testKey);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testMaxSessionsPerHost);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testWait);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testStale);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testIdle);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testAsync);
+	CppUnit_addTest(pSuite, HTTPSessionPoolTest, testNoKeepAlive);
+
+	return pSuite;
+}
@@ -0,0 +1,47 @@
+//
+// HTTPSessionPoolTest.h
+//
+// $Id$
+//
+// Definition of the HTTPSessionPoolTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef HTTPSessionPoolTest_INCLUDED
+#define HTTPSessionPoolTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class HTTPSessionPoolTest: public CppUnit::TestCase
+{
+public:
+	HTTPSessionPoolTest(const std::string& name);
+	~HTTPSessionPoolTest();
+
+	void testReuse();
+	void testKey();
+	void testMaxSessionsPerHost();
+	void testWait();
+	void testStale();
+	void testIdle();
+	void testAsync();
+	void testNoKeepAlive();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // HTTPSessionPoolTest_INCLUDED
@@ -12,9 +12,11 @@
 
 #include "HTTPTestSuite.h"
 #include "HTTPRequestTest.h"
+#include "HTTPHeaderTableTest.h"
 #include "HTTPResponseTest.h"
 #include "HTTPCookieTest.h"
 #include "HTTPCredentialsTest.h"
+#include "HTTPBufferAllocatorTest.h"
 
 
 CppUnit::Test* HTTPTestSuite::suite()
@@ -22,9 +24,11 @@ CppUnit::Test* HTTPTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("HTTPTestSuite");
 
 	pSuite->addTest(HTTPRequestTest::suite());
+	pSuite->addTest(HTTPHeaderTableTest::suite());
 	pSuite->addTest(HTTPResponseTest::suite());
 	pSuite->addTest(HTTPCookieTest::suite());
 	pSuite->addTest(HTTPCredentialsTest::suite());
+	pSuite->addTest(HTTPBufferAllocatorTest::suite());
 
 	return pSuite;
 }
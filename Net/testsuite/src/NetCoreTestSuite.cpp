@@ -14,6 +14,7 @@
 #include "IPAddressTest.h"
 #include "SocketAddressTest.h"
 #include "DNSTest.h"
+#include "DNSResolverTest.h"
 #include "NetworkInterfaceTest.h"
 
 
@@ -24,6 +25,7 @@ CppUnit::Test* NetCoreTestSuite::suite()
 	pSuite->addTest(IPAddressTest::suite());
 	pSuite->addTest(SocketAddressTest::suite());
 	pSuite->addTest(DNSTest::suite());
+	pSuite->addTest(DNSResolverTest::suite());
 #ifdef POCO_NET_HAS_INTERFACE
 	pSuite->addTest(NetworkInterfaceTest::suite());
 #endif // POCO_NET_HAS_INTERFACE
@@ -0,0 +1,194 @@
+//
+// PollSetTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "PollSetTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "EchoServer.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/PollSet.h"
+#include "Poco/Stopwatch.h"
+
+
+using Poco::Net::Socket;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketAddress;
+using Poco::Net::PollSet;
+using Poco::Timespan;
+using Poco::Stopwatch;
+
+
+PollSetTest::PollSetTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+PollSetTest::~PollSetTest()
+{
+}
+
+
+void PollSetTest::testPoll()
+{
+	EchoServer echoServer1;
+	EchoServer echoServer2;
+	StreamSocket ss1;
+	StreamSocket ss2;
+
+	ss1.connect(SocketAddress("127.0.0.1", echoServer1.port()));
+	ss2.connect(SocketAddress("127.0.0.1", echoServer2.port()));
+
+	PollSet ps;
+	assert (ps.empty());
+	ps.add(ss1, PollSet::POLL_READ);
+	assert (ps.has(ss1));
+	assert (!ps.has(ss2));
+	assert (ps.count() == 1);
+
+	// nothing readable
+	Stopwatch sw;
+	sw.start();
+	Timespan timeout(1000000);
+	assert (ps.poll(timeout).empty());
+	assert (sw.elapsed() >= 900000);
+
+	ps.add(ss2, PollSet::POLL_READ);
+	assert (ps.count() == 2);
+
+	// ss1 must be writable, if polled for
+	ps.update(ss1, PollSet::POLL_READ | PollSet::POLL_WRITE);
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assert (sm.find(ss1) != sm.end());
+	assert (sm.find(ss2) == sm.end());
+	assert (sm.find(ss1)->second == PollSet::POLL_WRITE);
+
+	ps.update(ss1, PollSet::POLL_READ);
+
+	ss1.sendBytes("hello", 5);
+	char buffer[256];
+	sw.restart();
+	sm = ps.poll(timeout);
+	assert (sw.elapsed() < 1100000);
+	assert (sm.find(ss1) != sm.end());
+	assert (sm.find(ss2) == sm.end());
+	assert (sm.find(ss1)->second == PollSet::POLL_READ);
+
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "hello");
+
+	ss2.sendBytes("HELLO", 5);
+	sw.restart();
+	sm = ps.poll(timeout);
+	assert (sw.elapsed() < 1100000);
+	assert (sm.find(ss1) == sm.end());
+	assert (sm.find(ss2) != sm.end());
+	assert (sm.find(ss2)->second == PollSet::POLL_READ);
+
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "HELLO");
+
+	ps.remove(ss2);
+	assert (!ps.has(ss2));
+	assert (ps.count() == 1);
+
+	ss2.sendBytes("HELLO", 5);
+	sw.restart();
+	sm = ps.poll(timeout);
+	assert (sm.empty());
+
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "HELLO");
+
+	ps.clear();
+	assert (ps.empty());
+
+	ss1.close();
+	ss2.close();
+}
+
+
+void PollSetTest::testPollEdgeTriggered()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	PollSet ps(PollSet::TRIGGER_EDGE);
+	ps.add(ss, PollSet::POLL_READ);
+
+	Timespan timeout(1000000);
+	ss.sendBytes("hello", 5);
+	PollSet::SocketModeMap sm = ps.poll(timeout);
+	assert (sm.find(ss) != sm.end());
+	assert (sm.find(ss)->second == PollSet::POLL_READ);
+
+	if (ps.trigger() == PollSet::TRIGGER_EDGE)
+	{
+		// data has not been read, but the state did not change
+		assert (ps.poll(Timespan(250000)).empty());
+	}
+	else
+	{
+		// level-triggered fallback reports the socket again
+		assert (!ps.poll(Timespan(250000)).empty());
+	}
+
+	char buffer[256];
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n == 5);
+	assert (std::string(buffer, n) == "hello");
+	ss.close();
+}
+
+
+void PollSetTest::testPollClosedSocket()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+
+	PollSet ps;
+	ps.add(ss, PollSet::POLL_READ);
+	ss.close();
+
+	assert (ps.poll(Timespan(250000)).empty());
+	ps.remove(ss);
+	assert (ps.empty());
+}
+
+
+void PollSetTest::setUp()
+{
+}
+
+
+void PollSetTest::tearDown()
+{
+}
+
+
+CppUnit::Test* PollSetTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("PollSetTest");
+
+	CppUnit_addTest(pSuite, PollSetTest, testPoll);
+	CppUnit_addTest(pSuite, PollSetTest, testPollEdgeTriggered);
+	CppUnit_addTest(pSuite, PollSetTest, testPollClosedSocket);
+
+	return pSuite;
+}
@@ -12,6 +12,8 @@
 
 #include "ReactorTestSuite.h"
 #include "SocketReactorTest.h"
+#include "SocketCompletionReactorTest.h"
+#include "SocketWriteQueueTest.h"
 
 
 CppUnit::Test* ReactorTestSuite::suite()
@@ -19,6 +21,8 @@ CppUnit::Test* ReactorTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ReactorTestSuite");
 
 	pSuite->addTest(SocketReactorTest::suite());
+	pSuite->addTest(SocketCompletionReactorTest::suite());
+	pSuite->addTest(SocketWriteQueueTest::suite());
 
 	return pSuite;
 }
@@ -0,0 +1,307 @@
+//
+// ServerStatisticsTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "ServerStatisticsTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/ServerStatistics.h"
+#include "Poco/Net/ServerStatisticsRequestHandler.h"
+#include "Poco/Net/HTTPServer.h"
+#include "Poco/Net/HTTPServerParams.h"
+#include "Poco/Net/HTTPRequestHandlerFactory.h"
+#include "Poco/Net/HTTPClientSession.h"
+#include "Poco/Net/HTTPRequest.h"
+#include "Poco/Net/HTTPServerRequest.h"
+#include "Poco/Net/HTTPResponse.h"
+#include "Poco/Net/HTTPServerResponse.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/StreamCopier.h"
+#include "Poco/Thread.h"
+#include <sstream>
+
+
+using Poco::Net::ServerStatistics;
+using Poco::Net::ServerStatisticsRequestHandler;
+using Poco::Net::HTTPServer;
+using Poco::Net::HTTPServerParams;
+using Poco::Net::HTTPRequestHandler;
+using Poco::Net::HTTPRequestHandlerFactory;
+using Poco::Net::HTTPClientSession;
+using Poco::Net::HTTPRequest;
+using Poco::Net::HTTPServerRequest;
+using Poco::Net::HTTPResponse;
+using Poco::Net::HTTPServerResponse;
+using Poco::Net::HTTPMessage;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::StreamCopier;
+
+
+namespace
+{
+	class HelloRequestHandler: public HTTPRequestHandler
+	{
+	public:
+		void handleRequest(HTTPServerRequest& request, HTTPServerResponse& response)
+		{
+			response.setContentType("text/plain");
+			response.sendBuffer("Hello, world!", 13);
+		}
+	};
+
+	class RequestHandlerFactory: public HTTPRequestHandlerFactory
+	{
+	public:
+		RequestHandlerFactory(ServerStatistics::Ptr pStatistics):
+			_pStatistics(pStatistics)
+		{
+		}
+
+		HTTPRequestHandler* createRequestHandler(const HTTPServerRequest& request)
+		{
+			if (request.getURI().compare(0, 6, "/stats") == 0)
+				return new ServerStatisticsRequestHandler(_pStatistics);
+			else
+				return new HelloRequestHandler;
+		}
+
+	private:
+		ServerStatistics::Ptr _pStatistics;
+	};
+}
+
+
+ServerStatisticsTest::ServerStatisticsTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+ServerStatisticsTest::~ServerStatisticsTest()
+{
+}
+
+
+void ServerStatisticsTest::testCounter()
+{
+	ServerStatistics::Ptr pStatistics = new ServerStatistics;
+	assert (pStatistics->requests().value() == 0);
+	pStatistics->requests().add();
+	pStatistics->requests().add(41);
+	assert (pStatistics->requests().value() == 42);
+	pStatistics->bytesSent().add(Poco::UInt64(1) << 40);
+	assert (pStatistics->bytesSent().value() == Poco::UInt64(1) << 40);
+	pStatistics->reset();
+	assert (pStatistics->requests().value() == 0);
+	assert (pStatistics->bytesSent().value() == 0);
+}
+
+
+void ServerStatisticsTest::testHistogramBuckets()
+{
+	typedef ServerStatistics::Histogram Histogram;
+
+	for (int i = 0; i < Histogram::SUB_BUCKET_COUNT; ++i)
+	{
+		assert (Histogram::bucketIndex(i) == i);
+		assert (Histogram::bucketLowerBound(i) == i);
+		assert (Histogram::bucketUpperBound(i) == i);
+	}
+	assert (Histogram::bucketIndex(16) == 16);
+	assert (Histogram::bucketIndex(31) == 31);
+	assert (Histogram::bucketIndex(32) == 32);
+	assert (Histogram::bucketIndex(33) == 32);
+	assert (Histogram::bucketLowerBound(32) == 32);
+	assert (Histogram::bucketUpperBound(32) == 33);
+	assert (Histogram::bucketIndex(Histogram::MAX_VALUE) == Histogram::BUCKET_COUNT - 1);
+	assert (Histogram::bucketIndex(Histogram::MAX_VALUE + 1) == Histogram::BUCKET_COUNT - 1);
+	assert (Histogram::bucketUpperBound(Histogram::BUCKET_COUNT - 1) == Histogram::MAX_VALUE);
+
+	// buckets are contiguous, and the relative bucket width is bounded
+	for (int i = 1; i < Histogram::BUCKET_COUNT; ++i)
+	{
+		Poco::UInt64 lower = Histogram::bucketLowerBound(i);
+		Poco::UInt64 upper = Histogram::bucketUpperBound(i);
+		assert (lower == Histogram::bucketUpperBound(i - 1) + 1);
+		assert (Histogram::bucketIndex(lower) == i);
+		assert (Histogram::bucketIndex(upper) == i);
+		assert ((upper - lower)*Histogram::SUB_BUCKET_COUNT <= lower);
+	}
+}
+
+
+void ServerStatisticsTest::testHistogramPercentiles()
+{
+	ServerStatistics::Histogram h;
+	assert (h.count() == 0);
+	assert (h.minimum() == 0);
+	assert (h.maximum() == 0);
+	assert (h.mean() == 0);
+	assert (h.percentile(50) == 0);
+
+	for (Poco::UInt64 i = 1; i <= 100; ++i)
+	{
+		h.record(i);
+	}
+	assert (h.count() == 100);
+	assert (h.sum() == 5050);
+	assert (h.minimum() == 1);
+	assert (h.maximum() == 100);
+	assert (h.mean() == 50.5);
+	assert (h.percentile(0) == 1);
+	assert (h.percentile(10) == 10);
+	assert (h.percentile(50) == 51);
+	assert (h.percentile(90) == 91);
+	assert (h.percentile(99) == 99);
+	assert (h.percentile(100) == 100);
+
+	h.record(1000000);
+	assert (h.maximum() == 1000000);
+	assert (h.percentile(100) == 1000000);
+	assert (h.percentile(50) == 51);
+
+	h.reset();
+	assert (h.count() == 0);
+	assert (h.sum() == 0);
+	assert (h.maximum() == 0);
+	assert (h.percentile(100) == 0);
+}
+
+
+void ServerStatisticsTest::testWriteJSON()
+{
+	ServerStatistics::Ptr pStatistics = new ServerStatistics;
+	pStatistics->requests().add(3);
+	pStatistics->requestHandleTime().record(10);
+	pStatistics->requestHandleTime().record(20);
+
+	std::ostringstream ostr;
+	pStatistics->writeJSON(ostr);
+	std::string json = ostr.str();
+	assert (json[0] == '{');
+	assert (json[json.size() - 1] == '}');
+	assert (json.find("\"requests\":3,") != std::string::npos);
+	assert (json.find("\"requestHandleTime\":{\"count\":2,\"sum\":30,\"min\":10,\"max\":20,\"mean\":15.0,\"p50\":10,") != std::string::npos);
+	assert (json.find("\"queueWaitTime\":{\"count\":0,") != std::string::npos);
+}
+
+
+void ServerStatisticsTest::testWritePrometheus()
+{
+	ServerStatistics::Ptr pStatistics = new ServerStatistics;
+	pStatistics->connections().add(2);
+	pStatistics->queueWaitTime().record(1500000);
+
+	std::ostringstream ostr;
+	pStatistics->writePrometheus(ostr, "test");
+	std::string text = ostr.str();
+	assert (text.find("# TYPE test_connections_total counter\ntest_connections_total 2\n") != std::string::npos);
+	assert (text.find("# TYPE test_queue_wait_seconds summary\n") != std::string::npos);
+	assert (text.find("test_queue_wait_seconds{quantile=\"0.5\"} 1.500000\n") != std::string::npos);
+	assert (text.find("test_queue_wait_seconds_sum 1.500000\n") != std::string::npos);
+	assert (text.find("test_queue_wait_seconds_count 1\n") != std::string::npos);
+}
+
+
+void ServerStatisticsTest::testHTTPServer()
+{
+	ServerStatistics::Ptr pStatistics = new ServerStatistics;
+	ServerSocket svs(0);
+	HTTPServerParams* pParams = new HTTPServerParams;
+	pParams->setKeepAlive(true);
+	pParams->setStatistics(pStatistics);
+	HTTPServer srv(new RequestHandlerFactory(pStatistics), svs, pParams);
+	srv.start();
+
+	HTTPClientSession cs("127.0.0.1", svs.address().port());
+	cs.setKeepAlive(true);
+	for (int i = 0; i < 2; ++i)
+	{
+		HTTPRequest request("GET", "/hello", HTTPMessage::HTTP_1_1);
+		cs.sendRequest(request);
+		HTTPResponse response;
+		std::string rbody;
+		StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+		assert (response.getStatus() == HTTPResponse::HTTP_OK);
+		assert (rbody == "Hello, world!");
+	}
+
+	HTTPRequest request("GET", "/stats?format=json", HTTPMessage::HTTP_1_1);
+	request.setKeepAlive(false);
+	cs.sendRequest(request);
+	HTTPResponse response;
+	std::string rbody;
+	StreamCopier::copyToString(cs.receiveResponse(response), rbody);
+	assert (response.getContentType() == "application/json");
+	assert (rbody.find("\"requests\":3,\"keepAliveRequests\":2,") != std::string::npos);
+
+	HTTPClientSession cs2("127.0.0.1", svs.address().port());
+	HTTPRequest request2("GET", "/stats", HTTPMessage::HTTP_1_1);
+	cs2.sendRequest(request2);
+	StreamCopier::copyToString(cs2.receiveResponse(response), rbody);
+	assert (response.getContentType() == "text/plain; version=0.0.4");
+	assert (rbody.find("poco_server_http_requests_total 4\n") != std::string::npos);
+
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", svs.address().port()));
+	std::string bad(100, 'X');
+	bad += " / HTTP/1.1\r\n\r\n";
+	ss.sendBytes(bad.data(), static_cast<int>(bad.size()));
+	char buffer[256];
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n).find("400") != std::string::npos);
+
+	srv.stop();
+	for (int i = 0; i < 50 && pStatistics->connections().value() < 3; ++i)
+	{
+		Poco::Thread::sleep(20);
+	}
+	assert (pStatistics->connections().value() == 3);
+	assert (pStatistics->queueWaitTime().count() == 3);
+	assert (pStatistics->connectionTime().count() == 3);
+	assert (pStatistics->requests().value() == 4);
+	assert (pStatistics->keepAliveRequests().value() == 2);
+	assert (pStatistics->badRequests().value() == 1);
+	assert (pStatistics->requestParseTime().count() == 4);
+	assert (pStatistics->requestHandleTime().count() == 4);
+	assert (pStatistics->responseWriteTime().count() == 4);
+	assert (pStatistics->bytesReceived().value() > 0);
+	assert (pStatistics->bytesSent().value() > 4*13);
+}
+
+
+void ServerStatisticsTest::setUp()
+{
+}
+
+
+void ServerStatisticsTest::tearDown()
+{
+}
+
+
+CppUnit::Test* ServerStatisticsTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("ServerStatisticsTest");
+
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testCounter);
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testHistogramBuckets);
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testHistogramPercentiles);
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testWriteJSON);
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testWritePrometheus);
+	CppUnit_addTest(pSuite, ServerStatisticsTest, testHTTPServer);
+
+	return pSuite;
+}
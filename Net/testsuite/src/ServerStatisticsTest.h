@@ -0,0 +1,45 @@
+//
+// ServerStatisticsTest.h
+//
+// $Id$
+//
+// Definition of the ServerStatisticsTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef ServerStatisticsTest_INCLUDED
+#define ServerStatisticsTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class ServerStatisticsTest: public CppUnit::TestCase
+{
+public:
+	ServerStatisticsTest(const std::string& name);
+	~ServerStatisticsTest();
+
+	void testCounter();
+	void testHistogramBuckets();
+	void testHistogramPercentiles();
+	void testWriteJSON();
+	void testWritePrometheus();
+	void testHTTPServer();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // ServerStatisticsTest_INCLUDED
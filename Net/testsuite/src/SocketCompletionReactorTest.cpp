@@ -0,0 +1,439 @@
+//
+// SocketCompletionReactorTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "SocketCompletionReactorTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/SocketCompletionReactor.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
+#include <string>
+
+
+using Poco::Net::SocketCompletionReactor;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::Socket;
+using Poco::Net::SocketAddress;
+using Poco::Thread;
+using Poco::Event;
+
+
+namespace
+{
+	class EchoHandler: public SocketCompletionReactor::Handler
+	{
+	public:
+		EchoHandler(SocketCompletionReactor& reactor):
+			_reactor(reactor),
+			_accepted(0),
+			_received(0),
+			_sent(0),
+			_closed(false),
+			_removed(false)
+		{
+		}
+
+		void onAccept(ServerSocket& serverSocket, StreamSocket& socket)
+		{
+			++_accepted;
+			_reactor.addSocket(socket, *this);
+		}
+
+		void onReceive(StreamSocket& socket, const char* buffer, std::size_t length)
+		{
+			if (length == 0)
+			{
+				_closed = true;
+				_removed = !_reactor.hasSocket(socket);
+				_done.set();
+			}
+			else
+			{
+				_received += length;
+				_reactor.send(socket, buffer, length);
+			}
+		}
+
+		void onSent(StreamSocket& socket, std::size_t length)
+		{
+			_sent += length;
+		}
+
+		bool waitClosed()
+		{
+			return _done.tryWait(5000);
+		}
+
+		int accepted() const
+		{
+			return _accepted;
+		}
+
+		std::size_t received() const
+		{
+			return _received;
+		}
+
+		std::size_t sent() const
+		{
+			return _sent;
+		}
+
+		bool closed() const
+		{
+			return _closed;
+		}
+
+		bool removed() const
+		{
+			return _removed;
+		}
+
+	private:
+		SocketCompletionReactor& _reactor;
+		int _accepted;
+		std::size_t _received;
+		std::size_t _sent;
+		bool _closed;
+		bool _removed;
+		Event _done;
+	};
+
+
+	class SendHandler: public SocketCompletionReactor::Handler
+	{
+	public:
+		SendHandler(SocketCompletionReactor& reactor, const std::string& data):
+			_reactor(reactor),
+			_data(data),
+			_sent(0),
+			_pending(0)
+		{
+		}
+
+		void onAccept(ServerSocket& serverSocket, StreamSocket& socket)
+		{
+			_reactor.addSocket(socket, *this);
+			// queue the data in several chunks
+			std::size_t chunk = _data.size()/4;
+			for (std::size_t pos = 0; pos < _data.size(); pos += chunk)
+			{
+				_reactor.send(socket, _data.data() + pos, pos + chunk < _data.size() ? chunk : _data.size() - pos);
+			}
+		}
+
+		void onSent(StreamSocket& socket, std::size_t length)
+		{
+			_sent += length;
+			if (_sent == _data.size())
+			{
+				_pending = _reactor.pendingOutput(socket);
+				_done.set();
+			}
+		}
+
+		bool waitSent()
+		{
+			return _done.tryWait(5000);
+		}
+
+		std::size_t sent() const
+		{
+			return _sent;
+		}
+
+		std::size_t pending() const
+		{
+			return _pending;
+		}
+
+	private:
+		SocketCompletionReactor& _reactor;
+		std::string _data;
+		std::size_t _sent;
+		std::size_t _pending;
+		Event _done;
+	};
+
+	class StallHandler: public SocketCompletionReactor::Handler
+	{
+	public:
+		StallHandler(SocketCompletionReactor& reactor, std::size_t size):
+			_reactor(reactor),
+			_data(size, 'x')
+		{
+		}
+
+		void onAccept(ServerSocket& serverSocket, StreamSocket& socket)
+		{
+			_socket = socket;
+			_reactor.addSocket(socket, *this);
+			_reactor.send(socket, _data.data(), _data.size());
+			_done.set();
+		}
+
+		bool waitAccepted()
+		{
+			return _done.tryWait(5000);
+		}
+
+		StreamSocket& socket()
+		{
+			return _socket;
+		}
+
+	private:
+		SocketCompletionReactor& _reactor;
+		std::string _data;
+		StreamSocket _socket;
+		Event _done;
+	};
+}
+
+
+SocketCompletionReactorTest::SocketCompletionReactorTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SocketCompletionReactorTest::~SocketCompletionReactorTest()
+{
+}
+
+
+void SocketCompletionReactorTest::testEcho()
+{
+	echo(true);
+}
+
+
+void SocketCompletionReactorTest::testEchoPollSet()
+{
+	echo(false);
+}
+
+
+void SocketCompletionReactorTest::testLargeSend()
+{
+	largeSend(true);
+}
+
+
+void SocketCompletionReactorTest::testLargeSendPollSet()
+{
+	largeSend(false);
+}
+
+
+void SocketCompletionReactorTest::testPeerShutdown()
+{
+	SocketCompletionReactor reactor;
+	EchoHandler handler(reactor);
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	reactor.addAcceptor(ss, handler);
+	assert (reactor.hasSocket(ss));
+	Thread thread;
+	thread.start(reactor);
+
+	StreamSocket sock;
+	sock.connect(SocketAddress("127.0.0.1", ss.address().port()));
+	sock.shutdownSend();
+	assert (handler.waitClosed());
+	assert (handler.closed());
+	assert (handler.removed());
+	assert (handler.received() == 0);
+
+	reactor.stop();
+	thread.join();
+	reactor.removeSocket(ss);
+	assert (!reactor.hasSocket(ss));
+}
+
+
+void SocketCompletionReactorTest::testMaxSockets()
+{
+	// With io_uring, the slot of a removed socket only becomes
+	// available again once its pending operations have completed.
+	SocketCompletionReactor reactor(1, 1024, false);
+	SocketCompletionReactor::Handler handler;
+	ServerSocket ss1(SocketAddress("127.0.0.1", 0));
+	ServerSocket ss2(SocketAddress("127.0.0.1", 0));
+	reactor.addAcceptor(ss1, handler);
+	try
+	{
+		reactor.addAcceptor(ss1, handler);
+		fail("socket already added - must throw");
+	}
+	catch (Poco::ExistsException&)
+	{
+	}
+	try
+	{
+		reactor.addAcceptor(ss2, handler);
+		fail("too many sockets - must throw");
+	}
+	catch (Poco::IllegalStateException&)
+	{
+	}
+	reactor.removeSocket(ss1);
+	reactor.addAcceptor(ss2, handler);
+	assert (reactor.hasSocket(ss2));
+	assert (!reactor.hasSocket(ss1));
+}
+
+
+void SocketCompletionReactorTest::testRemoveWhileSending()
+{
+	// The peer does not receive, so the send operation is still
+	// pending when the socket is removed and when the reactor is
+	// destroyed. Its data must remain valid until it has completed.
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket sock;
+	{
+		SocketCompletionReactor reactor(16, 1024);
+		StallHandler handler(reactor, 16*1024*1024);
+		reactor.addAcceptor(ss, handler);
+		Thread thread;
+		thread.start(reactor);
+
+		sock.connect(SocketAddress("127.0.0.1", ss.address().port()));
+		assert (handler.waitAccepted());
+		Thread::sleep(100);
+		reactor.stop();
+		thread.join();
+		assert (reactor.pendingOutput(handler.socket()) > 0);
+
+		reactor.removeSocket(handler.socket());
+		assert (!reactor.hasSocket(handler.socket()));
+		assert (reactor.pendingOutput(handler.socket()) == 0);
+	}
+
+	sock.setReceiveTimeout(Poco::Timespan(5, 0));
+	char buffer[8192];
+	int n = sock.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (buffer[0] == 'x' && buffer[n - 1] == 'x');
+}
+
+
+void SocketCompletionReactorTest::echo(bool useIOUring)
+{
+	SocketCompletionReactor reactor(SocketCompletionReactor::DEFAULT_MAX_SOCKETS, SocketCompletionReactor::DEFAULT_BUFFER_SIZE, useIOUring);
+	assert (reactor.usesIOUring() == (useIOUring && SocketCompletionReactor::isIOUringAvailable()));
+	EchoHandler handler(reactor);
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	reactor.addAcceptor(ss, handler);
+	Thread thread;
+	thread.start(reactor);
+
+	StreamSocket sock1;
+	sock1.connect(SocketAddress("127.0.0.1", ss.address().port()));
+	StreamSocket sock2;
+	sock2.connect(SocketAddress("127.0.0.1", ss.address().port()));
+	sock1.setReceiveTimeout(Poco::Timespan(5, 0));
+	sock2.setReceiveTimeout(Poco::Timespan(5, 0));
+
+	char buffer[256];
+	int n = sock1.sendBytes("hello", 5);
+	assert (n == 5);
+	n = sock1.receiveBytes(buffer, sizeof(buffer));
+	assert (std::string(buffer, n) == "hello");
+
+	n = sock2.sendBytes("hello, world", 12);
+	assert (n == 12);
+	std::string received;
+	while (received.size() < 12)
+	{
+		n = sock2.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		received.append(buffer, n);
+	}
+	assert (received == "hello, world");
+
+	sock1.close();
+	assert (handler.waitClosed());
+	sock2.close();
+
+	reactor.stop();
+	thread.join();
+	assert (handler.accepted() == 2);
+	assert (handler.received() == 17);
+	assert (handler.sent() == 17);
+}
+
+
+void SocketCompletionReactorTest::largeSend(bool useIOUring)
+{
+	std::string data;
+	data.reserve(1024*1024);
+	for (int i = 0; i < 1024*1024; ++i)
+	{
+		data += static_cast<char>('a' + i % 26);
+	}
+
+	SocketCompletionReactor reactor(16, 1024, useIOUring);
+	SendHandler handler(reactor, data);
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	reactor.addAcceptor(ss, handler);
+	Thread thread;
+	thread.start(reactor);
+
+	StreamSocket sock;
+	sock.connect(SocketAddress("127.0.0.1", ss.address().port()));
+	sock.setReceiveTimeout(Poco::Timespan(5, 0));
+	std::string received;
+	char buffer[8192];
+	while (received.size() < data.size())
+	{
+		int n = sock.receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		received.append(buffer, n);
+	}
+	assert (received == data);
+	assert (handler.waitSent());
+	assert (handler.sent() == data.size());
+	assert (handler.pending() == 0);
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketCompletionReactorTest::setUp()
+{
+}
+
+
+void SocketCompletionReactorTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SocketCompletionReactorTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SocketCompletionReactorTest");
+
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testEcho);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testEchoPollSet);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testLargeSend);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testLargeSendPollSet);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testPeerShutdown);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testMaxSockets);
+	CppUnit_addTest(pSuite, SocketCompletionReactorTest, testRemoveWhileSending);
+
+	return pSuite;
+}
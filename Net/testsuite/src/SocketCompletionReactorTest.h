@@ -0,0 +1,48 @@
+//
+// SocketCompletionReactorTest.h
+//
+// $Id$
+//
+// Definition of the SocketCompletionReactorTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef SocketCompletionReactorTest_INCLUDED
+#define SocketCompletionReactorTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class SocketCompletionReactorTest: public CppUnit::TestCase
+{
+public:
+	SocketCompletionReactorTest(const std::string& name);
+	~SocketCompletionReactorTest();
+
+	void testEcho();
+	void testEchoPollSet();
+	void testLargeSend();
+	void testLargeSendPollSet();
+	void testPeerShutdown();
+	void testMaxSockets();
+	void testRemoveWhileSending();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+	void echo(bool useIOUring);
+	void largeSend(bool useIOUring);
+};
+
+
+#endif // SocketCompletionReactorTest_INCLUDED
@@ -16,23 +16,30 @@
 #include "Poco/Net/SocketReactor.h"
 #include "Poco/Net/SocketNotification.h"
 #include "Poco/Net/SocketConnector.h"
+#include "Poco/Net/HappyEyeballsConnector.h"
 #include "Poco/Net/SocketAcceptor.h"
 #include "Poco/Net/ParallelSocketAcceptor.h"
 #include "Poco/Net/StreamSocket.h"
 #include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/DatagramSocket.h"
 #include "Poco/Net/SocketAddress.h"
+#include "Poco/Net/DNSResolver.h"
 #include "Poco/Observer.h"
 #include "Poco/Exception.h"
+#include "Poco/Thread.h"
 #include <sstream>
 
 
 using Poco::Net::SocketReactor;
 using Poco::Net::SocketConnector;
+using Poco::Net::HappyEyeballsConnector;
 using Poco::Net::SocketAcceptor;
 using Poco::Net::ParallelSocketAcceptor;
 using Poco::Net::StreamSocket;
 using Poco::Net::ServerSocket;
+using Poco::Net::DatagramSocket;
 using Poco::Net::SocketAddress;
+using Poco::Net::DNSResolver;
 using Poco::Net::SocketNotification;
 using Poco::Net::ReadableNotification;
 using Poco::Net::WritableNotification;
@@ -295,6 +302,112 @@ namespace
 		bool _failed;
 		bool _shutdown;
 	};
+
+	
+	
+	class ResolveFailConnector: public SocketConnector<ClientServiceHandler>
+	{
+	public:
+		ResolveFailConnector(const std::string& host, SocketReactor& reactor, DNSResolver& resolver):
+			SocketConnector<ClientServiceHandler>(host, 80, reactor, resolver),
+			_errorCode(0)
+		{
+		}
+
+		void onError(int errorCode)
+		{
+			_errorCode = errorCode;
+		}
+
+		int errorCode() const
+		{
+			return _errorCode;
+		}
+
+	private:
+		int _errorCode;
+	};
+
+
+	class FailHappyEyeballsConnector: public HappyEyeballsConnector<ClientServiceHandler>
+	{
+	public:
+		FailHappyEyeballsConnector(const std::vector<SocketAddress>& addresses, SocketReactor& reactor):
+			HappyEyeballsConnector<ClientServiceHandler>(addresses, reactor),
+			_errorCode(0)
+		{
+		}
+
+		FailHappyEyeballsConnector(const std::string& host, SocketReactor& reactor, DNSResolver& resolver):
+			HappyEyeballsConnector<ClientServiceHandler>(host, 80, reactor, resolver),
+			_errorCode(0)
+		{
+		}
+
+		void onError(int errorCode)
+		{
+			_errorCode = errorCode;
+			reactor().stop();
+		}
+
+		int errorCode() const
+		{
+			return _errorCode;
+		}
+
+		static std::vector<SocketAddress> interleave(const std::vector<SocketAddress>& addresses)
+		{
+			return HappyEyeballsConnector<ClientServiceHandler>::interleave(addresses);
+		}
+
+	private:
+		int _errorCode;
+	};
+
+	
+	class BusyHandler
+		/// Keeps a SocketReactor busy with a socket that is always
+		/// writable, so that the reactor's poll never times out.
+	{
+	public:
+		BusyHandler(SocketReactor& reactor):
+			_socket(SocketAddress("127.0.0.1", 0)),
+			_reactor(reactor),
+			_count(0)
+		{
+			_reactor.addEventHandler(_socket, Observer<BusyHandler, WritableNotification>(*this, &BusyHandler::onWritable));
+		}
+
+		~BusyHandler()
+		{
+			_reactor.removeEventHandler(_socket, Observer<BusyHandler, WritableNotification>(*this, &BusyHandler::onWritable));
+		}
+
+		void onWritable(WritableNotification* pNf)
+		{
+			pNf->release();
+			++_count;
+		}
+
+		int count() const
+		{
+			return _count;
+		}
+
+	private:
+		DatagramSocket _socket;
+		SocketReactor& _reactor;
+		int _count;
+	};
+
+
+	Poco::UInt16 closedPort()
+	{
+		ServerSocket ss(SocketAddress("127.0.0.1", 0));
+		Poco::UInt16 port = ss.address().port();
+		ss.close();
+		return port;
+	}
 }
 
 
@@ -397,6 +510,138 @@ void SocketReactorTest::testSocketConnectorTimeout()
 }
 
 
+void SocketReactorTest::testSocketConnectorResolver()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	DNSResolver resolver;
+	SocketConnector<ClientServiceHandler> connector("localhost", ss.address().port(), reactor, resolver);
+	assert (resolver.cacheMisses() == 0);
+	connector.start();
+	ClientServiceHandler::setOnce(true);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assert (data.size() == 1024);
+	assert (!ClientServiceHandler::readableError());
+	assert (!ClientServiceHandler::writableError());
+	assert (!ClientServiceHandler::timeoutError());
+	assert (resolver.cacheMisses() == 1);
+}
+
+
+void SocketReactorTest::testSocketConnectorResolveError()
+{
+	// A cached lookup failure is reported from within start(), to
+	// the subclass's onError(), which must already be in place.
+	SocketReactor reactor;
+	DNSResolver resolver;
+	try
+	{
+		resolver.resolve("nonexistent.invalid");
+		fail("nonexistent host - must throw");
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	ResolveFailConnector connector("nonexistent.invalid", reactor, resolver);
+	assert (connector.errorCode() == 0);
+	connector.start();
+	assert (connector.errorCode() == POCO_EHOSTUNREACH);
+
+	FailHappyEyeballsConnector heConnector("nonexistent.invalid", reactor, resolver);
+	assert (heConnector.errorCode() == 0);
+	heConnector.start();
+	assert (heConnector.errorCode() == POCO_EHOSTUNREACH);
+	assert (resolver.cacheHits() == 2);
+}
+
+
+void SocketReactorTest::testHappyEyeballsConnector()
+{
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	std::vector<SocketAddress> addresses;
+	addresses.push_back(SocketAddress("127.0.0.1", closedPort()));
+	addresses.push_back(SocketAddress("127.0.0.1", ss.address().port()));
+	HappyEyeballsConnector<ClientServiceHandler> connector(addresses, reactor);
+	ClientServiceHandler::setOnce(true);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assert (data.size() == 1024);
+	assert (!ClientServiceHandler::readableError());
+	assert (!ClientServiceHandler::writableError());
+	assert (!ClientServiceHandler::timeoutError());
+}
+
+
+void SocketReactorTest::testHappyEyeballsConnectorFail()
+{
+	SocketReactor reactor;
+	std::vector<SocketAddress> addresses;
+	addresses.push_back(SocketAddress("127.0.0.1", closedPort()));
+	addresses.push_back(SocketAddress("127.0.0.1", closedPort()));
+	FailHappyEyeballsConnector connector(addresses, reactor);
+	reactor.run();
+	assert (connector.errorCode() != 0);
+}
+
+
+void SocketReactorTest::testHappyEyeballsConnectorBusy()
+{
+	// A listening socket with a full accept queue drops further
+	// SYNs, so connection attempts to it neither succeed nor fail.
+	ServerSocket blackhole(SocketAddress("127.0.0.1", 0), 0);
+	std::vector<StreamSocket> fillers(3);
+	for (std::vector<StreamSocket>::iterator it = fillers.begin(); it != fillers.end(); ++it)
+	{
+		it->connectNB(blackhole.address());
+	}
+	Poco::Thread::sleep(100);
+
+	SocketAddress ssa;
+	ServerSocket ss(ssa);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(ss, reactor);
+	BusyHandler busy(reactor);
+	std::vector<SocketAddress> addresses;
+	addresses.push_back(blackhole.address());
+	addresses.push_back(SocketAddress("127.0.0.1", ss.address().port()));
+	HappyEyeballsConnector<ClientServiceHandler> connector(addresses, reactor);
+	connector.setAttemptDelay(Poco::Timespan(60, 0));
+	connector.setAttemptTimeout(Poco::Timespan(0, 200000));
+	ClientServiceHandler::setOnce(true);
+	ClientServiceHandler::resetData();
+	reactor.run();
+	std::string data(ClientServiceHandler::data());
+	assert (data.size() == 1024);
+	assert (busy.count() > 0);
+}
+
+
+void SocketReactorTest::testHappyEyeballsInterleave()
+{
+	std::vector<SocketAddress> addresses;
+	addresses.push_back(SocketAddress("2001:db8::1", 80));
+	addresses.push_back(SocketAddress("2001:db8::2", 80));
+	addresses.push_back(SocketAddress("2001:db8::3", 80));
+	addresses.push_back(SocketAddress("10.0.0.1", 80));
+	addresses.push_back(SocketAddress("10.0.0.2", 80));
+	std::vector<SocketAddress> result = FailHappyEyeballsConnector::interleave(addresses);
+	assert (result.size() == 5);
+	assert (result[0].host().toString() == "2001:db8::1");
+	assert (result[1].host().toString() == "10.0.0.1");
+	assert (result[2].host().toString() == "2001:db8::2");
+	assert (result[3].host().toString() == "10.0.0.2");
+	assert (result[4].host().toString() == "2001:db8::3");
+}
+
+
 void SocketReactorTest::setUp()
 {
 	ClientServiceHandler::setCloseOnTimeout(false);
@@ -416,6 +661,14 @@ CppUnit::Test* SocketReactorTest::suite()
 	CppUnit_addTest(pSuite, SocketReactorTest, testParallelSocketReactor);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorFail);
 	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorTimeout);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorResolver);
+	CppUnit_addTest(pSuite, SocketReactorTest, testSocketConnectorResolveError);
+	CppUnit_addTest(pSuite, SocketReactorTest, testHappyEyeballsConnector);
+	CppUnit_addTest(pSuite, SocketReactorTest, testHappyEyeballsConnectorFail);
+	CppUnit_addTest(pSuite, SocketReactorTest, testHappyEyeballsConnectorBusy);
+#if defined(POCO_HAVE_IPv6)
+	CppUnit_addTest(pSuite, SocketReactorTest, testHappyEyeballsInterleave);
+#endif
 
 	return pSuite;
 }
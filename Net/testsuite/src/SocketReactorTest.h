@@ -31,6 +31,12 @@ public:
 	void testParallelSocketReactor();
 	void testSocketConnectorFail();
 	void testSocketConnectorTimeout();
+	void testSocketConnectorResolver();
+	void testSocketConnectorResolveError();
+	void testHappyEyeballsConnector();
+	void testHappyEyeballsConnectorFail();
+	void testHappyEyeballsConnectorBusy();
+	void testHappyEyeballsInterleave();
 
 	void setUp();
 	void tearDown();
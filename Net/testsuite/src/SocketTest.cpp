@@ -24,6 +24,9 @@
 #include "Poco/FIFOBuffer.h"
 #include "Poco/Delegate.h"
 #include "Poco/File.h"
+#include "Poco/FileStream.h"
+#include "Poco/TemporaryFile.h"
+#include "Poco/Thread.h"
 #include <iostream>
 
 
@@ -66,6 +69,87 @@ void SocketTest::testEcho()
 }
 
 
+void SocketTest::testSendBytesVector()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+	std::string header("hello, ");
+	std::string body(20000, 'x');
+	std::string trailer("bye");
+	Poco::Net::SocketBufVec buffers;
+	buffers.push_back(Socket::makeBuffer(header.data(), header.size()));
+	buffers.push_back(Socket::makeBuffer(body.data(), body.size()));
+	buffers.push_back(Socket::makeBuffer(trailer.data(), trailer.size()));
+	assert (Socket::bufferLength(buffers) == header.size() + body.size() + trailer.size());
+	int n = ss.sendBytes(buffers);
+	assert (n == static_cast<int>(Socket::bufferLength(buffers)));
+	std::string received;
+	char buffer[4096];
+	while (received.size() < static_cast<std::size_t>(n))
+	{
+		int rc = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (rc > 0);
+		received.append(buffer, rc);
+	}
+	assert (received == header + body + trailer);
+	ss.close();
+}
+
+
+void SocketTest::testReceiveBytesVector()
+{
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+	std::string data("hello, world");
+	int n = ss.sendBytes(data.data(), (int) data.size());
+	assert (n == data.size());
+	char header[7];
+	char body[64];
+	Poco::Net::SocketBufVec buffers;
+	buffers.push_back(Socket::makeBuffer(header, sizeof(header)));
+	buffers.push_back(Socket::makeBuffer(body, sizeof(body)));
+	for (int i = 0; i < 100 && ss.available() < n; ++i)
+		Poco::Thread::sleep(10);
+	assert (ss.receiveBytes(buffers) == n);
+	assert (std::string(header, sizeof(header)) == "hello, ");
+	assert (std::string(body, n - sizeof(header)) == "world");
+	ss.close();
+}
+
+
+void SocketTest::testSendFile()
+{
+	Poco::TemporaryFile file;
+	std::string content;
+	for (int i = 0; i < 50000; ++i) content += char('0' + i % 10);
+	{
+		Poco::FileOutputStream ostr(file.path());
+		ostr << content;
+	}
+
+	EchoServer echoServer;
+	StreamSocket ss;
+	ss.connect(SocketAddress("127.0.0.1", echoServer.port()));
+	Poco::FileInputStream istr(file.path());
+	Poco::Int64 n = ss.sendFile(istr, 1000, 10000);
+	assert (n == 10000);
+	n = ss.sendFile(istr, 49990);
+	assert (n == 10);
+	std::string received;
+	char buffer[4096];
+	while (received.size() < 10010)
+	{
+		int rc = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (rc > 0);
+		received.append(buffer, rc);
+	}
+	assert (received == content.substr(1000, 10000) + content.substr(49990));
+	ss.close();
+}
+
+
 void SocketTest::testPoll()
 {
 	EchoServer echoServer;
@@ -557,6 +641,9 @@ CppUnit::Test* SocketTest::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SocketTest");
 
 	CppUnit_addTest(pSuite, SocketTest, testEcho);
+	CppUnit_addTest(pSuite, SocketTest, testSendBytesVector);
+	CppUnit_addTest(pSuite, SocketTest, testReceiveBytesVector);
+	CppUnit_addTest(pSuite, SocketTest, testSendFile);
 	CppUnit_addTest(pSuite, SocketTest, testPoll);
 	CppUnit_addTest(pSuite, SocketTest, testAvailable);
 	CppUnit_addTest(pSuite, SocketTest, testFIFOBuffer);
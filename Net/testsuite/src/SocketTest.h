@@ -27,6 +27,9 @@ public:
 	~SocketTest();
 
 	void testEcho();
+	void testSendBytesVector();
+	void testReceiveBytesVector();
+	void testSendFile();
 	void testPoll();
 	void testAvailable();
 	void testFIFOBuffer();
@@ -0,0 +1,363 @@
+//
+// SocketWriteQueueTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "SocketWriteQueueTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/SocketWriteQueue.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/ServerSocket.h"
+#include "Poco/Net/StreamSocket.h"
+#include "Poco/Net/SocketAddress.h"
+#include "Poco/Delegate.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include "Poco/Exception.h"
+#include <string>
+
+
+using Poco::Net::SocketWriteQueue;
+using Poco::Net::SocketReactor;
+using Poco::Net::ServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::SocketAddress;
+using Poco::Thread;
+using Poco::Event;
+using Poco::delegate;
+
+
+namespace
+{
+	class WatermarkObserver
+	{
+	public:
+		WatermarkObserver():
+			_high(0),
+			_low(0),
+			_failed(0)
+		{
+		}
+
+		void onHighWatermark(const void* pSender, const std::size_t& pending)
+		{
+			++_high;
+			_highEvent.set();
+		}
+
+		void onLowWatermark(const void* pSender, const std::size_t& pending)
+		{
+			++_low;
+			_lowEvent.set();
+		}
+
+		void onWriteFailed(const void* pSender, const Poco::Exception& exc)
+		{
+			++_failed;
+			_failedEvent.set();
+		}
+
+		bool waitHigh()
+		{
+			return _highEvent.tryWait(5000);
+		}
+
+		bool waitLow()
+		{
+			return _lowEvent.tryWait(5000);
+		}
+
+		bool waitFailed()
+		{
+			return _failedEvent.tryWait(5000);
+		}
+
+		int high() const
+		{
+			return _high;
+		}
+
+		int low() const
+		{
+			return _low;
+		}
+
+		int failed() const
+		{
+			return _failed;
+		}
+
+	private:
+		int _high;
+		int _low;
+		int _failed;
+		Event _highEvent;
+		Event _lowEvent;
+		Event _failedEvent;
+	};
+
+	std::string makeData(std::size_t size, char first)
+	{
+		std::string data;
+		data.reserve(size);
+		for (std::size_t i = 0; i < size; ++i)
+		{
+			data += static_cast<char>(first + i % 26);
+		}
+		return data;
+	}
+
+	std::string receive(StreamSocket& socket, std::size_t size)
+	{
+		std::string received;
+		char buffer[16384];
+		while (received.size() < size)
+		{
+			int n = socket.receiveBytes(buffer, sizeof(buffer));
+			if (n <= 0) break;
+			received.append(buffer, n);
+		}
+		return received;
+	}
+
+	bool waitEmpty(const SocketWriteQueue& queue)
+	{
+		for (int i = 0; i < 250 && !queue.empty(); ++i)
+		{
+			Thread::sleep(20);
+		}
+		return queue.empty();
+	}
+}
+
+
+SocketWriteQueueTest::SocketWriteQueueTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SocketWriteQueueTest::~SocketWriteQueueTest()
+{
+}
+
+
+void SocketWriteQueueTest::testWrite()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket client;
+	client.connect(ss.address());
+	client.setReceiveTimeout(Poco::Timespan(5, 0));
+	StreamSocket server = ss.acceptConnection();
+
+	SocketReactor reactor;
+	Thread thread;
+	thread.start(reactor);
+	{
+		SocketWriteQueue queue(server, reactor);
+		assert (queue.empty());
+		assert (queue.socket() == server);
+		assert (server.getBlocking() == false);
+
+		std::string expected;
+		for (int i = 0; i < 1000; ++i)
+		{
+			std::string line = "line ";
+			line += static_cast<char>('0' + i % 10);
+			line += '\n';
+			queue.write(line.data(), line.size());
+			expected += line;
+		}
+		std::string data = makeData(100000, 'a');
+		std::string copy(data);
+		queue.adopt(copy);
+		assert (copy.empty());
+		expected += data;
+
+		std::string received = receive(client, expected.size());
+		assert (received == expected);
+		assert (waitEmpty(queue));
+		assert (!queue.failed());
+	}
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketWriteQueueTest::testSharedBuffer()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket client1;
+	client1.connect(ss.address());
+	client1.setReceiveTimeout(Poco::Timespan(5, 0));
+	StreamSocket server1 = ss.acceptConnection();
+	StreamSocket client2;
+	client2.connect(ss.address());
+	client2.setReceiveTimeout(Poco::Timespan(5, 0));
+	StreamSocket server2 = ss.acceptConnection();
+
+	SocketReactor reactor;
+	Thread thread;
+	thread.start(reactor);
+	{
+		SocketWriteQueue queue1(server1, reactor);
+		SocketWriteQueue queue2(server2, reactor);
+
+		SocketWriteQueue::SharedBuffer pMessage(new std::string(makeData(4*1024*1024, 'A')));
+		queue1.write(pMessage);
+		queue2.write(pMessage);
+		queue1.write("end", 3);
+		queue2.write("end", 3);
+
+		std::string received = receive(client2, pMessage->size() + 3);
+		assert (received == *pMessage + "end");
+		received = receive(client1, pMessage->size() + 3);
+		assert (received == *pMessage + "end");
+		assert (waitEmpty(queue1));
+		assert (waitEmpty(queue2));
+	}
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketWriteQueueTest::testBackpressure()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket client;
+	client.connect(ss.address());
+	client.setReceiveTimeout(Poco::Timespan(5, 0));
+	StreamSocket server = ss.acceptConnection();
+
+	SocketReactor reactor;
+	Thread thread;
+	thread.start(reactor);
+	{
+		WatermarkObserver observer;
+		SocketWriteQueue queue(server, reactor);
+		queue.setWatermarks(64*1024, 256*1024);
+		queue.highWatermarkReached += delegate(&observer, &WatermarkObserver::onHighWatermark);
+		queue.lowWatermarkReached += delegate(&observer, &WatermarkObserver::onLowWatermark);
+
+		// the client does not read, so the data eventually piles up in the queue
+		std::string expected;
+		std::string block = makeData(1000, 'a');
+		while (!queue.full() && expected.size() < 64*1024*1024)
+		{
+			queue.write(block.data(), block.size());
+			expected += block;
+		}
+		assert (queue.full());
+		assert (queue.pending() >= 256*1024);
+		assert (observer.waitHigh());
+		assert (observer.high() == 1);
+		assert (observer.low() == 0);
+
+		std::string received = receive(client, expected.size());
+		assert (received == expected);
+		assert (observer.waitLow());
+		assert (observer.low() == 1);
+		assert (waitEmpty(queue));
+		assert (!queue.full());
+
+		queue.highWatermarkReached -= delegate(&observer, &WatermarkObserver::onHighWatermark);
+		queue.lowWatermarkReached -= delegate(&observer, &WatermarkObserver::onLowWatermark);
+	}
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketWriteQueueTest::testWriteFailed()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket client;
+	client.connect(ss.address());
+	StreamSocket server = ss.acceptConnection();
+
+	SocketReactor reactor;
+	Thread thread;
+	thread.start(reactor);
+	{
+		WatermarkObserver observer;
+		SocketWriteQueue queue(server, reactor);
+		queue.writeFailed += delegate(&observer, &WatermarkObserver::onWriteFailed);
+
+		client.close();
+		std::string block = makeData(65536, 'a');
+		for (int i = 0; i < 1000 && !queue.failed(); ++i)
+		{
+			queue.write(block.data(), block.size());
+			Thread::sleep(1);
+		}
+		assert (queue.failed());
+		assert (observer.waitFailed());
+		assert (observer.failed() == 1);
+		assert (queue.empty());
+		queue.write(block.data(), block.size());
+		assert (queue.empty());
+
+		queue.writeFailed -= delegate(&observer, &WatermarkObserver::onWriteFailed);
+	}
+	reactor.stop();
+	thread.join();
+}
+
+
+void SocketWriteQueueTest::testWatermarks()
+{
+	ServerSocket ss(SocketAddress("127.0.0.1", 0));
+	StreamSocket client;
+	client.connect(ss.address());
+	StreamSocket server = ss.acceptConnection();
+
+	SocketReactor reactor;
+	SocketWriteQueue queue(server, reactor);
+	assert (queue.getLowWatermark() == SocketWriteQueue::DEFAULT_LOW_WATERMARK);
+	assert (queue.getHighWatermark() == SocketWriteQueue::DEFAULT_HIGH_WATERMARK);
+	assert (queue.getCoalesceSize() == SocketWriteQueue::DEFAULT_COALESCE_SIZE);
+	queue.setWatermarks(10, 20);
+	assert (queue.getLowWatermark() == 10);
+	assert (queue.getHighWatermark() == 20);
+	try
+	{
+		queue.setWatermarks(20, 10);
+		fail("low > high - must throw");
+	}
+	catch (Poco::InvalidArgumentException&)
+	{
+	}
+	queue.setCoalesceSize(0);
+	assert (queue.getCoalesceSize() == 0);
+}
+
+
+void SocketWriteQueueTest::setUp()
+{
+}
+
+
+void SocketWriteQueueTest::tearDown()
+{
+}
+
+
+CppUnit::Test* SocketWriteQueueTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SocketWriteQueueTest");
+
+	CppUnit_addTest(pSuite, SocketWriteQueueTest, testWrite);
+	CppUnit_addTest(pSuite, SocketWriteQueueTest, testSharedBuffer);
+	CppUnit_addTest(pSuite, SocketWriteQueueTest, testBackpressure);
+	CppUnit_addTest(pSuite, SocketWriteQueueTest, testWriteFailed);
+	CppUnit_addTest(pSuite, SocketWriteQueueTest, testWatermarks);
+
+	return pSuite;
+}
@@ -0,0 +1,44 @@
+//
+// SocketWriteQueueTest.h
+//
+// $Id$
+//
+// Definition of the SocketWriteQueueTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef SocketWriteQueueTest_INCLUDED
+#define SocketWriteQueueTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class SocketWriteQueueTest: public CppUnit::TestCase
+{
+public:
+	SocketWriteQueueTest(const std::string& name);
+	~SocketWriteQueueTest();
+
+	void testWrite();
+	void testSharedBuffer();
+	void testBackpressure();
+	void testWriteFailed();
+	void testWatermarks();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // SocketWriteQueueTest_INCLUDED
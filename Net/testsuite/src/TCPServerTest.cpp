@@ -21,6 +21,7 @@
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Thread.h"
 #include <iostream>
+#include <vector>
 
 
 using Poco::Net::TCPServer;
@@ -244,6 +245,74 @@ void TCPServerTest::testMultiConnections()
 }
 
 
+void TCPServerTest::testLockFreeQueue()
+{
+	ServerSocket svs(0);
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setMaxThreads(2);
+	pParams->setMaxQueued(2);
+	pParams->setThreadIdleTime(100);
+	pParams->setLockFreeQueue(true);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs, pParams);
+	srv.start();
+	assert (srv.params().getLockFreeQueue());
+	assert (srv.currentConnections() == 0);
+	assert (srv.currentThreads() == 0);
+	assert (srv.queuedConnections() == 0);
+	assert (srv.totalConnections() == 0);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	StreamSocket ss1(sa);
+	StreamSocket ss2(sa);
+	std::string data("hello, world");
+	ss1.sendBytes(data.data(), (int) data.size());
+	ss2.sendBytes(data.data(), (int) data.size());
+
+	char buffer[256];
+	int n = ss1.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	n = ss2.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	assert (srv.currentConnections() == 2);
+	assert (srv.currentThreads() == 2);
+	assert (srv.queuedConnections() == 0);
+	assert (srv.totalConnections() == 2);
+
+	StreamSocket ss3(sa);
+	StreamSocket ss4(sa);
+	Thread::sleep(200);
+	assert (srv.queuedConnections() == 2);
+	StreamSocket ss5(sa);
+	Thread::sleep(200);
+	assert (srv.queuedConnections() == 2);
+	assert (srv.refusedConnections() == 1);
+
+	ss1.close();
+	Thread::sleep(1000);
+	assert (srv.currentConnections() == 2);
+	assert (srv.queuedConnections() == 1);
+	assert (srv.totalConnections() == 3);
+
+	ss3.sendBytes(data.data(), (int) data.size());
+	n = ss3.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+
+	ss2.close();
+	ss3.close();
+	ss4.close();
+	ss5.close();
+	Thread::sleep(1000);
+	assert (srv.currentConnections() == 0);
+	assert (srv.queuedConnections() == 0);
+	assert (srv.totalConnections() == 4);
+}
+
+
 void TCPServerTest::testThreadCapacity()
 {
 	ServerSocket svs(0);
@@ -279,6 +348,47 @@ void TCPServerTest::testFilter()
 }
 
 
+void TCPServerTest::testReusePortAcceptors()
+{
+#if defined(POCO_OS_FAMILY_UNIX)
+	TCPServerParams* pParams = new TCPServerParams;
+	pParams->setAcceptorCount(4);
+	pParams->setMaxThreads(8);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), 0, pParams);
+	srv.start();
+	assert (srv.params().getAcceptorCount() == 4);
+	assert (srv.totalConnections() == 0);
+
+	// the kernel may assign all connections to a single listening
+	// socket, so each worker group must be able to serve all of them
+	SocketAddress sa("127.0.0.1", srv.socket().address().port());
+	const int count = 8;
+	std::vector<StreamSocket> sockets;
+	for (int i = 0; i < count; i++)
+	{
+		sockets.push_back(StreamSocket(sa));
+	}
+	std::string data("hello, world");
+	char buffer[256];
+	for (int i = 0; i < count; i++)
+	{
+		sockets[i].sendBytes(data.data(), (int) data.size());
+		int n = sockets[i].receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		assert (std::string(buffer, n) == data);
+	}
+	assert (srv.totalConnections() == count);
+	for (int i = 0; i < count; i++)
+	{
+		sockets[i].close();
+	}
+	Thread::sleep(1000);
+	assert (srv.currentConnections() == 0);
+	srv.stop();
+#endif
+}
+
+
 void TCPServerTest::setUp()
 {
 }
@@ -296,8 +406,10 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testOneConnection);
 	CppUnit_addTest(pSuite, TCPServerTest, testTwoConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
+	CppUnit_addTest(pSuite, TCPServerTest, testLockFreeQueue);
 	CppUnit_addTest(pSuite, TCPServerTest, testThreadCapacity);
 	CppUnit_addTest(pSuite, TCPServerTest, testFilter);
+	CppUnit_addTest(pSuite, TCPServerTest, testReusePortAcceptors);
 
 	return pSuite;
 }
@@ -29,8 +29,10 @@ public:
 	void testOneConnection();
 	void testTwoConnections();
 	void testMultiConnections();
+	void testLockFreeQueue();
 	void testThreadCapacity();
 	void testFilter();
+	void testReusePortAcceptors();
 
 	void setUp();
 	void tearDown();
@@ -14,6 +14,8 @@
 #include "Poco/CppUnit/TestCaller.h"
 #include "Poco/CppUnit/TestSuite.h"
 #include "Poco/Net/WebSocket.h"
+#include "Poco/Net/WebSocketImpl.h"
+#include "Poco/Net/WebSocketDeflate.h"
 #include "Poco/Net/SocketStream.h"
 #include "Poco/Net/HTTPClientSession.h"
 #include "Poco/Net/HTTPServer.h"
@@ -25,7 +27,10 @@
 #include "Poco/Net/ServerSocket.h"
 #include "Poco/Net/NetException.h"
 #include "Poco/Thread.h"
+#include "Poco/Runnable.h"
 #include "Poco/Buffer.h"
+#include <cstring>
+#include <limits>
 
 
 using Poco::Net::HTTPClientSession;
@@ -35,6 +40,7 @@ using Poco::Net::HTTPServerRequest;
 using Poco::Net::HTTPServerResponse;
 using Poco::Net::SocketStream;
 using Poco::Net::WebSocket;
+using Poco::Net::WebSocketDeflate;
 using Poco::Net::WebSocketException;
 
 
@@ -51,13 +57,18 @@ namespace
 		{
 			try
 			{
-				WebSocket ws(request, response);
-				Poco::Buffer<char> buffer(_bufSize);
+				bool deflate = request.getURI() == "/deflate";
+				WebSocket ws(deflate ? WebSocket(request, response, WebSocketDeflate::Params()) : WebSocket(request, response));
+				bool into = deflate || request.getURI() == "/into";
+				Poco::Buffer<char> buffer(into ? 0 : _bufSize);
 				int flags;
 				int n;
 				do
 				{
-					n = ws.receiveFrame(buffer.begin(), buffer.size(), flags);
+					if (into)
+						n = ws.receiveFrameInto(buffer, flags);
+					else
+						n = ws.receiveFrame(buffer.begin(), buffer.size(), flags);
 					ws.sendFrame(buffer.begin(), n, flags);
 				}
 				while (n > 0 || (flags & WebSocket::FRAME_OP_BITMASK) != WebSocket::FRAME_OP_CLOSE);
@@ -99,6 +110,30 @@ namespace
 	private:
 		std::size_t _bufSize;
 	};
+
+	class FrameSender: public Poco::Runnable
+	{
+	public:
+		FrameSender(WebSocket& ws, char c, int count, int size):
+			_ws(ws),
+			_payload(size, c),
+			_count(count)
+		{
+		}
+
+		void run()
+		{
+			for (int i = 0; i < _count; ++i)
+			{
+				_ws.sendFrame(_payload.data(), (int) _payload.size(), WebSocket::FRAME_BINARY);
+			}
+		}
+
+	private:
+		WebSocket& _ws;
+		std::string _payload;
+		int _count;
+	};
 }
 
 
@@ -268,6 +303,424 @@ void WebSocketTest::testWebSocketLargeInOneFrame()
 }
 
 
+void WebSocketTest::testReceiveFrameInto()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/into", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response);
+
+	const int sizes[] = { 0, 1, 2, 3, 17, 125, 126, 127, 128, 65535, 65536, 65537, 1000000, 5 };
+	Poco::Buffer<char> buffer(0);
+	for (std::size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); ++k)
+	{
+		std::string payload;
+		for (int i = 0; i < sizes[k]; ++i)
+			payload += static_cast<char>(i % 251);
+		ws.sendFrame(payload.data(), (int) payload.size(), WebSocket::FRAME_BINARY);
+		int flags;
+		int n = ws.receiveFrameInto(buffer, flags);
+		assert (n == payload.size());
+		assert (buffer.size() == payload.size());
+		assert (std::memcmp(payload.data(), buffer.begin(), n) == 0);
+		assert (flags == WebSocket::FRAME_BINARY);
+	}
+	// the buffer is not shrunk for smaller frames
+	assert (buffer.capacity() >= 1000000);
+
+	ws.shutdown();
+	int flags;
+	int n = ws.receiveFrameInto(buffer, flags);
+	assert (n == 2);
+	assert ((flags & WebSocket::FRAME_OP_BITMASK) == WebSocket::FRAME_OP_CLOSE);
+}
+
+
+void WebSocketTest::testConcurrentSend()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/into", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response);
+
+	const int count = 100;
+	const int size = 100000;
+	FrameSender sender1(ws, 'a', count, size);
+	FrameSender sender2(ws, 'b', count, size);
+	Poco::Thread thread1;
+	Poco::Thread thread2;
+	thread1.start(sender1);
+	thread2.start(sender2);
+
+	// every echoed frame must be complete and must not be mixed up with another one
+	Poco::Buffer<char> buffer(0);
+	int received[2] = {0, 0};
+	for (int i = 0; i < 2*count; ++i)
+	{
+		int flags;
+		int n = ws.receiveFrameInto(buffer, flags);
+		assert (n == size);
+		assert (flags == WebSocket::FRAME_BINARY);
+		char c = buffer[0];
+		assert (c == 'a' || c == 'b');
+		assert (std::string(buffer.begin(), n) == std::string(size, c));
+		++received[c - 'a'];
+	}
+	thread1.join();
+	thread2.join();
+	assert (received[0] == count && received[1] == count);
+
+	ws.shutdown();
+	int flags;
+	ws.receiveFrameInto(buffer, flags);
+	assert ((flags & WebSocket::FRAME_OP_BITMASK) == WebSocket::FRAME_OP_CLOSE);
+}
+
+
+void WebSocketTest::testMaskPayload()
+{
+	const char mask[4] = { '\x12', '\x34', '\x56', '\x78' };
+	char src[100];
+	for (int i = 0; i < (int) sizeof(src); ++i)
+		src[i] = static_cast<char>(i*7);
+
+	for (std::size_t length = 0; length <= sizeof(src); ++length)
+	{
+		char expected[100];
+		for (std::size_t i = 0; i < length; ++i)
+			expected[i] = src[i] ^ mask[i % 4];
+
+		char dest[100];
+		Poco::Net::WebSocketImpl::maskPayload(dest, src, length, mask);
+		assert (std::memcmp(dest, expected, length) == 0);
+
+		char inPlace[100];
+		std::memcpy(inPlace, src, length);
+		Poco::Net::WebSocketImpl::maskPayload(inPlace, inPlace, length, mask);
+		assert (std::memcmp(inPlace, expected, length) == 0);
+	}
+}
+
+
+void WebSocketTest::testPerMessageDeflate()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/deflate", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocketDeflate::Params params;
+	params.clientNoContextTakeover = true;
+	params.serverMaxWindowBits = 10;
+	WebSocket ws(cs, request, response, params);
+	assert (ws.perMessageDeflate());
+	assert (response.get("Sec-WebSocket-Extensions") == "permessage-deflate; client_no_context_takeover; server_max_window_bits=10");
+
+	const WebSocketDeflate* pDeflate = static_cast<Poco::Net::WebSocketImpl*>(ws.impl())->perMessageDeflate();
+	assert (pDeflate->client());
+	assert (!pDeflate->params().serverNoContextTakeover);
+	assert (pDeflate->params().clientNoContextTakeover);
+	assert (pDeflate->params().serverMaxWindowBits == 10);
+	assert (pDeflate->params().clientMaxWindowBits == 15);
+
+	const int sizes[] = { 0, 1, 5, 125, 126, 4000, 65536, 1000000, 3 };
+	Poco::Buffer<char> buffer(0);
+	for (std::size_t k = 0; k < sizeof(sizes)/sizeof(sizes[0]); ++k)
+	{
+		std::string payload;
+		while (payload.size() < static_cast<std::size_t>(sizes[k]))
+			payload += "{\"id\": 42, \"name\": \"WebSocket\"}";
+		payload.resize(sizes[k]);
+		ws.sendFrame(payload.data(), (int) payload.size());
+		int flags;
+		int n = ws.receiveFrameInto(buffer, flags);
+		assert (n == payload.size());
+		assert (std::memcmp(payload.data(), buffer.begin(), n) == 0);
+		assert (flags == WebSocket::FRAME_TEXT);
+	}
+
+	std::string payload("Hello, world!");
+	ws.sendFrame(payload.data(), (int) payload.size(), WebSocket::FRAME_BINARY);
+	char data[64];
+	int flags;
+	int n = ws.receiveFrame(data, sizeof(data), flags);
+	assert (n == payload.size());
+	assert (payload.compare(0, payload.size(), data, n) == 0);
+	assert (flags == WebSocket::FRAME_BINARY);
+
+	// a fragmented message
+	ws.sendFrame("Hello", 5, WebSocket::FRAME_OP_TEXT);
+	ws.sendFrame(", ", 2, WebSocket::FRAME_OP_CONT);
+	ws.sendFrame("world!", 6, WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT);
+	buffer.resize(0);
+	n = ws.receiveFrame(buffer, flags);
+	assert (n == 5);
+	assert (flags == WebSocket::FRAME_OP_TEXT);
+	n = ws.receiveFrame(buffer, flags);
+	assert (n == 2);
+	assert (flags == WebSocket::FRAME_OP_CONT);
+	n = ws.receiveFrame(buffer, flags);
+	assert (n == 6);
+	assert (flags == (WebSocket::FRAME_FLAG_FIN | WebSocket::FRAME_OP_CONT));
+	assert (std::string(buffer.begin(), buffer.size()) == payload);
+
+	ws.shutdown();
+	n = ws.receiveFrameInto(buffer, flags);
+	assert (n == 2);
+	assert ((flags & WebSocket::FRAME_OP_BITMASK) == WebSocket::FRAME_OP_CLOSE);
+}
+
+
+void WebSocketTest::testPerMessageDeflateDeclined()
+{
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer server(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	server.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/ws", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, WebSocketDeflate::Params());
+	assert (!ws.perMessageDeflate());
+	assert (!response.has("Sec-WebSocket-Extensions"));
+
+	std::string payload("Hello, world!");
+	ws.sendFrame(payload.data(), (int) payload.size());
+	char data[64];
+	int flags;
+	int n = ws.receiveFrame(data, sizeof(data), flags);
+	assert (n == payload.size());
+	assert (payload.compare(0, payload.size(), data, n) == 0);
+	assert (flags == WebSocket::FRAME_TEXT);
+}
+
+
+void WebSocketTest::testDeflate()
+{
+	// Examples from RFC 7692, section 7.2.3.
+	WebSocketDeflate::Params params;
+	WebSocketDeflate client(params, true);
+	WebSocketDeflate server(params, false);
+	Poco::Buffer<char> compressed(0);
+	Poco::Buffer<char> inflated(0);
+
+	client.deflate("Hello", 5, true, compressed);
+	assert (std::string(compressed.begin(), compressed.size()) == std::string("\xf2\x48\xcd\xc9\xc9\x07\x00", 7));
+	server.inflate(compressed.begin(), compressed.size(), true, inflated, 1024);
+	assert (std::string(inflated.begin(), inflated.size()) == "Hello");
+
+	// context takeover: the second message refers to the first one
+	client.deflate("Hello", 5, true, compressed);
+	assert (std::string(compressed.begin(), compressed.size()) == std::string("\xf2\x00\x11\x00\x00", 5));
+	inflated.resize(0);
+	server.inflate(compressed.begin(), compressed.size(), true, inflated, 1024);
+	assert (std::string(inflated.begin(), inflated.size()) == "Hello");
+
+	// empty message
+	client.deflate("", 0, true, compressed);
+	assert (compressed.size() == 1 && compressed[0] == 0);
+	inflated.resize(0);
+	server.inflate(compressed.begin(), compressed.size(), true, inflated, 1024);
+	assert (inflated.size() == 0);
+
+	// DEFLATE block with BFINAL set
+	const char final[] = "\xf3\x48\xcd\xc9\xc9\x07\x00";
+	WebSocketDeflate server2(params, false);
+	inflated.resize(0);
+	server2.inflate(final, 7, true, inflated, 1024);
+	assert (std::string(inflated.begin(), inflated.size()) == "Hello");
+	inflated.resize(0);
+	server2.inflate(final, 7, true, inflated, 1024);
+	assert (std::string(inflated.begin(), inflated.size()) == "Hello");
+
+	// no context takeover
+	params.serverNoContextTakeover = true;
+	WebSocketDeflate server3(params, false);
+	server3.deflate("Hello", 5, true, compressed);
+	assert (std::string(compressed.begin(), compressed.size()) == std::string("\xf2\x48\xcd\xc9\xc9\x07\x00", 7));
+	server3.deflate("Hello", 5, true, compressed);
+	assert (std::string(compressed.begin(), compressed.size()) == std::string("\xf2\x48\xcd\xc9\xc9\x07\x00", 7));
+
+	try
+	{
+		inflated.resize(0);
+		server.inflate("\xff\xff\xff", 3, true, inflated, 1024);
+		fail("invalid data - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assert (exc.code() == WebSocket::WS_ERR_COMPRESSION);
+	}
+}
+
+
+void WebSocketTest::testDeflateBomb()
+{
+	WebSocketDeflate::Params params;
+	WebSocketDeflate client(params, true);
+	WebSocketDeflate server(params, false);
+	std::string payload(10000000, '\0');
+	Poco::Buffer<char> compressed(0);
+	client.deflate(payload.data(), payload.size(), true, compressed);
+	assert (compressed.size() < 20000);
+	Poco::Buffer<char> inflated(0);
+	try
+	{
+		server.inflate(compressed.begin(), compressed.size(), true, inflated, 65536);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assert (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+	assert (inflated.size() <= 65537);
+	assert (inflated.capacity() <= 65537);
+
+	Poco::Net::ServerSocket ss(0);
+	Poco::Net::HTTPServer httpServer(new WebSocketRequestHandlerFactory, ss, new Poco::Net::HTTPServerParams);
+	httpServer.start();
+
+	Poco::Thread::sleep(200);
+
+	HTTPClientSession cs("127.0.0.1", ss.address().port());
+	HTTPRequest request(HTTPRequest::HTTP_GET, "/deflate", HTTPRequest::HTTP_1_1);
+	HTTPResponse response;
+	WebSocket ws(cs, request, response, params);
+	assert (ws.perMessageDeflate());
+	assert (ws.getMaxPayloadSize() == std::numeric_limits<int>::max());
+	ws.setMaxPayloadSize(65536);
+	assert (ws.getMaxPayloadSize() == 65536);
+
+	int flags;
+	char data[64];
+	ws.sendFrame(payload.data(), 1000, WebSocket::FRAME_BINARY);
+	try
+	{
+		ws.receiveFrame(data, sizeof(data), flags);
+		fail("buffer too small - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assert (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+
+	HTTPClientSession cs2("127.0.0.1", ss.address().port());
+	HTTPRequest request2(HTTPRequest::HTTP_GET, "/deflate", HTTPRequest::HTTP_1_1);
+	WebSocket ws2(cs2, request2, response, params);
+	ws2.setMaxPayloadSize(65536);
+	ws2.sendFrame(payload.data(), (int) payload.size(), WebSocket::FRAME_BINARY);
+	Poco::Buffer<char> buffer(0);
+	try
+	{
+		ws2.receiveFrameInto(buffer, flags);
+		fail("payload too big - must throw");
+	}
+	catch (WebSocketException& exc)
+	{
+		assert (exc.code() == WebSocket::WS_ERR_PAYLOAD_TOO_BIG);
+	}
+	assert (buffer.size() <= 65537);
+}
+
+
+void WebSocketTest::testDeflateNegotiation()
+{
+	WebSocketDeflate::Params params;
+	assert (WebSocketDeflate::formatOffer(params) == "permessage-deflate; client_max_window_bits");
+	params.serverNoContextTakeover = true;
+	params.serverMaxWindowBits = 10;
+	params.clientMaxWindowBits = 12;
+	assert (WebSocketDeflate::formatOffer(params) == "permessage-deflate; server_no_context_takeover; server_max_window_bits=10; client_max_window_bits=12");
+
+	WebSocketDeflate::Params server;
+	WebSocketDeflate::Params agreed;
+	assert (!WebSocketDeflate::negotiate("", server, agreed));
+	assert (!WebSocketDeflate::negotiate("x-webkit-deflate-frame", server, agreed));
+	assert (WebSocketDeflate::negotiate("permessage-deflate", server, agreed));
+	assert (WebSocketDeflate::formatResponse(agreed) == "permessage-deflate");
+
+	assert (WebSocketDeflate::negotiate(WebSocketDeflate::formatOffer(params), server, agreed));
+	assert (agreed.serverNoContextTakeover);
+	assert (!agreed.clientNoContextTakeover);
+	assert (agreed.serverMaxWindowBits == 10);
+	assert (agreed.clientMaxWindowBits == 12);
+	assert (WebSocketDeflate::formatResponse(agreed) == "permessage-deflate; server_no_context_takeover; server_max_window_bits=10; client_max_window_bits=12");
+
+	// the server's limits
+	server.clientNoContextTakeover = true;
+	server.serverMaxWindowBits = 9;
+	server.clientMaxWindowBits = 11;
+	assert (WebSocketDeflate::negotiate("permessage-deflate; server_max_window_bits=10; client_max_window_bits", server, agreed));
+	assert (agreed.clientNoContextTakeover);
+	assert (agreed.serverMaxWindowBits == 9);
+	assert (agreed.clientMaxWindowBits == 11);
+	// the client's window size can only be limited if the client agrees
+	assert (WebSocketDeflate::negotiate("permessage-deflate", server, agreed));
+	assert (agreed.clientMaxWindowBits == 15);
+
+	// invalid or unsupported offers are skipped
+	server = WebSocketDeflate::Params();
+	assert (!WebSocketDeflate::negotiate("permessage-deflate; server_max_window_bits=8", server, agreed));
+	assert (!WebSocketDeflate::negotiate("permessage-deflate; server_max_window_bits=16", server, agreed));
+	assert (!WebSocketDeflate::negotiate("permessage-deflate; server_max_window_bits", server, agreed));
+	assert (!WebSocketDeflate::negotiate("permessage-deflate; foo", server, agreed));
+	assert (!WebSocketDeflate::negotiate("permessage-deflate; server_no_context_takeover; server_no_context_takeover", server, agreed));
+	assert (WebSocketDeflate::negotiate("permessage-deflate; server_max_window_bits=8, permessage-deflate; server_max_window_bits=\"12\"", server, agreed));
+	assert (agreed.serverMaxWindowBits == 12);
+
+	// client side
+	params = WebSocketDeflate::Params();
+	assert (!WebSocketDeflate::accept("", params, agreed));
+	assert (WebSocketDeflate::accept("permessage-deflate; server_no_context_takeover; client_max_window_bits=10", params, agreed));
+	assert (agreed.serverNoContextTakeover);
+	assert (!agreed.clientNoContextTakeover);
+	assert (agreed.serverMaxWindowBits == 15);
+	assert (agreed.clientMaxWindowBits == 10);
+	params.serverMaxWindowBits = 10;
+	assert (WebSocketDeflate::accept("permessage-deflate; server_max_window_bits=9", params, agreed));
+	assert (agreed.serverMaxWindowBits == 9);
+
+	const char* invalid[] =
+	{
+		"permessage-deflate; server_max_window_bits=11",
+		"permessage-deflate; client_max_window_bits=8",
+		"permessage-deflate; client_max_window_bits",
+		"permessage-deflate; foo=1",
+		"permessage-deflate, permessage-deflate"
+	};
+	for (std::size_t i = 0; i < sizeof(invalid)/sizeof(invalid[0]); ++i)
+	{
+		try
+		{
+			WebSocketDeflate::accept(invalid[i], params, agreed);
+			fail("invalid response - must throw");
+		}
+		catch (WebSocketException& exc)
+		{
+			assert (exc.code() == WebSocket::WS_ERR_HANDSHAKE_EXTENSION);
+		}
+	}
+}
+
+
 void WebSocketTest::setUp()
 {
 }
@@ -285,6 +738,14 @@ CppUnit::Test* WebSocketTest::suite()
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocket);
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketLarge);
 	CppUnit_addTest(pSuite, WebSocketTest, testWebSocketLargeInOneFrame);
+	CppUnit_addTest(pSuite, WebSocketTest, testReceiveFrameInto);
+	CppUnit_addTest(pSuite, WebSocketTest, testConcurrentSend);
+	CppUnit_addTest(pSuite, WebSocketTest, testMaskPayload);
+	CppUnit_addTest(pSuite, WebSocketTest, testPerMessageDeflate);
+	CppUnit_addTest(pSuite, WebSocketTest, testPerMessageDeflateDeclined);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflate);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflateBomb);
+	CppUnit_addTest(pSuite, WebSocketTest, testDeflateNegotiation);
 
 	return pSuite;
 }
@@ -29,6 +29,14 @@ public:
 	void testWebSocket();
 	void testWebSocketLarge();
 	void testWebSocketLargeInOneFrame();
+	void testReceiveFrameInto();
+	void testConcurrentSend();
+	void testMaskPayload();
+	void testPerMessageDeflate();
+	void testPerMessageDeflateDeclined();
+	void testDeflate();
+	void testDeflateBomb();
+	void testDeflateNegotiation();
 
 	void setUp();
 	void tearDown();
@@ -22,6 +22,8 @@
 
 #include "Poco/Net/NetSSL.h"
 #include "Poco/Net/SocketDefs.h"
+#include "Poco/Net/SessionCache.h"
+#include "Poco/Net/SessionTicketKeys.h"
 #include "Poco/Crypto/X509Certificate.h"
 #include "Poco/Crypto/RSAKey.h"
 #include "Poco/RefCountedObject.h"
@@ -326,6 +328,37 @@ public:
 		/// session resumption.
 		///
 		/// The feature can be disabled by calling this method.
+
+	void setSessionCache(SessionCache::Ptr pCache);
+		/// Sets the SessionCache used by all client connections using
+		/// this Context. The cache can be shared with other Context objects.
+		///
+		/// With a SessionCache, sessions are stored and offered for
+		/// resumption automatically, keyed by server host name and port.
+		/// This also enables session caching for the Context (see
+		/// enableSessionCache()). Passing a null pointer removes
+		/// the cache and disables session caching.
+		///
+		/// This method may only be called on CLIENT_USE Context objects.
+
+	SessionCache::Ptr getSessionCache() const;
+		/// Returns the SessionCache, or a null pointer
+		/// if no SessionCache has been set.
+
+	void setSessionTicketKeys(SessionTicketKeys::Ptr pKeys);
+		/// Sets the keys used for encrypting and decrypting RFC 5077
+		/// session tickets, and enables session tickets.
+		/// The SessionTicketKeys can be shared with other Context objects,
+		/// so that they accept each other's tickets.
+		///
+		/// Without SessionTicketKeys, OpenSSL uses keys that are
+		/// generated when the Context is created and never rotated.
+		///
+		/// This method may only be called on SERVER_USE Context objects.
+
+	SessionTicketKeys::Ptr getSessionTicketKeys() const;
+		/// Returns the SessionTicketKeys, or a null pointer
+		/// if no SessionTicketKeys have been set.
 		
 	void disableProtocols(int protocols);
 		/// Disables the given protocols.
@@ -355,10 +388,16 @@ private:
 	void createSSLContext();
 		/// Create a SSL_CTX object according to Context configuration.
 
+	static int ticketKeyCallback(SSL* pSSL, unsigned char* pKeyName, unsigned char* pIV, EVP_CIPHER_CTX* pCipherCtx, HMAC_CTX* pHMACCtx, int encrypt);
+		/// The OpenSSL session ticket key callback, which
+		/// passes the call to the SessionTicketKeys.
+
 	Usage _usage;
 	VerificationMode _mode;
 	SSL_CTX* _pSSLContext;
 	bool _extendedCertificateVerification;
+	SessionCache::Ptr _pSessionCache;
+	SessionTicketKeys::Ptr _pTicketKeys;
 };
 
 
@@ -398,6 +437,18 @@ inline bool Context::extendedCertificateVerificationEnabled() const
 }
 
 
+inline SessionCache::Ptr Context::getSessionCache() const
+{
+	return _pSessionCache;
+}
+
+
+inline SessionTicketKeys::Ptr Context::getSessionTicketKeys() const
+{
+	return _pTicketKeys;
+}
+
+
 } } // namespace Poco::Net
 
 
@@ -70,6 +70,12 @@ class NetSSL_API HTTPSClientSession: public HTTPClientSession
 	/// to the HTTPSClientSession, the HTTPSClientSession class will
 	/// attempt to reuse a previously obtained Session object in
 	/// case of a reconnect.
+	///
+	/// If a SessionCache has been set for the Context object (see
+	/// Context::setSessionCache()), all HTTPSClientSession objects
+	/// using the Context share the cached sessions, so a new
+	/// HTTPSClientSession resumes the session of an earlier
+	/// connection to the same host and port.
 {
 public:
 	enum
@@ -89,8 +89,9 @@ class NetSSL_API SSLManager
 	///            </invalidCertificateHandler>
 	///            <cacheSessions>true|false</cacheSessions>
 	///            <sessionIdContext>someString</sessionIdContext> <!-- server only -->
-	///            <sessionCacheSize>0..n</sessionCacheSize>       <!-- server only -->
+	///            <sessionCacheSize>0..n</sessionCacheSize>
 	///            <sessionTimeout>0..n</sessionTimeout>           <!-- server only -->
+	///            <sessionTicketRotation>0..n</sessionTicketRotation> <!-- server only -->
 	///            <extendedVerification>true|false</extendedVerification>
 	///            <requireTLSv1>true|false</requireTLSv1>
 	///            <requireTLSv1_1>true|false</requireTLSv1_1>
@@ -129,6 +130,9 @@ class NetSSL_API SSLManager
 	///    - invalidCertificateHandler.name: The name of the class (subclass of CertificateHandler)
 	///      used for confirming invalid certificates.
 	///    - cacheSessions (boolean): Enables or disables session caching.
+	///      For a client, this creates a SessionCache for the default client
+	///      context, so that sessions are resumed automatically for every
+	///      server (see Context::setSessionCache()).
 	///    - sessionIdContext (string): contains the application's unique session ID context, which becomes 
 	///      part of each session identifier generated by the server. Can be an arbitrary sequence 
 	///      of bytes with a maximum length of SSL_MAX_SSL_SESSION_ID_LENGTH. Should be specified
@@ -139,7 +143,11 @@ class NetSSL_API SSLManager
 	///      sessions. The default size (according to OpenSSL documentation) is 1024*20, which may be too 
 	///      large for many applications, especially on embedded platforms with limited memory.
 	///      Specifying a size of 0 will set an unlimited cache size.
+	///      For a client, sets the maximum number of sessions in the SessionCache
+	///      (default 1024).
 	///    - sessionTimeout (integer):  Sets the timeout (in seconds) of cached sessions on the server.
+	///    - sessionTicketRotation (integer): Enables session tickets with keys
+	///      that are rotated every given number of seconds (see SessionTicketKeys).
 	///    - extendedVerification (boolean): Enable or disable the automatic post-connection
 	///      extended certificate verification.
 	///    - requireTLSv1 (boolean): Require a TLSv1 connection.
@@ -331,6 +339,7 @@ private:
 	static const std::string CFG_SESSION_ID_CONTEXT;
 	static const std::string CFG_SESSION_CACHE_SIZE;
 	static const std::string CFG_SESSION_TIMEOUT;
+	static const std::string CFG_SESSION_TICKET_ROTATION;
 	static const std::string CFG_EXTENDED_VERIFICATION;
 	static const std::string CFG_REQUIRE_TLSV1;
 	static const std::string CFG_REQUIRE_TLSV1_1;
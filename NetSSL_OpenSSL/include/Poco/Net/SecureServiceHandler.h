@@ -0,0 +1,259 @@
+//
+// SecureServiceHandler.h
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLSockets
+// Module:  SecureServiceHandler
+//
+// Definition of the SecureServiceHandler class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef NetSSL_SecureServiceHandler_INCLUDED
+#define NetSSL_SecureServiceHandler_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketNotification.h"
+#include "Poco/Exception.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include <string>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SecureServiceHandler
+	/// SecureServiceHandler is the base class for service handlers
+	/// that serve a SSL/TLS connection from a SocketReactor, using
+	/// non-blocking I/O.
+	///
+	/// The SSL handshake, as well as sending and receiving data,
+	/// is driven entirely by the reactor's notifications. Whenever
+	/// OpenSSL needs to read from or write to the socket to make
+	/// progress (SecureStreamSocket::ERR_SSL_WANT_READ or
+	/// SecureStreamSocket::ERR_SSL_WANT_WRITE), the handler
+	/// changes its interest in WritableNotification accordingly
+	/// and returns to the reactor, so a single reactor thread can
+	/// serve a large number of connections, including slow clients
+	/// in the middle of a handshake.
+	///
+	/// The constructor is compatible with SocketAcceptor and
+	/// SocketConnector. For the server side, a SocketAcceptor is
+	/// used with a SecureServerSocket:
+	///
+	///     SecureServerSocket svs(443, 64, pContext);
+	///     SocketReactor reactor;
+	///     SocketAcceptor<MyServiceHandler> acceptor(svs, reactor);
+	///     reactor.run();
+	///
+	/// For the client side, a SocketConnector is given an unconnected
+	/// SecureStreamSocket:
+	///
+	///     SecureStreamSocket ss(pContext);
+	///     ss.setPeerHostName("www.appinf.com");
+	///     SocketConnector<MyServiceHandler> connector(addr, reactor, ss);
+	///
+	/// Subclasses must implement onData(), which is called with the
+	/// application data received over the connection, and may override
+	/// onHandshake(), onClose() and onError(). Data is sent with send(),
+	/// which never blocks. Data that cannot be sent immediately is kept
+	/// in the handler's send buffer and sent as soon as the socket
+	/// becomes writable.
+	///
+	/// The handler destroys itself when the connection is closed, either
+	/// by the peer, due to an error, by the handshake timeout expiring
+	/// or the reactor shutting down, or by calling close().
+	///
+	/// All methods of a SecureServiceHandler must only be called from
+	/// the reactor's thread.
+{
+public:
+	enum
+	{
+		BUFFER_SIZE = 16384,
+			/// The size of the receive buffer, and the maximum
+			/// number of bytes passed to a single SSL_write().
+			/// This is the maximum size of a SSL record.
+		DEFAULT_HANDSHAKE_TIMEOUT = 30
+			/// The default handshake timeout in seconds.
+	};
+
+	SecureServiceHandler(const StreamSocket& socket, SocketReactor& reactor);
+		/// Creates the SecureServiceHandler for the given socket, which
+		/// must be a SecureStreamSocket, puts the socket into non-blocking
+		/// mode and registers the handler with the given SocketReactor.
+		///
+		/// Throws a Poco::InvalidArgumentException if the socket
+		/// is not a SecureStreamSocket.
+
+	virtual ~SecureServiceHandler();
+		/// Unregisters the handler from the SocketReactor,
+		/// closes the socket and destroys the SecureServiceHandler.
+
+	void send(const void* buffer, std::size_t length);
+		/// Sends the given data over the connection.
+		///
+		/// If the handshake has not been completed yet, or if the data
+		/// cannot be sent without blocking, the data (or the part not
+		/// sent) is kept in the send buffer and sent later.
+
+	void close();
+		/// Closes the connection, unregisters the handler from
+		/// the reactor and destroys the handler.
+		///
+		/// If called from within a callback, the handler is
+		/// destroyed after the callback returns.
+
+	bool handshakeComplete() const;
+		/// Returns true if the SSL handshake has been completed.
+
+	std::size_t pendingOutput() const;
+		/// Returns the number of bytes in the send
+		/// buffer that have not been sent yet.
+
+	void setHandshakeTimeout(const Poco::Timespan& timeout);
+		/// Sets the maximum time allowed for completing the handshake,
+		/// measured from the creation of the handler. If the handshake
+		/// has not been completed within that time, the connection
+		/// is closed.
+		///
+		/// The timeout is checked whenever the reactor sends a
+		/// TimeoutNotification, so it is enforced with the
+		/// granularity of the reactor's timeout.
+
+	Poco::Timespan getHandshakeTimeout() const;
+		/// Returns the handshake timeout.
+
+	SecureStreamSocket& socket();
+		/// Returns the handler's socket.
+
+	SocketReactor& reactor();
+		/// Returns the SocketReactor the handler is registered with.
+
+protected:
+	virtual void onHandshake();
+		/// Called when the SSL handshake has been completed
+		/// and the peer certificate has been verified.
+		///
+		/// The default implementation does nothing.
+
+	virtual void onData(const char* pData, std::size_t length) = 0;
+		/// Called with the application data received
+		/// over the connection.
+
+	virtual void onClose();
+		/// Called when the connection is closed, before
+		/// the handler is destroyed.
+		///
+		/// The default implementation does nothing.
+
+	virtual void onError(const Poco::Exception& exc);
+		/// Called when the handshake, sending or receiving fails,
+		/// or when onData() or onHandshake() throws. The connection
+		/// is closed after onError() returns.
+		///
+		/// The default implementation does nothing.
+
+	void onReadable(ReadableNotification* pNotification);
+	void onWritable(WritableNotification* pNotification);
+	void onSocketError(ErrorNotification* pNotification);
+	void onTimeout(TimeoutNotification* pNotification);
+	void onShutdown(ShutdownNotification* pNotification);
+
+	void dispatch(bool readable);
+		/// Continues the handshake, sends the buffered data and,
+		/// if readable is true, receives data from the socket.
+
+	bool handshake();
+		/// Continues the handshake. Returns true if
+		/// the handshake has been completed.
+
+	void flush();
+		/// Sends as much of the send buffer as possible.
+
+	void receive();
+		/// Receives data until OpenSSL needs more data from
+		/// the socket, and passes it to onData().
+
+	void updateInterest();
+		/// Registers or unregisters the handler for WritableNotification,
+		/// depending on whether OpenSSL waits for the socket to
+		/// become writable.
+
+private:
+	SecureServiceHandler();
+	SecureServiceHandler(const SecureServiceHandler&);
+	SecureServiceHandler& operator = (const SecureServiceHandler&);
+
+	SecureStreamSocket _socket;
+	SocketReactor&     _reactor;
+	std::string        _sendBuffer;
+	std::size_t        _sendOffset;
+	char*              _pReceiveBuffer;
+	Poco::Timestamp    _created;
+	Poco::Timespan     _handshakeTimeout;
+	int                _handshakeState;
+	int                _sendState;
+	int                _receiveState;
+	bool               _handshakeComplete;
+	bool               _writable;
+	bool               _dispatching;
+	bool               _closed;
+};
+
+
+//
+// inlines
+//
+inline bool SecureServiceHandler::handshakeComplete() const
+{
+	return _handshakeComplete;
+}
+
+
+inline std::size_t SecureServiceHandler::pendingOutput() const
+{
+	return _sendBuffer.size() - _sendOffset;
+}
+
+
+inline void SecureServiceHandler::setHandshakeTimeout(const Poco::Timespan& timeout)
+{
+	_handshakeTimeout = timeout;
+}
+
+
+inline Poco::Timespan SecureServiceHandler::getHandshakeTimeout() const
+{
+	return _handshakeTimeout;
+}
+
+
+inline SecureStreamSocket& SecureServiceHandler::socket()
+{
+	return _socket;
+}
+
+
+inline SocketReactor& SecureServiceHandler::reactor()
+{
+	return _reactor;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SecureServiceHandler_INCLUDED
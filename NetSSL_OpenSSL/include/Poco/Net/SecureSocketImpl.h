@@ -129,6 +129,18 @@ public:
 	int available() const;
 		/// Returns the number of bytes available from the
 		/// SSL buffer for immediate reading.
+
+	void setBlocking(bool flag);
+		/// Sets the underlying socket to blocking or
+		/// non-blocking mode.
+		///
+		/// In non-blocking mode, the handshake, sendBytes()
+		/// and receiveBytes() never wait for the socket, but return
+		/// SecureStreamSocket::ERR_SSL_WANT_READ or
+		/// SecureStreamSocket::ERR_SSL_WANT_WRITE instead.
+
+	bool getBlocking() const;
+		/// Returns the blocking mode of the underlying socket.
 	
 	int completeHandshake();
 		/// Completes the SSL handshake.
@@ -223,6 +235,18 @@ protected:
 		/// Note that simply closing a socket is not sufficient
 		/// to be able to re-use it again.
 
+	std::string sessionCacheKey(const SocketAddress& address) const;
+		/// Returns the key for the context's SessionCache for
+		/// a connection to the given address.
+
+	void handshakeCompleted();
+		/// Updates the statistics of the context's SessionCache
+		/// after a client-side handshake has been completed.
+
+	static int onNewSession(SSL* pSSL, SSL_SESSION* pSession);
+		/// The OpenSSL new session callback, which stores
+		/// the session in the context's SessionCache.
+
 private:	
 	SecureSocketImpl(const SecureSocketImpl&);
 	SecureSocketImpl& operator = (const SecureSocketImpl&);
@@ -233,8 +257,10 @@ private:
 	bool _needHandshake;
 	std::string _peerHostName;
 	Session::Ptr _pSession;
+	std::string _sessionCacheKey;
 	
 	friend class SecureStreamSocketImpl;
+	friend class Context;
 };
 
 
@@ -247,6 +273,18 @@ inline poco_socket_t SecureSocketImpl::sockfd()
 }
 
 
+inline void SecureSocketImpl::setBlocking(bool flag)
+{
+	_pSocket->setBlocking(flag);
+}
+
+
+inline bool SecureSocketImpl::getBlocking() const
+{
+	return _pSocket->getBlocking();
+}
+
+
 inline Context::Ptr SecureSocketImpl::context() const
 {
 	return _pContext;
@@ -51,6 +51,10 @@ class NetSSL_API SecureStreamSocket: public StreamSocket
 	/// hostname) is performed when using nonblocking I/O. To manually
 	/// perform peer certificate validation, call verifyPeerCertificate()
 	/// after the SSL handshake has been completed.
+	///
+	/// To serve SSL connections from a SocketReactor, derive the
+	/// service handler from SecureServiceHandler, which drives the
+	/// handshake and I/O with the reactor's notifications.
 {
 public:
 	enum
@@ -82,12 +82,31 @@ public:
 		///
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
+
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket, as if they were a single buffer.
+		/// Any specified flags are ignored.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends the file contents through the socket. The file is
+		/// read into user space for encryption, so sendfile() is
+		/// never used.
 	
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in
+		/// the given buffers, as if they were a single buffer.
+		///
+		/// Returns the number of bytes received.
 	
 	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Not supported by a SecureStreamSocket.
@@ -112,6 +131,17 @@ public:
 		/// can be read from the currently buffered SSL record,
 		/// before a new record is read from the underlying socket.
 
+	void setBlocking(bool flag);
+		/// Sets the socket in blocking mode if flag is true,
+		/// disables blocking mode if flag is false.
+		///
+		/// The blocking mode is kept by the underlying
+		/// StreamSocketImpl, which also performs the I/O for
+		/// the SSL connection.
+
+	bool getBlocking() const;
+		/// Returns the blocking mode of the socket.
+
 	void shutdownReceive();
 		/// Shuts down the receiving part of the socket connection.
 		///
@@ -241,6 +271,18 @@ inline void SecureStreamSocketImpl::setPeerHostName(const std::string& peerHostN
 }
 
 
+inline void SecureStreamSocketImpl::setBlocking(bool flag)
+{
+	_impl.setBlocking(flag);
+}
+
+
+inline bool SecureStreamSocketImpl::getBlocking() const
+{
+	return _impl.getBlocking();
+}
+
+
 inline Context::Ptr SecureStreamSocketImpl::context() const
 {
 	return _impl.context();
@@ -44,6 +44,12 @@ public:
 	SSL_SESSION* sslSession() const;
 		/// Returns the stored OpenSSL SSL_SESSION object.
 
+	bool isResumable() const;
+		/// Returns true if the session can be used to resume
+		/// a connection, i.e. it has not expired and, with
+		/// OpenSSL 1.1.1 or newer, contains the data (session ID
+		/// or ticket) required for resumption.
+
 protected:	
 	Session(SSL_SESSION* pSession);
 		/// Creates a new Session object, using the given
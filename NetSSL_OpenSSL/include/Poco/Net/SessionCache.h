@@ -0,0 +1,163 @@
+//
+// SessionCache.h
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionCache
+//
+// Definition of the SessionCache class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef NetSSL_SessionCache_INCLUDED
+#define NetSSL_SessionCache_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/Net/Session.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Mutex.h"
+#include <map>
+#include <list>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SessionCache: public Poco::RefCountedObject
+	/// A bounded cache of client-side SSL sessions, keyed by
+	/// the server's host name and port.
+	///
+	/// When a SessionCache is set for a client Context (see
+	/// Context::setSessionCache()), every SecureStreamSocket using the
+	/// Context (and thus, every HTTPSClientSession) automatically
+	/// offers the cached session for the server it connects to, and
+	/// stores new sessions (or session tickets) received from
+	/// the server in the cache. The host name used for the key is
+	/// the peer host name set for the socket, or the server's IP
+	/// address if no peer host name has been set.
+	///
+	/// A SessionCache can be shared by multiple Context objects.
+	/// If the cache is full, the least recently used session
+	/// is removed. Sessions that have expired or are not
+	/// resumable are never returned.
+	///
+	/// The cache counts the lookups that found a session (hits) or
+	/// not (misses), as well as the completed handshakes that
+	/// resumed a session or not, so the session reuse
+	/// rate can be monitored.
+	///
+	/// All methods are thread-safe.
+{
+public:
+	typedef Poco::AutoPtr<SessionCache> Ptr;
+
+	enum
+	{
+		DEFAULT_CAPACITY = 1024
+	};
+
+	explicit SessionCache(std::size_t capacity = DEFAULT_CAPACITY);
+		/// Creates a SessionCache holding at most
+		/// capacity sessions.
+
+	Session::Ptr get(const std::string& key);
+		/// Returns the session stored for the given key,
+		/// or a null pointer if there is no resumable session.
+
+	void add(const std::string& key, Session::Ptr pSession);
+		/// Stores the session for the given key, replacing any
+		/// session previously stored for the key.
+		///
+		/// If the cache is full, the least recently
+		/// used session is removed.
+
+	void remove(const std::string& key);
+		/// Removes the session for the given key.
+
+	void clear();
+		/// Removes all sessions from the cache.
+
+	void countHandshake(bool resumed);
+		/// Updates the handshake statistics after a client
+		/// handshake has been completed.
+
+	std::size_t size() const;
+		/// Returns the number of sessions in the cache.
+
+	std::size_t capacity() const;
+		/// Returns the maximum number of sessions in the cache.
+
+	Poco::UInt64 hits() const;
+		/// Returns the number of lookups that found a session.
+
+	Poco::UInt64 misses() const;
+		/// Returns the number of lookups that did not
+		/// find a resumable session.
+
+	Poco::UInt64 resumedHandshakes() const;
+		/// Returns the number of handshakes that resumed
+		/// a session.
+
+	Poco::UInt64 fullHandshakes() const;
+		/// Returns the number of handshakes that did not
+		/// resume a session, either because no session was
+		/// cached, or because the server did not accept it.
+
+	void resetStatistics();
+		/// Resets all counters to zero.
+
+	static std::string key(const std::string& host, Poco::UInt16 port);
+		/// Returns the cache key for the given server,
+		/// in the form "<host>:<port>".
+
+protected:
+	~SessionCache();
+		/// Destroys the SessionCache.
+
+private:
+	SessionCache(const SessionCache&);
+	SessionCache& operator = (const SessionCache&);
+
+	struct Entry
+	{
+		std::string  key;
+		Session::Ptr pSession;
+	};
+
+	typedef std::list<Entry> EntryList;
+	typedef std::map<std::string, EntryList::iterator> EntryMap;
+
+	std::size_t  _capacity;
+	EntryList    _entries;
+	EntryMap     _index;
+	Poco::UInt64 _hits;
+	Poco::UInt64 _misses;
+	Poco::UInt64 _resumed;
+	Poco::UInt64 _full;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline std::size_t SessionCache::capacity() const
+{
+	return _capacity;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SessionCache_INCLUDED
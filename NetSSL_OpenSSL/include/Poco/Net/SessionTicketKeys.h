@@ -0,0 +1,165 @@
+//
+// SessionTicketKeys.h
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionTicketKeys
+//
+// Definition of the SessionTicketKeys class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef NetSSL_SessionTicketKeys_INCLUDED
+#define NetSSL_SessionTicketKeys_INCLUDED
+
+
+#include "Poco/Net/NetSSL.h"
+#include "Poco/RefCountedObject.h"
+#include "Poco/AutoPtr.h"
+#include "Poco/Timestamp.h"
+#include "Poco/Timespan.h"
+#include "Poco/Mutex.h"
+#include <openssl/evp.h>
+#include <openssl/hmac.h>
+#include <deque>
+
+
+namespace Poco {
+namespace Net {
+
+
+class NetSSL_API SessionTicketKeys: public Poco::RefCountedObject
+	/// SessionTicketKeys manages the keys a server uses to
+	/// encrypt and authenticate TLS session tickets (RFC 5077),
+	/// which allow clients to resume a session without the server
+	/// keeping any per-session state.
+	///
+	/// The keys are generated randomly and rotated periodically.
+	/// New tickets are always issued with the most recent key.
+	/// Tickets issued with one of the older keys are still accepted
+	/// (and renewed with the current key), until the key has been
+	/// replaced by keyCount newer keys. So, a ticket can be used
+	/// for at least (keyCount - 1) rotation intervals.
+	///
+	/// To use the keys, pass the SessionTicketKeys object to
+	/// Context::setSessionTicketKeys(). The same SessionTicketKeys
+	/// object can be shared by multiple server Context objects, so
+	/// that a ticket issued for one Context is accepted by the
+	/// others. Since the keys are random, tickets cannot be shared
+	/// across processes.
+	///
+	/// The number of tickets issued, accepted and rejected
+	/// (because the key has expired or the ticket is invalid)
+	/// is counted, so the session reuse rate can be monitored.
+	///
+	/// All methods are thread-safe.
+{
+public:
+	typedef Poco::AutoPtr<SessionTicketKeys> Ptr;
+
+	enum
+	{
+		DEFAULT_ROTATION_INTERVAL = 3600,
+			/// The default key rotation interval in seconds.
+		DEFAULT_KEY_COUNT = 3,
+			/// The default number of keys accepted for decryption.
+		KEY_NAME_SIZE = 16,
+		CIPHER_KEY_SIZE = 32,
+		HMAC_KEY_SIZE = 32
+	};
+
+	explicit SessionTicketKeys(const Poco::Timespan& rotationInterval = Poco::Timespan(DEFAULT_ROTATION_INTERVAL, 0), int keyCount = DEFAULT_KEY_COUNT);
+		/// Creates the SessionTicketKeys and generates the first key.
+		///
+		/// A new key is generated when the current key is older than
+		/// rotationInterval. At most keyCount keys are kept.
+
+	void rotate();
+		/// Generates a new key immediately, and removes
+		/// the oldest key if there are more than keyCount keys.
+
+	const Poco::Timespan& rotationInterval() const;
+		/// Returns the key rotation interval.
+
+	int keyCount() const;
+		/// Returns the maximum number of keys kept.
+
+	Poco::UInt64 ticketsIssued() const;
+		/// Returns the number of tickets issued.
+
+	Poco::UInt64 ticketsAccepted() const;
+		/// Returns the number of tickets accepted
+		/// for resuming a session.
+
+	Poco::UInt64 ticketsRejected() const;
+		/// Returns the number of tickets presented by clients
+		/// that could not be used, because the key that encrypted
+		/// them is no longer known.
+
+	void resetStatistics();
+		/// Resets all counters to zero.
+
+	int processTicket(unsigned char* pKeyName, unsigned char* pIV, EVP_CIPHER_CTX* pCipherCtx, HMAC_CTX* pHMACCtx, int encrypt);
+		/// Sets up the cipher and HMAC contexts for encrypting
+		/// (if encrypt is non-zero) or decrypting a session ticket.
+		///
+		/// This implements the OpenSSL session ticket key callback
+		/// (see SSL_CTX_set_tlsext_ticket_key_cb()) and is called
+		/// by Context.
+
+protected:
+	~SessionTicketKeys();
+		/// Destroys the SessionTicketKeys, erasing the keys.
+
+private:
+	SessionTicketKeys(const SessionTicketKeys&);
+	SessionTicketKeys& operator = (const SessionTicketKeys&);
+
+	struct Key
+	{
+		unsigned char   name[KEY_NAME_SIZE];
+		unsigned char   cipherKey[CIPHER_KEY_SIZE];
+		unsigned char   hmacKey[HMAC_KEY_SIZE];
+		Poco::Timestamp created;
+	};
+
+	typedef std::deque<Key> KeyList;
+
+	void rotateImpl();
+
+	Poco::Timespan _rotationInterval;
+	int            _keyCount;
+	KeyList        _keys;
+	Poco::UInt64   _issued;
+	Poco::UInt64   _accepted;
+	Poco::UInt64   _rejected;
+	mutable Poco::FastMutex _mutex;
+};
+
+
+//
+// inlines
+//
+inline const Poco::Timespan& SessionTicketKeys::rotationInterval() const
+{
+	return _rotationInterval;
+}
+
+
+inline int SessionTicketKeys::keyCount() const
+{
+	return _keyCount;
+}
+
+
+} } // namespace Poco::Net
+
+
+#endif // NetSSL_SessionTicketKeys_INCLUDED
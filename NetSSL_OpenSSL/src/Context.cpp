@@ -17,6 +17,7 @@
 #include "Poco/Net/Context.h"
 #include "Poco/Net/SSLManager.h"
 #include "Poco/Net/SSLException.h"
+#include "Poco/Net/SecureSocketImpl.h"
 #include "Poco/Net/Utility.h"
 #include "Poco/Crypto/OpenSSLInitializer.h"
 #include "Poco/File.h"
@@ -118,6 +119,7 @@ void Context::init(const Params& params)
 	Poco::Crypto::OpenSSLInitializer::initialize();
 	
 	createSSLContext();
+	SSL_CTX_set_app_data(_pSSLContext, this);
 
 	try
 	{
@@ -173,7 +175,7 @@ void Context::init(const Params& params)
 
 		SSL_CTX_set_cipher_list(_pSSLContext, params.cipherList.c_str());
 		SSL_CTX_set_verify_depth(_pSSLContext, params.verificationDepth);
-		SSL_CTX_set_mode(_pSSLContext, SSL_MODE_AUTO_RETRY);
+		SSL_CTX_set_mode(_pSSLContext, SSL_MODE_AUTO_RETRY | SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER);
 		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_OFF);
 		
 		initDH(params.dhParamsFile);
@@ -314,6 +316,71 @@ void Context::disableStatelessSessionResumption()
 }
 
 
+void Context::setSessionCache(SessionCache::Ptr pCache)
+{
+	poco_assert (!isForServerUse());
+
+	_pSessionCache = pCache;
+	if (pCache)
+	{
+		// Sessions are only stored in the SessionCache, which
+		// receives them from SecureSocketImpl::onNewSession().
+		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+		SSL_CTX_sess_set_new_cb(_pSSLContext, &SecureSocketImpl::onNewSession);
+	}
+	else
+	{
+		SSL_CTX_sess_set_new_cb(_pSSLContext, 0);
+		SSL_CTX_set_session_cache_mode(_pSSLContext, SSL_SESS_CACHE_OFF);
+	}
+}
+
+
+void Context::setSessionTicketKeys(SessionTicketKeys::Ptr pKeys)
+{
+	poco_assert (isForServerUse());
+
+#if !defined(OPENSSL_NO_TLSEXT) && defined(SSL_CTRL_SET_TLSEXT_TICKET_KEY_CB)
+	_pTicketKeys = pKeys;
+	if (pKeys)
+	{
+		SSL_CTX_set_tlsext_ticket_key_cb(_pSSLContext, &Context::ticketKeyCallback);
+#if defined(SSL_OP_NO_TICKET)
+		SSL_CTX_clear_options(_pSSLContext, SSL_OP_NO_TICKET);
+#endif
+	}
+	else
+	{
+		SSL_CTX_set_tlsext_ticket_key_cb(_pSSLContext, 0);
+	}
+#else
+	throw Poco::NotImplementedException("Session tickets are not supported by this OpenSSL version");
+#endif
+}
+
+
+int Context::ticketKeyCallback(SSL* pSSL, unsigned char* pKeyName, unsigned char* pIV, EVP_CIPHER_CTX* pCipherCtx, HMAC_CTX* pHMACCtx, int encrypt)
+{
+	Context* pContext = reinterpret_cast<Context*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(pSSL)));
+	if (!pContext || !pContext->_pTicketKeys) return -1;
+
+	try
+	{
+		int rc = pContext->_pTicketKeys->processTicket(pKeyName, pIV, pCipherCtx, pHMACCtx, encrypt);
+#if defined(TLS1_3_VERSION)
+		// TLSv1.3 clients use a ticket only once, so a new
+		// ticket must be issued whenever a session is resumed.
+		if (rc == 1 && !encrypt && SSL_version(pSSL) == TLS1_3_VERSION) rc = 2;
+#endif
+		return rc;
+	}
+	catch (...)
+	{
+		return -1;
+	}
+}
+
+
 void Context::disableProtocols(int protocols)
 {
 	if (protocols & PROTO_SSLV2)
@@ -55,6 +55,7 @@ const std::string SSLManager::CFG_CACHE_SESSIONS("cacheSessions");
 const std::string SSLManager::CFG_SESSION_ID_CONTEXT("sessionIdContext");
 const std::string SSLManager::CFG_SESSION_CACHE_SIZE("sessionCacheSize");
 const std::string SSLManager::CFG_SESSION_TIMEOUT("sessionTimeout");
+const std::string SSLManager::CFG_SESSION_TICKET_ROTATION("sessionTicketRotation");
 const std::string SSLManager::CFG_EXTENDED_VERIFICATION("extendedVerification");
 const std::string SSLManager::CFG_REQUIRE_TLSV1("requireTLSv1");
 const std::string SSLManager::CFG_REQUIRE_TLSV1_1("requireTLSv1_1");
@@ -347,10 +348,20 @@ void SSLManager::initDefaultContext(bool server)
 			int timeout = config.getInt(prefix + CFG_SESSION_TIMEOUT);
 			_ptrDefaultServerContext->setSessionTimeout(timeout);
 		}
+		int ticketRotation = config.getInt(prefix + CFG_SESSION_TICKET_ROTATION, 0);
+		if (ticketRotation > 0)
+		{
+			_ptrDefaultServerContext->setSessionTicketKeys(new SessionTicketKeys(Poco::Timespan(ticketRotation, 0)));
+		}
 	}
 	else
 	{
 		_ptrDefaultClientContext->enableSessionCache(cacheSessions);
+		if (cacheSessions)
+		{
+			int cacheSize = config.getInt(prefix + CFG_SESSION_CACHE_SIZE, SessionCache::DEFAULT_CAPACITY);
+			_ptrDefaultClientContext->setSessionCache(new SessionCache(cacheSize));
+		}
 	}
 	bool extendedVerification = config.getBool(prefix + CFG_EXTENDED_VERIFICATION, false);
 	if (server)
@@ -0,0 +1,316 @@
+//
+// SecureServiceHandler.cpp
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLSockets
+// Module:  SecureServiceHandler
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SecureServiceHandler.h"
+#include "Poco/Net/SSLException.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Observer.h"
+
+
+using Poco::Observer;
+
+
+namespace Poco {
+namespace Net {
+
+
+SecureServiceHandler::SecureServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+	_socket(socket),
+	_reactor(reactor),
+	_sendOffset(0),
+	_pReceiveBuffer(new char[BUFFER_SIZE]),
+	_handshakeTimeout(DEFAULT_HANDSHAKE_TIMEOUT, 0),
+	_handshakeState(0),
+	_sendState(0),
+	_receiveState(0),
+	_handshakeComplete(false),
+	_writable(true),
+	_dispatching(false),
+	_closed(false)
+{
+	try
+	{
+		_socket.setBlocking(false);
+	}
+	catch (...)
+	{
+		delete [] _pReceiveBuffer;
+		throw;
+	}
+
+	_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, ReadableNotification>(*this, &SecureServiceHandler::onReadable));
+	_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, ErrorNotification>(*this, &SecureServiceHandler::onSocketError));
+	_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, TimeoutNotification>(*this, &SecureServiceHandler::onTimeout));
+	_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, ShutdownNotification>(*this, &SecureServiceHandler::onShutdown));
+	// The first WritableNotification starts the handshake. A client must
+	// send its hello message first; a server finds out whether the client
+	// hello has already arrived.
+	_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, WritableNotification>(*this, &SecureServiceHandler::onWritable));
+}
+
+
+SecureServiceHandler::~SecureServiceHandler()
+{
+	try
+	{
+		if (!_closed)
+		{
+			_closed = true;
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ReadableNotification>(*this, &SecureServiceHandler::onReadable));
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, WritableNotification>(*this, &SecureServiceHandler::onWritable));
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ErrorNotification>(*this, &SecureServiceHandler::onSocketError));
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, TimeoutNotification>(*this, &SecureServiceHandler::onTimeout));
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ShutdownNotification>(*this, &SecureServiceHandler::onShutdown));
+			_socket.close();
+		}
+	}
+	catch (...)
+	{
+		poco_unexpected();
+	}
+	delete [] _pReceiveBuffer;
+}
+
+
+void SecureServiceHandler::send(const void* buffer, std::size_t length)
+{
+	if (_closed) throw Poco::IllegalStateException("Connection has been closed");
+
+	if (_sendOffset == _sendBuffer.size())
+	{
+		_sendBuffer.clear();
+		_sendOffset = 0;
+	}
+	else if (_sendOffset > 0)
+	{
+		// The context has SSL_MODE_ACCEPT_MOVING_WRITE_BUFFER set, so
+		// the data of a pending SSL_write() may be moved.
+		_sendBuffer.erase(0, _sendOffset);
+		_sendOffset = 0;
+	}
+	_sendBuffer.append(static_cast<const char*>(buffer), length);
+
+	if (_handshakeComplete)
+	{
+		flush();
+		if (!_dispatching) updateInterest();
+	}
+}
+
+
+void SecureServiceHandler::close()
+{
+	if (_closed) return;
+
+	_closed = true;
+	try
+	{
+		_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ReadableNotification>(*this, &SecureServiceHandler::onReadable));
+		_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, WritableNotification>(*this, &SecureServiceHandler::onWritable));
+		_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ErrorNotification>(*this, &SecureServiceHandler::onSocketError));
+		_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, TimeoutNotification>(*this, &SecureServiceHandler::onTimeout));
+		_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, ShutdownNotification>(*this, &SecureServiceHandler::onShutdown));
+		_socket.close();
+	}
+	catch (Poco::Exception&)
+	{
+	}
+	try
+	{
+		onClose();
+	}
+	catch (...)
+	{
+	}
+	if (!_dispatching) delete this;
+}
+
+
+void SecureServiceHandler::onHandshake()
+{
+}
+
+
+void SecureServiceHandler::onClose()
+{
+}
+
+
+void SecureServiceHandler::onError(const Poco::Exception& exc)
+{
+}
+
+
+void SecureServiceHandler::onReadable(ReadableNotification* pNotification)
+{
+	pNotification->release();
+	dispatch(true);
+}
+
+
+void SecureServiceHandler::onWritable(WritableNotification* pNotification)
+{
+	pNotification->release();
+	dispatch(false);
+}
+
+
+void SecureServiceHandler::onSocketError(ErrorNotification* pNotification)
+{
+	pNotification->release();
+	close();
+}
+
+
+void SecureServiceHandler::onTimeout(TimeoutNotification* pNotification)
+{
+	pNotification->release();
+	if (!_handshakeComplete && _created.isElapsed(_handshakeTimeout.totalMicroseconds()))
+	{
+		close();
+	}
+}
+
+
+void SecureServiceHandler::onShutdown(ShutdownNotification* pNotification)
+{
+	pNotification->release();
+	close();
+}
+
+
+void SecureServiceHandler::dispatch(bool readable)
+{
+	_dispatching = true;
+	try
+	{
+		// Application data may have arrived together with
+		// the last message of the handshake.
+		if (!_handshakeComplete && handshake()) readable = true;
+		if (_handshakeComplete && !_closed)
+		{
+			flush();
+			if (readable || _receiveState == SecureStreamSocket::ERR_SSL_WANT_WRITE) receive();
+		}
+	}
+	catch (Poco::Exception& exc)
+	{
+		try
+		{
+			onError(exc);
+		}
+		catch (...)
+		{
+		}
+		close();
+	}
+	_dispatching = false;
+	if (_closed)
+		delete this;
+	else
+		updateInterest();
+}
+
+
+bool SecureServiceHandler::handshake()
+{
+	int rc = _socket.completeHandshake();
+	if (rc == 1)
+	{
+		_socket.verifyPeerCertificate();
+		_handshakeComplete = true;
+		_handshakeState = 0;
+		onHandshake();
+		return true;
+	}
+	else if (rc == 0)
+	{
+		throw SSLConnectionUnexpectedlyClosedException();
+	}
+	_handshakeState = rc;
+	return false;
+}
+
+
+void SecureServiceHandler::flush()
+{
+	_sendState = 0;
+	while (_sendOffset < _sendBuffer.size())
+	{
+		std::size_t length = _sendBuffer.size() - _sendOffset;
+		if (length > BUFFER_SIZE) length = BUFFER_SIZE;
+		int n = _socket.sendBytes(_sendBuffer.data() + _sendOffset, static_cast<int>(length));
+		if (n > 0)
+		{
+			_sendOffset += n;
+		}
+		else
+		{
+			_sendState = n;
+			return;
+		}
+	}
+	_sendBuffer.clear();
+	_sendOffset = 0;
+}
+
+
+void SecureServiceHandler::receive()
+{
+	_receiveState = 0;
+	int n;
+	do
+	{
+		n = _socket.receiveBytes(_pReceiveBuffer, BUFFER_SIZE);
+		if (n > 0)
+		{
+			onData(_pReceiveBuffer, n);
+		}
+		else if (n == 0)
+		{
+			close();
+		}
+		else
+		{
+			_receiveState = n;
+		}
+	}
+	// Data already decrypted by OpenSSL does not make
+	// the socket readable, so it must be read now.
+	while (n > 0 && !_closed && _socket.available() > 0);
+}
+
+
+void SecureServiceHandler::updateInterest()
+{
+	bool writable;
+	if (!_handshakeComplete)
+		writable = _handshakeState == SecureStreamSocket::ERR_SSL_WANT_WRITE;
+	else
+		writable = _receiveState == SecureStreamSocket::ERR_SSL_WANT_WRITE || (pendingOutput() > 0 && _sendState == SecureStreamSocket::ERR_SSL_WANT_WRITE);
+
+	if (writable != _writable)
+	{
+		if (writable)
+			_reactor.addEventHandler(_socket, Observer<SecureServiceHandler, WritableNotification>(*this, &SecureServiceHandler::onWritable));
+		else
+			_reactor.removeEventHandler(_socket, Observer<SecureServiceHandler, WritableNotification>(*this, &SecureServiceHandler::onWritable));
+		_writable = writable;
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -110,6 +110,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, bool performHandsha
 	poco_assert (!_pSSL);
 
 	_pSocket->connect(address);
+	_sessionCacheKey = sessionCacheKey(address);
 	connectSSL(performHandshake);
 }
 
@@ -121,6 +122,7 @@ void SecureSocketImpl::connect(const SocketAddress& address, const Poco::Timespa
 	poco_assert (!_pSSL);
 
 	_pSocket->connect(address, timeout);
+	_sessionCacheKey = sessionCacheKey(address);
 	Poco::Timespan receiveTimeout = _pSocket->getReceiveTimeout();
 	Poco::Timespan sendTimeout = _pSocket->getSendTimeout();
 	_pSocket->setReceiveTimeout(timeout);
@@ -138,6 +140,7 @@ void SecureSocketImpl::connectNB(const SocketAddress& address)
 	poco_assert (!_pSSL);
 
 	_pSocket->connectNB(address);
+	_sessionCacheKey = sessionCacheKey(address);
 	connectSSL(false);
 }
 
@@ -166,9 +169,25 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 	}
 #endif
 
-	if (_pSession)
+	Session::Ptr pSession = _pSession;
+	SessionCache::Ptr pCache = _pContext->getSessionCache();
+	if (pCache)
 	{
-		SSL_set_session(_pSSL, _pSession->sslSession());
+		if (_sessionCacheKey.empty())
+		{
+			_sessionCacheKey = sessionCacheKey(_pSocket->peerAddress());
+		}
+		// A session explicitly set with useSession() takes
+		// precedence, unless it can no longer be resumed.
+		if (!pSession || !pSession->isResumable())
+		{
+			pSession = pCache->get(_sessionCacheKey);
+		}
+		SSL_set_app_data(_pSSL, this);
+	}
+	if (pSession)
+	{
+		SSL_set_session(_pSSL, pSession->sslSession());
 	}
 	
 	try
@@ -177,6 +196,7 @@ void SecureSocketImpl::connectSSL(bool performHandshake)
 		{
 			int ret = SSL_connect(_pSSL);
 			handleError(ret);
+			handshakeCompleted();
 			verifyPeerCertificate();
 		}
 		else
@@ -341,7 +361,11 @@ int SecureSocketImpl::completeHandshake()
 	{
 		return handleError(rc);
 	}
-	_needHandshake = false;
+	if (_needHandshake)
+	{
+		_needHandshake = false;
+		handshakeCompleted();
+	}
 	return rc;
 }
 
@@ -516,6 +540,7 @@ void SecureSocketImpl::setPeerHostName(const std::string& peerHostName)
 void SecureSocketImpl::reset()
 {
 	close();
+	_sessionCacheKey.clear();
 	if (_pSSL)
 	{
 		SSL_free(_pSSL);
@@ -555,6 +580,47 @@ void SecureSocketImpl::useSession(Session::Ptr pSession)
 }
 
 
+std::string SecureSocketImpl::sessionCacheKey(const SocketAddress& address) const
+{
+	if (_peerHostName.empty())
+		return SessionCache::key(address.host().toString(), address.port());
+	else
+		return SessionCache::key(_peerHostName, address.port());
+}
+
+
+void SecureSocketImpl::handshakeCompleted()
+{
+	SessionCache::Ptr pCache = _pContext->getSessionCache();
+	if (pCache && !_sessionCacheKey.empty())
+	{
+		pCache->countHandshake(SSL_session_reused(_pSSL) != 0);
+	}
+}
+
+
+int SecureSocketImpl::onNewSession(SSL* pSSL, SSL_SESSION* pSession)
+{
+	SecureSocketImpl* pThis = reinterpret_cast<SecureSocketImpl*>(SSL_get_app_data(pSSL));
+	if (!pThis || pThis->_sessionCacheKey.empty()) return 0;
+
+	SessionCache::Ptr pCache = pThis->_pContext->getSessionCache();
+	if (!pCache) return 0;
+
+	// The Session takes over the reference to the SSL_SESSION,
+	// which is signaled to OpenSSL by returning 1.
+	Session::Ptr pCachedSession = new Session(pSession);
+	try
+	{
+		pCache->add(pThis->_sessionCacheKey, pCachedSession);
+	}
+	catch (...)
+	{
+	}
+	return 1;
+}
+
+
 bool SecureSocketImpl::sessionWasReused()
 {
 	if (_pSSL)
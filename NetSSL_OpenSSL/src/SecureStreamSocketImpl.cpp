@@ -123,12 +123,30 @@ int SecureStreamSocketImpl::sendBytes(const void* buffer, int length, int flags)
 }
 
 
+int SecureStreamSocketImpl::sendBytes(const SocketBufVec& buffers, int flags)
+{
+	return sendGathered(buffers, flags);
+}
+
+
+Poco::Int64 SecureStreamSocketImpl::sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count)
+{
+	return SocketImpl::sendFile(istr, offset, count);
+}
+
+
 int SecureStreamSocketImpl::receiveBytes(void* buffer, int length, int flags)
 {
 	return _impl.receiveBytes(buffer, length, flags);
 }
 
 
+int SecureStreamSocketImpl::receiveBytes(SocketBufVec& buffers, int flags)
+{
+	return receiveScattered(buffers, flags);
+}
+
+
 int SecureStreamSocketImpl::sendTo(const void* buffer, int length, const SocketAddress& address, int flags)
 {
 	throw Poco::InvalidAccessException("Cannot sendTo() on a SecureStreamSocketImpl");
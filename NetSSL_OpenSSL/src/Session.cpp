@@ -21,6 +21,7 @@
 
 
 #include "Poco/Net/Session.h"
+#include "Poco/Timestamp.h"
 
 
 namespace Poco {
@@ -39,4 +40,14 @@ Session::~Session()
 }
 
 
+bool Session::isResumable() const
+{
+#if OPENSSL_VERSION_NUMBER >= 0x10101000L
+	if (!SSL_SESSION_is_resumable(_pSession)) return false;
+#endif
+	Poco::Timestamp now;
+	return SSL_SESSION_get_time(_pSession) + SSL_SESSION_get_timeout(_pSession) > static_cast<long>(now.epochTime());
+}
+
+
 } } // namespace Poco::Net
@@ -0,0 +1,183 @@
+//
+// SessionCache.cpp
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionCache
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SessionCache.h"
+#include "Poco/NumberFormatter.h"
+
+
+namespace Poco {
+namespace Net {
+
+
+SessionCache::SessionCache(std::size_t capacity):
+	_capacity(capacity),
+	_hits(0),
+	_misses(0),
+	_resumed(0),
+	_full(0)
+{
+	poco_assert (capacity > 0);
+}
+
+
+SessionCache::~SessionCache()
+{
+}
+
+
+Session::Ptr SessionCache::get(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	EntryMap::iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		if (it->second->pSession->isResumable())
+		{
+			_entries.splice(_entries.begin(), _entries, it->second);
+			++_hits;
+			return it->second->pSession;
+		}
+		_entries.erase(it->second);
+		_index.erase(it);
+	}
+	++_misses;
+	return 0;
+}
+
+
+void SessionCache::add(const std::string& key, Session::Ptr pSession)
+{
+	poco_check_ptr (pSession);
+
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	EntryMap::iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		it->second->pSession = pSession;
+		_entries.splice(_entries.begin(), _entries, it->second);
+	}
+	else
+	{
+		if (_entries.size() >= _capacity)
+		{
+			_index.erase(_entries.back().key);
+			_entries.pop_back();
+		}
+		Entry entry;
+		entry.key = key;
+		entry.pSession = pSession;
+		_entries.push_front(entry);
+		_index[key] = _entries.begin();
+	}
+}
+
+
+void SessionCache::remove(const std::string& key)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	EntryMap::iterator it = _index.find(key);
+	if (it != _index.end())
+	{
+		_entries.erase(it->second);
+		_index.erase(it);
+	}
+}
+
+
+void SessionCache::clear()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_entries.clear();
+	_index.clear();
+}
+
+
+void SessionCache::countHandshake(bool resumed)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (resumed)
+		++_resumed;
+	else
+		++_full;
+}
+
+
+std::size_t SessionCache::size() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _entries.size();
+}
+
+
+Poco::UInt64 SessionCache::hits() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _hits;
+}
+
+
+Poco::UInt64 SessionCache::misses() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _misses;
+}
+
+
+Poco::UInt64 SessionCache::resumedHandshakes() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _resumed;
+}
+
+
+Poco::UInt64 SessionCache::fullHandshakes() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _full;
+}
+
+
+void SessionCache::resetStatistics()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_hits = 0;
+	_misses = 0;
+	_resumed = 0;
+	_full = 0;
+}
+
+
+std::string SessionCache::key(const std::string& host, Poco::UInt16 port)
+{
+	std::string k(host);
+	k += ':';
+	Poco::NumberFormatter::append(k, port);
+	return k;
+}
+
+
+} } // namespace Poco::Net
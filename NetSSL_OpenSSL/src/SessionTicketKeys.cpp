@@ -0,0 +1,150 @@
+//
+// SessionTicketKeys.cpp
+//
+// $Id$
+//
+// Library: NetSSL_OpenSSL
+// Package: SSLCore
+// Module:  SessionTicketKeys
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "Poco/Net/SessionTicketKeys.h"
+#include "Poco/Net/SSLException.h"
+#include "Poco/Net/Utility.h"
+#include <openssl/rand.h>
+#include <openssl/crypto.h>
+#include <cstring>
+
+
+namespace Poco {
+namespace Net {
+
+
+SessionTicketKeys::SessionTicketKeys(const Poco::Timespan& rotationInterval, int keyCount):
+	_rotationInterval(rotationInterval),
+	_keyCount(keyCount),
+	_issued(0),
+	_accepted(0),
+	_rejected(0)
+{
+	poco_assert (keyCount > 0);
+
+	rotateImpl();
+}
+
+
+SessionTicketKeys::~SessionTicketKeys()
+{
+	for (KeyList::iterator it = _keys.begin(); it != _keys.end(); ++it)
+	{
+		OPENSSL_cleanse(&*it, sizeof(Key));
+	}
+}
+
+
+void SessionTicketKeys::rotate()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	rotateImpl();
+}
+
+
+Poco::UInt64 SessionTicketKeys::ticketsIssued() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _issued;
+}
+
+
+Poco::UInt64 SessionTicketKeys::ticketsAccepted() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _accepted;
+}
+
+
+Poco::UInt64 SessionTicketKeys::ticketsRejected() const
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	return _rejected;
+}
+
+
+void SessionTicketKeys::resetStatistics()
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	_issued = 0;
+	_accepted = 0;
+	_rejected = 0;
+}
+
+
+int SessionTicketKeys::processTicket(unsigned char* pKeyName, unsigned char* pIV, EVP_CIPHER_CTX* pCipherCtx, HMAC_CTX* pHMACCtx, int encrypt)
+{
+	Poco::FastMutex::ScopedLock lock(_mutex);
+
+	if (encrypt)
+	{
+		if (_keys.front().created.isElapsed(_rotationInterval.totalMicroseconds()))
+		{
+			rotateImpl();
+		}
+		const Key& key = _keys.front();
+		if (RAND_bytes(pIV, EVP_CIPHER_iv_length(EVP_aes_256_cbc())) != 1) return -1;
+		std::memcpy(pKeyName, key.name, KEY_NAME_SIZE);
+		if (EVP_EncryptInit_ex(pCipherCtx, EVP_aes_256_cbc(), 0, key.cipherKey, pIV) != 1) return -1;
+		if (HMAC_Init_ex(pHMACCtx, key.hmacKey, HMAC_KEY_SIZE, EVP_sha256(), 0) != 1) return -1;
+		++_issued;
+		return 1;
+	}
+	else
+	{
+		for (KeyList::const_iterator it = _keys.begin(); it != _keys.end(); ++it)
+		{
+			if (std::memcmp(pKeyName, it->name, KEY_NAME_SIZE) == 0)
+			{
+				if (HMAC_Init_ex(pHMACCtx, it->hmacKey, HMAC_KEY_SIZE, EVP_sha256(), 0) != 1) return -1;
+				if (EVP_DecryptInit_ex(pCipherCtx, EVP_aes_256_cbc(), 0, it->cipherKey, pIV) != 1) return -1;
+				++_accepted;
+				// Ask OpenSSL to issue a new ticket with
+				// the current key if an older key was used.
+				return it == _keys.begin() ? 1 : 2;
+			}
+		}
+		++_rejected;
+		return 0;
+	}
+}
+
+
+void SessionTicketKeys::rotateImpl()
+{
+	Key key;
+	if (RAND_bytes(key.name, KEY_NAME_SIZE) != 1 ||
+	    RAND_bytes(key.cipherKey, CIPHER_KEY_SIZE) != 1 ||
+	    RAND_bytes(key.hmacKey, HMAC_KEY_SIZE) != 1)
+	{
+		throw SSLException("Cannot generate session ticket key", Utility::getLastError());
+	}
+	_keys.push_front(key);
+	OPENSSL_cleanse(&key, sizeof(key));
+	while (_keys.size() > static_cast<std::size_t>(_keyCount))
+	{
+		OPENSSL_cleanse(&_keys.back(), sizeof(Key));
+		_keys.pop_back();
+	}
+}
+
+
+} } // namespace Poco::Net
@@ -25,6 +25,8 @@
 #include "Poco/Net/SecureStreamSocket.h"
 #include "Poco/Net/Context.h"
 #include "Poco/Net/Session.h"
+#include "Poco/Net/SessionCache.h"
+#include "Poco/Net/SessionTicketKeys.h"
 #include "Poco/Net/SSLManager.h"
 #include "Poco/Net/SSLException.h"
 #include "Poco/Util/Application.h"
@@ -416,6 +418,55 @@ void HTTPSClientSessionTest::testCachedSession()
 }
 
 
+void HTTPSClientSessionTest::testSessionCache()
+{
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+	
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");	
+	pServerContext->setSessionTicketKeys(new SessionTicketKeys);
+
+	HTTPSTestServer srv(pServerContext);
+
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.privateKeyFile"),
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	SessionCache::Ptr pCache = new SessionCache;
+	pClientContext->setSessionCache(pCache);
+
+	for (int i = 0; i < 3; i++)
+	{
+		HTTPSClientSession s("127.0.0.1", srv.port(), pClientContext);
+		HTTPRequest request(HTTPRequest::HTTP_GET, "/small");
+		s.sendRequest(request);
+		HTTPResponse response;
+		std::istream& rs = s.receiveResponse(response);
+		assert (response.getContentLength() == HTTPSTestServer::SMALL_BODY.length());
+		std::ostringstream ostr;
+		StreamCopier::copyStream(rs, ostr);
+		assert (ostr.str() == HTTPSTestServer::SMALL_BODY);
+	}
+	assert (pCache->fullHandshakes() == 1);
+	assert (pCache->resumedHandshakes() == 2);
+	assert (pCache->hits() == 2);
+}
+
+
 void HTTPSClientSessionTest::testUnknownContentLength()
 {
 	HTTPSTestServer srv;
@@ -481,6 +532,7 @@ CppUnit::Test* HTTPSClientSessionTest::suite()
 #endif
 	CppUnit_addTest(pSuite, HTTPSClientSessionTest, testProxy);
 	CppUnit_addTest(pSuite, HTTPSClientSessionTest, testCachedSession);
+	CppUnit_addTest(pSuite, HTTPSClientSessionTest, testSessionCache);
 	CppUnit_addTest(pSuite, HTTPSClientSessionTest, testUnknownContentLength);
 	CppUnit_addTest(pSuite, HTTPSClientSessionTest, testServerAbort);
 
@@ -38,6 +38,7 @@ public:
 	void testInterop();
 	void testProxy();
 	void testCachedSession();
+	void testSessionCache();
 	void testUnknownContentLength();
 	void testServerAbort();
 
@@ -0,0 +1,315 @@
+//
+// SecureServiceHandlerTest.cpp
+//
+// $Id$
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#include "SecureServiceHandlerTest.h"
+#include "Poco/CppUnit/TestCaller.h"
+#include "Poco/CppUnit/TestSuite.h"
+#include "Poco/Net/SecureServiceHandler.h"
+#include "Poco/Net/SecureStreamSocket.h"
+#include "Poco/Net/SecureServerSocket.h"
+#include "Poco/Net/SocketReactor.h"
+#include "Poco/Net/SocketAcceptor.h"
+#include "Poco/Net/SocketConnector.h"
+#include "Poco/Net/TCPServer.h"
+#include "Poco/Net/TCPServerConnection.h"
+#include "Poco/Net/TCPServerConnectionFactory.h"
+#include "Poco/Net/SSLManager.h"
+#include "Poco/Net/NetException.h"
+#include "Poco/Thread.h"
+#include "Poco/Event.h"
+#include <vector>
+#include <iostream>
+
+
+using Poco::Net::SecureServiceHandler;
+using Poco::Net::SecureStreamSocket;
+using Poco::Net::SecureServerSocket;
+using Poco::Net::StreamSocket;
+using Poco::Net::ServerSocket;
+using Poco::Net::SocketReactor;
+using Poco::Net::SocketAcceptor;
+using Poco::Net::SocketConnector;
+using Poco::Net::SocketAddress;
+using Poco::Net::TCPServer;
+using Poco::Net::TCPServerConnection;
+using Poco::Net::TCPServerConnectionFactoryImpl;
+using Poco::Net::SSLManager;
+using Poco::Net::ConnectionResetException;
+using Poco::Thread;
+using Poco::Event;
+using Poco::Timespan;
+
+
+namespace
+{
+	class EchoServiceHandler: public SecureServiceHandler
+	{
+	public:
+		EchoServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			SecureServiceHandler(socket, reactor)
+		{
+			setHandshakeTimeout(handshakeTimeout);
+		}
+
+		static Timespan handshakeTimeout;
+
+	protected:
+		void onData(const char* pData, std::size_t length)
+		{
+			send(pData, length);
+		}
+	};
+
+	Timespan EchoServiceHandler::handshakeTimeout(SecureServiceHandler::DEFAULT_HANDSHAKE_TIMEOUT, 0);
+
+
+	class ClientServiceHandler: public SecureServiceHandler
+	{
+	public:
+		ClientServiceHandler(const StreamSocket& socket, SocketReactor& reactor):
+			SecureServiceHandler(socket, reactor)
+		{
+		}
+
+		static std::string data;
+		static Event done;
+
+	protected:
+		void onHandshake()
+		{
+			send("hello, world", 12);
+		}
+
+		void onData(const char* pData, std::size_t length)
+		{
+			data.append(pData, length);
+			if (data.size() >= 12) close();
+		}
+
+		void onClose()
+		{
+			done.set();
+		}
+	};
+
+	std::string ClientServiceHandler::data;
+	Event ClientServiceHandler::done;
+
+
+	class EchoConnection: public TCPServerConnection
+	{
+	public:
+		EchoConnection(const StreamSocket& s): TCPServerConnection(s)
+		{
+		}
+
+		void run()
+		{
+			StreamSocket& ss = socket();
+			try
+			{
+				char buffer[256];
+				int n = ss.receiveBytes(buffer, sizeof(buffer));
+				while (n > 0)
+				{
+					ss.sendBytes(buffer, n);
+					n = ss.receiveBytes(buffer, sizeof(buffer));
+				}
+			}
+			catch (Poco::Exception& exc)
+			{
+				std::cerr << "EchoConnection: " << exc.displayText() << std::endl;
+			}
+		}
+	};
+}
+
+
+SecureServiceHandlerTest::SecureServiceHandlerTest(const std::string& name): CppUnit::TestCase(name)
+{
+}
+
+
+SecureServiceHandlerTest::~SecureServiceHandlerTest()
+{
+}
+
+
+void SecureServiceHandlerTest::testAcceptor()
+{
+	SecureServerSocket svs(0);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss(sa);
+	std::string data("hello, world");
+	ss.sendBytes(data.data(), (int) data.size());
+	char buffer[256];
+	int n = ss.receiveBytes(buffer, sizeof(buffer));
+	assert (n > 0);
+	assert (std::string(buffer, n) == data);
+	ss.close();
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureServiceHandlerTest::testMultipleConnections()
+{
+	SecureServerSocket svs(0);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	std::vector<SecureStreamSocket> sockets;
+	for (int i = 0; i < 10; i++)
+	{
+		sockets.push_back(SecureStreamSocket(sa));
+	}
+	for (int i = 0; i < 10; i++)
+	{
+		std::string data("hello, world ");
+		data += static_cast<char>('0' + i);
+		sockets[i].sendBytes(data.data(), (int) data.size());
+	}
+	for (int i = 0; i < 10; i++)
+	{
+		std::string data("hello, world ");
+		data += static_cast<char>('0' + i);
+		char buffer[256];
+		int n = sockets[i].receiveBytes(buffer, sizeof(buffer));
+		assert (n > 0);
+		assert (std::string(buffer, n) == data);
+		sockets[i].close();
+	}
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureServiceHandlerTest::testLargeData()
+{
+	SecureServerSocket svs(0);
+	SocketReactor reactor;
+	SocketAcceptor<EchoServiceHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss(sa);
+	// Much more than fits into the socket buffers, so that the
+	// handler must wait for the socket to become writable.
+	const int size = 4*1024*1024;
+	std::string data;
+	data.reserve(size);
+	for (int i = 0; i < size; i++) data += static_cast<char>('a' + i % 26);
+	int sent = ss.sendBytes(data.data(), size);
+	assert (sent == size);
+
+	std::string received;
+	std::vector<char> buffer(16384);
+	while (received.size() < data.size())
+	{
+		int n = ss.receiveBytes(&buffer[0], (int) buffer.size());
+		assert (n > 0);
+		received.append(&buffer[0], n);
+	}
+	assert (received == data);
+	ss.close();
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureServiceHandlerTest::testConnector()
+{
+	SecureServerSocket svs(0);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	SocketReactor reactor;
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss(SSLManager::instance().defaultClientContext());
+	SocketConnector<ClientServiceHandler> connector(sa, reactor, ss);
+	Thread thread;
+	thread.start(reactor);
+
+	assert (ClientServiceHandler::done.tryWait(10000));
+	assert (ClientServiceHandler::data == "hello, world");
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureServiceHandlerTest::testHandshakeTimeout()
+{
+	EchoServiceHandler::handshakeTimeout = Timespan(0, 200000);
+	SecureServerSocket svs(0);
+	SocketReactor reactor(Timespan(0, 50000));
+	SocketAcceptor<EchoServiceHandler> acceptor(svs, reactor);
+	Thread thread;
+	thread.start(reactor);
+
+	// A plain TCP client that never starts the handshake.
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	StreamSocket ss(sa);
+	ss.setReceiveTimeout(Timespan(10, 0));
+	try
+	{
+		char buffer[256];
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		assert (n == 0);
+	}
+	catch (ConnectionResetException&)
+	{
+	}
+	ss.close();
+
+	reactor.stop();
+	thread.join();
+}
+
+
+void SecureServiceHandlerTest::setUp()
+{
+	ClientServiceHandler::data.clear();
+	ClientServiceHandler::done.reset();
+}
+
+
+void SecureServiceHandlerTest::tearDown()
+{
+	EchoServiceHandler::handshakeTimeout = Timespan(SecureServiceHandler::DEFAULT_HANDSHAKE_TIMEOUT, 0);
+}
+
+
+CppUnit::Test* SecureServiceHandlerTest::suite()
+{
+	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("SecureServiceHandlerTest");
+
+	CppUnit_addTest(pSuite, SecureServiceHandlerTest, testAcceptor);
+	CppUnit_addTest(pSuite, SecureServiceHandlerTest, testMultipleConnections);
+	CppUnit_addTest(pSuite, SecureServiceHandlerTest, testLargeData);
+	CppUnit_addTest(pSuite, SecureServiceHandlerTest, testConnector);
+	CppUnit_addTest(pSuite, SecureServiceHandlerTest, testHandshakeTimeout);
+
+	return pSuite;
+}
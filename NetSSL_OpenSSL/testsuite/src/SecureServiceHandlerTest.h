@@ -0,0 +1,44 @@
+//
+// SecureServiceHandlerTest.h
+//
+// $Id$
+//
+// Definition of the SecureServiceHandlerTest class.
+//
+// Copyright (c) 2016, Applied Informatics Software Engineering GmbH.
+// and Contributors.
+//
+// SPDX-License-Identifier:	BSL-1.0
+//
+
+
+#ifndef SecureServiceHandlerTest_INCLUDED
+#define SecureServiceHandlerTest_INCLUDED
+
+
+#include "Poco/Net/Net.h"
+#include "Poco/CppUnit/TestCase.h"
+
+
+class SecureServiceHandlerTest: public CppUnit::TestCase
+{
+public:
+	SecureServiceHandlerTest(const std::string& name);
+	~SecureServiceHandlerTest();
+
+	void testAcceptor();
+	void testMultipleConnections();
+	void testLargeData();
+	void testConnector();
+	void testHandshakeTimeout();
+
+	void setUp();
+	void tearDown();
+
+	static CppUnit::Test* suite();
+
+private:
+};
+
+
+#endif // SecureServiceHandlerTest_INCLUDED
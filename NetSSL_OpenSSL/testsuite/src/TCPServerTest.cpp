@@ -21,6 +21,8 @@
 #include "Poco/Net/SecureServerSocket.h"
 #include "Poco/Net/Context.h"
 #include "Poco/Net/Session.h"
+#include "Poco/Net/SessionCache.h"
+#include "Poco/Net/SessionTicketKeys.h"
 #include "Poco/Net/SSLManager.h"
 #include "Poco/Util/Application.h"
 #include "Poco/Util/AbstractConfiguration.h"
@@ -39,6 +41,8 @@ using Poco::Net::SecureServerSocket;
 using Poco::Net::SocketAddress;
 using Poco::Net::Context;
 using Poco::Net::Session;
+using Poco::Net::SessionCache;
+using Poco::Net::SessionTicketKeys;
 using Poco::Net::SSLManager;
 using Poco::Thread;
 using Poco::Util::Application;
@@ -46,6 +50,16 @@ using Poco::Util::Application;
 
 namespace
 {
+	bool echo(SecureStreamSocket& ss)
+	{
+		std::string data("hello, world");
+		ss.sendBytes(data.data(), (int) data.size());
+		char buffer[256];
+		int n = ss.receiveBytes(buffer, sizeof(buffer));
+		return n > 0 && std::string(buffer, n) == data;
+	}
+
+
 	class EchoConnection: public TCPServerConnection
 	{
 	public:
@@ -383,6 +397,158 @@ void TCPServerTest::testReuseSession()
 }
 
 
+void TCPServerTest::testSessionCache()
+{
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	SessionTicketKeys::Ptr pKeys = new SessionTicketKeys;
+	pServerContext->setSessionTicketKeys(pKeys);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	SessionCache::Ptr pCache = new SessionCache(2);
+	Context::Ptr pClientContext1 = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext1->setSessionCache(pCache);
+	assert (pClientContext1->sessionCacheEnabled());
+	Context::Ptr pClientContext2 = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext2->setSessionCache(pCache);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss1(sa, pClientContext1);
+	assert (!ss1.sessionWasReused());
+	assert (echo(ss1));
+	ss1.close();
+	assert (pCache->size() == 1);
+	assert (pCache->misses() == 1);
+	assert (pCache->hits() == 0);
+	assert (pCache->fullHandshakes() == 1);
+	assert (pKeys->ticketsIssued() > 0);
+
+	// The session is shared by all sockets, and all
+	// Contexts using the SessionCache.
+	SecureStreamSocket ss2(sa, pClientContext1);
+	assert (ss2.sessionWasReused());
+	assert (echo(ss2));
+	ss2.close();
+	SecureStreamSocket ss3(sa, pClientContext2);
+	assert (ss3.sessionWasReused());
+	assert (echo(ss3));
+	ss3.close();
+	assert (pCache->hits() == 2);
+	assert (pCache->resumedHandshakes() == 2);
+	assert (pCache->fullHandshakes() == 1);
+	assert (pKeys->ticketsAccepted() == 2);
+
+	// Sessions are keyed by host and port.
+	SecureStreamSocket ss4(sa, "localhost", pClientContext1);
+	assert (!ss4.sessionWasReused());
+	assert (echo(ss4));
+	ss4.close();
+	assert (pCache->size() == 2);
+	assert (pCache->get(SessionCache::key("127.0.0.1", sa.port())));
+	assert (pCache->get(SessionCache::key("localhost", sa.port())));
+	assert (!pCache->get(SessionCache::key("localhost", sa.port() + 1)));
+
+	pCache->add(SessionCache::key("127.0.0.2", sa.port()), pCache->get(SessionCache::key("localhost", sa.port())));
+	assert (pCache->size() == 2);
+	assert (!pCache->get(SessionCache::key("127.0.0.1", sa.port())));
+
+	pCache->clear();
+	assert (pCache->size() == 0);
+}
+
+
+void TCPServerTest::testSessionTicketKeyRotation()
+{
+	// ensure OpenSSL machinery is fully setup
+	Context::Ptr pDefaultServerContext = SSLManager::instance().defaultServerContext();
+	Context::Ptr pDefaultClientContext = SSLManager::instance().defaultClientContext();
+
+	Context::Ptr pServerContext = new Context(
+		Context::SERVER_USE, 
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.privateKeyFile"),
+		Application::instance().config().getString("openSSL.server.caConfig"),
+		Context::VERIFY_NONE,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	SessionTicketKeys::Ptr pKeys = new SessionTicketKeys(Poco::Timespan(3600, 0), 2);
+	pServerContext->setSessionTicketKeys(pKeys);
+
+	SecureServerSocket svs(0, 64, pServerContext);
+	TCPServer srv(new TCPServerConnectionFactoryImpl<EchoConnection>(), svs);
+	srv.start();
+
+	SessionCache::Ptr pCache = new SessionCache;
+	Context::Ptr pClientContext = new Context(
+		Context::CLIENT_USE, 
+		Application::instance().config().getString("openSSL.client.caConfig"),
+		Context::VERIFY_RELAXED,
+		9,
+		true,
+		"ALL:!ADH:!LOW:!EXP:!MD5:@STRENGTH");
+	pClientContext->setSessionCache(pCache);
+
+	SocketAddress sa("127.0.0.1", svs.address().port());
+	SecureStreamSocket ss1(sa, pClientContext);
+	assert (echo(ss1));
+	ss1.close();
+
+	// A ticket encrypted with the previous key is still accepted.
+	pKeys->rotate();
+	SecureStreamSocket ss2(sa, pClientContext);
+	assert (ss2.sessionWasReused());
+	assert (echo(ss2));
+	ss2.close();
+	assert (pKeys->ticketsAccepted() == 1);
+	assert (pKeys->ticketsRejected() == 0);
+
+	// The renewed ticket is encrypted with the current key, so rotating
+	// once more keeps it valid; after another rotation, it is rejected.
+	pKeys->rotate();
+	SecureStreamSocket ss3(sa, pClientContext);
+	assert (ss3.sessionWasReused());
+	assert (echo(ss3));
+	ss3.close();
+
+	pKeys->rotate();
+	pKeys->rotate();
+	SecureStreamSocket ss4(sa, pClientContext);
+	assert (!ss4.sessionWasReused());
+	assert (echo(ss4));
+	ss4.close();
+	assert (pKeys->ticketsRejected() == 1);
+	assert (pCache->resumedHandshakes() == 2);
+	assert (pCache->fullHandshakes() == 2);
+}
+
+
 void TCPServerTest::setUp()
 {
 }
@@ -402,6 +568,8 @@ CppUnit::Test* TCPServerTest::suite()
 	CppUnit_addTest(pSuite, TCPServerTest, testMultiConnections);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSocket);
 	CppUnit_addTest(pSuite, TCPServerTest, testReuseSession);
+	CppUnit_addTest(pSuite, TCPServerTest, testSessionCache);
+	CppUnit_addTest(pSuite, TCPServerTest, testSessionTicketKeyRotation);
 
 	return pSuite;
 }
@@ -31,6 +31,8 @@ public:
 	void testMultiConnections();
 	void testReuseSocket();
 	void testReuseSession();
+	void testSessionCache();
+	void testSessionTicketKeyRotation();
 
 	void setUp();
 	void tearDown();
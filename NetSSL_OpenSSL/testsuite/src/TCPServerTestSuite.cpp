@@ -12,6 +12,7 @@
 
 #include "TCPServerTestSuite.h"
 #include "TCPServerTest.h"
+#include "SecureServiceHandlerTest.h"
 
 
 CppUnit::Test* TCPServerTestSuite::suite()
@@ -19,6 +20,7 @@ CppUnit::Test* TCPServerTestSuite::suite()
 	CppUnit::TestSuite* pSuite = new CppUnit::TestSuite("TCPServerTestSuite");
 
 	pSuite->addTest(TCPServerTest::suite());
+	pSuite->addTest(SecureServiceHandlerTest::suite());
 
 	return pSuite;
 }
@@ -83,12 +83,31 @@ public:
 		///
 		/// Returns the number of bytes sent, which may be
 		/// less than the number of bytes specified.
+
+	int sendBytes(const SocketBufVec& buffers, int flags = 0);
+		/// Sends the contents of the given buffers through
+		/// the socket, as if they were a single buffer.
+		/// Any specified flags are ignored.
+		///
+		/// Returns the number of bytes sent, which may be
+		/// less than the total size of the buffers.
+
+	Poco::Int64 sendFile(Poco::FileInputStream& istr, Poco::UInt64 offset, Poco::UInt64 count);
+		/// Sends the file contents through the socket. The file is
+		/// read into user space for encryption, so sendfile() is
+		/// never used.
 	
 	int receiveBytes(void* buffer, int length, int flags = 0);
 		/// Receives data from the socket and stores it
 		/// in buffer. Up to length bytes are received.
 		///
 		/// Returns the number of bytes received.
+
+	int receiveBytes(SocketBufVec& buffers, int flags = 0);
+		/// Receives data from the socket and stores it in
+		/// the given buffers, as if they were a single buffer.
+		///
+		/// Returns the number of bytes received.
 	
 	int sendTo(const void* buffer, int length, const SocketAddress& address, int flags = 0);
 		/// Not supported by a SecureStreamSocket.